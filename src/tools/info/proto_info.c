@@ -11,6 +11,8 @@
 #include "ucx_info.h"
 
 #include <ucp/api/ucp.h>
+#include <ucp/core/ucp_ep.h>
+#include <ucp/proto/proto_select.h>
 #include <ucs/time/time.h>
 #include <ucs/sys/string.h>
 #include <ucs/debug/assert.h>
@@ -193,7 +195,7 @@ out_destroy_listener:
 
 ucs_status_t
 print_ucp_ep_info(ucp_worker_h worker, const ucp_ep_params_t *base_ep_params,
-                  const char *ip_addr)
+                  const char *ip_addr, int proto_prefill)
 {
     ucp_listener_h listener    = NULL;
     ucp_ep_h server_ep         = NULL;
@@ -253,6 +255,10 @@ print_ucp_ep_info(ucp_worker_h worker, const ucp_ep_params_t *base_ep_params,
         goto out_close_eps;
     }
 
+    if (proto_prefill) {
+        ucp_proto_select_prefill(worker, ep->cfg_index);
+    }
+
     ucp_ep_print_info(ep, stdout);
 
 out_close_eps:
@@ -281,7 +287,7 @@ print_ucp_info(int print_opts, ucs_config_print_flags_t print_flags,
                uint64_t ctx_features, const ucp_ep_params_t *base_ep_params,
                size_t estimated_num_eps, size_t estimated_num_ppn,
                unsigned dev_type_bitmap, const char *mem_size,
-               const char *ip_addr)
+               const char *ip_addr, const char *proto_cache_file)
 {
     ucp_config_t *config;
     ucs_status_t status;
@@ -315,6 +321,10 @@ print_ucp_info(int print_opts, ucs_config_print_flags_t print_flags,
     if (!(dev_type_bitmap & UCS_BIT(UCT_DEVICE_TYPE_NET))) {
         ucp_config_modify(config, "NET_DEVICES", "");
     }
+    if (proto_cache_file != NULL) {
+        ucp_config_modify(config, "PROTO_ENABLE", "y");
+        ucp_config_modify(config, "PROTO_CACHE_FILE", proto_cache_file);
+    }
 
     status = ucp_init(&params, config, &context);
     if (status != UCS_OK) {
@@ -352,7 +362,8 @@ print_ucp_info(int print_opts, ucs_config_print_flags_t print_flags,
     }
 
     if (print_opts & PRINT_UCP_EP) {
-        status = print_ucp_ep_info(worker, base_ep_params, ip_addr);
+        status = print_ucp_ep_info(worker, base_ep_params, ip_addr,
+                                   proto_cache_file != NULL);
     }
 
     ucp_worker_destroy(worker);
@@ -36,6 +36,8 @@ static void usage() {
     printf("  -w              Show UCP worker information\n");
     printf("  -e              Show UCP endpoint configuration\n");
     printf("  -m <size>       Show UCP memory allocation method for a given size\n");
+    printf("  -P <file>       Save protocol selection of tag send operations to a\n"
+           "                  cache file, to be used with UCX_PROTO_CACHE_FILE (requires -e)\n");
     printf("  -u <features>   UCP context features to use. String of one or more of:\n");
     printf("                    'a' : atomic operations\n");
     printf("                    'r' : remote memory access\n");
@@ -70,7 +72,7 @@ int main(int argc, char **argv)
     size_t ucp_num_eps;
     size_t ucp_num_ppn;
     unsigned print_opts;
-    char *tl_name, *mem_size;
+    char *tl_name, *mem_size, *proto_cache_file;
     const char *f;
     int c;
 
@@ -81,10 +83,11 @@ int main(int argc, char **argv)
     ucp_num_eps              = 1;
     ucp_num_ppn              = 1;
     mem_size                 = NULL;
+    proto_cache_file         = NULL;
     dev_type_bitmap          = UINT_MAX;
     ucp_ep_params.field_mask = 0;
 
-    while ((c = getopt(argc, argv, "fahvcydbswpeCt:n:u:D:m:N:A:")) != -1) {
+    while ((c = getopt(argc, argv, "fahvcydbswpeCt:n:u:D:m:N:A:P:")) != -1) {
         switch (c) {
         case 'f':
             print_flags |= UCS_CONFIG_PRINT_CONFIG | UCS_CONFIG_PRINT_HEADER | UCS_CONFIG_PRINT_DOC;
@@ -126,6 +129,9 @@ int main(int argc, char **argv)
             print_opts |= PRINT_MEM_MAP;
             mem_size = optarg;
             break;
+        case 'P':
+            proto_cache_file = optarg;
+            break;
         case 't':
             tl_name = optarg;
             break;
@@ -231,7 +237,8 @@ int main(int argc, char **argv)
 
         return print_ucp_info(print_opts, print_flags, ucp_features,
                               &ucp_ep_params, ucp_num_eps, ucp_num_ppn,
-                              dev_type_bitmap, mem_size, ip_addr);
+                              dev_type_bitmap, mem_size, ip_addr,
+                              proto_cache_file);
     }
 
     return 0;
@@ -43,6 +43,6 @@ print_ucp_info(int print_opts, ucs_config_print_flags_t print_flags,
                uint64_t ctx_features, const ucp_ep_params_t *base_ep_params,
                size_t estimated_num_eps, size_t estimated_num_ppn,
                unsigned dev_type_bitmap, const char *mem_size,
-               const char *ip_addr);
+               const char *ip_addr, const char *proto_cache_file);
 
 #endif
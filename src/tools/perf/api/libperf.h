@@ -38,6 +38,10 @@ typedef enum {
     UCX_PERF_CMD_TAG,
     UCX_PERF_CMD_TAG_SYNC,
     UCX_PERF_CMD_STREAM,
+    UCX_PERF_CMD_CONNECT,          /* Create and close endpoints to the peer's
+                                      worker address */
+    UCX_PERF_CMD_CONNECT_SOCKADDR, /* Create and close endpoints to the peer's
+                                      listener */
     UCX_PERF_CMD_LAST
 } ucx_perf_cmd_t;
 
@@ -121,6 +125,13 @@ typedef struct ucx_perf_result {
         double              total_average;  /* Average of the whole test */
     }
     latency, bandwidth, msgrate;
+    struct {
+        double              create;  /* Endpoint creation */
+        double              wireup;  /* Connection establishment and first
+                                        round trip */
+        double              close;   /* Endpoint close */
+    } conn_phase;                    /* Average time of each phase of a
+                                        connection, for connection tests */
 } ucx_perf_result_t;
 
 
@@ -215,6 +226,9 @@ typedef struct ucx_perf_params {
         ucp_perf_datatype_t    recv_datatype;
         size_t                 am_hdr_size; /* UCP Active Message header size
                                                (not included in message size) */
+        struct sockaddr_storage peer_addr;  /* Host address of the peer for
+                                               connection tests through a
+                                               listener, port is ignored */
     } ucp;
 
 } ucx_perf_params_t;
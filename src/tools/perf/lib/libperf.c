@@ -294,6 +294,9 @@ static void ucx_perf_test_prepare_new_run(ucx_perf_context_t *perf,
     perf->prev.msgs         = 0;
     perf->prev.bytes        = 0;
     perf->prev.iters        = 0;
+    perf->conn_phase.create = 0;
+    perf->conn_phase.wireup = 0;
+    perf->conn_phase.close  = 0;
     perf->timing_queue_head = 0;
 
     for (i = 0; i < TIMING_QUEUE_SIZE; ++i) {
@@ -375,6 +378,12 @@ void ucx_perf_calc_result(ucx_perf_context_t *perf, ucx_perf_result_t *result)
         perf->current.msgs /
         (perf->current.time_acc - perf->start_time_acc) * factor;
 
+
+    /* Connection phases */
+
+    result->conn_phase.create = perf->conn_phase.create / perf->current.iters;
+    result->conn_phase.wireup = perf->conn_phase.wireup / perf->current.iters;
+    result->conn_phase.close  = perf->conn_phase.close  / perf->current.iters;
 }
 
 static ucs_status_t ucx_perf_test_check_params(ucx_perf_params_t *params)
@@ -390,7 +399,9 @@ static ucs_status_t ucx_perf_test_check_params(ucx_perf_params_t *params)
           (params->command != UCX_PERF_CMD_AM) &&
           (params->command != UCX_PERF_CMD_TAG) &&
           (params->command != UCX_PERF_CMD_TAG_SYNC) &&
-          (params->command != UCX_PERF_CMD_STREAM))) &&
+          (params->command != UCX_PERF_CMD_STREAM) &&
+          (params->command != UCX_PERF_CMD_CONNECT) &&
+          (params->command != UCX_PERF_CMD_CONNECT_SOCKADDR))) &&
         ucx_perf_get_message_size(params) < 1) {
         if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
             ucs_error("Message size too small, need to be at least 1");
@@ -416,6 +427,15 @@ static ucs_status_t ucx_perf_test_check_params(ucx_perf_params_t *params)
         return UCS_ERR_INVALID_PARAM;
     }
 
+    if (((params->command == UCX_PERF_CMD_CONNECT) ||
+         (params->command == UCX_PERF_CMD_CONNECT_SOCKADDR)) &&
+        (params->thread_count > 1)) {
+        if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
+            ucs_error("Connection tests do not support multiple threads");
+        }
+        return UCS_ERR_UNSUPPORTED;
+    }
+
     if (params->max_outstanding < 1) {
         if (params->flags & UCX_PERF_TEST_FLAG_VERBOSE) {
             ucs_error("max_outstanding, need to be at least 1");
@@ -980,6 +1000,8 @@ static ucs_status_t ucp_perf_test_fill_params(ucx_perf_params_t *params,
         ucp_params->features |= UCP_FEATURE_STREAM;
         break;
     case UCX_PERF_CMD_AM:
+    case UCX_PERF_CMD_CONNECT:
+    case UCX_PERF_CMD_CONNECT_SOCKADDR:
         ucp_params->features |= UCP_FEATURE_AM;
         break;
     default:
@@ -1177,6 +1199,9 @@ static void ucp_perf_test_destroy_eps(ucx_perf_context_t* perf)
                          ucs_status_string(UCS_PTR_STATUS(req)));
             }
         }
+
+        free(perf->ucp.tctx[i].perf.ucp.remote_worker_addr);
+        perf->ucp.tctx[i].perf.ucp.remote_worker_addr = NULL;
     }
 }
 
@@ -1236,8 +1261,9 @@ static ucs_status_t ucp_perf_test_receive_remote_data(ucx_perf_context_t *perf)
 
     /* Initialize all endpoints and rkeys to NULL to handle error flow */
     for (i = 0; i < thread_count; i++) {
-        perf->ucp.tctx[i].perf.ucp.ep   = NULL;
-        perf->ucp.tctx[i].perf.ucp.rkey = NULL;
+        perf->ucp.tctx[i].perf.ucp.ep                 = NULL;
+        perf->ucp.tctx[i].perf.ucp.rkey               = NULL;
+        perf->ucp.tctx[i].perf.ucp.remote_worker_addr = NULL;
     }
 
     /* receive the data from the remote peer, extract the address from it
@@ -1263,6 +1289,20 @@ static ucs_status_t ucp_perf_test_receive_remote_data(ucx_perf_context_t *perf)
             goto err_free_eps_buffer;
         }
 
+        if (perf->params.command == UCX_PERF_CMD_CONNECT) {
+            /* Connection test creates more endpoints to the same address */
+            perf->ucp.tctx[i].perf.ucp.remote_worker_addr =
+                    malloc(remote_info->ucp.worker_addr_len);
+            if (perf->ucp.tctx[i].perf.ucp.remote_worker_addr == NULL) {
+                ucs_error("failed to allocate remote worker address");
+                status = UCS_ERR_NO_MEMORY;
+                goto err_free_eps_buffer;
+            }
+
+            memcpy(perf->ucp.tctx[i].perf.ucp.remote_worker_addr, address,
+                   remote_info->ucp.worker_addr_len);
+        }
+
         if (remote_info->rkey_size > 0) {
             status = ucp_ep_rkey_unpack(perf->ucp.tctx[i].perf.ucp.ep, rkey_buffer,
                                         &perf->ucp.tctx[i].perf.ucp.rkey);
@@ -1865,6 +1905,8 @@ ucs_status_t ucx_perf_run(const ucx_perf_params_t *params,
             perf->ucp.ep          = perf->ucp.tctx[0].perf.ucp.ep;
             perf->ucp.remote_addr = perf->ucp.tctx[0].perf.ucp.remote_addr;
             perf->ucp.rkey        = perf->ucp.tctx[0].perf.ucp.rkey;
+            perf->ucp.remote_worker_addr =
+                    perf->ucp.tctx[0].perf.ucp.remote_worker_addr;
         }
 
         if (params->warmup_iter > 0) {
@@ -1961,6 +2003,11 @@ static void ucx_perf_thread_report_aggregated_results(ucx_perf_context_t *perf)
     agg_result.latency.moment_average   = 0.0;
     agg_result.latency.typical          = 0.0;
 
+    /* connection tests do not support multiple threads */
+    agg_result.conn_phase.create        = 0.0;
+    agg_result.conn_phase.wireup        = 0.0;
+    agg_result.conn_phase.close         = 0.0;
+
     /* in case of multiple threads, we have to aggregate the results so that the
      * final output of the result would show the performance numbers that were
      * collected from all the threads.
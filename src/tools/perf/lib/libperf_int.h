@@ -76,6 +76,13 @@ struct ucx_perf_context {
         double                   time_acc; /* accurate time (for avg latency/bw/msgrate) */
     } current, prev;
 
+    /* Accumulated time of connection phases, in seconds */
+    struct {
+        double                   create;
+        double                   wireup;
+        double                   close;
+    } conn_phase;
+
     ucs_time_t                   timing_queue[TIMING_QUEUE_SIZE];
     unsigned                     timing_queue_head;
     const ucx_perf_allocator_t   *allocator;
@@ -105,6 +112,8 @@ struct ucx_perf_context {
             ucp_dt_iov_t               *send_iov;
             ucp_dt_iov_t               *recv_iov;
             void                       *am_hdr;
+            void                       *remote_worker_addr; /* For connection
+                                                               tests */
         } ucp;
     };
 };
@@ -14,6 +14,7 @@
 #include "libperf_int.h"
 
 #include <ucs/sys/preprocessor.h>
+#include <ucs/sys/sock.h>
 #include <limits>
 
 
@@ -24,6 +25,8 @@ template <ucx_perf_cmd_t CMD, ucx_perf_test_type_t TYPE, unsigned FLAGS>
 class ucp_perf_test_runner {
 public:
     static const unsigned AM_ID     = 1;
+    static const unsigned REPLY_ID  = 2;
+    static const unsigned CLOSE_ID  = 3;
     static const ucp_tag_t TAG      = 0x1337a880u;
     static const ucp_tag_t TAG_MASK = (FLAGS & UCX_PERF_TEST_FLAG_TAG_WILDCARD) ?
                                       0 : (ucp_tag_t)-1;
@@ -35,41 +38,61 @@ public:
           m_outstanding(0),
           m_max_outstanding(m_perf.params.max_outstanding),
           m_am_rx_buffer(NULL),
-          m_am_rx_length(0ul)
+          m_am_rx_length(0ul),
+          m_conn_replies(0),
+          m_conn_served(0),
+          m_conn_close_ep(NULL)
 
     {
         memset(&m_am_rx_params, 0, sizeof(m_am_rx_params));
 
         ucs_assert_always(m_max_outstanding > 0);
 
-        set_am_handler(am_data_handler, this, UCP_AM_FLAG_WHOLE_MSG);
+        if (CMD == UCX_PERF_CMD_AM) {
+            set_am_handler(AM_ID, am_data_handler, this, UCP_AM_FLAG_WHOLE_MSG);
+        } else if (is_connect_test()) {
+            set_am_handler(AM_ID, conn_request_handler, this, 0);
+            set_am_handler(REPLY_ID, conn_reply_handler, this, 0);
+            set_am_handler(CLOSE_ID, conn_close_handler, this, 0);
+        }
     }
 
     ~ucp_perf_test_runner()
     {
-        set_am_handler(NULL, this, 0);
+        if (CMD == UCX_PERF_CMD_AM) {
+            set_am_handler(AM_ID, NULL, this, 0);
+        } else if (is_connect_test()) {
+            set_am_handler(AM_ID, NULL, this, 0);
+            set_am_handler(REPLY_ID, NULL, this, 0);
+            set_am_handler(CLOSE_ID, NULL, this, 0);
+        }
     }
 
-    void set_am_handler(ucp_am_recv_callback_t cb, void *arg, unsigned flags)
+    static bool is_connect_test()
     {
-        if (CMD == UCX_PERF_CMD_AM) {
-            ucp_am_handler_param_t param;
-            param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
-                               UCP_AM_HANDLER_PARAM_FIELD_CB |
-                               UCP_AM_HANDLER_PARAM_FIELD_ARG;
-            param.id         = AM_ID;
-            param.cb         = cb;
-            param.arg        = arg;
-
-            if (flags != 0) {
-                param.field_mask |= UCP_AM_HANDLER_PARAM_FIELD_FLAGS;
-                param.flags       = flags;
-            }
+        return (CMD == UCX_PERF_CMD_CONNECT) ||
+               (CMD == UCX_PERF_CMD_CONNECT_SOCKADDR);
+    }
 
-            ucs_status_t status = ucp_worker_set_am_recv_handler(
-                                      m_perf.ucp.worker, &param);
-            ucs_assert_always(status == UCS_OK);
+    void set_am_handler(unsigned id, ucp_am_recv_callback_t cb, void *arg,
+                        unsigned flags)
+    {
+        ucp_am_handler_param_t param;
+        param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
+                           UCP_AM_HANDLER_PARAM_FIELD_CB |
+                           UCP_AM_HANDLER_PARAM_FIELD_ARG;
+        param.id         = id;
+        param.cb         = cb;
+        param.arg        = arg;
+
+        if (flags != 0) {
+            param.field_mask |= UCP_AM_HANDLER_PARAM_FIELD_FLAGS;
+            param.flags       = flags;
         }
+
+        ucs_status_t status = ucp_worker_set_am_recv_handler(
+                                  m_perf.ucp.worker, &param);
+        ucs_assert_always(status == UCS_OK);
     }
 
     void create_iov_buffer(ucp_dt_iov_t *iov, void *buffer)
@@ -270,6 +293,88 @@ public:
         return UCS_OK;
     }
 
+    static ucs_status_t
+    conn_request_handler(void *arg, const void *header, size_t header_length,
+                         void *data, size_t length,
+                         const ucp_am_recv_param_t *param)
+    {
+        ucp_perf_test_runner *test = (ucp_perf_test_runner*)arg;
+        ucp_request_param_t send_param;
+        ucs_status_ptr_t request;
+
+        ucs_assert_always(param->recv_attr & UCP_AM_RECV_ATTR_FIELD_REPLY_EP);
+
+        send_param.op_attr_mask = 0;
+        request = ucp_am_send_nbx(param->reply_ep, REPLY_ID, NULL, 0, NULL, 0,
+                                  &send_param);
+        if (UCS_PTR_IS_PTR(request)) {
+            ucp_request_free(request);
+        }
+
+        ++test->m_conn_served;
+        return UCS_OK;
+    }
+
+    static ucs_status_t
+    conn_reply_handler(void *arg, const void *header, size_t header_length,
+                       void *data, size_t length,
+                       const ucp_am_recv_param_t *param)
+    {
+        ucp_perf_test_runner *test = (ucp_perf_test_runner*)arg;
+
+        ++test->m_conn_replies;
+        return UCS_OK;
+    }
+
+    static ucs_status_t
+    conn_close_handler(void *arg, const void *header, size_t header_length,
+                       void *data, size_t length,
+                       const ucp_am_recv_param_t *param)
+    {
+        ucp_perf_test_runner *test = (ucp_perf_test_runner*)arg;
+
+        /* The endpoint is closed by the server loop, since it cannot be
+         * closed from the callback */
+        ucs_assert_always(param->recv_attr & UCP_AM_RECV_ATTR_FIELD_REPLY_EP);
+        ucs_assert_always(test->m_conn_close_ep == NULL);
+        test->m_conn_close_ep = param->reply_ep;
+        return UCS_OK;
+    }
+
+    static void conn_handler(ucp_conn_request_h conn_request, void *arg)
+    {
+        ucp_perf_test_runner *test = (ucp_perf_test_runner*)arg;
+        ucp_ep_params_t ep_params;
+        ucs_status_t status;
+        ucp_ep_h ep;
+
+        ep_params.field_mask      = UCP_EP_PARAM_FIELD_CONN_REQUEST |
+                                    UCP_EP_PARAM_FIELD_ERR_HANDLER;
+        ep_params.conn_request    = conn_request;
+        ep_params.err_handler.cb  = conn_err_handler;
+        ep_params.err_handler.arg = NULL;
+
+        status = ucp_ep_create(test->m_perf.ucp.worker, &ep_params, &ep);
+        if (status != UCS_OK) {
+            ucs_warn("failed to accept connection request: %s",
+                     ucs_status_string(status));
+        }
+    }
+
+    static void conn_err_handler(void *arg, ucp_ep_h ep, ucs_status_t status)
+    {
+        ucp_request_param_t param;
+        ucs_status_ptr_t request;
+
+        /* The client closed the connection, release the server endpoint */
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+        param.flags        = UCP_EP_CLOSE_FLAG_FORCE;
+        request            = ucp_ep_close_nbx(ep, &param);
+        if (UCS_PTR_IS_PTR(request)) {
+            ucp_request_free(request);
+        }
+    }
+
     void UCS_F_ALWAYS_INLINE wait_window(unsigned n, bool is_requestor)
     {
         while (m_outstanding >= (m_max_outstanding - n + 1)) {
@@ -634,8 +739,238 @@ public:
         return UCS_OK;
     }
 
+    ucs_status_t wait_request(ucs_status_ptr_t request)
+    {
+        ucs_status_t status;
+
+        if (!UCS_PTR_IS_PTR(request)) {
+            return UCS_PTR_STATUS(request);
+        }
+
+        while ((status = ucp_request_check_status(request)) ==
+               UCS_INPROGRESS) {
+            progress_requestor();
+        }
+
+        ucp_request_free(request);
+        return status;
+    }
+
+    /* Create a listener on the server, and pass its address to the client */
+    ucs_status_t exchange_listener_addr(unsigned my_index,
+                                        ucp_listener_h *listener_p,
+                                        struct sockaddr_storage *listen_addr)
+    {
+        struct {
+            ucs_status_t status;
+            uint16_t     port;
+        } local_info, remote_info;
+        ucp_listener_params_t listener_params;
+        ucp_listener_attr_t listener_attr;
+        struct sockaddr_in addr;
+        struct iovec vec;
+        void *req = NULL;
+
+        local_info.status = UCS_OK;
+        local_info.port   = 0;
+
+        if (my_index == 0) {
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family      = AF_INET;
+            addr.sin_addr.s_addr = INADDR_ANY;
+
+            listener_params.field_mask        = UCP_LISTENER_PARAM_FIELD_SOCK_ADDR |
+                                                UCP_LISTENER_PARAM_FIELD_CONN_HANDLER;
+            listener_params.sockaddr.addr     = (const struct sockaddr*)&addr;
+            listener_params.sockaddr.addrlen  = sizeof(addr);
+            listener_params.conn_handler.cb   = conn_handler;
+            listener_params.conn_handler.arg  = this;
+
+            local_info.status = ucp_listener_create(m_perf.ucp.worker,
+                                                    &listener_params,
+                                                    listener_p);
+            if (local_info.status == UCS_OK) {
+                listener_attr.field_mask = UCP_LISTENER_ATTR_FIELD_SOCKADDR;
+                local_info.status        = ucp_listener_query(*listener_p,
+                                                              &listener_attr);
+            }
+
+            if (local_info.status == UCS_OK) {
+                local_info.status = ucs_sockaddr_get_port(
+                        (const struct sockaddr*)&listener_attr.sockaddr,
+                        &local_info.port);
+            }
+        } else if (m_perf.params.ucp.peer_addr.ss_family == AF_UNSPEC) {
+            ucs_error("peer host address is required for connecting to a "
+                      "listener");
+            local_info.status = UCS_ERR_INVALID_ADDR;
+        }
+
+        vec.iov_base = &local_info;
+        vec.iov_len  = sizeof(local_info);
+        rte_call(&m_perf, post_vec, &vec, 1, &req);
+        rte_call(&m_perf, exchange_vec, req);
+        rte_call(&m_perf, recv, 1 - my_index, &remote_info,
+                 sizeof(remote_info), req);
+
+        if (local_info.status != UCS_OK) {
+            return local_info.status;
+        } else if (remote_info.status != UCS_OK) {
+            return remote_info.status;
+        }
+
+        if (my_index == 1) {
+            *listen_addr = m_perf.params.ucp.peer_addr;
+            return ucs_sockaddr_set_port((struct sockaddr*)listen_addr,
+                                         remote_info.port);
+        }
+
+        return UCS_OK;
+    }
+
+    /* Create an endpoint, complete one round trip on it, and close it */
+    ucs_status_t connect_once(const struct sockaddr_storage *listen_addr)
+    {
+        unsigned replies = m_conn_replies;
+        ucp_request_param_t param;
+        ucp_ep_params_t ep_params;
+        ucs_time_t t0, t1, t2, t3;
+        ucs_status_t status;
+        ucp_ep_h ep;
+
+        if (CMD == UCX_PERF_CMD_CONNECT_SOCKADDR) {
+            ep_params.field_mask       = UCP_EP_PARAM_FIELD_FLAGS |
+                                         UCP_EP_PARAM_FIELD_SOCK_ADDR |
+                                         UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE |
+                                         UCP_EP_PARAM_FIELD_ERR_HANDLER;
+            ep_params.flags            = UCP_EP_PARAMS_FLAGS_CLIENT_SERVER;
+            ep_params.sockaddr.addr    = (const struct sockaddr*)listen_addr;
+            ep_params.sockaddr.addrlen = sizeof(*listen_addr);
+            ep_params.err_mode         = UCP_ERR_HANDLING_MODE_PEER;
+            ep_params.err_handler.cb   = (ucp_err_handler_cb_t)
+                                         ucs_empty_function;
+            ep_params.err_handler.arg  = NULL;
+        } else {
+            ep_params.field_mask       = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+            ep_params.address          = (const ucp_address_t*)
+                                         m_perf.ucp.remote_worker_addr;
+        }
+
+        t0     = ucs_get_time();
+        status = ucp_ep_create(m_perf.ucp.worker, &ep_params, &ep);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        /* The reply arrives after the connection is fully established */
+        t1                 = ucs_get_time();
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+        param.flags        = UCP_AM_SEND_FLAG_REPLY;
+        status             = wait_request(ucp_am_send_nbx(ep, AM_ID, NULL, 0,
+                                                          NULL, 0, &param));
+        while ((status == UCS_OK) && (m_conn_replies == replies)) {
+            progress_requestor();
+        }
+
+        t2 = ucs_get_time();
+        if ((status == UCS_OK) && (CMD == UCX_PERF_CMD_CONNECT)) {
+            /* Without a connection manager, the server does not know when the
+             * client closes its endpoint, so ask it to close its side */
+            status = wait_request(ucp_am_send_nbx(ep, CLOSE_ID, NULL, 0, NULL,
+                                                  0, &param));
+        }
+
+        param.op_attr_mask = 0;
+        wait_request(ucp_ep_close_nbx(ep, &param));
+        t3                 = ucs_get_time();
+
+        m_perf.conn_phase.create += ucs_time_to_sec(t1 - t0);
+        m_perf.conn_phase.wireup += ucs_time_to_sec(t2 - t1);
+        m_perf.conn_phase.close  += ucs_time_to_sec(t3 - t2);
+        return status;
+    }
+
+    /* Wait for the close request of the client, and close the server
+     * endpoint which was created for the client endpoint */
+    ucs_status_t close_server_ep()
+    {
+        ucp_request_param_t param;
+        ucp_ep_h ep;
+
+        while (m_conn_close_ep == NULL) {
+            progress_responder();
+        }
+
+        ep                 = m_conn_close_ep;
+        m_conn_close_ep    = NULL;
+        param.op_attr_mask = 0;
+        return wait_request(ucp_ep_close_nbx(ep, &param));
+    }
+
+    ucs_status_t run_connect()
+    {
+        ucp_listener_h listener = NULL;
+        struct sockaddr_storage listen_addr;
+        ucs_status_t status;
+        unsigned my_index, served;
+
+        my_index = rte_call(&m_perf, group_index);
+
+        if (CMD == UCX_PERF_CMD_CONNECT_SOCKADDR) {
+            status = exchange_listener_addr(my_index, &listener, &listen_addr);
+            if (status != UCS_OK) {
+                goto out;
+            }
+        }
+
+        ucp_perf_barrier(&m_perf);
+
+        ucx_perf_test_start_clock(&m_perf);
+
+        status = UCS_OK;
+        if (my_index == 0) {
+            UCX_PERF_TEST_FOREACH(&m_perf) {
+                served = m_conn_served;
+                while (m_conn_served == served) {
+                    progress_responder();
+                }
+
+                if (CMD == UCX_PERF_CMD_CONNECT) {
+                    status = close_server_ep();
+                    if (status != UCS_OK) {
+                        break;
+                    }
+                }
+                ucx_perf_update(&m_perf, 1, 0);
+            }
+        } else if (my_index == 1) {
+            UCX_PERF_TEST_FOREACH(&m_perf) {
+                status = connect_once(&listen_addr);
+                if (status != UCS_OK) {
+                    break;
+                }
+                ucx_perf_update(&m_perf, 1, 0);
+            }
+        }
+
+        ucx_perf_get_time(&m_perf);
+
+        /* Let the server complete the disconnect of the last endpoint */
+        ucp_perf_barrier(&m_perf);
+
+out:
+        if (listener != NULL) {
+            ucp_listener_destroy(listener);
+        }
+        return status;
+    }
+
     ucs_status_t run()
     {
+        if (is_connect_test()) {
+            return run_connect();
+        }
+
         /* coverity[switch_selector_expr_is_constant] */
         switch (TYPE) {
         case UCX_PERF_TEST_TYPE_PINGPONG:
@@ -718,6 +1053,10 @@ private:
     void                *m_am_rx_buffer;
     size_t              m_am_rx_length;
     ucp_request_param_t m_am_rx_params;
+    /* Used by connection tests only */
+    unsigned            m_conn_replies;
+    unsigned            m_conn_served;
+    ucp_ep_h            m_conn_close_ep;
 };
 
 
@@ -761,6 +1100,9 @@ private:
 #define TEST_CASE_ALL_AM(_perf, _case) \
     TEST_CASE(_perf, UCS_PP_TUPLE_0 _case, UCS_PP_TUPLE_1 _case, 0, 0)
 
+#define TEST_CASE_ALL_CONNECT(_perf, _case) \
+    TEST_CASE(_perf, UCS_PP_TUPLE_0 _case, UCS_PP_TUPLE_1 _case, 0, 0)
+
 ucs_status_t ucp_perf_test_dispatch(ucx_perf_context_t *perf)
 {
     UCS_PP_FOREACH(TEST_CASE_ALL_OSD, perf,
@@ -791,6 +1133,11 @@ ucs_status_t ucp_perf_test_dispatch(ucx_perf_context_t *perf)
         (UCX_PERF_CMD_AM,       UCX_PERF_TEST_TYPE_STREAM_UNI)
         );
 
+    UCS_PP_FOREACH(TEST_CASE_ALL_CONNECT, perf,
+        (UCX_PERF_CMD_CONNECT,          UCX_PERF_TEST_TYPE_STREAM_UNI),
+        (UCX_PERF_CMD_CONNECT_SOCKADDR, UCX_PERF_TEST_TYPE_STREAM_UNI)
+        );
+
     ucs_error("Invalid test case: %d/%d/0x%x",
               perf->params.command, perf->params.test_type,
               perf->params.flags);
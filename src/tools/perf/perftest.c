@@ -168,6 +168,12 @@ test_type_t tests[] = {
     {"ucp_am_bw", UCX_PERF_API_UCP, UCX_PERF_CMD_AM, UCX_PERF_TEST_TYPE_STREAM_UNI,
      "am bandwidth / message rate", "overhead", 32},
 
+    {"ucp_conn", UCX_PERF_API_UCP, UCX_PERF_CMD_CONNECT, UCX_PERF_TEST_TYPE_STREAM_UNI,
+     "connection latency / rate to worker address", "latency", 1},
+
+    {"ucp_conn_sa", UCX_PERF_API_UCP, UCX_PERF_CMD_CONNECT_SOCKADDR, UCX_PERF_TEST_TYPE_STREAM_UNI,
+     "connection latency / rate to listener", "latency", 1},
+
     {NULL}
 };
 
@@ -281,6 +287,15 @@ static void print_progress(char **test_names, unsigned num_names,
                result->msgrate.total_average);
     }
 
+    if (final && !(flags & TEST_FLAG_PRINT_CSV) &&
+        ((result->conn_phase.create + result->conn_phase.wireup +
+          result->conn_phase.close) > 0)) {
+        printf("Connection phases (usec): create %.3f, wireup %.3f, "
+               "close %.3f\n", result->conn_phase.create * 1000000.0,
+               result->conn_phase.wireup * 1000000.0,
+               result->conn_phase.close * 1000000.0);
+    }
+
     fflush(stdout);
 }
 
@@ -498,6 +513,8 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("\n");
     printf("   NOTE: When running UCP tests, transport and device should be specified by\n");
     printf("         environment variables: UCX_TLS and UCX_[SELF|SHM|NET]_DEVICES.\n");
+    printf("         Connection tests create and close an endpoint in every iteration,\n");
+    printf("         so a smaller number of iterations (-n, -w) is recommended.\n");
     printf("\n");
 }
 
@@ -1178,6 +1195,9 @@ static ucs_status_t setup_sock_rte(struct perftest_context *ctx)
                       NULL, NULL);
         }
 
+        /* connection tests through a listener connect to the same host */
+        memcpy(&ctx->params.super.ucp.peer_addr, &inaddr, sizeof(inaddr));
+
         ctx->sock_rte_group.connfd    = sockfd;
         ctx->sock_rte_group.is_server = 0;
     }
@@ -223,7 +223,17 @@ typedef enum {
     /**< Pack addresses of network devices only. Using such shortened addresses
      *   for the remote node peers will reduce the amount of wireup data being
      *   exchanged during connection establishment phase. */
-    UCP_WORKER_ADDRESS_FLAG_NET_ONLY = UCS_BIT(0)
+    UCP_WORKER_ADDRESS_FLAG_NET_ONLY = UCS_BIT(0),
+
+    /**< Pack only the interface addresses of the worker, and refer to a
+     *   dictionary for the device addresses and transport attributes. The
+     *   dictionary is a full address, queried with the same other flags from
+     *   a worker with identical transports on the same host, and it must be
+     *   added to the remote peer by @ref ucp_worker_add_address_dict
+     *   "ucp_worker_add_address_dict()" before the compact address is used.
+     *   The flag is ignored if transports are not configured to
+     *   use the full address format. */
+    UCP_WORKER_ADDRESS_FLAG_COMPACT  = UCS_BIT(1)
 } ucp_worker_address_flags_t;
 
 
@@ -264,7 +274,7 @@ enum ucp_ep_params_flags_field {
                                                            must be provided and
                                                            contain the address
                                                            of the remote peer */
-    UCP_EP_PARAMS_FLAGS_NO_LOOPBACK    = UCS_BIT(1)   /**< Avoid connecting the
+    UCP_EP_PARAMS_FLAGS_NO_LOOPBACK    = UCS_BIT(1),  /**< Avoid connecting the
                                                            endpoint to itself when
                                                            connecting the endpoint
                                                            to the same worker it
@@ -273,6 +283,41 @@ enum ucp_ep_params_flags_field {
                                                            send to a particular
                                                            remote endpoint, for
                                                            example stream */
+    UCP_EP_PARAMS_FLAGS_LAZY_CONNECT   = UCS_BIT(2),  /**< Defer transport
+                                                           selection and wireup
+                                                           with the remote worker
+                                                           until the first
+                                                           communication
+                                                           operation is posted
+                                                           on the endpoint.
+                                                           Useful when many
+                                                           endpoints are created
+                                                           but only some of them
+                                                           are used. Supported
+                                                           only with
+                                                           @ref ucp_ep_params_t::address. */
+    UCP_EP_PARAMS_FLAGS_AM_AGGREGATE   = UCS_BIT(3)   /**< Aggregate small
+                                                           active messages sent
+                                                           by @ref ucp_am_send_nbx
+                                                           on the endpoint into
+                                                           a single transport
+                                                           message. A message
+                                                           which is aggregated
+                                                           completes immediately,
+                                                           and is sent when the
+                                                           aggregate is full,
+                                                           after
+                                                           UCX_AM_AGGREGATE_DELAY,
+                                                           before a message
+                                                           which is not
+                                                           aggregated, or when
+                                                           the endpoint or the
+                                                           worker is flushed.
+                                                           Useful to improve the
+                                                           message rate on
+                                                           transports with high
+                                                           per-message overhead,
+                                                           such as TCP. */
 };
 
 
@@ -715,7 +760,19 @@ typedef enum {
      * the data handlers, which are registered with @a UCP_AM_FLAG_WHOLE_MSG
      * flag.
      */
-    UCP_AM_RECV_ATTR_FLAG_ONLY          = UCS_BIT(19)
+    UCP_AM_RECV_ATTR_FLAG_ONLY          = UCS_BIT(19),
+
+    /**
+     * Indicates that the data was assembled in a buffer returned by the
+     * @ref ucp_am_handler_param_t.alloc_cb callback of the handler. The buffer
+     * is owned by the user, and must not be passed to @ref ucp_am_data_release
+     * or @ref ucp_am_recv_data_nbx. If the message could not be received
+     * completely, the callback is invoked with zero @a length, so that the
+     * buffer can be reclaimed. The data is not held by UCP, so the callback
+     * should return UCS_OK. This flag is mutually exclusive with
+     * @a UCP_AM_RECV_ATTR_FLAG_DATA and @a UCP_AM_RECV_ATTR_FLAG_RNDV flags.
+     */
+    UCP_AM_RECV_ATTR_FLAG_USER_BUFFER   = UCS_BIT(20)
 } ucp_am_recv_attr_t;
 
 
@@ -742,7 +799,11 @@ enum ucp_am_handler_param_field {
     /**
      * Indicates that @ref ucp_am_handler_param_t.arg field is valid.
      */
-    UCP_AM_HANDLER_PARAM_FIELD_ARG     = UCS_BIT(3)
+    UCP_AM_HANDLER_PARAM_FIELD_ARG     = UCS_BIT(3),
+    /**
+     * Indicates that @ref ucp_am_handler_param_t.alloc_cb field is valid.
+     */
+    UCP_AM_HANDLER_PARAM_FIELD_ALLOC_CB = UCS_BIT(4)
 };
 
 
@@ -796,6 +857,79 @@ typedef struct ucp_dt_iov {
 } ucp_dt_iov_t;
 
 
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Maximal number of dimensions of a strided datatype.
+ */
+#define UCP_DT_STRIDED_MAX_DIMS 4
+
+
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Dimension of a strided datatype.
+ *
+ * This structure describes one dimension of a strided datatype created by
+ * @ref ucp_dt_create_strided "ucp_dt_create_strided()".
+ */
+typedef struct ucp_dt_strided_dim {
+    size_t  count;    /**< Number of items in the dimension */
+    size_t  stride;   /**< Distance in bytes between the beginnings of
+                           consecutive items */
+} ucp_dt_strided_dim_t;
+
+
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Generic datatype flags.
+ *
+ * The enumeration list describes the flags which can be set on a generic
+ * datatype by @ref ucp_dt_generic_set_flags "ucp_dt_generic_set_flags()".
+ */
+enum ucp_dt_generic_flags {
+    UCP_DT_GENERIC_FLAG_PARALLEL_PACK = UCS_BIT(0)  /**< The
+                                        @ref ucp_generic_dt_ops::pack "pack()"
+                                        routine may be called concurrently from
+                                        several threads, for different offsets
+                                        of the same state, and in any order of
+                                        offsets. It must pack exactly
+                                        @e max_length bytes unless the end of
+                                        the packed data is reached. */
+};
+
+
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Operation of a datatype created by @ref ucp_dt_create_unpack_op
+ *        "ucp_dt_create_unpack_op()".
+ *
+ * The operation is applied element-wise while received data is unpacked to
+ * the user buffer.
+ */
+typedef enum ucp_dt_unpack_op {
+    UCP_DT_UNPACK_OP_SUM,        /**< Add the received elements to the
+                                      elements of the buffer. */
+    UCP_DT_UNPACK_OP_MAX,        /**< Store the maximum of the received element
+                                      and the element of the buffer. */
+    UCP_DT_UNPACK_OP_TO_FLOAT16  /**< Store the received elements in the buffer
+                                      converted to IEEE 754 half precision,
+                                      rounded to nearest even. The element type
+                                      must be @ref UCP_DT_ELEM_TYPE_FLOAT32. */
+} ucp_dt_unpack_op_t;
+
+
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Type of the elements of a datatype created by
+ *        @ref ucp_dt_create_unpack_op "ucp_dt_create_unpack_op()".
+ */
+typedef enum ucp_dt_elem_type {
+    UCP_DT_ELEM_TYPE_INT32,      /**< int32_t */
+    UCP_DT_ELEM_TYPE_INT64,      /**< int64_t */
+    UCP_DT_ELEM_TYPE_FLOAT32,    /**< float */
+    UCP_DT_ELEM_TYPE_FLOAT64     /**< double */
+} ucp_dt_elem_type_t;
+
+
 /**
  * @ingroup UCP_DATATYPE
  * @brief UCP generic data type descriptor
@@ -1611,6 +1745,16 @@ typedef struct ucp_am_handler_param {
      * @ref ucp_am_recv_callback_t function as the @a arg argument.
      */
     void                     *arg;
+
+    /**
+     * Callback which provides a buffer for assembling the data of
+     * multi-fragment eager and non-empty rendezvous messages. The data is then
+     * received directly to this buffer, and @a cb is invoked with
+     * @a UCP_AM_RECV_ATTR_FLAG_USER_BUFFER flag once the whole message has
+     * arrived. If this callback returns NULL, or is not set, the message is
+     * handled as usual. The @a arg field is passed to this callback as well.
+     */
+    ucp_am_alloc_callback_t  alloc_cb;
 } ucp_am_handler_param_t;
 
 
@@ -2003,6 +2147,29 @@ ucs_status_t ucp_worker_get_address(ucp_worker_h worker,
 void ucp_worker_release_address(ucp_worker_h worker, ucp_address_t *address);
 
 
+/**
+ * @ingroup UCP_WORKER
+ * @brief Add an address dictionary to the worker object.
+ *
+ * This routine adds a full worker address as a dictionary, which allows
+ * the @ref ucp_worker_h "worker" to use compact addresses that were obtained
+ * with @ref UCP_WORKER_ADDRESS_FLAG_COMPACT flag. A single dictionary can be
+ * used for the compact addresses of all workers with identical transports,
+ * typically all processes on the same remote host, which reduces the amount of
+ * address data to distribute to @ref ucp_ep_create "ucp_ep_create()".
+ *
+ * @param [in]  worker            Worker object to add the dictionary to.
+ * @param [in]  address           Full worker address to use as a dictionary.
+ *                                The address may be released after this call.
+ *
+ * @note Adding an identical dictionary more than once has no effect.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_worker_add_address_dict(ucp_worker_h worker,
+                                         const ucp_address_t *address);
+
+
 /**
  * @ingroup UCP_WORKER
  * @brief Progress all communications on a specific worker.
@@ -3477,6 +3644,56 @@ ucs_status_ptr_t ucp_stream_recv_nbx(ucp_ep_h ep, void *buffer, size_t count,
 ucs_status_ptr_t ucp_stream_recv_data_nb(ucp_ep_h ep, size_t *length);
 
 
+/**
+ * @ingroup UCP_COMM
+ * @brief Get all stream data received on an endpoint, without copying it.
+ *
+ * This routine fills @a iov with pointers to the data which was received on
+ * endpoint @a ep and was not consumed yet, in the order it was received. The
+ * data stays owned by UCP; after processing it, the application releases a
+ * prefix of it by calling @ref ucp_stream_data_consume. The routine is
+ * non-blocking and therefore returns immediately.
+ *
+ * @param [in]     ep       UCP endpoint that is used for the receive
+ *                          operation.
+ * @param [out]    iov      Array of @a *iovcnt_p entries to fill.
+ * @param [inout]  iovcnt_p In: number of entries in @a iov. Out: number of
+ *                          entries which were filled. It is 0 if there is no
+ *                          received data on the @a ep.
+ * @param [out]    length_p Total length of the data in the filled entries.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ *
+ * @note The returned pointers are valid until the data they point to is
+ *       consumed. Calling this routine again returns the same data, followed
+ *       by the data which arrived meanwhile.
+ * @note This routine must not be mixed with @ref ucp_stream_recv_nbx or
+ *       @ref ucp_stream_recv_data_nb on the same endpoint while the returned
+ *       data is in use.
+ */
+ucs_status_t ucp_stream_recv_data_iov(ucp_ep_h ep, ucp_dt_iov_t *iov,
+                                      size_t *iovcnt_p, size_t *length_p);
+
+
+/**
+ * @ingroup UCP_COMM
+ * @brief Release the stream data returned by @ref ucp_stream_recv_data_iov.
+ *
+ * This routine releases the first @a length bytes of the data received on
+ * endpoint @a ep. Receive buffers which are consumed completely are returned
+ * to UCP, and the rest of the data is returned by the next call to
+ * @ref ucp_stream_recv_data_iov.
+ *
+ * @param [in]  ep        Endpoint the data was received from.
+ * @param [in]  length    Number of bytes to consume.
+ *
+ * @return UCS_OK                - The data was consumed.
+ * @return UCS_ERR_INVALID_PARAM - @a length is larger than the received
+ *                                 data. All the received data is consumed.
+ */
+ucs_status_t ucp_stream_data_consume(ucp_ep_h ep, size_t length);
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Non-blocking tagged-receive operation.
@@ -4268,6 +4485,106 @@ ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *contex
                                    ucp_datatype_t *datatype_p);
 
 
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Set flags of a generic datatype.
+ *
+ * This routine sets the flags of a generic datatype, which describe the
+ * capabilities of its @ref ucp_generic_dt_ops_t "routines". With
+ * @ref UCP_DT_GENERIC_FLAG_PARALLEL_PACK, large messages of the datatype may be
+ * packed by helper threads in parallel, ahead of sending them, as configured
+ * by UCX_GENERIC_DT_PACK_THREADS.
+ * The flags must not be changed while the datatype is used by a communication
+ * operation.
+ *
+ * @param [in]  datatype     Generic datatype created by
+ *                           @ref ucp_dt_create_generic "ucp_dt_create_generic()".
+ * @param [in]  flags        Bitmap of @ref ucp_dt_generic_flags.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_dt_generic_set_flags(ucp_datatype_t datatype, uint64_t flags);
+
+
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Create a datatype which applies an operation on received data.
+ *
+ * This routine creates a datatype which describes an array of elements of
+ * type @a elem_type in the packed (network) format. When a message is received
+ * to a buffer of this datatype, the operation @a op is applied on each
+ * received element and the corresponding element of the buffer, while the
+ * fragments of the message are unpacked. This avoids receiving to a temporary
+ * buffer and an additional pass over the data. The operation is done with the
+ * vector instructions of the CPU, when they are available.
+ *
+ * The @a count passed to a receive routine is the number of elements in the
+ * buffer. The elements of the buffer are of type @a elem_type, or 16-bit half
+ * precision values for @ref UCP_DT_UNPACK_OP_TO_FLOAT16. The sender may use a
+ * contiguous datatype with the same element type. When used to send, the
+ * datatype packs the elements of the buffer without any operation, converting
+ * half precision values back to single precision for
+ * @ref UCP_DT_UNPACK_OP_TO_FLOAT16.
+ *
+ * The buffer must reside in host memory. Since the elements of the buffer are
+ * updated as the fragments arrive, the contents of the buffer are undefined if
+ * the receive completes with an error.
+ *
+ * The application is responsible for releasing the @a datatype_p object using
+ * @ref ucp_dt_destroy "ucp_dt_destroy()" routine.
+ *
+ * @param [in]  op           Operation to apply on received elements.
+ * @param [in]  elem_type    Type of the elements in the packed format.
+ * @param [out] datatype_p   A pointer to datatype object.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_dt_create_unpack_op(ucp_dt_unpack_op_t op,
+                                     ucp_dt_elem_type_t elem_type,
+                                     ucp_datatype_t *datatype_p);
+
+
+/**
+ * @ingroup UCP_DATATYPE
+ * @brief Create a strided datatype.
+ *
+ * This routine creates a datatype object which describes a regular,
+ * possibly nested, strided layout, such as a column or a sub-block of a
+ * matrix. The data is packed and unpacked by the library, without calling
+ * user-defined routines.
+ *
+ * The datatype consists of contiguous elements of @a elem_size bytes.
+ * @a dims[0] is the innermost dimension: it contains @a dims[0].count elements
+ * which are @a dims[0].stride bytes apart. Every next dimension @a dims[i]
+ * contains @a dims[i].count copies of the layout described by the previous
+ * dimensions, which are @a dims[i].stride bytes apart. The items of a
+ * dimension must not overlap.
+ *
+ * When a buffer of @a count items of the datatype is passed to a
+ * communication routine, the items follow each other in memory, and each item
+ * starts right after the last element of the previous one.
+ *
+ * For example, a column of a row-major matrix of @a ncols doubles is described
+ * by @a elem_size = sizeof(double) and a single dimension with
+ * @a count = number of rows and @a stride = @a ncols * sizeof(double).
+ *
+ * The application is responsible for releasing the @a datatype_p object using
+ * @ref ucp_dt_destroy "ucp_dt_destroy()" routine.
+ *
+ * @param [in]  elem_size    Size in bytes of a contiguous element.
+ * @param [in]  dims         Array of dimensions, starting from the innermost.
+ * @param [in]  num_dims     Number of entries in @a dims, up to
+ *                           @ref UCP_DT_STRIDED_MAX_DIMS.
+ * @param [out] datatype_p   A pointer to datatype object.
+ *
+ * @return Error code as defined by @ref ucs_status_t
+ */
+ucs_status_t ucp_dt_create_strided(size_t elem_size,
+                                   const ucp_dt_strided_dim_t *dims,
+                                   unsigned num_dims,
+                                   ucp_datatype_t *datatype_p);
+
+
 /**
  * @ingroup UCP_DATATYPE
  * @brief Destroy a datatype and release its resources.
@@ -4275,7 +4592,8 @@ ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *contex
  * This routine destroys the @a datatype object and
  * releases any resources that are associated with the object.
  * The @a datatype object must be allocated using @ref ucp_dt_create_generic
- * "ucp_dt_create_generic()" routine.
+ * "ucp_dt_create_generic()" or @ref ucp_dt_create_strided
+ * "ucp_dt_create_strided()" routine.
  *
  * @warning
  * @li Once the @a datatype object is released an access to this object may
@@ -675,6 +675,32 @@ typedef ucs_status_t (*ucp_am_recv_callback_t)(void *arg, const void *header,
                                                const ucp_am_recv_param_t *param);
 
 
+/**
+ * @ingroup UCP_ENDPOINT
+ * @brief Callback to provide a receive buffer for an incoming Active Message.
+ *
+ * The callback is invoked from the progress context when the first fragment of
+ * a multi-fragment eager message, or a rendezvous request, arrives. It is not
+ * invoked for messages which fit in a single fragment.
+ *
+ * @param [in]  arg           User-defined argument.
+ * @param [in]  header        User defined active message header. Can be NULL.
+ * @param [in]  header_length Active message header length in bytes.
+ * @param [in]  length        Length of the message data in bytes.
+ *
+ * @return Pointer to a host memory buffer of at least @a length bytes, which
+ *         is passed to @ref ucp_am_recv_callback_t as @a data when the message
+ *         is received. NULL, or a pointer to an error status (see
+ *         @ref UCS_STATUS_PTR), makes UCP receive the message to its own
+ *         buffer.
+ *
+ * @note This callback should be set by @ref ucp_worker_set_am_recv_handler
+ *       function.
+ */
+typedef void *(*ucp_am_alloc_callback_t)(void *arg, const void *header,
+                                         size_t header_length, size_t length);
+
+
 /**
  * @ingroup UCP_ENDPOINT
  * @brief Tuning parameters for the UCP endpoint.
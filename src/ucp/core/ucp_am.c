@@ -25,12 +25,40 @@
 
 UCS_ARRAY_IMPL(ucp_am_cbs, unsigned, ucp_am_entry_t, static)
 
+static ucs_mpool_ops_t ucp_am_agg_mpool_ops = {
+    .chunk_alloc   = ucs_mpool_chunk_malloc,
+    .chunk_release = ucs_mpool_chunk_free,
+    .obj_init      = NULL,
+    .obj_cleanup   = NULL
+};
+
+static void ucp_am_invoke_user_buffer_cb(ucp_worker_h worker, uint16_t am_id,
+                                         void *user_hdr,
+                                         uint32_t user_hdr_length,
+                                         void *buffer, size_t length,
+                                         ucp_ep_h reply_ep, uint64_t recv_flags);
+
 ucs_status_t ucp_am_init(ucp_worker_h worker)
 {
-    if (!(worker->context->config.features & UCP_FEATURE_AM)) {
+    ucp_context_h context = worker->context;
+    ucs_status_t status;
+
+    if (!(context->config.features & UCP_FEATURE_AM)) {
         return UCS_OK;
     }
 
+    status = ucs_mpool_init(&worker->am_agg.mp, 0,
+                            sizeof(ucp_am_agg_desc_t) +
+                            context->config.ext.am_aggregate_size,
+                            0, UCS_SYS_CACHE_LINE_SIZE, 16, UINT_MAX,
+                            &ucp_am_agg_mpool_ops, "ucp_am_agg_bufs");
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ucs_list_head_init(&worker->am_agg.descs);
+    worker->am_agg.prog_id = UCS_CALLBACKQ_ID_NULL;
+
     ucs_array_init_dynamic(&worker->am);
     return UCS_OK;
 }
@@ -41,6 +69,9 @@ void ucp_am_cleanup(ucp_worker_h worker)
         return;
     }
 
+    ucs_assert(ucs_list_is_empty(&worker->am_agg.descs));
+    uct_worker_progress_unregister_safe(worker->uct, &worker->am_agg.prog_id);
+    ucs_mpool_cleanup(&worker->am_agg.mp, 1);
     ucs_array_cleanup_dynamic(&worker->am);
 }
 
@@ -51,6 +82,7 @@ void ucp_am_ep_init(ucp_ep_h ep)
     if (ep->worker->context->config.features & UCP_FEATURE_AM) {
         ucs_list_head_init(&ep_ext->am.started_ams);
         ucs_queue_head_init(&ep_ext->am.mid_rdesc_q);
+        ucp_ep_ext_gen(ep)->am_agg_desc = NULL;
     }
 }
 
@@ -58,6 +90,8 @@ void ucp_am_ep_cleanup(ucp_ep_h ep)
 {
     ucp_ep_ext_proto_t *ep_ext = ucp_ep_ext_proto(ep);
     ucp_recv_desc_t *rdesc, *tmp_rdesc;
+    ucp_am_first_hdr_t *first_hdr;
+    ucp_am_agg_desc_t *agg_desc;
     ucs_queue_iter_t iter;
     size_t UCS_V_UNUSED count;
 
@@ -69,6 +103,16 @@ void ucp_am_ep_cleanup(ucp_ep_h ep)
     ucs_list_for_each_safe(rdesc, tmp_rdesc, &ep_ext->am.started_ams,
                            am_first.list) {
         ucs_list_del(&rdesc->am_first.list);
+        if (rdesc->flags & UCP_RECV_DESC_FLAG_AM_USER_BUFFER) {
+            /* Let the user reclaim the buffer of the incomplete message */
+            first_hdr = (ucp_am_first_hdr_t*)(rdesc + 1);
+            ucp_am_invoke_user_buffer_cb(ep->worker,
+                                         first_hdr->super.super.am_id,
+                                         first_hdr + 1,
+                                         first_hdr->super.super.header_length,
+                                         rdesc->am_first.user_buffer, 0, NULL,
+                                         0);
+        }
         ucs_free(rdesc);
         ++count;
     }
@@ -84,6 +128,15 @@ void ucp_am_ep_cleanup(ucp_ep_h ep)
     }
     ucs_trace_data("worker %p: %zu unhandled middle AM fragments have been"
                    " dropped on ep %p", ep->worker, count, ep);
+
+    agg_desc = ucp_ep_ext_gen(ep)->am_agg_desc;
+    if (agg_desc != NULL) {
+        ucs_trace_data("worker %p: %zu bytes of aggregated AMs have been"
+                       " dropped on ep %p", ep->worker, agg_desc->length, ep);
+        ucs_list_del(&agg_desc->list);
+        ucs_mpool_put_inline(agg_desc);
+        ucp_ep_ext_gen(ep)->am_agg_desc = NULL;
+    }
 }
 
 size_t ucp_am_max_header_size(ucp_worker_h worker)
@@ -134,22 +187,7 @@ static void ucp_am_rndv_send_ats(ucp_worker_h worker,
                                  ucp_am_rndv_rts_hdr_t *rts,
                                  ucs_status_t status)
 {
-    ucp_request_t *req;
-    ucp_ep_h ep;
-
-    UCP_WORKER_GET_EP_BY_ID(&ep, worker, rts->super.sreq.ep_id, return,
-                            "AM RNDV ATS");
-    req = ucp_request_get(worker);
-    if (ucs_unlikely(req == NULL)) {
-        ucs_error("failed to allocate request for AM RNDV ATS");
-        return;
-    }
-
-    req->send.ep = ep;
-    req->flags   = 0;
-
-    ucp_rndv_req_send_ack(req, NULL, rts->super.sreq.req_id, status,
-                          UCP_AM_ID_RNDV_ATS, "send_ats");
+    ucp_rndv_send_ats(worker, &rts->super, status);
 }
 
 static UCS_F_ALWAYS_INLINE void ucp_am_release_long_desc(ucp_recv_desc_t *desc)
@@ -213,12 +251,14 @@ UCS_PROFILE_FUNC_VOID(ucp_am_data_release, (worker, data),
 static void ucp_worker_am_init_handler(ucp_worker_h worker, uint16_t id,
                                        void *context, unsigned flags,
                                        ucp_am_callback_t cb_old,
-                                       ucp_am_recv_callback_t cb)
+                                       ucp_am_recv_callback_t cb,
+                                       ucp_am_alloc_callback_t alloc_cb)
 {
     ucp_am_entry_t *am_cb = &ucs_array_elem(&worker->am, id);
 
-    am_cb->context = context;
-    am_cb->flags   = flags;
+    am_cb->context  = context;
+    am_cb->flags    = flags;
+    am_cb->alloc_cb = alloc_cb;
 
     if (cb_old != NULL) {
         ucs_assert(cb == NULL);
@@ -253,7 +293,7 @@ static ucs_status_t ucp_worker_set_am_handler_common(ucp_worker_h worker,
         capacity = ucs_array_capacity(&worker->am);
 
         for (i = ucs_array_length(&worker->am); i < capacity; ++i) {
-            ucp_worker_am_init_handler(worker, id, NULL, 0, NULL, NULL);
+            ucp_worker_am_init_handler(worker, i, NULL, 0, NULL, NULL, NULL);
         }
 
         ucs_array_set_length(&worker->am, capacity);
@@ -275,7 +315,7 @@ ucs_status_t ucp_worker_set_am_handler(ucp_worker_h worker, uint16_t id,
         goto out;
     }
 
-    ucp_worker_am_init_handler(worker, id, arg, flags, cb, NULL);
+    ucp_worker_am_init_handler(worker, id, arg, flags, cb, NULL, NULL);
 
 out:
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
@@ -354,7 +394,8 @@ ucp_am_pack_user_header(void *buffer, ucp_request_t *req)
 
     ucp_dt_pack(req->send.ep->worker, ucp_dt_make_contig(1),
                 UCS_MEMORY_TYPE_HOST, buffer, req->send.msg_proto.am.header,
-                &hdr_state, req->send.msg_proto.am.header_length);
+                &hdr_state, req->send.msg_proto.am.header_length,
+                req->send.msg_proto.am.header_length);
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
@@ -405,7 +446,9 @@ ucs_status_t ucp_worker_set_am_recv_handler(ucp_worker_h worker,
     ucp_worker_am_init_handler(worker, id,
                                UCP_PARAM_VALUE(AM_HANDLER, param, arg, ARG, NULL),
                                flags | UCP_AM_CB_PRIV_FLAG_NBX,
-                               NULL, param->cb);
+                               NULL, param->cb,
+                               UCP_PARAM_VALUE(AM_HANDLER, param, alloc_cb,
+                                               ALLOC_CB, NULL));
 
 out:
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
@@ -434,7 +477,7 @@ ucp_am_bcopy_pack_data(void *buffer, ucp_request_t *req, size_t length)
     return user_header_length +
            ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                        req->send.mem_type, buffer, req->send.buffer,
-                       &req->send.state.dt, payload_length);
+                       &req->send.state.dt, payload_length, req->send.length);
 }
 
 static size_t
@@ -511,7 +554,7 @@ ucp_am_bcopy_pack_args_mid(void *dest, void *arg)
     return sizeof(*hdr) + ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                                       req->send.mem_type, hdr + 1,
                                       req->send.buffer, &req->send.state.dt,
-                                      length);
+                                      length, req->send.length);
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
@@ -911,6 +954,251 @@ ucp_am_try_send_short(ucp_ep_h ep, uint16_t id, uint32_t flags,
     return UCS_ERR_NO_RESOURCE;
 }
 
+static UCS_F_ALWAYS_INLINE size_t ucp_am_agg_elem_size(size_t length)
+{
+    return ucs_align_up_pow2(sizeof(ucp_am_agg_elem_hdr_t) + length,
+                             sizeof(uint64_t));
+}
+
+static size_t ucp_am_agg_pack(void *dest, void *arg)
+{
+    ucp_request_t *req          = arg;
+    ucp_am_agg_desc_t *agg_desc = req->send.buffer;
+    ucp_am_agg_hdr_t *hdr       = dest;
+
+    memcpy(dest, agg_desc + 1, agg_desc->length);
+    hdr->ep_id = ucp_send_request_get_ep_remote_id(req);
+
+    return agg_desc->length;
+}
+
+static void ucp_am_agg_req_complete(ucp_request_t *req, ucs_status_t status)
+{
+    ucp_am_agg_desc_t *agg_desc = req->send.buffer;
+
+    if (ucs_unlikely(status != UCS_OK)) {
+        ucs_diag("ep %p: failed to send %zu bytes of aggregated active"
+                 " messages: %s", req->send.ep, agg_desc->length,
+                 ucs_status_string(status));
+    }
+
+    ucs_mpool_put_inline(agg_desc);
+    ucp_request_put(req);
+}
+
+static void ucp_am_agg_completion(uct_completion_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t,
+                                          send.state.uct_comp);
+
+    ucp_am_agg_req_complete(req, self->status);
+}
+
+static ucs_status_t ucp_am_agg_progress(uct_pending_req_t *self)
+{
+    ucp_request_t *req          = ucs_container_of(self, ucp_request_t,
+                                                   send.uct);
+    ucp_am_agg_desc_t *agg_desc = req->send.buffer;
+    ucs_status_t status;
+
+    status = ucp_do_am_single(self, UCP_AM_ID_AGGREGATE, ucp_am_agg_pack,
+                              agg_desc->length);
+    if (ucs_unlikely(status == UCS_ERR_NO_RESOURCE)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    ucp_am_agg_req_complete(req, status);
+    return UCS_OK;
+}
+
+/*
+ * Detach the aggregate from its endpoint and send it. The messages packed to
+ * it were already completed to the user, so the request is internal.
+ */
+static void ucp_am_agg_desc_send(ucp_am_agg_desc_t *agg_desc)
+{
+    ucp_ep_h ep = agg_desc->ep;
+    ucp_request_t *req;
+
+    ucs_list_del(&agg_desc->list);
+    ucp_ep_ext_gen(ep)->am_agg_desc = NULL;
+
+    req = ucp_request_get(ep->worker);
+    if (ucs_unlikely(req == NULL)) {
+        ucs_error("ep %p: failed to allocate request for aggregated active"
+                  " messages", ep);
+        ucs_mpool_put_inline(agg_desc);
+        return;
+    }
+
+    req->flags                      = 0;
+    req->send.ep                    = ep;
+    req->send.buffer                = agg_desc;
+    req->send.length                = agg_desc->length;
+    req->send.lane                  = ucp_ep_get_am_lane(ep);
+    req->send.pending_lane          = UCP_NULL_LANE;
+    req->send.uct.func              = ucp_am_agg_progress;
+    req->send.state.uct_comp.func   = ucp_am_agg_completion;
+    req->send.state.uct_comp.count  = 0;
+    req->send.state.uct_comp.status = UCS_OK;
+
+    ucp_request_send(req, 0);
+}
+
+static unsigned ucp_am_agg_progress_cb(void *arg)
+{
+    ucp_worker_h worker = arg;
+    ucs_time_t delay    = worker->context->config.ext.am_aggregate_delay;
+    unsigned count      = 0;
+    ucp_am_agg_desc_t *agg_desc, *tmp_agg_desc;
+    ucs_time_t now;
+
+    now = (delay == 0) ? 0 : ucs_get_time();
+    ucs_list_for_each_safe(agg_desc, tmp_agg_desc, &worker->am_agg.descs,
+                           list) {
+        if ((delay != 0) && ((now - agg_desc->start_time) < delay)) {
+            /* The list is ordered by start time */
+            break;
+        }
+
+        ucp_am_agg_desc_send(agg_desc);
+        ++count;
+    }
+
+    if (ucs_list_is_empty(&worker->am_agg.descs)) {
+        uct_worker_progress_unregister_safe(worker->uct,
+                                            &worker->am_agg.prog_id);
+    }
+
+    return count;
+}
+
+void ucp_am_ep_agg_flush(ucp_ep_h ep)
+{
+    ucp_am_agg_desc_t *agg_desc;
+
+    if (!(ep->flags & UCP_EP_FLAG_AM_AGGREGATE)) {
+        return;
+    }
+
+    agg_desc = ucp_ep_ext_gen(ep)->am_agg_desc;
+    if (agg_desc != NULL) {
+        ucp_am_agg_desc_send(agg_desc);
+    }
+}
+
+void ucp_am_worker_agg_flush(ucp_worker_h worker)
+{
+    ucp_am_agg_desc_t *agg_desc, *tmp_agg_desc;
+
+    if (!(worker->context->config.features & UCP_FEATURE_AM)) {
+        return;
+    }
+
+    ucs_list_for_each_safe(agg_desc, tmp_agg_desc, &worker->am_agg.descs,
+                           list) {
+        ucp_am_agg_desc_send(agg_desc);
+    }
+}
+
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_am_agg_add(ucp_ep_h ep, uint16_t id, uint32_t flags, const void *header,
+               size_t header_length, const void *buffer, size_t length)
+{
+    ucp_worker_h worker         = ep->worker;
+    ucp_ep_ext_gen_t *ep_ext    = ucp_ep_ext_gen(ep);
+    ucp_am_agg_desc_t *agg_desc = ep_ext->am_agg_desc;
+    size_t elem_size            = ucp_am_agg_elem_size(length +
+                                                       header_length);
+    ucp_am_agg_elem_hdr_t *elem_hdr;
+    size_t max_length;
+
+    max_length = ucs_min(worker->context->config.ext.am_aggregate_size,
+                         ucp_ep_config(ep)->am.max_bcopy);
+    if ((sizeof(ucp_am_agg_hdr_t) + elem_size) > max_length) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    if ((agg_desc != NULL) &&
+        ((agg_desc->length + elem_size) > agg_desc->max_length)) {
+        ucp_am_agg_desc_send(agg_desc);
+        agg_desc = NULL;
+    }
+
+    if (agg_desc == NULL) {
+        agg_desc = ucs_mpool_get_inline(&worker->am_agg.mp);
+        if (ucs_unlikely(agg_desc == NULL)) {
+            return UCS_ERR_NO_MEMORY;
+        }
+
+        agg_desc->ep         = ep;
+        agg_desc->start_time = ucs_get_time();
+        agg_desc->length     = sizeof(ucp_am_agg_hdr_t);
+        agg_desc->max_length = max_length;
+        ep_ext->am_agg_desc  = agg_desc;
+        ucs_list_add_tail(&worker->am_agg.descs, &agg_desc->list);
+        uct_worker_progress_register_safe(worker->uct, ucp_am_agg_progress_cb,
+                                          worker, 0, &worker->am_agg.prog_id);
+    }
+
+    elem_hdr = UCS_PTR_BYTE_OFFSET(agg_desc + 1, agg_desc->length);
+    ucp_am_fill_short_header(&elem_hdr->super, id, flags, header_length);
+    elem_hdr->length   = length + header_length;
+    elem_hdr->reserved = 0;
+    memcpy(elem_hdr + 1, buffer, length);
+    memcpy(UCS_PTR_BYTE_OFFSET(elem_hdr + 1, length), header, header_length);
+    agg_desc->length  += elem_size;
+
+    return UCS_OK;
+}
+
+/*
+ * Pack a message to the aggregate of the endpoint, if it can be completed
+ * immediately and its data is in host memory.
+ */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_am_agg_try_send(ucp_ep_h ep, uint16_t id, uint32_t flags,
+                    const void *header, size_t header_length,
+                    const void *buffer, size_t count,
+                    const ucp_request_param_t *param)
+{
+    ucs_memory_type_t mem_type;
+    ucs_status_t status;
+    size_t length;
+
+    if ((flags & UCP_AM_SEND_FLAG_RNDV) ||
+        (param->op_attr_mask & UCP_OP_ATTR_FLAG_NO_IMM_CMPL) ||
+        (ep->flags & UCP_EP_FLAG_FAILED)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    if (param->op_attr_mask & UCP_OP_ATTR_FIELD_DATATYPE) {
+        if (!UCP_DT_IS_CONTIG(param->datatype)) {
+            return UCS_ERR_NO_RESOURCE;
+        }
+
+        length = ucp_contig_dt_length(param->datatype, count);
+    } else {
+        length = count;
+    }
+
+    mem_type = ucp_request_get_memory_type(ep->worker->context, buffer,
+                                           length, param);
+    if (!UCP_MEM_IS_HOST(mem_type)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    if (flags & UCP_AM_SEND_REPLY) {
+        status = ucp_ep_resolve_remote_id(ep, ep->am_lane);
+        if (ucs_unlikely(status != UCS_OK)) {
+            return status;
+        }
+    }
+
+    return ucp_am_agg_add(ep, id, flags, header, header_length, buffer,
+                          length);
+}
+
 UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_am_send_nbx,
                  (ep, id, header, header_length, buffer, count, param),
                  ucp_ep_h ep, unsigned id, const void *header,
@@ -932,10 +1220,28 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_am_send_nbx,
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
 
+    status = ucp_ep_resolve_lazy_connect(ep);
+    if (ucs_unlikely(status != UCS_OK)) {
+        ret = UCS_STATUS_PTR(status);
+        goto out;
+    }
+
     flags     = ucp_request_param_flags(param);
     attr_mask = param->op_attr_mask &
                 (UCP_OP_ATTR_FIELD_DATATYPE | UCP_OP_ATTR_FLAG_NO_IMM_CMPL);
 
+    if (ep->flags & UCP_EP_FLAG_AM_AGGREGATE) {
+        status = ucp_am_agg_try_send(ep, id, flags, header, header_length,
+                                     buffer, count, param);
+        if (status == UCS_OK) {
+            ret = NULL;
+            goto out;
+        }
+
+        /* Keep the order with the messages which were aggregated before */
+        ucp_am_ep_agg_flush(ep);
+    }
+
     if (flags & UCP_AM_SEND_REPLY) {
         max_short = &ucp_ep_config(ep)->am_u.max_reply_eager_short;
         proto     = ucp_ep_config(ep)->am_u.reply_proto;
@@ -1245,6 +1551,44 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_handler,
                                  NULL, am_flags, 0ul);
 }
 
+UCS_PROFILE_FUNC(ucs_status_t, ucp_am_handler_aggregate,
+                 (am_arg, am_data, am_length, am_flags),
+                 void *am_arg, void *am_data, size_t am_length,
+                 unsigned am_flags)
+{
+    ucp_worker_h worker             = am_arg;
+    ucp_am_agg_hdr_t *agg_hdr       = am_data;
+    void *end                       = UCS_PTR_BYTE_OFFSET(am_data, am_length);
+    ucp_am_agg_elem_hdr_t *elem_hdr = (ucp_am_agg_elem_hdr_t*)(agg_hdr + 1);
+    uint64_t recv_flags;
+    ucp_ep_h reply_ep;
+
+    /* The data of the messages is not kept in the UCT descriptor, since it is
+     * shared by all of them. Callbacks which hold the data get a copy. */
+    while ((void*)elem_hdr < end) {
+        ucs_assert(UCS_PTR_BYTE_OFFSET(elem_hdr, sizeof(*elem_hdr) +
+                                                 elem_hdr->length) <= end);
+
+        if (elem_hdr->super.flags & UCP_AM_SEND_REPLY) {
+            UCP_WORKER_GET_VALID_EP_BY_ID(&reply_ep, worker, agg_hdr->ep_id,
+                                          goto next, "AM (aggregate)");
+            recv_flags = UCP_AM_RECV_ATTR_FIELD_REPLY_EP;
+        } else {
+            reply_ep   = NULL;
+            recv_flags = 0ul;
+        }
+
+        ucp_am_handler_common(worker, &elem_hdr->super, sizeof(*elem_hdr),
+                              sizeof(*elem_hdr) + elem_hdr->length, reply_ep,
+                              0, recv_flags);
+next:
+        elem_hdr = UCS_PTR_BYTE_OFFSET(elem_hdr,
+                                       ucp_am_agg_elem_size(elem_hdr->length));
+    }
+
+    return UCS_OK;
+}
+
 static UCS_F_ALWAYS_INLINE ucp_recv_desc_t*
 ucp_am_find_first_rdesc(ucp_worker_h worker, ucp_ep_ext_proto_t *ep_ext,
                        uint64_t msg_id)
@@ -1264,14 +1608,79 @@ ucp_am_find_first_rdesc(ucp_worker_h worker, ucp_ep_ext_proto_t *ep_ext,
 
 static UCS_F_ALWAYS_INLINE void
 ucp_am_copy_data_fragment(ucp_recv_desc_t *first_rdesc, void *data,
-                          size_t length, size_t offset)
+                          size_t length, size_t offset, size_t total_size)
 {
-    UCS_PROFILE_NAMED_CALL("am_memcpy_recv", ucs_memcpy_relaxed,
-                           UCS_PTR_BYTE_OFFSET(first_rdesc + 1, offset),
-                           data, length);
+    void *dest;
+
+    if (first_rdesc->flags & UCP_RECV_DESC_FLAG_AM_USER_BUFFER) {
+        /* Only the headers are kept in the descriptor */
+        ucs_assert(offset >= first_rdesc->payload_offset);
+        dest = UCS_PTR_BYTE_OFFSET(first_rdesc->am_first.user_buffer,
+                                   offset - first_rdesc->payload_offset);
+    } else {
+        dest = UCS_PTR_BYTE_OFFSET(first_rdesc + 1, offset);
+    }
+
+    UCS_PROFILE_NAMED_CALL("am_memcpy_recv", ucs_memcpy_relaxed, dest, data,
+                           length, UCS_ARCH_MEMCPY_NT_SOURCE, total_size);
     first_rdesc->am_first.remaining -= length;
 }
 
+static UCS_F_ALWAYS_INLINE void*
+ucp_am_alloc_user_buffer(ucp_worker_h worker, uint16_t am_id,
+                         const void *user_hdr, size_t user_hdr_length,
+                         size_t length)
+{
+    ucp_am_entry_t *am_cb;
+    void *buffer;
+
+    if (am_id >= ucs_array_length(&worker->am)) {
+        return NULL;
+    }
+
+    am_cb = &ucs_array_elem(&worker->am, am_id);
+    if (am_cb->alloc_cb == NULL) {
+        return NULL;
+    }
+
+    buffer = am_cb->alloc_cb(am_cb->context, user_hdr, user_hdr_length, length);
+    if (ucs_unlikely(UCS_PTR_IS_ERR(buffer))) {
+        /* Receive the message to an internal descriptor instead */
+        ucs_diag("worker %p: AM id %u failed to allocate user buffer of %zu "
+                 "bytes: %s", worker, am_id, length,
+                 ucs_status_string(UCS_PTR_STATUS(buffer)));
+        return NULL;
+    }
+
+    return buffer;
+}
+
+/* Pass the data assembled in a user buffer to the user callback. The whole
+ * message is received if length is equal to the message size, otherwise the
+ * callback is invoked with zero length to let the user reclaim the buffer. */
+static void ucp_am_invoke_user_buffer_cb(ucp_worker_h worker, uint16_t am_id,
+                                         void *user_hdr,
+                                         uint32_t user_hdr_length,
+                                         void *buffer, size_t length,
+                                         ucp_ep_h reply_ep, uint64_t recv_flags)
+{
+    ucs_status_t status;
+
+    ucs_trace_data("worker %p: AM id %u received to user buffer %p length %zu",
+                   worker, am_id, buffer, length);
+
+    /* The buffer is owned by the user, so UCS_INPROGRESS has no effect, and an
+     * error can't fail the receive, which is already completed */
+    status = ucp_am_invoke_cb(worker, am_id, user_hdr, user_hdr_length, buffer,
+                              length, reply_ep,
+                              recv_flags | UCP_AM_RECV_ATTR_FLAG_USER_BUFFER);
+    if (ucs_unlikely(UCS_STATUS_IS_ERR(status))) {
+        ucs_diag("worker %p: AM id %u handler failed on user buffer %p "
+                 "length %zu: %s", worker, am_id, buffer, length,
+                 ucs_status_string(status));
+    }
+}
+
 static UCS_F_ALWAYS_INLINE uint64_t
 ucp_am_hdr_reply_ep(ucp_worker_h worker, uint16_t flags, ucp_ep_h ep,
                     ucp_ep_h *reply_ep_p)
@@ -1289,16 +1698,16 @@ ucp_am_hdr_reply_ep(ucp_worker_h worker, uint16_t flags, ucp_ep_h ep,
 static UCS_F_ALWAYS_INLINE void
 ucp_am_handle_unfinished(ucp_worker_h worker, ucp_recv_desc_t *first_rdesc,
                          void *data, size_t length, size_t offset,
-                         ucp_ep_h reply_ep)
+                         size_t total_size, ucp_ep_h reply_ep)
 {
     ucp_am_first_hdr_t *first_hdr;
     ucs_status_t status;
     void *msg, *user_hdr;
     uint64_t recv_flags;
-    size_t desc_offset, user_hdr_length, total_size;
+    size_t desc_offset, user_hdr_length;
     uint16_t am_id;
 
-    ucp_am_copy_data_fragment(first_rdesc, data, length, offset);
+    ucp_am_copy_data_fragment(first_rdesc, data, length, offset, total_size);
 
     if (first_rdesc->am_first.remaining > 0) {
         /* not all fragments arrived yet */
@@ -1311,13 +1720,22 @@ ucp_am_handle_unfinished(ucp_worker_h worker, ucp_recv_desc_t *first_rdesc,
 
     first_hdr       = (ucp_am_first_hdr_t*)(first_rdesc + 1);
     recv_flags      = ucp_am_hdr_reply_ep(worker, first_hdr->super.super.flags,
-                                          reply_ep, &reply_ep) |
-                      UCP_AM_RECV_ATTR_FLAG_DATA;
+                                          reply_ep, &reply_ep);
     msg             = first_hdr + 1;
     am_id           = first_hdr->super.super.am_id;
-    total_size      = first_hdr->total_size;
     user_hdr_length = first_hdr->super.super.header_length;
-    user_hdr        = UCS_PTR_BYTE_OFFSET(msg, total_size);
+
+    if (first_rdesc->flags & UCP_RECV_DESC_FLAG_AM_USER_BUFFER) {
+        /* user desc layout: |desc|first_hdr|user_hdr| */
+        ucp_am_invoke_user_buffer_cb(worker, am_id, msg, user_hdr_length,
+                                     first_rdesc->am_first.user_buffer,
+                                     total_size, reply_ep, recv_flags);
+        ucs_free(first_rdesc);
+        return;
+    }
+
+    recv_flags |= UCP_AM_RECV_ATTR_FLAG_DATA;
+    user_hdr    = UCS_PTR_BYTE_OFFSET(msg, total_size);
 
     /* Need to reinit descriptor, because we passed data shifted by
      * ucp_am_first_hdr_t size to the cb. In ucp_am_data_release and
@@ -1366,7 +1784,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
     ucp_ep_h ep;
     size_t total_length;
     uint64_t recv_flags;
-    void *user_hdr;
+    void *user_hdr, *user_buffer;
 
     UCP_WORKER_GET_VALID_EP_BY_ID(&ep, worker, first_hdr->super.ep_id,
                                   return UCS_OK, "AM first fragment");
@@ -1390,27 +1808,57 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
     ucs_assert(NULL == ucp_am_find_first_rdesc(worker, ep_ext,
                                                first_hdr->msg_id));
 
-    /* Alloc buffer for the data and its desc, as we know total_size.
-     * Need to allocate a separate rdesc which would be in one contigious chunk
-     * with data buffer. */
-    first_rdesc = ucs_malloc(total_length + sizeof(ucp_recv_desc_t),
-                             "ucp recv desc for long AM");
+    user_hdr    = UCS_PTR_BYTE_OFFSET(first_hdr, am_length - user_hdr_length);
+    user_buffer = ucp_am_alloc_user_buffer(worker, first_hdr->super.super.am_id,
+                                           user_hdr, user_hdr_length,
+                                           first_hdr->total_size);
+    if (user_buffer != NULL) {
+        /* The data is assembled in the user buffer, so the desc holds only
+         * the headers: |desc|first_hdr|user_hdr| */
+        first_rdesc = ucs_malloc(sizeof(*first_rdesc) + sizeof(*first_hdr) +
+                                 user_hdr_length, "ucp recv desc for user AM");
+    } else {
+        /* Alloc buffer for the data and its desc, as we know total_size.
+         * Need to allocate a separate rdesc which would be in one contigious
+         * chunk with data buffer. */
+        first_rdesc = ucs_malloc(total_length + sizeof(ucp_recv_desc_t),
+                                 "ucp recv desc for long AM");
+    }
+
     if (ucs_unlikely(first_rdesc == NULL)) {
         ucs_error("failed to allocate buffer for assembling UCP AM (id %u)",
                   first_hdr->super.super.am_id);
+        if (user_buffer != NULL) {
+            ucp_am_invoke_user_buffer_cb(worker, first_hdr->super.super.am_id,
+                                         user_hdr, user_hdr_length,
+                                         user_buffer, 0, NULL, 0);
+        }
         return UCS_OK; /* release UCT desc */
     }
 
-    first_rdesc->am_first.remaining = first_hdr->total_size +
-                                      sizeof(*first_hdr);
-    first_rdesc->payload_offset     = sizeof(*first_hdr);
+    first_rdesc->am_first.remaining   = first_hdr->total_size +
+                                        sizeof(*first_hdr);
+    first_rdesc->am_first.user_buffer = user_buffer;
+    first_rdesc->payload_offset       = sizeof(*first_hdr);
 
-    /* Copy user header to the end of message */
-    user_hdr = UCS_PTR_BYTE_OFFSET(first_hdr, am_length - user_hdr_length);
-    UCS_PROFILE_NAMED_CALL("am_memcpy_recv", ucs_memcpy_relaxed,
-                           UCS_PTR_BYTE_OFFSET(first_rdesc + 1,
-                                               first_rdesc->am_first.remaining),
-                           user_hdr, user_hdr_length);
+    if (user_buffer != NULL) {
+        first_rdesc->flags = UCP_RECV_DESC_FLAG_AM_USER_BUFFER;
+
+        /* Copy the headers to the desc, the data follows in the user buffer */
+        memcpy(first_rdesc + 1, first_hdr, sizeof(*first_hdr));
+        memcpy(UCS_PTR_BYTE_OFFSET(first_rdesc + 1, sizeof(*first_hdr)),
+               user_hdr, user_hdr_length);
+        first_rdesc->am_first.remaining -= sizeof(*first_hdr);
+    } else {
+        first_rdesc->flags = 0;
+
+        /* Copy user header to the end of message */
+        UCS_PROFILE_NAMED_CALL("am_memcpy_recv", ucs_memcpy_relaxed,
+                               UCS_PTR_BYTE_OFFSET(first_rdesc + 1,
+                                                   first_rdesc->am_first.remaining),
+                               user_hdr, user_hdr_length,
+                               UCS_ARCH_MEMCPY_NT_NONE, user_hdr_length);
+    }
 
     /* Copy all already arrived middle fragments to the data buffer */
     ucs_queue_for_each_safe(mid_rdesc, iter, &ep_ext->am.mid_rdesc_q,
@@ -1422,16 +1870,26 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
         ucs_queue_del_iter(&ep_ext->am.mid_rdesc_q, iter);
         ucp_am_copy_data_fragment(first_rdesc, mid_hdr + 1,
                                   mid_rdesc->length - sizeof(*mid_hdr),
-                                  mid_hdr->offset + first_rdesc->payload_offset);
+                                  mid_hdr->offset + first_rdesc->payload_offset,
+                                  first_hdr->total_size);
         ucp_recv_desc_release(mid_rdesc);
     }
 
     ucs_list_add_tail(&ep_ext->am.started_ams, &first_rdesc->am_first.list);
 
-    /* Note: copy first chunk of data together with AM header, which contains
-     * data needed to process other fragments. */
-    ucp_am_handle_unfinished(worker, first_rdesc, first_hdr,
-                             am_length - user_hdr_length, 0, ep);
+    if (user_buffer != NULL) {
+        ucp_am_handle_unfinished(worker, first_rdesc, first_hdr + 1,
+                                 am_length - user_hdr_length -
+                                 sizeof(*first_hdr),
+                                 first_rdesc->payload_offset,
+                                 first_hdr->total_size, ep);
+    } else {
+        /* Note: copy first chunk of data together with AM header, which
+         * contains data needed to process other fragments. */
+        ucp_am_handle_unfinished(worker, first_rdesc, first_hdr,
+                                 am_length - user_hdr_length, 0,
+                                 first_hdr->total_size, ep);
+    }
 
     return UCS_OK; /* release UCT desc */
 }
@@ -1455,9 +1913,12 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_middle_handler,
     first_rdesc = ucp_am_find_first_rdesc(worker, ep_ext, msg_id);
     if (first_rdesc != NULL) {
         /* First fragment already arrived, just copy the data */
+        /* The first fragment header is at the beginning of the descriptor */
         ucp_am_handle_unfinished(worker, first_rdesc, mid_hdr + 1,
                                  am_length - sizeof(*mid_hdr),
                                  mid_hdr->offset + first_rdesc->payload_offset,
+                                 ((ucp_am_first_hdr_t*)(first_rdesc + 1))->
+                                         total_size,
                                  ep);
         return UCS_OK; /* data is copied, release UCT desc */
     }
@@ -1479,6 +1940,87 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_middle_handler,
     return status;
 }
 
+static void ucp_am_rndv_user_buffer_completed(void *request,
+                                              ucs_status_t status,
+                                              size_t length, void *user_data)
+{
+    ucp_am_user_buffer_rndv_t *rndv = user_data;
+    ucp_worker_h worker             = rndv->worker;
+    ucp_ep_h reply_ep               = NULL;
+    uint64_t recv_flags             = 0;
+
+    if (ucs_unlikely(status != UCS_OK)) {
+        ucs_debug("worker %p: failed to receive AM id %u to user buffer %p: %s",
+                  worker, rndv->am_id, rndv->buffer,
+                  ucs_status_string(status));
+        length = 0;
+    } else if (rndv->am_flags & UCP_AM_SEND_REPLY) {
+        UCP_WORKER_GET_VALID_EP_BY_ID(&reply_ep, worker, rndv->ep_id,
+                                      { reply_ep = NULL; goto out; },
+                                      "AM reply ep");
+        recv_flags = UCP_AM_RECV_ATTR_FIELD_REPLY_EP;
+    }
+
+out:
+    ucp_am_invoke_user_buffer_cb(worker, rndv->am_id, rndv + 1,
+                                 rndv->header_length, rndv->buffer, length,
+                                 reply_ep, recv_flags);
+    ucs_free(rndv);
+}
+
+/* Start receiving rendezvous data to a buffer provided by the user. The user
+ * callback is invoked when the receive completes. */
+static ucs_status_t
+ucp_am_rndv_recv_user_buffer(ucp_worker_h worker, ucp_recv_desc_t *desc,
+                             const ucp_am_rndv_rts_hdr_t *rts,
+                             const void *user_hdr, void *buffer)
+{
+    ucp_request_param_t param;
+    ucp_am_user_buffer_rndv_t *rndv;
+    ucs_status_ptr_t sptr;
+
+    /* The user header is kept until completion, because RTS desc is released
+     * before the completion callback is invoked */
+    rndv = ucs_malloc(sizeof(*rndv) + rts->am.header_length,
+                      "ucp am user buffer rndv");
+    if (rndv == NULL) {
+        ucs_error("failed to allocate AM user buffer rendezvous context");
+        ucp_am_invoke_user_buffer_cb(worker, rts->am.am_id, (void*)user_hdr,
+                                     rts->am.header_length, buffer, 0, NULL,
+                                     0);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    rndv->worker        = worker;
+    rndv->buffer        = buffer;
+    rndv->ep_id         = rts->super.sreq.ep_id;
+    rndv->am_id         = rts->am.am_id;
+    rndv->am_flags      = rts->am.flags;
+    rndv->header_length = rts->am.header_length;
+    memcpy(rndv + 1, user_hdr, rts->am.header_length);
+
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
+                         UCP_OP_ATTR_FIELD_USER_DATA |
+                         UCP_OP_ATTR_FIELD_MEMORY_TYPE;
+    param.cb.recv_am   = ucp_am_rndv_user_buffer_completed;
+    param.user_data    = rndv;
+    param.memory_type  = UCS_MEMORY_TYPE_HOST;
+
+    sptr = ucp_am_recv_data_nbx(worker, desc + 1, buffer, rts->super.size,
+                                &param);
+    if (UCS_PTR_IS_ERR(sptr)) {
+        /* Let the RTS be dropped with an error */
+        desc->flags &= ~UCP_RECV_DESC_FLAG_RECV_STARTED;
+        ucp_am_rndv_user_buffer_completed(NULL, UCS_PTR_STATUS(sptr), 0, rndv);
+        return UCS_PTR_STATUS(sptr);
+    }
+
+    /* Rendezvous always returns a request, which is released on completion */
+    ucs_assert(UCS_PTR_IS_PTR(sptr));
+    ucp_request_release(sptr);
+    return UCS_INPROGRESS;
+}
+
 ucs_status_t ucp_am_rndv_process_rts(void *arg, void *data, size_t length,
                                      unsigned tl_flags)
 {
@@ -1490,7 +2032,7 @@ ucs_status_t ucp_am_rndv_process_rts(void *arg, void *data, size_t length,
     ucp_am_entry_t *am_cb;
     ucp_am_recv_param_t param;
     ucs_status_t status, desc_status;
-    void *hdr;
+    void *hdr, *user_buffer;
 
     UCP_WORKER_GET_VALID_EP_BY_ID(&ep, worker, rts->super.sreq.ep_id,
                                   { status = UCS_ERR_CANCELED;
@@ -1520,12 +2062,22 @@ ucs_status_t ucp_am_rndv_process_rts(void *arg, void *data, size_t length,
         goto out_send_ats;
     }
 
-    am_cb           = &ucs_array_elem(&worker->am, am_id);
-    param.recv_attr = UCP_AM_RECV_ATTR_FLAG_RNDV |
-                      ucp_am_hdr_reply_ep(worker, rts->am.flags, ep,
-                                          &param.reply_ep);
-    status          = am_cb->cb(am_cb->context, hdr, rts->am.header_length,
-                                desc + 1, rts->super.size, &param);
+    /* Zero-length rendezvous has no data to receive to a user buffer */
+    user_buffer = (rts->super.size == 0) ? NULL :
+                  ucp_am_alloc_user_buffer(worker, am_id, hdr,
+                                           rts->am.header_length,
+                                           rts->super.size);
+    if (user_buffer != NULL) {
+        status = ucp_am_rndv_recv_user_buffer(worker, desc, rts, hdr,
+                                              user_buffer);
+    } else {
+        am_cb           = &ucs_array_elem(&worker->am, am_id);
+        param.recv_attr = UCP_AM_RECV_ATTR_FLAG_RNDV |
+                          ucp_am_hdr_reply_ep(worker, rts->am.flags, ep,
+                                              &param.reply_ep);
+        status          = am_cb->cb(am_cb->context, hdr, rts->am.header_length,
+                                    desc + 1, rts->super.size, &param);
+    }
     if (ucp_am_rdesc_in_progress(desc, status)) {
         /* User either wants to save descriptor for later use or initiated
          * rendezvous receive (by ucp_am_recv_data_nbx) in the callback. */
@@ -1569,6 +2121,8 @@ UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_MIDDLE,
               ucp_am_long_middle_handler, NULL, 0);
 UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_SINGLE_REPLY,
               ucp_am_handler_reply, NULL, 0);
+UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_AGGREGATE,
+              ucp_am_handler_aggregate, NULL, 0);
 
 const ucp_request_send_proto_t ucp_am_proto = {
     .contig_short           = ucp_am_contig_short,
@@ -29,6 +29,8 @@ typedef struct ucp_am_entry {
         ucp_am_callback_t      cb_old;   /* user defined callback, used by legacy API */
         ucp_am_recv_callback_t cb;       /* user defined callback */
     };
+    ucp_am_alloc_callback_t    alloc_cb;   /* user defined receive buffer
+                                              allocator */
     void                       *context;   /* user defined callback argument */
     unsigned                   flags;      /* flags affecting callback behavior
                                               (set by the user) */
@@ -70,9 +72,57 @@ typedef struct {
 typedef struct {
     ucs_list_link_t          list;        /* entry into list of unfinished AM's */
     size_t                   remaining;   /* how many bytes left to receive */
+    void                     *user_buffer; /* buffer provided by the user, if
+                                              UCP_RECV_DESC_FLAG_AM_USER_BUFFER
+                                              is set */
 } ucp_am_first_desc_t;
 
 
+typedef struct {
+    uint64_t                 ep_id; /* ep which can be used for reply */
+} UCS_S_PACKED ucp_am_agg_hdr_t;
+
+
+/**
+ * Header of a message packed to an aggregate. The messages follow each other,
+ * and each one is padded to a multiple of 8 bytes.
+ */
+typedef struct {
+    ucp_am_hdr_t             super;
+    uint32_t                 length; /* payload and user header length */
+    uint32_t                 reserved;
+} UCS_S_PACKED ucp_am_agg_elem_hdr_t;
+
+
+/**
+ * Aggregate of small active messages, which is filled on an endpoint and then
+ * sent by a single transport message
+ */
+typedef struct ucp_am_agg_desc {
+    ucs_list_link_t          list;       /* entry in the worker list of
+                                            aggregates which were not sent */
+    ucp_ep_h                 ep;         /* endpoint to send on */
+    ucs_time_t               start_time; /* time the first message was added */
+    size_t                   length;     /* length of the packed data */
+    size_t                   max_length; /* maximal length of the packed data */
+    /* ucp_am_agg_hdr_t and the packed messages follow */
+} ucp_am_agg_desc_t;
+
+
+/**
+ * Context of a rendezvous receive to a buffer provided by the user
+ */
+typedef struct {
+    ucp_worker_h             worker;
+    void                     *buffer;        /* user buffer */
+    uint64_t                 ep_id;          /* ep which can be used for reply */
+    uint16_t                 am_id;
+    uint16_t                 am_flags;
+    uint32_t                 header_length;  /* user header length */
+    /* user header follows */
+} ucp_am_user_buffer_rndv_t;
+
+
 typedef struct {
     ucp_rndv_rts_hdr_t       super;
     ucp_am_hdr_t             am;
@@ -93,6 +143,10 @@ void ucp_am_ep_cleanup(ucp_ep_h ep);
 
 size_t ucp_am_max_header_size(ucp_worker_h worker);
 
+void ucp_am_ep_agg_flush(ucp_ep_h ep);
+
+void ucp_am_worker_agg_flush(ucp_worker_h worker);
+
 ucs_status_t ucp_am_rndv_process_rts(void *arg, void *data, size_t length,
                                      unsigned tl_flags);
 
@@ -13,21 +13,81 @@
 #include "ucp_context.h"
 #include "ucp_request.h"
 
+#include <ucp/proto/proto_cache.h>
+
 #include <ucs/config/parser.h>
 #include <ucs/algorithm/crc.h>
+#include <ucs/arch/atomic.h>
 #include <ucs/datastruct/mpool.inl>
 #include <ucs/datastruct/queue.h>
 #include <ucs/datastruct/string_set.h>
 #include <ucs/debug/log.h>
 #include <ucs/debug/debug_int.h>
+#include <ucs/memory/numa.h>
 #include <ucs/sys/compiler.h>
 #include <ucs/sys/string.h>
+#include <ucs/sys/sys.h>
+#include <ucs/sys/topo.h>
 #include <ucs/vfs/base/vfs_obj.h>
+#include <pthread.h>
 #include <string.h>
+#include <unistd.h>
 
 
 #define UCP_RSC_CONFIG_ALL    "all"
 
+#define UCP_RSC_CACHE_MAGIC      "ucx_resources"
+#define UCP_RSC_CACHE_VERSION    1
+#define UCP_RSC_CACHE_NO_SYS_DEV "-"
+
+
+/**
+ * Memory domain which is opened and queried during resource discovery, before
+ * its transport resources are added to the context.
+ */
+typedef struct {
+    ucp_rsc_index_t        cmpt_index;       /* Index of the component */
+    uct_md_resource_desc_t md_rsc;           /* Memory domain resource */
+    ucp_tl_md_t            tl_md;            /* Memory domain, md is NULL if
+                                                it was not opened */
+    uct_tl_resource_desc_t *tl_resources;    /* Transport resources */
+    unsigned               num_tl_resources; /* Number of transport resources */
+    int                    cached;           /* Transport resources were read
+                                                from the resource cache */
+    ucs_status_t           open_status;      /* Status of opening the MD */
+    ucs_status_t           query_status;     /* Status of querying resources */
+} ucp_md_discovery_t;
+
+
+/**
+ * State shared by the threads which open memory domains
+ */
+typedef struct {
+    ucp_context_h          context;
+    ucp_md_discovery_t     *mds;
+    uint32_t               num_mds;
+    volatile uint32_t      next;             /* Next memory domain to open */
+} ucp_md_discovery_ctx_t;
+
+
+/**
+ * Arguments of writing the resource cache
+ */
+typedef struct {
+    ucp_context_h            context;
+    const ucp_md_discovery_t *mds;
+    unsigned                 num_mds;
+    uint32_t                 key;              /* Hash of the configuration */
+} ucp_rsc_cache_write_ctx_t;
+
+
+KHASH_IMPL(ucp_tl_reachable, uint64_t, int, 1, kh_int64_hash_func,
+           kh_int64_hash_equal);
+
+
+extern char **environ;
+
+
 ucp_am_handler_t ucp_am_handlers[UCP_AM_ID_LAST] = {{0, NULL, NULL}};
 
 static const char *ucp_atomic_modes[] = {
@@ -62,6 +122,25 @@ const char *ucp_operation_names[] = {
     [UCP_OP_ID_LAST]          = NULL
 };
 
+#define UCP_CONFIG_MPOOL_PLACEMENT_FIELDS(_prefix, _mp_name, _field) \
+  {_prefix "HUGETLB", "auto", \
+   "Back the worker " _mp_name " memory pool by huge pages:\n" \
+   " yes  - use only huge pages, fail if they are not available.\n" \
+   " try  - try huge pages first, and fall back to regular pages.\n" \
+   " no   - do not use huge pages.\n" \
+   " auto - use the default allocation method of the memory pool.", \
+   ucs_offsetof(ucp_config_t, ctx._field.hugetlb), \
+   UCS_CONFIG_TYPE_TERNARY_AUTO}, \
+  \
+  {_prefix "NUMA_POLICY", "default", \
+   "NUMA policy of the worker " _mp_name " memory pool:\n" \
+   " default   - use the process memory policy.\n" \
+   " preferred - prefer the NUMA nodes the allocating thread runs on.\n" \
+   " bind      - bind to the NUMA nodes the allocating thread runs on.", \
+   ucs_offsetof(ucp_config_t, ctx._field.numa_policy), \
+   UCS_CONFIG_TYPE_ENUM(ucs_numa_policy_names)}
+
+
 static ucs_config_field_t ucp_config_table[] = {
   {"NET_DEVICES", UCP_RSC_CONFIG_ALL,
    "Specifies which network device(s) to use. The order is not meaningful.\n"
@@ -129,6 +208,23 @@ static ucs_config_field_t ucp_config_table[] = {
    "Issue a warning in case of invalid device and/or transport configuration.",
    ucs_offsetof(ucp_config_t, warn_invalid_config), UCS_CONFIG_TYPE_BOOL},
 
+  {"RESOURCE_DISCOVERY_THREADS", "1",
+   "Number of threads which open the memory domains and query their transport\n"
+   "resources during context initialization. Opening a memory domain may scan\n"
+   "sysfs and probe devices, so using several threads can reduce the time of\n"
+   "ucp_init() on hosts with many devices.",
+   ucs_offsetof(ucp_config_t, rsc_discovery_threads), UCS_CONFIG_TYPE_UINT},
+
+  {"RESOURCE_CACHE_DIR", "",
+   "Directory of per-host files which cache the transport resources found\n"
+   "during context initialization. The file name contains the host name and a\n"
+   "key computed from the boot id, the library version, the memory domain names\n"
+   "and the UCX environment variables. When a matching file exists, memory\n"
+   "domains without transport resources are not opened, and the resources of\n"
+   "the other memory domains are not queried.\n"
+   "An empty value disables the cache.",
+   ucs_offsetof(ucp_config_t, rsc_cache_dir), UCS_CONFIG_TYPE_STRING},
+
   {"BCOPY_THRESH", "0",
    "Threshold for switching from short to bcopy protocol",
    ucs_offsetof(ucp_config_t, ctx.bcopy_thresh), UCS_CONFIG_TYPE_MEMUNITS},
@@ -277,6 +373,15 @@ static ucs_config_field_t ucp_config_table[] = {
    "RNDV fragment size \n",
    ucs_offsetof(ucp_config_t, ctx.rndv_frag_size), UCS_CONFIG_TYPE_MEMUNITS},
 
+  UCP_CONFIG_MPOOL_PLACEMENT_FIELDS("AM_BUFS_", "active message buffers",
+                                    am_mpool_placement),
+
+  UCP_CONFIG_MPOOL_PLACEMENT_FIELDS("REG_BUFS_", "pre-registered bounce buffers",
+                                    reg_mpool_placement),
+
+  UCP_CONFIG_MPOOL_PLACEMENT_FIELDS("RNDV_FRAG_", "RNDV pipeline fragments",
+                                    rndv_frag_mpool_placement),
+
   {"RNDV_PIPELINE_SEND_THRESH", "inf",
    "RNDV size threshold to enable sender side pipeline for mem type\n",
    ucs_offsetof(ucp_config_t, ctx.rndv_pipeline_send_thresh), UCS_CONFIG_TYPE_MEMUNITS},
@@ -313,14 +418,27 @@ static ucs_config_field_t ucp_config_table[] = {
    "Experimental: enable new protocol selection logic",
    ucs_offsetof(ucp_config_t, ctx.proto_enable), UCS_CONFIG_TYPE_BOOL},
 
+  {"PROTO_CACHE_FILE", "",
+   "File of protocol selection decisions, used when PROTO_ENABLE=y. The saved\n"
+   "decisions are loaded during context initialization, and the protocols\n"
+   "they select are initialized without evaluating the other candidates. New\n"
+   "decisions are saved to the file when the context is destroyed. Decisions\n"
+   "are keyed by transport and device names, the library version and the UCX\n"
+   "environment variables, so a file can be shared by processes on hosts with\n"
+   "identical hardware. The file can be generated by \"ucx_info -e -P <file>\".\n"
+   "An empty value disables the cache.",
+   ucs_offsetof(ucp_config_t, proto_cache_file), UCS_CONFIG_TYPE_STRING},
+
   /* TODO: set for keepalive more reasonable values */
   {"KEEPALIVE_INTERVAL", "60s",
-   "Time interval between keepalive rounds (0 - disabled).",
+   "Time interval between keepalive checks of an endpoint (0 - disabled).\n"
+   "Checks of different endpoints are spread over the interval.",
    ucs_offsetof(ucp_config_t, ctx.keepalive_interval), UCS_CONFIG_TYPE_TIME},
 
   {"KEEPALIVE_NUM_EPS", "128",
-   "Maximal number of endpoints to check on every keepalive round\n"
-   "(inf - check all endpoints on every round, must be greater than 0)",
+   "Maximal number of endpoints to check on a single progress call, the rest\n"
+   "of the endpoints which are due are checked on the next calls\n"
+   "(inf - check all due endpoints at once, must be greater than 0)",
    ucs_offsetof(ucp_config_t, ctx.keepalive_num_eps), UCS_CONFIG_TYPE_UINT},
 
   {"PROTO_INDIRECT_ID", "auto",
@@ -329,6 +447,69 @@ static ucs_config_field_t ucp_config_table[] = {
    "endpoint.",
    ucs_offsetof(ucp_config_t, ctx.proto_indirect_id), UCS_CONFIG_TYPE_ON_OFF_AUTO},
 
+  {"WAIT_SPIN", "0",
+   "Time to busy-poll the worker in ucp_worker_wait() before arming it and\n"
+   "going to sleep. Events which arrive during that time are handled without\n"
+   "system calls, but the callbacks of completed operations may be called from\n"
+   "ucp_worker_wait(). The value 0 disables busy-polling, and 'auto' selects\n"
+   "the time according to how long it took recent events to arrive, up to\n"
+   "UCX_WAIT_SPIN_MAX.",
+   ucs_offsetof(ucp_config_t, ctx.wait_spin), UCS_CONFIG_TYPE_TIME_UNITS},
+
+  {"WAIT_SPIN_MAX", "50us",
+   "Maximal time to busy-poll the worker in ucp_worker_wait() when\n"
+   "UCX_WAIT_SPIN is 'auto'.",
+   ucs_offsetof(ucp_config_t, ctx.wait_spin_max), UCS_CONFIG_TYPE_TIME_UNITS},
+
+  {"LAZY_IFACE_OPEN", "n",
+   "Let workers open transport interfaces only when an endpoint is connected\n"
+   "over them. The first worker of the context opens all interfaces, and the\n"
+   "next workers advertise the attributes and addresses it saved. Applies only\n"
+   "to point-to-point transports, such as RC, whose peers connect to endpoint\n"
+   "addresses rather than interface addresses. Reduces the creation time and\n"
+   "memory footprint of workers which use only some of the transports.",
+   ucs_offsetof(ucp_config_t, ctx.lazy_iface_open), UCS_CONFIG_TYPE_BOOL},
+
+  {"SHARED_IFACES", "",
+   "Transports whose interfaces are opened once per context and shared by all\n"
+   "its workers. Reduces the number of connections used by processes with many\n"
+   "workers. Messages on a shared interface carry the destination worker, so\n"
+   "it is used only with peers which share the same transport, and other peers\n"
+   "are reached by another transport. Only active messages are sent over\n"
+   "shared interfaces, and they can't be used with UCP_FEATURE_WAKEUP. The\n"
+   "value is a list of transport names, which may contain wildcards.",
+   ucs_offsetof(ucp_config_t, shared_tls), UCS_CONFIG_TYPE_STRING_ARRAY},
+
+  {"PAYLOAD_CHECKSUM", "n",
+   "Send a CRC32C checksum of the payload with tag-matching eager and\n"
+   "rendezvous messages. The receiver verifies it when the message is\n"
+   "received, and completes the receive request with UCS_ERR_IO_ERROR if the\n"
+   "data does not match. Applies to contiguous and IOV buffers in host memory,\n"
+   "when tag matching offload is not used. The checksum is calculated with the\n"
+   "CPU CRC instructions when they are available.",
+   ucs_offsetof(ucp_config_t, ctx.payload_checksum), UCS_CONFIG_TYPE_BOOL},
+
+  {"AM_AGGREGATE_SIZE", "8k",
+   "Maximal size of a transport message which aggregates small active messages\n"
+   "on an endpoint created with UCP_EP_PARAMS_FLAGS_AM_AGGREGATE. It is also\n"
+   "limited by the maximal bcopy size of the active message lane.",
+   ucs_offsetof(ucp_config_t, ctx.am_aggregate_size), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"AM_AGGREGATE_DELAY", "0",
+   "Maximal time to hold aggregated active messages before sending them. The\n"
+   "value 0 sends them on the next worker progress.",
+   ucs_offsetof(ucp_config_t, ctx.am_aggregate_delay), UCS_CONFIG_TYPE_TIME_UNITS},
+
+  {"GENERIC_DT_PACK_THREADS", "0",
+   "Number of helper threads which pack large messages of generic datatypes\n"
+   "created with UCP_DT_GENERIC_FLAG_PARALLEL_PACK, ahead of sending them.\n"
+   "The value 0 disables parallel packing.",
+   ucs_offsetof(ucp_config_t, ctx.generic_dt_pack_threads), UCS_CONFIG_TYPE_UINT},
+
+  {"GENERIC_DT_PACK_THRESH", "1m",
+   "Minimal size of a generic datatype message to pack by the helper threads.",
+   ucs_offsetof(ucp_config_t, ctx.generic_dt_pack_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
    {NULL}
 };
 UCS_CONFIG_REGISTER_TABLE(ucp_config_table, "UCP context", NULL, ucp_config_t,
@@ -660,34 +841,24 @@ static void ucp_add_tl_resource_if_enabled(ucp_context_h context, ucp_tl_md_t *m
     }
 }
 
-static ucs_status_t ucp_add_tl_resources(ucp_context_h context,
-                                         ucp_md_index_t md_index,
-                                         const ucp_config_t *config,
-                                         unsigned *num_resources_p,
-                                         ucs_string_set_t avail_devices[],
-                                         ucs_string_set_t *avail_tls,
-                                         uint64_t dev_cfg_masks[],
-                                         uint64_t *tl_cfg_mask)
+static ucs_status_t
+ucp_add_tl_resources(ucp_context_h context, ucp_md_index_t md_index,
+                     const ucp_config_t *config,
+                     const uct_tl_resource_desc_t *tl_resources,
+                     unsigned num_tl_resources, unsigned *num_resources_p,
+                     ucs_string_set_t avail_devices[],
+                     ucs_string_set_t *avail_tls, uint64_t dev_cfg_masks[],
+                     uint64_t *tl_cfg_mask)
 {
     ucp_tl_md_t *md = &context->tl_mds[md_index];
-    uct_tl_resource_desc_t *tl_resources;
     ucp_tl_resource_desc_t *tmp;
-    unsigned num_tl_resources;
-    ucs_status_t status;
     ucp_rsc_index_t i;
 
     *num_resources_p = 0;
 
-    /* check what are the available uct resources */
-    status = uct_md_query_tl_resources(md->md, &tl_resources, &num_tl_resources);
-    if (status != UCS_OK) {
-        ucs_error("Failed to query resources: %s", ucs_status_string(status));
-        goto err;
-    }
-
     if (num_tl_resources == 0) {
         ucs_debug("No tl resources found for md %s", md->rsc.md_name);
-        goto out_free_resources;
+        return UCS_OK;
     }
 
     tmp = ucs_realloc(context->tl_rscs,
@@ -696,8 +867,7 @@ static ucs_status_t ucp_add_tl_resources(ucp_context_h context,
                       "ucp resources");
     if (tmp == NULL) {
         ucs_error("Failed to allocate resources");
-        status = UCS_ERR_NO_MEMORY;
-        goto err_free_resources;
+        return UCS_ERR_NO_MEMORY;
     }
 
     /* print configuration */
@@ -717,14 +887,7 @@ static ucs_status_t ucp_add_tl_resources(ucp_context_h context,
                                        dev_cfg_masks, tl_cfg_mask);
     }
 
-out_free_resources:
-    uct_release_tl_resource_list(tl_resources);
     return UCS_OK;
-
-err_free_resources:
-    uct_release_tl_resource_list(tl_resources);
-err:
-    return status;
 }
 
 static void ucp_get_aliases_set(ucs_string_set_t *avail_tls)
@@ -831,6 +994,20 @@ static void ucp_free_resources(ucp_context_t *context)
         ucs_memtype_cache_destroy(context->memtype_cache);
     }
 
+    if (context->tl_iface_cache != NULL) {
+        for (i = 0; i < context->num_tls; ++i) {
+            kh_destroy_inplace(ucp_tl_reachable,
+                               &context->tl_iface_cache[i].reachable);
+            ucs_free(context->tl_iface_cache[i].dev_addr);
+        }
+        ucs_free(context->tl_iface_cache);
+    }
+
+    if (context->shared_tls != NULL) {
+        pthread_mutex_destroy(&context->shared_tls_lock);
+        ucs_free(context->shared_tls);
+    }
+
     ucs_free(context->tl_rscs);
     for (i = 0; i < context->num_mds; ++i) {
         uct_md_close(context->tl_mds[i].md);
@@ -902,6 +1079,408 @@ static ucs_status_t ucp_fill_tl_md(ucp_context_h context,
     return UCS_OK;
 }
 
+static void ucp_md_discovery_release_resources(ucp_md_discovery_t *md)
+{
+    if (md->cached) {
+        ucs_free(md->tl_resources);
+    } else if (md->tl_resources != NULL) {
+        uct_release_tl_resource_list(md->tl_resources);
+    }
+
+    md->tl_resources     = NULL;
+    md->num_tl_resources = 0;
+    md->cached           = 0;
+}
+
+static void ucp_md_discovery_cleanup(ucp_md_discovery_t *mds, unsigned num_mds)
+{
+    unsigned i;
+
+    for (i = 0; i < num_mds; ++i) {
+        if (mds[i].tl_md.md != NULL) {
+            uct_md_close(mds[i].tl_md.md);
+        }
+        ucp_md_discovery_release_resources(&mds[i]);
+    }
+
+    ucs_free(mds);
+}
+
+static void ucp_discover_md(ucp_context_h context, ucp_md_discovery_t *md)
+{
+    if (md->cached && (md->num_tl_resources == 0)) {
+        /* The cache file says the memory domain has no transport resources,
+         * or that it could not be opened */
+        md->open_status = UCS_ERR_NO_DEVICE;
+        return;
+    }
+
+    md->open_status = ucp_fill_tl_md(context, md->cmpt_index, &md->md_rsc,
+                                     &md->tl_md);
+    if (md->open_status != UCS_OK) {
+        md->tl_md.md = NULL;
+        return;
+    }
+
+    if (!md->cached) {
+        md->query_status = uct_md_query_tl_resources(md->tl_md.md,
+                                                     &md->tl_resources,
+                                                     &md->num_tl_resources);
+    }
+}
+
+static void *ucp_md_discovery_thread(void *arg)
+{
+    ucp_md_discovery_ctx_t *ctx = arg;
+    uint32_t i;
+
+    while ((i = ucs_atomic_fadd32(&ctx->next, 1)) < ctx->num_mds) {
+        ucp_discover_md(ctx->context, &ctx->mds[i]);
+    }
+
+    return NULL;
+}
+
+static void ucp_discover_mds_parallel(ucp_context_h context,
+                                      ucp_md_discovery_t *mds,
+                                      unsigned num_mds, unsigned num_threads)
+{
+    ucp_md_discovery_ctx_t ctx;
+    unsigned i, num_started;
+    pthread_t *threads;
+    int ret;
+
+    ctx.context = context;
+    ctx.mds     = mds;
+    ctx.num_mds = num_mds;
+    ctx.next    = 0;
+
+    num_threads = ucs_max(ucs_min(num_threads, num_mds), 1);
+    threads     = ucs_alloca(num_threads * sizeof(*threads));
+    num_started = 0;
+    for (i = 1; i < num_threads; ++i) {
+        ret = pthread_create(&threads[num_started], NULL,
+                             ucp_md_discovery_thread, &ctx);
+        if (ret != 0) {
+            ucs_debug("failed to create resource discovery thread: %s",
+                      strerror(ret));
+            break;
+        }
+
+        ++num_started;
+    }
+
+    /* The calling thread opens memory domains as well, and completes the
+     * work if no helper thread could be created */
+    ucp_md_discovery_thread(&ctx);
+
+    for (i = 0; i < num_started; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+static int ucp_config_env_is_cache_neutral(const char *var)
+{
+    /* Variables which select the caches themselves, or affect only logging,
+     * do not change the cached results */
+    static const char *prefixes[] = {
+        "UCX_PROTO_ENABLE=", "UCX_PROTO_CACHE_FILE=", "UCX_RESOURCE_CACHE_DIR=",
+        "UCX_RESOURCE_DISCOVERY_THREADS=", "UCX_LOG_"
+    };
+    unsigned i;
+
+    for (i = 0; i < ucs_static_array_size(prefixes); ++i) {
+        if (!strncmp(var, prefixes[i], strlen(prefixes[i]))) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t ucp_config_env_crc32(uint32_t crc)
+{
+    const char *version = ucp_get_version_string();
+    uint32_t env_crc    = 0;
+    char **envp;
+
+    crc = ucs_crc32(crc, version, strlen(version));
+
+    /* Environment variables can change the resources of a memory domain and
+     * the performance of protocols. Sum their checksums, so the result does
+     * not depend on their order */
+    for (envp = environ; *envp != NULL; ++envp) {
+        if (!strncmp(*envp, UCS_DEFAULT_ENV_PREFIX,
+                     strlen(UCS_DEFAULT_ENV_PREFIX)) &&
+            !ucp_config_env_is_cache_neutral(*envp)) {
+            env_crc += ucs_crc32(0, *envp, strlen(*envp));
+        }
+    }
+
+    return ucs_crc32(crc, &env_crc, sizeof(env_crc));
+}
+
+static uint32_t ucp_rsc_cache_key(ucp_context_h context,
+                                  const ucp_md_discovery_t *mds,
+                                  unsigned num_mds)
+{
+    uint64_t boot_id[2] = {0, 0};
+    const char *cmpt_name;
+    uint32_t crc;
+    unsigned i;
+
+    crc = ucp_config_env_crc32(0);
+    (void)ucs_sys_get_boot_id(&boot_id[0], &boot_id[1]);
+    crc = ucs_crc32(crc, boot_id, sizeof(boot_id));
+
+    for (i = 0; i < num_mds; ++i) {
+        cmpt_name = context->tl_cmpts[mds[i].cmpt_index].attr.name;
+        crc       = ucs_crc32(crc, cmpt_name, strlen(cmpt_name) + 1);
+        crc       = ucs_crc32(crc, mds[i].md_rsc.md_name,
+                              strlen(mds[i].md_rsc.md_name) + 1);
+    }
+
+    return crc;
+}
+
+static void ucp_rsc_cache_path(const ucp_config_t *config, uint32_t key,
+                               char *path, size_t max)
+{
+    ucs_snprintf_zero(path, max, "%s/ucx_resources_%s_%08x",
+                      config->rsc_cache_dir, ucs_get_host_name(), key);
+}
+
+static ucs_status_t ucp_rsc_cache_read_md(FILE *stream, ucp_context_h context,
+                                          ucp_md_discovery_t *md)
+{
+    char line[256], name1[64], name2[64], bdf[64];
+    uct_tl_resource_desc_t *rsc;
+    unsigned i, num_tl_resources;
+    int dev_type;
+
+    if ((fgets(line, sizeof(line), stream) == NULL) ||
+        (sscanf(line, "md %63s %63s %u", name1, name2,
+                &num_tl_resources) != 3) ||
+        strcmp(name1, context->tl_cmpts[md->cmpt_index].attr.name) ||
+        strcmp(name2, md->md_rsc.md_name) ||
+        (num_tl_resources > UCP_MAX_RESOURCES)) {
+        return UCS_ERR_NO_ELEM;
+    }
+
+    md->cached = 1;
+    if (num_tl_resources == 0) {
+        return UCS_OK;
+    }
+
+    md->tl_resources = ucs_calloc(num_tl_resources, sizeof(*md->tl_resources),
+                                  "ucp_cached_tl_resources");
+    if (md->tl_resources == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    md->num_tl_resources = num_tl_resources;
+    for (i = 0; i < num_tl_resources; ++i) {
+        rsc = &md->tl_resources[i];
+        if ((fgets(line, sizeof(line), stream) == NULL) ||
+            (sscanf(line, "tl %63s %63s %d %63s", name1, name2, &dev_type,
+                    bdf) != 4) ||
+            (strlen(name1) >= sizeof(rsc->tl_name)) ||
+            (strlen(name2) >= sizeof(rsc->dev_name)) ||
+            (dev_type < 0) || (dev_type >= UCT_DEVICE_TYPE_LAST)) {
+            return UCS_ERR_NO_ELEM;
+        }
+
+        ucs_strncpy_zero(rsc->tl_name, name1, sizeof(rsc->tl_name));
+        ucs_strncpy_zero(rsc->dev_name, name2, sizeof(rsc->dev_name));
+        rsc->dev_type = (uct_device_type_t)dev_type;
+        if (!strcmp(bdf, UCP_RSC_CACHE_NO_SYS_DEV)) {
+            rsc->sys_device = UCS_SYS_DEVICE_ID_UNKNOWN;
+        } else if (ucs_topo_find_device_by_bdf_name(bdf, &rsc->sys_device) !=
+                   UCS_OK) {
+            return UCS_ERR_NO_ELEM;
+        }
+    }
+
+    return UCS_OK;
+}
+
+static ucs_status_t ucp_rsc_cache_load(ucp_context_h context,
+                                       const ucp_config_t *config,
+                                       ucp_md_discovery_t *mds,
+                                       unsigned num_mds, uint32_t key)
+{
+    char path[PATH_MAX], line[256];
+    unsigned i, version, file_key;
+    ucs_status_t status;
+    FILE *stream;
+
+    ucp_rsc_cache_path(config, key, path, sizeof(path));
+    stream = fopen(path, "r");
+    if (stream == NULL) {
+        ucs_debug("resource cache %s is not available: %m", path);
+        return UCS_ERR_NO_ELEM;
+    }
+
+    if ((fgets(line, sizeof(line), stream) == NULL) ||
+        (sscanf(line, UCP_RSC_CACHE_MAGIC " %u %x", &version, &file_key) != 2) ||
+        (version != UCP_RSC_CACHE_VERSION) || (file_key != key)) {
+        status = UCS_ERR_NO_ELEM;
+    } else {
+        status = UCS_OK;
+        for (i = 0; (i < num_mds) && (status == UCS_OK); ++i) {
+            status = ucp_rsc_cache_read_md(stream, context, &mds[i]);
+        }
+    }
+
+    fclose(stream);
+
+    if (status != UCS_OK) {
+        ucs_debug("ignoring invalid resource cache %s", path);
+        for (i = 0; i < num_mds; ++i) {
+            ucp_md_discovery_release_resources(&mds[i]);
+        }
+        return status;
+    }
+
+    ucs_debug("using resource cache %s", path);
+    return UCS_OK;
+}
+
+static ucs_status_t ucp_rsc_cache_write(FILE *stream, void *arg)
+{
+    const ucp_rsc_cache_write_ctx_t *ctx = arg;
+    const ucp_md_discovery_t *mds        = ctx->mds;
+    const uct_tl_resource_desc_t *rsc;
+    unsigned i, j, num_tl_resources;
+    const char *bdf;
+    char buf[32];
+
+    fprintf(stream, UCP_RSC_CACHE_MAGIC " %u %08x\n", UCP_RSC_CACHE_VERSION,
+            ctx->key);
+    for (i = 0; i < ctx->num_mds; ++i) {
+        num_tl_resources = (mds[i].open_status == UCS_OK) ?
+                           mds[i].num_tl_resources : 0;
+        fprintf(stream, "md %s %s %u\n",
+                ctx->context->tl_cmpts[mds[i].cmpt_index].attr.name,
+                mds[i].md_rsc.md_name, num_tl_resources);
+
+        for (j = 0; j < num_tl_resources; ++j) {
+            rsc = &mds[i].tl_resources[j];
+            if (rsc->sys_device == UCS_SYS_DEVICE_ID_UNKNOWN) {
+                bdf = UCP_RSC_CACHE_NO_SYS_DEV;
+            } else {
+                bdf = ucs_topo_sys_device_bdf_name(rsc->sys_device, buf,
+                                                   sizeof(buf));
+                if (bdf == NULL) {
+                    ucs_debug("cannot cache resources of %s", rsc->dev_name);
+                    return UCS_ERR_UNSUPPORTED;
+                }
+            }
+
+            fprintf(stream, "tl %s %s %d %s\n", rsc->tl_name, rsc->dev_name,
+                    rsc->dev_type, bdf);
+        }
+    }
+
+    return UCS_OK;
+}
+
+static void ucp_rsc_cache_save(ucp_context_h context,
+                               const ucp_config_t *config,
+                               const ucp_md_discovery_t *mds,
+                               unsigned num_mds, uint32_t key)
+{
+    ucp_rsc_cache_write_ctx_t ctx;
+    char path[PATH_MAX];
+    ucs_status_t status;
+
+    ucp_rsc_cache_path(config, key, path, sizeof(path));
+
+    ctx.context = context;
+    ctx.mds     = mds;
+    ctx.num_mds = num_mds;
+    ctx.key     = key;
+    status      = ucs_sys_write_file_atomic(path, ucp_rsc_cache_write, &ctx);
+    if (status != UCS_OK) {
+        ucs_debug("failed to save resource cache %s", path);
+        return;
+    }
+
+    ucs_debug("saved resource cache %s", path);
+}
+
+/**
+ * Open the memory domains of all components and query their transport
+ * resources. The memory domains are opened by several threads if configured,
+ * and their resources are taken from the per-host cache file if it exists.
+ */
+static ucs_status_t ucp_discover_mds(ucp_context_h context,
+                                     const ucp_config_t *config,
+                                     unsigned max_mds,
+                                     ucp_md_discovery_t **mds_p)
+{
+    uct_component_attr_t uct_component_attr;
+    uct_md_resource_desc_t *md_rscs;
+    const ucp_tl_cmpt_t *tl_cmpt;
+    ucp_md_discovery_t *mds;
+    unsigned i, j, num_mds;
+    ucs_status_t status;
+    int use_cache, cached;
+    uint32_t key;
+
+    mds = ucs_calloc(max_mds, sizeof(*mds), "ucp_md_discovery");
+    if (mds == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    /* List memory domain resources */
+    md_rscs = ucs_alloca(max_mds * sizeof(*md_rscs));
+    num_mds = 0;
+    for (i = 0; i < context->num_cmpts; ++i) {
+        tl_cmpt                         = &context->tl_cmpts[i];
+        uct_component_attr.field_mask   = UCT_COMPONENT_ATTR_FIELD_MD_RESOURCES;
+        uct_component_attr.md_resources = &md_rscs[num_mds];
+        status = uct_component_query(tl_cmpt->cmpt, &uct_component_attr);
+        if (status != UCS_OK) {
+            ucs_free(mds);
+            return status;
+        }
+
+        for (j = 0; j < tl_cmpt->attr.md_resource_count; ++j, ++num_mds) {
+            mds[num_mds].cmpt_index = i;
+            mds[num_mds].md_rsc     = md_rscs[num_mds];
+        }
+    }
+
+    use_cache = strlen(config->rsc_cache_dir) > 0;
+    cached    = 0;
+    key       = 0;
+    if (use_cache) {
+        key    = ucp_rsc_cache_key(context, mds, num_mds);
+        cached = (ucp_rsc_cache_load(context, config, mds, num_mds, key) ==
+                  UCS_OK);
+    }
+
+    ucp_discover_mds_parallel(context, mds, num_mds,
+                              config->rsc_discovery_threads);
+
+    if (use_cache && !cached) {
+        for (i = 0; i < num_mds; ++i) {
+            if ((mds[i].open_status == UCS_OK) &&
+                (mds[i].query_status != UCS_OK)) {
+                break;
+            }
+        }
+
+        if (i == num_mds) {
+            ucp_rsc_cache_save(context, config, mds, num_mds, key);
+        }
+    }
+
+    *mds_p = mds;
+    return UCS_OK;
+}
+
 static void ucp_resource_config_array_str(const ucs_config_names_array_t *array,
                                           const char *title, char *buf, size_t max)
 {
@@ -1047,47 +1626,45 @@ static ucs_status_t ucp_check_resources(ucp_context_h context,
     return ucp_check_tl_names(context);
 }
 
-static ucs_status_t ucp_add_component_resources(ucp_context_h context,
-                                                ucp_rsc_index_t cmpt_index,
-                                                ucs_string_set_t avail_devices[],
-                                                ucs_string_set_t *avail_tls,
-                                                uint64_t dev_cfg_masks[],
-                                                uint64_t *tl_cfg_mask,
-                                                const ucp_config_t *config)
+static ucs_status_t
+ucp_add_component_resources(ucp_context_h context, ucp_rsc_index_t cmpt_index,
+                            ucp_md_discovery_t *mds,
+                            ucs_string_set_t avail_devices[],
+                            ucs_string_set_t *avail_tls,
+                            uint64_t dev_cfg_masks[], uint64_t *tl_cfg_mask,
+                            const ucp_config_t *config)
 {
     const ucp_tl_cmpt_t *tl_cmpt = &context->tl_cmpts[cmpt_index];
-    uct_component_attr_t uct_component_attr;
     unsigned num_tl_resources;
+    ucp_md_discovery_t *md;
     ucs_status_t status;
     ucp_rsc_index_t i;
     unsigned md_index;
     uint64_t mem_type_mask;
     uint64_t mem_type_bitmap;
 
-
-    /* List memory domain resources */
-    uct_component_attr.field_mask   = UCT_COMPONENT_ATTR_FIELD_MD_RESOURCES;
-    uct_component_attr.md_resources =
-                    ucs_alloca(tl_cmpt->attr.md_resource_count *
-                               sizeof(*uct_component_attr.md_resources));
-    status = uct_component_query(tl_cmpt->cmpt, &uct_component_attr);
-    if (status != UCS_OK) {
-        goto out;
-    }
-
-    /* Open all memory domains */
+    /* Add the memory domains which were opened by discovery */
     mem_type_mask = UCS_BIT(UCS_MEMORY_TYPE_HOST);
     for (i = 0; i < tl_cmpt->attr.md_resource_count; ++i) {
-        md_index = context->num_mds;
-        status = ucp_fill_tl_md(context, cmpt_index,
-                                &uct_component_attr.md_resources[i],
-                                &context->tl_mds[md_index]);
-        if (status != UCS_OK) {
+        md = &mds[i];
+        if (md->open_status != UCS_OK) {
             continue;
         }
 
+        if (md->query_status != UCS_OK) {
+            ucs_error("Failed to query resources: %s",
+                      ucs_status_string(md->query_status));
+            status = md->query_status;
+            goto out;
+        }
+
+        md_index                   = context->num_mds;
+        context->tl_mds[md_index]  = md->tl_md;
+        md->tl_md.md               = NULL;
+
         /* Add communication resources of each MD */
         status = ucp_add_tl_resources(context, md_index, config,
+                                      md->tl_resources, md->num_tl_resources,
                                       &num_tl_resources, avail_devices,
                                       avail_tls, dev_cfg_masks, tl_cfg_mask);
         if (status != UCS_OK) {
@@ -1120,6 +1697,49 @@ out:
     return status;
 }
 
+static ucs_status_t ucp_fill_shared_tls(ucp_context_h context,
+                                        const ucp_config_t *config)
+{
+    ucp_tl_resource_desc_t *resource;
+    ucp_rsc_index_t rsc_index;
+
+    if (config->shared_tls.count == 0) {
+        return UCS_OK;
+    }
+
+    /* Events of shared interfaces are dispatched by worker progress, so they
+     * can't wake up a worker */
+    if (context->config.features & UCP_FEATURE_WAKEUP) {
+        ucs_debug("interfaces are not shared since wakeup feature is "
+                  "requested");
+        return UCS_OK;
+    }
+
+    for (rsc_index = 0; rsc_index < context->num_tls; ++rsc_index) {
+        resource = &context->tl_rscs[rsc_index];
+        if (!(resource->flags & UCP_TL_RSC_FLAG_SOCKADDR) &&
+            (ucs_config_names_search(config->shared_tls,
+                                     resource->tl_rsc.tl_name) >= 0)) {
+            UCS_BITMAP_SET(context->shared_tl_bitmap, rsc_index);
+        }
+    }
+
+    if (UCS_BITMAP_IS_ZERO_INPLACE(&context->shared_tl_bitmap)) {
+        return UCS_OK;
+    }
+
+    context->shared_tls = ucs_calloc(context->num_tls,
+                                     sizeof(*context->shared_tls),
+                                     "ucp_shared_tls");
+    if (context->shared_tls == NULL) {
+        ucs_error("failed to allocate shared interfaces array");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    pthread_mutex_init(&context->shared_tls_lock, NULL);
+    return UCS_OK;
+}
+
 static ucs_status_t ucp_fill_resources(ucp_context_h context,
                                        const ucp_config_t *config)
 {
@@ -1128,7 +1748,9 @@ static ucs_status_t ucp_fill_resources(ucp_context_h context,
     ucs_string_set_t avail_devices[UCT_DEVICE_TYPE_LAST];
     ucs_string_set_t avail_tls;
     uct_component_h *uct_components;
+    ucp_md_discovery_t *mds;
     unsigned i, num_uct_components;
+    unsigned md_offset;
     uct_device_type_t dev_type;
     ucs_status_t status;
     unsigned max_mds;
@@ -1139,10 +1761,13 @@ static ucs_status_t ucp_fill_resources(ucp_context_h context,
     context->num_mds          = 0;
     context->tl_rscs          = NULL;
     context->num_tls          = 0;
+    context->tl_iface_cache   = NULL;
+    context->shared_tls       = NULL;
     context->memtype_cache    = NULL;
     context->mem_type_mask    = 0;
     context->num_mem_type_detect_mds = 0;
 
+    UCS_BITMAP_CLEAR(&context->shared_tl_bitmap);
     for (i = 0; i < UCS_MEMORY_TYPE_LAST; ++i) {
         UCS_BITMAP_CLEAR(&context->mem_type_access_tls[i]);
     }
@@ -1216,16 +1841,29 @@ static ucs_status_t ucp_fill_resources(ucp_context_h context,
         goto err_free_resources;
     }
 
+    /* Open the memory domains and query their transport resources */
+    status = ucp_discover_mds(context, config, max_mds, &mds);
+    if (status != UCS_OK) {
+        goto err_free_resources;
+    }
+
     /* Collect resources of each component */
+    md_offset = 0;
     for (i = 0; i < context->num_cmpts; ++i) {
-        status = ucp_add_component_resources(context, i, avail_devices,
-                                             &avail_tls, dev_cfg_masks,
-                                             &tl_cfg_mask, config);
+        status = ucp_add_component_resources(context, i, &mds[md_offset],
+                                             avail_devices, &avail_tls,
+                                             dev_cfg_masks, &tl_cfg_mask,
+                                             config);
         if (status != UCS_OK) {
+            ucp_md_discovery_cleanup(mds, max_mds);
             goto err_free_resources;
         }
+
+        md_offset += context->tl_cmpts[i].attr.md_resource_count;
     }
 
+    ucp_md_discovery_cleanup(mds, max_mds);
+
     /* Create memtype cache if we have memory type MDs, and it's enabled by
      * configuration
      */
@@ -1267,6 +1905,29 @@ static ucs_status_t ucp_fill_resources(ucp_context_h context,
         goto err_free_resources;
     }
 
+    /* In unified mode, workers select the interfaces to use after opening
+     * all of them, so they can't be opened lazily */
+    if (config->ctx.lazy_iface_open && !config->ctx.unified_mode) {
+        context->tl_iface_cache = ucs_calloc(context->num_tls,
+                                             sizeof(*context->tl_iface_cache),
+                                             "ucp_tl_iface_cache");
+        if (context->tl_iface_cache == NULL) {
+            ucs_error("failed to allocate transport interface cache");
+            status = UCS_ERR_NO_MEMORY;
+            goto err_free_resources;
+        }
+
+        for (i = 0; i < context->num_tls; ++i) {
+            kh_init_inplace(ucp_tl_reachable,
+                            &context->tl_iface_cache[i].reachable);
+        }
+    }
+
+    status = ucp_fill_shared_tls(context, config);
+    if (status != UCS_OK) {
+        goto err_free_resources;
+    }
+
     status = ucp_fill_sockaddr_prio_list(context, config);
     if (status != UCS_OK) {
         goto err_free_resources;
@@ -1558,6 +2219,25 @@ ucs_status_t ucp_init_version(unsigned api_major_version, unsigned api_minor_ver
         goto err_free_config;
     }
 
+    context->proto_cache = NULL;
+    if (context->config.ext.proto_enable && strlen(config->proto_cache_file)) {
+        status = ucp_proto_cache_create(context, config->proto_cache_file,
+                                        &context->proto_cache);
+        if (status != UCS_OK) {
+            goto err_free_resources;
+        }
+    }
+
+    context->dt_generic_pool = NULL;
+    if (context->config.ext.generic_dt_pack_threads > 0) {
+        status = ucp_dt_generic_pool_create(
+                context->config.ext.generic_dt_pack_threads,
+                &context->dt_generic_pool);
+        if (status != UCS_OK) {
+            goto err_destroy_proto_cache;
+        }
+    }
+
     if (dfl_config != NULL) {
         ucp_config_release(dfl_config);
     }
@@ -1572,6 +2252,12 @@ ucs_status_t ucp_init_version(unsigned api_major_version, unsigned api_minor_ver
     *context_p = context;
     return UCS_OK;
 
+err_destroy_proto_cache:
+    if (context->proto_cache != NULL) {
+        ucp_proto_cache_destroy(context->proto_cache);
+    }
+err_free_resources:
+    ucp_free_resources(context);
 err_free_config:
     ucp_free_config(context);
 err_free_ctx:
@@ -1587,6 +2273,12 @@ err:
 void ucp_cleanup(ucp_context_h context)
 {
     ucs_vfs_obj_remove(context);
+    if (context->dt_generic_pool != NULL) {
+        ucp_dt_generic_pool_destroy(context->dt_generic_pool);
+    }
+    if (context->proto_cache != NULL) {
+        ucp_proto_cache_destroy(context->proto_cache);
+    }
     ucp_free_resources(context);
     ucp_free_config(context);
     UCP_THREAD_LOCK_FINALIZE(&context->mt_lock);
@@ -1790,3 +2482,45 @@ const char* ucp_context_cm_name(ucp_context_h context, ucp_rsc_index_t cm_idx)
     ucs_assert(cm_idx != UCP_NULL_RESOURCE);
     return context->tl_cmpts[context->config.cm_cmpt_idxs[cm_idx]].attr.name;
 }
+
+ucs_status_t ucp_context_tl_reachable_get(ucp_context_h context,
+                                          ucp_rsc_index_t rsc_index,
+                                          uint64_t dev_key, int *reachable_p)
+{
+    khash_t(ucp_tl_reachable) *hash;
+    ucs_status_t status;
+    khiter_t iter;
+
+    hash = &context->tl_iface_cache[rsc_index].reachable;
+    UCP_THREAD_CS_ENTER(&context->mt_lock);
+    iter = kh_get(ucp_tl_reachable, hash, dev_key);
+    if (iter == kh_end(hash)) {
+        status = UCS_ERR_NO_ELEM;
+    } else {
+        *reachable_p = kh_val(hash, iter);
+        status       = UCS_OK;
+    }
+    UCP_THREAD_CS_EXIT(&context->mt_lock);
+
+    return status;
+}
+
+void ucp_context_tl_reachable_set(ucp_context_h context,
+                                  ucp_rsc_index_t rsc_index, uint64_t dev_key,
+                                  int reachable)
+{
+    khash_t(ucp_tl_reachable) *hash;
+    khiter_t iter;
+    int ret;
+
+    hash = &context->tl_iface_cache[rsc_index].reachable;
+    UCP_THREAD_CS_ENTER(&context->mt_lock);
+    iter = kh_put(ucp_tl_reachable, hash, dev_key, &ret);
+    if (ret == UCS_KH_PUT_FAILED) {
+        ucs_debug("failed to save reachability of %s",
+                  context->tl_rscs[rsc_index].tl_rsc.tl_name);
+    } else {
+        kh_val(hash, iter) = reachable;
+    }
+    UCP_THREAD_CS_EXIT(&context->mt_lock);
+}
@@ -14,11 +14,13 @@
 #include "ucp_thread.h"
 
 #include <ucp/api/ucp.h>
+#include <ucp/dt/dt_generic.h>
 #include <ucp/proto/proto.h>
 #include <uct/api/uct.h>
 #include <ucs/datastruct/mpool.h>
 #include <ucs/datastruct/queue_types.h>
 #include <ucs/datastruct/bitmap.h>
+#include <ucs/datastruct/khash.h>
 #include <ucs/memory/memtype_cache.h>
 #include <ucs/type/spinlock.h>
 #include <ucs/sys/string.h>
@@ -63,6 +65,12 @@ typedef struct ucp_context_config {
     size_t                                 seg_size;
     /** RNDV pipeline fragment size */
     size_t                                 rndv_frag_size;
+    /** Page size and NUMA placement of worker active message buffers */
+    ucs_mpool_chunk_placement_t            am_mpool_placement;
+    /** Page size and NUMA placement of worker pre-registered buffers */
+    ucs_mpool_chunk_placement_t            reg_mpool_placement;
+    /** Page size and NUMA placement of worker RNDV pipeline fragments */
+    ucs_mpool_chunk_placement_t            rndv_frag_mpool_placement;
     /** RNDV pipline send threshold */
     size_t                                 rndv_pipeline_send_thresh;
     /** Threshold for using tag matching offload capabilities. Smaller buffers
@@ -106,13 +114,30 @@ typedef struct ucp_context_config {
     size_t                                 listener_backlog;
     /** Enable new protocol selection logic */
     int                                    proto_enable;
-    /** Time period between keepalive rounds (0 - disabled) */
+    /** Time period between keepalive checks of an endpoint (0 - disabled) */
     double                                 keepalive_interval;
-    /** Maximal number of endpoints to check on every keepalive round
-     * (0 - disabled, inf - check all endpoints on every round) */
+    /** Maximal number of endpoints to check on a single progress call
+     * (inf - check all expired endpoints at once) */
     unsigned                               keepalive_num_eps;
     /** Enable indirect IDs to object pointers in wire protocols */
     ucs_on_off_auto_value_t                proto_indirect_id;
+    /** Time to busy-poll in ucp_worker_wait() before going to sleep
+     * (0 - disabled, auto - adapt to the time it takes events to arrive) */
+    ucs_time_t                             wait_spin;
+    /** Maximal time to busy-poll in ucp_worker_wait() in auto mode */
+    ucs_time_t                             wait_spin_max;
+    /** Open point-to-point transport interfaces when they are first used */
+    int                                    lazy_iface_open;
+    /** Send and verify checksums of tag-matching message payloads */
+    int                                    payload_checksum;
+    /** Maximal size of a message which aggregates small active messages */
+    size_t                                 am_aggregate_size;
+    /** Maximal time to hold aggregated active messages before sending them */
+    ucs_time_t                             am_aggregate_delay;
+    /** Number of threads which pack generic datatypes in parallel */
+    unsigned                               generic_dt_pack_threads;
+    /** Minimal size of a generic datatype message to pack in parallel */
+    size_t                                 generic_dt_pack_thresh;
 } ucp_context_config_t;
 
 
@@ -135,6 +160,14 @@ struct ucp_config {
     char                                   *env_prefix;
     /** MD to compare for transport selection scores */
     char                                   *selection_cmp;
+    /** Number of threads which open memory domains during initialization */
+    unsigned                               rsc_discovery_threads;
+    /** Directory of per-host transport resource cache files */
+    char                                   *rsc_cache_dir;
+    /** File of saved protocol selection decisions */
+    char                                   *proto_cache_file;
+    /** Transports whose interfaces are shared by the workers of a context */
+    ucs_config_names_array_t               shared_tls;
     /** Configuration saved directly in the context */
     ucp_context_config_t                   ctx;
 };
@@ -153,6 +186,26 @@ typedef struct ucp_tl_resource_desc {
 } ucp_tl_resource_desc_t;
 
 
+/* Reachability of remote devices, by device address hash */
+KHASH_TYPE(ucp_tl_reachable, uint64_t, int);
+
+
+/**
+ * Transport interface attributes and addresses, saved from the first worker
+ * which opened the interface, to let next workers advertise the transport
+ * before they open it.
+ */
+typedef struct ucp_tl_iface_cache {
+    uct_iface_attr_t              attr;       /* Interface attributes */
+    void                          *dev_addr;  /* Device address, followed by
+                                                 the interface address */
+    void                          *iface_addr;/* Interface address */
+    int                           valid;      /* Whether the entry is set */
+    khash_t(ucp_tl_reachable)     reachable;  /* Remote devices checked by
+                                                 opened interfaces */
+} ucp_tl_iface_cache_t;
+
+
 /**
  * Transport aliases.
  */
@@ -204,10 +257,29 @@ typedef struct ucp_context {
                                                * Not all resources may be used if unified
                                                * mode is enabled. */
     ucp_rsc_index_t               num_tls;    /* Number of resources in the array */
+    ucp_tl_iface_cache_t          *tl_iface_cache; /* Saved interface attributes
+                                                    * per resource, NULL if
+                                                    * lazy open is disabled */
+    ucp_tl_bitmap_t               shared_tl_bitmap; /* Resources whose interfaces
+                                                     * are shared by workers,
+                                                     * protected by
+                                                     * shared_tls_lock */
+    ucp_shared_tl_t               **shared_tls; /* Shared interface per resource,
+                                                 * NULL if none is shared */
+    pthread_mutex_t               shared_tls_lock; /* Protects the shared
+                                                    * interfaces, taken
+                                                    * regardless of the context
+                                                    * thread mode */
 
     /* Mask of memory type communication resources */
     ucp_tl_bitmap_t               mem_type_access_tls[UCS_MEMORY_TYPE_LAST];
 
+    /* Persistent protocol selection decisions, NULL if disabled */
+    ucp_proto_cache_t             *proto_cache;
+
+    /* Threads which pack generic datatypes in parallel, NULL if disabled */
+    ucp_dt_generic_pool_t         *dt_generic_pool;
+
     struct {
 
         /* Bitmap of features supported by the context */
@@ -370,6 +442,8 @@ void ucp_dump_payload(ucp_context_h context, char *buffer, size_t max,
 
 void ucp_context_tag_offload_enable(ucp_context_h context);
 
+uint32_t ucp_config_env_crc32(uint32_t crc);
+
 void ucp_context_uct_atomic_iface_flags(ucp_context_h context,
                                         ucp_tl_iface_atomic_flags_t *atomic);
 
@@ -493,6 +567,44 @@ out_host_mem:
     ucp_memory_info_set_host(mem_info);
 }
 
+static UCS_F_ALWAYS_INLINE void
+ucp_memory_detect_iov(ucp_context_h context, const ucp_dt_iov_t *iov,
+                      size_t iovcnt, ucs_memory_info_t *mem_info)
+{
+    ucs_status_t status;
+
+    UCS_STATIC_ASSERT(sizeof(ucp_dt_iov_t) == sizeof(struct iovec));
+    UCS_STATIC_ASSERT(offsetof(ucp_dt_iov_t, buffer) ==
+                      offsetof(struct iovec, iov_base));
+    UCS_STATIC_ASSERT(offsetof(ucp_dt_iov_t, length) ==
+                      offsetof(struct iovec, iov_len));
+
+    if (ucs_likely(context->num_mem_type_detect_mds == 0) ||
+        ucp_memory_type_cache_is_empty(context)) {
+        ucp_memory_info_set_host(mem_info);
+        return;
+    }
+
+    if (context->memtype_cache != NULL) {
+        status = ucs_memtype_cache_lookup_iov(context->memtype_cache,
+                                              (const struct iovec*)iov, iovcnt,
+                                              mem_info);
+        if (status != UCS_OK) {
+            /* None of the entries is in the cache - all are host memory */
+            ucp_memory_info_set_host(mem_info);
+            return;
+        }
+
+        if ((mem_info->type != UCS_MEMORY_TYPE_UNKNOWN) &&
+            (mem_info->sys_dev != UCS_SYS_DEVICE_ID_UNKNOWN)) {
+            return;
+        }
+    }
+
+    /* Mixed or unknown memory types - detect by the first entry */
+    ucp_memory_detect(context, iov->buffer, iov->length, mem_info);
+}
+
 
 ucp_tl_bitmap_t
 ucp_context_dev_tl_bitmap(ucp_context_h context, const char *dev_name);
@@ -504,4 +616,14 @@ ucp_context_dev_idx_tl_bitmap(ucp_context_h context, ucp_rsc_index_t dev_idx);
 
 const char* ucp_context_cm_name(ucp_context_h context, ucp_rsc_index_t cm_idx);
 
+
+ucs_status_t ucp_context_tl_reachable_get(ucp_context_h context,
+                                          ucp_rsc_index_t rsc_index,
+                                          uint64_t dev_key, int *reachable_p);
+
+
+void ucp_context_tl_reachable_set(ucp_context_h context,
+                                  ucp_rsc_index_t rsc_index, uint64_t dev_key,
+                                  int reachable);
+
 #endif
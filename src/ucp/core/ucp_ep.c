@@ -145,15 +145,15 @@ ucs_status_t ucp_ep_create_base(ucp_worker_h worker, const char *peer_name,
         goto err;
     }
 
-    ucp_ep_ext_gen(ep)->control_ext = ucs_calloc(1,
-                                                 sizeof(ucp_ep_ext_control_t),
-                                                 "ep_control_ext");
+    ucp_ep_ext_gen(ep)->control_ext = ucs_mpool_get(&worker->ep_control_mp);
     if (ucp_ep_ext_gen(ep)->control_ext == NULL) {
         ucs_error("Failed to allocate ep control extension");
         status = UCS_ERR_NO_MEMORY;
         goto err_free_ep;
     }
 
+    memset(ucp_ep_ext_control(ep), 0, sizeof(ucp_ep_ext_control_t));
+
     ep->refcount                         = 1;
     ep->cfg_index                        = UCP_WORKER_CFG_INDEX_NULL;
     ep->worker                           = worker;
@@ -203,7 +203,7 @@ ucs_status_t ucp_ep_create_base(ucp_worker_h worker, const char *peer_name,
     return UCS_OK;
 
 err_free_ep_control_ext:
-    ucs_free(ucp_ep_ext_control(ep));
+    ucs_mpool_put(ucp_ep_ext_control(ep));
 err_free_ep:
     ucs_strided_alloc_put(&worker->ep_alloc, ep);
 err:
@@ -267,7 +267,8 @@ static void ucp_ep_destroy_base(ucp_ep_h ep)
     ucs_vfs_obj_remove(ep);
     ucp_ep_remove_progress_callbacks(ep);
     UCS_STATS_NODE_FREE(ep->stats);
-    ucs_free(ucp_ep_ext_control(ep));
+    ucs_free(ucp_ep_ext_control(ep)->lazy_connect);
+    ucs_mpool_put(ucp_ep_ext_control(ep));
     ucs_strided_alloc_put(&ep->worker->ep_alloc, ep);
 }
 
@@ -569,6 +570,117 @@ err:
     return status;
 }
 
+static ucs_status_t
+ucp_ep_create_lazy_to_worker_addr(ucp_worker_h worker,
+                                  const ucp_unpacked_address_t *remote_address,
+                                  const ucp_address_t *packed_address,
+                                  unsigned ep_init_flags, ucp_ep_h *ep_p)
+{
+    ucp_ep_lazy_connect_t *lazy_connect;
+    ucp_ep_config_key_t key;
+    ucs_status_t status;
+    ucp_ep_h ep;
+
+    status = ucp_worker_create_ep(worker, ep_init_flags, remote_address->name,
+                                  "from api call (lazy)", &ep);
+    if (status != UCS_OK) {
+        goto err;
+    }
+
+    lazy_connect = ucs_malloc(sizeof(*lazy_connect) +
+                              remote_address->packed_length,
+                              "ucp_ep_lazy_connect");
+    if (lazy_connect == NULL) {
+        ucs_error("failed to allocate lazy connect address");
+        status = UCS_ERR_NO_MEMORY;
+        goto err_delete;
+    }
+
+    lazy_connect->ep_init_flags = ep_init_flags;
+    memcpy(lazy_connect->address, packed_address,
+           remote_address->packed_length);
+    ucp_ep_ext_control(ep)->lazy_connect = lazy_connect;
+
+    /* Configuration without lanes, which is replaced by the real one when
+     * the endpoint is used for the first time */
+    ucp_ep_config_key_reset(&key);
+    ucp_ep_config_key_set_err_mode(&key, ep_init_flags);
+
+    status = ucp_worker_get_ep_config(worker, &key, 0, &ep->cfg_index);
+    if (status != UCS_OK) {
+        goto err_delete;
+    }
+
+    ucp_ep_update_flags(ep, UCP_EP_FLAG_LAZY_CONNECT, 0);
+    *ep_p = ep;
+    return UCS_OK;
+
+err_delete:
+    ucp_ep_delete(ep);
+err:
+    return status;
+}
+
+ucs_status_t ucp_ep_lazy_connect(ucp_ep_h ep)
+{
+    ucp_worker_h worker = ep->worker;
+    unsigned addr_indices[UCP_MAX_LANES];
+    ucp_unpacked_address_t remote_address;
+    ucp_ep_lazy_connect_t *lazy_connect;
+    ucs_status_t status;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    /* Could be connected meanwhile by a wireup request from the peer */
+    if (!(ep->flags & UCP_EP_FLAG_LAZY_CONNECT)) {
+        status = UCS_OK;
+        goto out;
+    }
+
+    if (ep->flags & UCP_EP_FLAG_FAILED) {
+        status = UCS_ERR_CONNECTION_RESET;
+        goto out;
+    }
+
+    ucs_debug("ep %p: connect on first use", ep);
+
+    lazy_connect = ucp_ep_ext_control(ep)->lazy_connect;
+    status       = ucp_address_unpack(worker, lazy_connect->address,
+                                      UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT,
+                                      &remote_address);
+    if (status != UCS_OK) {
+        goto out;
+    }
+
+    status = ucp_wireup_init_lanes(ep, lazy_connect->ep_init_flags,
+                                   &ucp_tl_bitmap_max, &remote_address,
+                                   addr_indices);
+    ucs_free(remote_address.address_list);
+    if (status != UCS_OK) {
+        goto out;
+    }
+
+    ucp_ep_lazy_connect_release(ep);
+
+    if (!(ep->flags & UCP_EP_FLAG_LOCAL_CONNECTED)) {
+        ucs_assert(!(ep->flags & UCP_EP_FLAG_CONNECT_REQ_QUEUED));
+        status = ucp_wireup_send_request(ep);
+    }
+
+out:
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return status;
+}
+
+void ucp_ep_lazy_connect_release(ucp_ep_h ep)
+{
+    ucs_assert(ep->flags & UCP_EP_FLAG_LAZY_CONNECT);
+
+    ucs_free(ucp_ep_ext_control(ep)->lazy_connect);
+    ucp_ep_ext_control(ep)->lazy_connect = NULL;
+    ucp_ep_update_flags(ep, 0, UCP_EP_FLAG_LAZY_CONNECT);
+}
+
 static ucs_status_t ucp_ep_create_to_sock_addr(ucp_worker_h worker,
                                                const ucp_ep_params_t *params,
                                                ucp_ep_h *ep_p)
@@ -636,6 +748,7 @@ ucs_status_t ucp_ep_create_server_accept(ucp_worker_h worker,
     const ucp_wireup_sockaddr_data_t *sa_data = &conn_request->sa_data;
     unsigned ep_init_flags                    = 0;
     ucp_unpacked_address_t           remote_addr;
+    ucp_address_entry_t              *address;
     uint64_t                         addr_flags;
     unsigned                         i;
     ucs_status_t                     status;
@@ -659,8 +772,10 @@ ucs_status_t ucp_ep_create_server_accept(ucp_worker_h worker,
     }
 
     for (i = 0; i < remote_addr.address_count; ++i) {
-        remote_addr.address_list[i].dev_addr  = conn_request->remote_dev_addr;
-        remote_addr.address_list[i].dev_index = conn_request->sa_data.dev_index;
+        address               = &remote_addr.address_list[i];
+        address->dev_addr     = conn_request->remote_dev_addr;
+        address->dev_addr_len = conn_request->remote_dev_addr_len;
+        address->dev_index    = conn_request->sa_data.dev_index;
     }
 
     status = ucp_ep_cm_server_create_connected(worker, ep_init_flags,
@@ -745,10 +860,18 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
         goto out_free_address;
     }
 
-    status = ucp_ep_create_to_worker_addr(worker, &ucp_tl_bitmap_max,
-                                          &remote_address,
-                                          ucp_ep_init_flags(worker, params),
-                                          "from api call", &ep);
+    flags = UCP_PARAM_VALUE(EP, params, flags, FLAGS, 0);
+    if (flags & UCP_EP_PARAMS_FLAGS_LAZY_CONNECT) {
+        status = ucp_ep_create_lazy_to_worker_addr(
+                worker, &remote_address, params->address,
+                ucp_ep_init_flags(worker, params), &ep);
+    } else {
+        status = ucp_ep_create_to_worker_addr(worker, &ucp_tl_bitmap_max,
+                                              &remote_address,
+                                              ucp_ep_init_flags(worker,
+                                                                params),
+                                              "from api call", &ep);
+    }
     if (status != UCS_OK) {
         goto out_free_address;
     }
@@ -767,7 +890,6 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
      * Otherwise, add the new ep to the matching context as an expected endpoint,
      * waiting for connection request from the peer endpoint
      */
-    flags = UCP_PARAM_VALUE(EP, params, flags, FLAGS, 0);
     if ((remote_address.uuid == worker->uuid) &&
         !(flags & UCP_EP_PARAMS_FLAGS_NO_LOOPBACK)) {
         ucp_ep_update_remote_id(ep, ucp_ep_local_id(ep));
@@ -777,8 +899,10 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
                             UCS_CONN_MATCH_QUEUE_EXP);
     }
 
-    /* if needed, send initial wireup message */
-    if (!(ep->flags & UCP_EP_FLAG_LOCAL_CONNECTED)) {
+    /* if needed, send initial wireup message, lazily connected endpoint
+     * sends it on first use */
+    if (!(ep->flags & (UCP_EP_FLAG_LOCAL_CONNECTED |
+                       UCP_EP_FLAG_LAZY_CONNECT))) {
         ucs_assert(!(ep->flags & UCP_EP_FLAG_CONNECT_REQ_QUEUED));
         status = ucp_wireup_send_request(ep);
         if (status != UCS_OK) {
@@ -819,6 +943,10 @@ ucs_status_t ucp_ep_create(ucp_worker_h worker, const ucp_ep_params_t *params,
 
     if (status == UCS_OK) {
         ucp_ep_update_flags(ep, UCP_EP_FLAG_USED, 0);
+        if ((flags & UCP_EP_PARAMS_FLAGS_AM_AGGREGATE) &&
+            (worker->context->config.features & UCP_FEATURE_AM)) {
+            ucp_ep_update_flags(ep, UCP_EP_FLAG_AM_AGGREGATE, 0);
+        }
         *ep_p = ep;
     }
 
@@ -1288,6 +1416,23 @@ static int ucp_ep_config_lane_is_equal(const ucp_ep_config_key_t *key1,
            (config_lane1->lane_types == config_lane2->lane_types);
 }
 
+khint_t ucp_ep_config_key_hash(const ucp_ep_config_key_t *key)
+{
+    khint_t hash;
+    ucp_lane_index_t lane;
+
+    /* Use only fields which are compared by ucp_ep_config_is_equal() */
+    hash = kh_int64_hash_func(key->reachable_md_map) ^
+           (key->num_lanes | (key->am_lane << 8) | (key->err_mode << 16));
+    for (lane = 0; lane < key->num_lanes; ++lane) {
+        hash = (hash * 31) + key->lanes[lane].rsc_index +
+               (key->lanes[lane].dst_md_index << 8) +
+               (key->lanes[lane].lane_types << 16);
+    }
+
+    return hash;
+}
+
 int ucp_ep_config_is_equal(const ucp_ep_config_key_t *key1,
                            const ucp_ep_config_key_t *key2)
 {
@@ -2070,6 +2215,16 @@ ucs_status_t ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config,
                 config->tag.rndv.am_thresh  = config->rndv.am_thresh;
                 config->tag.rndv.rma_thresh = config->rndv.rma_thresh;
 
+                if (context->config.ext.payload_checksum) {
+                    /* Leave room for the checksum after the eager header, and
+                     * don't use the inline path which can't carry it */
+                    config->tag.eager.max_short  = -1;
+                    config->tag.eager.max_bcopy -= sizeof(uint32_t);
+                    if (config->tag.eager.max_zcopy > 0) {
+                        config->tag.eager.max_zcopy -= sizeof(uint32_t);
+                    }
+                }
+
                 /* Max Eager short has to be set after Zcopy and RNDV thresholds */
                 ucp_ep_config_set_memtype_thresh(&config->tag.max_eager_short,
                                                  config->tag.eager.max_short,
@@ -2466,6 +2621,11 @@ void ucp_ep_print_info(ucp_ep_h ep, FILE *stream)
 
     ucp_ep_config_print(stream, worker, ep, NULL, aux_rsc_index);
     fprintf(stream, "#\n");
+    fprintf(stream, "#                  memory: %zu bytes per endpoint "
+            "(%u x %zu + %zu control)\n", ucp_worker_ep_memory_size(worker),
+            worker->ep_alloc.stride_count, worker->ep_alloc.elem_size,
+            ucs_mpool_elem_size(&worker->ep_control_mp));
+    fprintf(stream, "#\n");
 
     if (worker->context->config.ext.proto_enable) {
         ucs_string_buffer_init(&strb);
@@ -2692,7 +2852,8 @@ static void ucp_ep_req_purge(ucp_ep_h ucp_ep, ucp_request_t *req,
         ucp_request_id_release(req);
     }
 
-    if (req->flags & (UCP_REQUEST_FLAG_SEND_AM | UCP_REQUEST_FLAG_SEND_TAG)) {
+    if (req->flags & (UCP_REQUEST_FLAG_SEND_AM | UCP_REQUEST_FLAG_SEND_TAG |
+                      UCP_REQUEST_FLAG_SEND_STREAM)) {
         ucs_assert(req->super_req == NULL);
         ucs_assert(req->send.ep == ucp_ep);
         ucp_request_complete_and_dereg_send(req, status);
@@ -20,6 +20,7 @@
 #include <ucs/datastruct/strided_alloc.h>
 #include <ucs/debug/assert.h>
 #include <ucs/stats/stats.h>
+#include <ucs/time/timer_wheel.h>
 
 
 #define UCP_MAX_IOV                16UL
@@ -70,6 +71,9 @@ enum {
     UCP_EP_FLAG_STREAM_HAS_DATA        = UCS_BIT(5), /* EP has data in the ext.stream.match_q */
     UCP_EP_FLAG_ON_MATCH_CTX           = UCS_BIT(6), /* EP is on match queue */
     UCP_EP_FLAG_REMOTE_ID              = UCS_BIT(7), /* remote ID is valid */
+    UCP_EP_FLAG_LAZY_CONNECT           = UCS_BIT(8), /* Lanes are not created yet, the
+                                                        remote address is saved in
+                                                        control extension */
     UCP_EP_FLAG_CONNECT_PRE_REQ_QUEUED = UCS_BIT(9), /* Pre-Connection request was queued */
     UCP_EP_FLAG_CLOSED                 = UCS_BIT(10),/* EP was closed */
     UCP_EP_FLAG_CLOSE_REQ_VALID        = UCS_BIT(11),/* close protocol is started and
@@ -81,6 +85,8 @@ enum {
     UCP_EP_FLAG_INDIRECT_ID            = UCS_BIT(14),/* protocols on this endpoint will send
                                                         indirect endpoint id instead of pointer,
                                                         can be replaced with looking at local ID */
+    UCP_EP_FLAG_AM_AGGREGATE           = UCS_BIT(15),/* small active messages are aggregated,
+                                                        see UCP_EP_PARAMS_FLAGS_AM_AGGREGATE */
 
     /* DEBUG bits */
     UCP_EP_FLAG_CONNECT_REQ_SENT       = UCS_BIT(16),/* DEBUG: Connection request was sent */
@@ -378,7 +384,9 @@ typedef struct ucp_ep {
     ucp_lane_index_t              am_lane;       /* Cached value */
     ucp_ep_flags_t                flags;         /* Endpoint flags */
 
-    /* TODO allocate ep dynamically according to number of lanes */
+    /* Kept inline for all UCP_MAX_LANES: the extensions are located at fixed
+     * strides of sizeof(ucp_ep_t), and the endpoint can't be moved when it
+     * is reconfigured, since ucp_ep_h is held by the user */
     uct_ep_h                      uct_eps[UCP_MAX_LANES]; /* Transports for every lane */
 
 #if ENABLE_DEBUG_DATA
@@ -419,6 +427,15 @@ typedef struct {
 } ucp_ep_close_proto_req_t;
 
 
+/**
+ * Remote worker address of an endpoint whose wireup is deferred to first use
+ */
+typedef struct {
+    unsigned                 ep_init_flags; /* Endpoint initialization flags */
+    uint8_t                  address[0]; /* Packed remote worker address */
+} ucp_ep_lazy_connect_t;
+
+
 /**
  * Endpoint extension for control data path
  */
@@ -428,6 +445,13 @@ typedef struct {
     ucs_ptr_map_key_t        remote_ep_id; /* Remote EP ID */
     ucp_err_handler_cb_t     err_cb; /* Error handler */
     ucp_ep_close_proto_req_t close_req; /* Close protocol request */
+    struct {
+        ucs_wtimer_t         timer; /* Next keepalive in worker's wheel */
+        ucp_lane_map_t       lane_map; /* Lanes to retry after no-resources */
+        ucp_ep_h             ep; /* Endpoint to do keepalive on */
+    } keepalive;
+    ucp_ep_lazy_connect_t    *lazy_connect; /* Saved remote address, valid
+                                                   if UCP_EP_FLAG_LAZY_CONNECT */
 } ucp_ep_ext_control_t;
 
 
@@ -448,6 +472,8 @@ typedef struct {
     ucp_ep_ext_control_t          *control_ext;  /* Control data path extension */
     /* List of requests which are waiting for remote completion */
     ucs_hlist_head_t              proto_reqs;
+    /* Aggregate of small active messages which was not sent yet, or NULL */
+    struct ucp_am_agg_desc        *am_agg_desc;
 } ucp_ep_ext_gen_t;
 
 
@@ -459,6 +485,8 @@ typedef struct {
         ucs_list_link_t           ready_list;    /* List entry in worker's EP list */
         ucs_queue_head_t          match_q;       /* Queue of receive data or requests,
                                                     depends on UCP_EP_FLAG_STREAM_HAS_DATA */
+        ucs_queue_head_t          reorder_q;     /* Queue of receive data which waits
+                                                    for a rendezvous receive to complete */
     } stream;
 
     struct {
@@ -500,6 +528,7 @@ typedef struct ucp_conn_request {
     ucp_rsc_index_t             cm_idx;
     char                        dev_name[UCT_DEVICE_NAME_MAX];
     uct_device_addr_t           *remote_dev_addr;
+    size_t                      remote_dev_addr_len;
     struct sockaddr_storage     client_address;
     ucp_ep_h                    ep; /* valid only if request is handled internally */
     ucp_wireup_sockaddr_data_t  sa_data;
@@ -537,6 +566,10 @@ ucs_status_t ucp_worker_create_ep(ucp_worker_h worker, unsigned ep_init_flags,
 
 void ucp_ep_release_id(ucp_ep_h ep);
 
+ucs_status_t ucp_ep_lazy_connect(ucp_ep_h ep);
+
+void ucp_ep_lazy_connect_release(ucp_ep_h ep);
+
 ucs_status_t ucp_ep_init_create_wireup(ucp_ep_h ep, unsigned ep_init_flags,
                                        ucp_wireup_ep_t **wireup_ep);
 
@@ -591,6 +624,8 @@ void ucp_ep_config_lanes_intersect(const ucp_ep_config_key_t *key1,
                                    const ucp_rsc_index_t *dst_rsc_indices2,
                                    ucp_lane_index_t *lane_map);
 
+khint_t ucp_ep_config_key_hash(const ucp_ep_config_key_t *key);
+
 int ucp_ep_config_is_equal(const ucp_ep_config_key_t *key1,
                            const ucp_ep_config_key_t *key2);
 
@@ -21,7 +21,7 @@
 static inline ucp_ep_config_t *ucp_ep_config(ucp_ep_h ep)
 {
     ucs_assert(ep->cfg_index != UCP_WORKER_CFG_INDEX_NULL);
-    return &ep->worker->ep_config[ep->cfg_index];
+    return ucp_worker_ep_config(ep->worker, ep->cfg_index);
 }
 
 static inline ucp_lane_index_t ucp_ep_get_am_lane(ucp_ep_h ep)
@@ -199,6 +199,19 @@ ucp_ep_resolve_remote_id(ucp_ep_h ep, ucp_lane_index_t lane)
     return ucp_wireup_connect_remote(ep, lane);
 }
 
+/*
+ * Create the transport lanes of an endpoint which was created with
+ * UCP_EP_PARAMS_FLAGS_LAZY_CONNECT, when it is used for the first time.
+ */
+static UCS_F_ALWAYS_INLINE ucs_status_t ucp_ep_resolve_lazy_connect(ucp_ep_h ep)
+{
+    if (ucs_likely(!(ep->flags & UCP_EP_FLAG_LAZY_CONNECT))) {
+        return UCS_OK;
+    }
+
+    return ucp_ep_lazy_connect(ep);
+}
+
 static inline void ucp_ep_update_remote_id(ucp_ep_h ep,
                                            ucs_ptr_map_key_t remote_id)
 {
@@ -644,21 +644,46 @@ ucp_mpool_malloc(ucp_worker_h worker, ucs_mpool_t *mp, size_t *size_p, void **ch
     ucp_mem_h memh;
     ucs_status_t status;
     ucp_mem_map_params_t mem_params;
+    size_t length;
+    void *address;
+    int is_allocate;
 
     /* Need to get default flags from ucp_mem_map_params2uct_flags() */
     mem_params.field_mask = 0;
-    status = ucp_mem_map_common(worker->context, NULL,
-                                *size_p + sizeof(*chunk_hdr), UCS_MEMORY_TYPE_HOST,
+    length                = *size_p + sizeof(*chunk_hdr);
+
+    if (ucs_mpool_chunk_placement_is_set(mp)) {
+        /* Allocate the chunk according to the placement and only register it,
+         * since UCT allocation methods do not control NUMA placement */
+        status = ucs_mpool_chunk_mmap(mp, &length, &address);
+        if (status != UCS_OK) {
+            goto out;
+        }
+
+        is_allocate = 0;
+    } else {
+        address     = NULL;
+        is_allocate = 1;
+    }
+
+    status = ucp_mem_map_common(worker->context, address, length,
+                                UCS_MEMORY_TYPE_HOST,
                                 ucp_mem_map_params2uct_flags(&mem_params),
-                                1, ucs_mpool_name(mp), &memh);
+                                is_allocate, ucs_mpool_name(mp), &memh);
     if (status != UCS_OK) {
-        goto out;
+        goto err_munmap;
     }
 
     chunk_hdr       = memh->address;
     chunk_hdr->memh = memh;
     *chunk_p        = chunk_hdr + 1;
     *size_p         = memh->length - sizeof(*chunk_hdr);
+    return UCS_OK;
+
+err_munmap:
+    if (!is_allocate) {
+        ucs_mpool_chunk_munmap(mp, address);
+    }
 out:
     return status;
 }
@@ -667,9 +692,14 @@ static inline void
 ucp_mpool_free(ucp_worker_h worker, ucs_mpool_t *mp, void *chunk)
 {
     ucp_mem_desc_t *chunk_hdr;
+    int is_allocated;
 
-    chunk_hdr = (ucp_mem_desc_t*)chunk - 1;
+    chunk_hdr    = (ucp_mem_desc_t*)chunk - 1;
+    is_allocated = (chunk_hdr->memh->alloc_method != UCT_ALLOC_METHOD_LAST);
     ucp_mem_unmap_common(worker->context, chunk_hdr->memh);
+    if (!is_allocated) {
+        ucs_mpool_chunk_munmap(mp, chunk_hdr);
+    }
 }
 
 void ucp_mpool_obj_init(ucs_mpool_t *mp, void *obj, void *chunk)
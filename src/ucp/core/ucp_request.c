@@ -241,6 +241,18 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_request_memory_reg,
         ucp_trace_req(req_dbg, "mem reg md_map 0x%"PRIx64"/0x%"PRIx64,
                       state->dt.contig.md_map, md_map);
         break;
+    case UCP_DATATYPE_STRIDED:
+        /* Register the whole memory region which contains the data */
+        ucs_assert(ucs_popcount(md_map) <= UCP_MAX_OP_MDS);
+        status = ucp_mem_rereg_mds(context, md_map, buffer,
+                                   ucp_dt_strided_span(
+                                           ucp_dt_to_strided(datatype), length),
+                                   flags, NULL, mem_type, NULL,
+                                   state->dt.contig.memh,
+                                   &state->dt.contig.md_map);
+        ucp_trace_req(req_dbg, "mem reg strided md_map 0x%"PRIx64"/0x%"PRIx64,
+                      state->dt.contig.md_map, md_map);
+        break;
     case UCP_DATATYPE_IOV:
         iovcnt = state->dt.iov.iovcnt;
         iov    = buffer;
@@ -296,6 +308,7 @@ UCS_PROFILE_FUNC_VOID(ucp_request_memory_dereg, (context, datatype, state, req_d
 
     switch (datatype & UCP_DATATYPE_CLASS_MASK) {
     case UCP_DATATYPE_CONTIG:
+    case UCP_DATATYPE_STRIDED:
         ucp_request_dt_dereg(context, &state->dt.contig, 1, req_dbg);
         break;
     case UCP_DATATYPE_IOV:
@@ -391,6 +404,10 @@ ucp_request_send_start(ucp_request_t *req, ssize_t max_short,
                 multi = ucp_dt_iov_count_nonempty(req->send.buffer, dt_count) >
                         (msg_config->max_iov - priv_iov_count);
             }
+        } else if (UCP_DT_IS_STRIDED(req->send.datatype)) {
+            multi = ucp_dt_strided_block_count(
+                            ucp_dt_to_strided(req->send.datatype), 0, length) >
+                    (msg_config->max_iov - priv_iov_count);
         } else {
             multi = 0;
         }
@@ -439,6 +456,40 @@ void ucp_request_send_state_ff(ucp_request_t *req, ucs_status_t status)
     }
 }
 
+ucs_status_t ucp_request_csum_verify(ucp_tag_t tag, size_t length,
+                                     uint32_t csum, uint32_t expected)
+{
+    if (csum != expected) {
+        ucs_diag("payload checksum mismatch: tag 0x%"PRIx64" length %zu "
+                 "received 0x%08x expected 0x%08x", tag, length, csum,
+                 expected);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    return UCS_OK;
+}
+
+ucs_status_t ucp_request_recv_csum_check(ucp_request_t *req)
+{
+    size_t length = req->recv.tag.info.length;
+    uint32_t csum;
+
+    ucs_assert(req->flags & UCP_REQUEST_FLAG_CSUM);
+
+    if (!UCP_MEM_IS_HOST(req->recv.mem_type) ||
+        !(UCP_DT_IS_CONTIG(req->recv.datatype) ||
+          UCP_DT_IS_IOV(req->recv.datatype))) {
+        ucp_trace_req(req, "payload checksum not verified for datatype 0x%"
+                      PRIx64" mem_type %s", req->recv.datatype,
+                      ucs_memory_type_names[req->recv.mem_type]);
+        return UCS_OK;
+    }
+
+    csum = ucp_dt_crc32c(req->recv.datatype, req->recv.buffer, length);
+    return ucp_request_csum_verify(req->recv.tag.info.sender_tag, length, csum,
+                                   req->recv.tag.csum);
+}
+
 ucs_status_t ucp_request_recv_msg_truncated(ucp_request_t *req, size_t length,
                                             size_t offset)
 {
@@ -45,6 +45,7 @@ enum {
     UCP_REQUEST_FLAG_CALLBACK             = UCS_BIT(6),
     UCP_REQUEST_FLAG_PROTO_INITIALIZED    = UCS_BIT(7),
     UCP_REQUEST_FLAG_SYNC                 = UCS_BIT(8),
+    UCP_REQUEST_FLAG_CSUM                 = UCS_BIT(9),
     UCP_REQUEST_FLAG_OFFLOADED            = UCS_BIT(10),
     UCP_REQUEST_FLAG_BLOCK_OFFLOAD        = UCS_BIT(11),
     UCP_REQUEST_FLAG_STREAM_RECV_WAITALL  = UCS_BIT(12),
@@ -53,9 +54,10 @@ enum {
     UCP_REQUEST_FLAG_RNDV_FRAG            = UCS_BIT(15),
     UCP_REQUEST_FLAG_RECV_AM              = UCS_BIT(16),
     UCP_REQUEST_FLAG_RECV_TAG             = UCS_BIT(17),
+    UCP_REQUEST_FLAG_SEND_STREAM          = UCS_BIT(18),
 #if UCS_ENABLE_ASSERT
-    UCP_REQUEST_FLAG_STREAM_RECV          = UCS_BIT(18),
-    UCP_REQUEST_DEBUG_FLAG_EXTERNAL       = UCS_BIT(19)
+    UCP_REQUEST_FLAG_STREAM_RECV          = UCS_BIT(19),
+    UCP_REQUEST_DEBUG_FLAG_EXTERNAL       = UCS_BIT(20)
 #else
     UCP_REQUEST_FLAG_STREAM_RECV          = 0,
     UCP_REQUEST_DEBUG_FLAG_EXTERNAL       = 0
@@ -92,10 +94,14 @@ enum {
     UCP_RECV_DESC_FLAG_MALLOC           = UCS_BIT(8), /* Descriptor was allocated with malloc
                                                          and must be freed, not returned to the
                                                          memory pool or UCT */
-    UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS = UCS_BIT(9)  /* Descriptor should not be released,
+    UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS = UCS_BIT(9), /* Descriptor should not be released,
                                                          because UCT AM callback is still in
                                                          the call stack and descriptor is not
                                                          initialized yet. */
+    UCP_RECV_DESC_FLAG_EAGER_CSUM       = UCS_BIT(10),/* Eager tag message header is followed
+                                                         by a payload checksum */
+    UCP_RECV_DESC_FLAG_AM_USER_BUFFER   = UCS_BIT(11) /* AM data is assembled in a buffer
+                                                         provided by the user */
 };
 
 
@@ -336,6 +342,10 @@ struct ucp_request {
                     ucp_worker_iface_t      *wiface;    /* Cached iface this request
                                                            is received on. Used in
                                                            tag offload expected callbacks*/
+                    uint32_t                csum;       /* Payload checksum sent by
+                                                           the peer, valid if
+                                                           UCP_REQUEST_FLAG_CSUM
+                                                           is set */
                 } tag;
 
                 struct {
@@ -446,6 +456,11 @@ ucs_status_t ucp_request_send_start(ucp_request_t *req, ssize_t max_short,
 /* Fast-forward to data end */
 void ucp_request_send_state_ff(ucp_request_t *req, ucs_status_t status);
 
+ucs_status_t ucp_request_csum_verify(ucp_tag_t tag, size_t length,
+                                     uint32_t csum, uint32_t expected);
+
+ucs_status_t ucp_request_recv_csum_check(ucp_request_t *req);
+
 ucs_status_t ucp_request_recv_msg_truncated(ucp_request_t *req, size_t length,
                                             size_t offset);
 
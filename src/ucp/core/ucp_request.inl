@@ -14,6 +14,7 @@
 
 #include <ucp/core/ucp_worker.h>
 #include <ucp/dt/dt.h>
+#include <ucp/rndv/rndv.h>
 #include <ucs/profile/profile.h>
 #include <ucs/datastruct/mpool.inl>
 #include <ucs/datastruct/ptr_map.inl>
@@ -198,6 +199,11 @@ ucp_request_complete_send(ucp_request_t *req, ucs_status_t status)
 static UCS_F_ALWAYS_INLINE void
 ucp_request_complete_tag_recv(ucp_request_t *req, ucs_status_t status)
 {
+    if (ucs_unlikely(req->flags & UCP_REQUEST_FLAG_CSUM) &&
+        (status == UCS_OK)) {
+        status = ucp_request_recv_csum_check(req);
+    }
+
     ucs_trace_req("completing receive request %p (%p) " UCP_REQUEST_FLAGS_FMT
                   " stag 0x%" PRIx64" len %zu, %s",
                   req, req + 1, UCP_REQUEST_FLAGS_ARG(req->flags),
@@ -328,6 +334,10 @@ void ucp_request_send_generic_dt_finish(ucp_request_t *req)
     if (UCP_DT_IS_GENERIC(req->send.datatype)) {
         dt = ucp_dt_to_generic(req->send.datatype);
         ucs_assert(NULL != dt);
+        if (req->send.state.dt.dt.generic.pack_job != NULL) {
+            ucp_dt_generic_pack_job_destroy(
+                    req->send.state.dt.dt.generic.pack_job);
+        }
         dt->ops.finish(req->send.state.dt.dt.generic.state);
     }
 }
@@ -347,6 +357,7 @@ static UCS_F_ALWAYS_INLINE void
 ucp_request_send_state_init(ucp_request_t *req, ucp_datatype_t datatype,
                             size_t dt_count)
 {
+    ucp_context_h    context;
     ucp_dt_generic_t *dt_gen;
     void             *state_gen;
 
@@ -359,6 +370,8 @@ ucp_request_send_state_init(ucp_request_t *req, ucp_datatype_t datatype,
 
     switch (datatype & UCP_DATATYPE_CLASS_MASK) {
     case UCP_DATATYPE_CONTIG:
+    case UCP_DATATYPE_STRIDED:
+        /* Strided buffer is registered as a whole, like a contiguous one */
         req->send.state.dt.dt.contig.md_map     = 0;
         return;
     case UCP_DATATYPE_IOV:
@@ -372,6 +385,11 @@ ucp_request_send_state_init(ucp_request_t *req, ucp_datatype_t datatype,
         state_gen = dt_gen->ops.start_pack(dt_gen->context, req->send.buffer,
                                            dt_count);
         req->send.state.dt.dt.generic.state = state_gen;
+        context   = req->send.ep->worker->context;
+        req->send.state.dt.dt.generic.pack_job =
+                ucp_dt_generic_pack_job_start(
+                        context->dt_generic_pool, dt_gen, state_gen,
+                        context->config.ext.generic_dt_pack_thresh);
         return;
     default:
         ucs_fatal("Invalid data type");
@@ -517,7 +535,8 @@ ucp_send_request_add_reg_lane(ucp_request_t *req, ucp_lane_index_t lane)
     /* Add new lane to registration map */
     ucp_md_map_t md_map;
 
-    if (ucs_likely(UCP_DT_IS_CONTIG(req->send.datatype))) {
+    if (ucs_likely(UCP_DT_IS_CONTIG(req->send.datatype)) ||
+        UCP_DT_IS_STRIDED(req->send.datatype)) {
         md_map = req->send.state.dt.dt.contig.md_map;
     } else if (UCP_DT_IS_IOV(req->send.datatype) &&
                (req->send.state.dt.dt.iov.dt_reg != NULL)) {
@@ -566,13 +585,31 @@ ucp_request_wait_uct_comp(ucp_request_t *req)
     }
 }
 
+/**
+ * Length of the whole message received to the request, or the receive buffer
+ * length if it is not known (stream receive).
+ */
+static UCS_F_ALWAYS_INLINE size_t
+ucp_request_recv_msg_length(const ucp_request_t *req)
+{
+    if (req->flags & UCP_REQUEST_FLAG_RECV_TAG) {
+        return req->recv.tag.info.length;
+    } else if (req->flags & UCP_REQUEST_FLAG_RECV_AM) {
+        /* AM receive requests get the data of a rendezvous RTS */
+        return ((const ucp_rndv_rts_hdr_t*)(req->recv.am.desc + 1))->size;
+    }
+
+    return req->recv.length;
+}
+
 static UCS_F_ALWAYS_INLINE void
 ucp_request_unpack_contig(ucp_request_t *req, void *buf, const void *data,
-                          size_t length)
+                          size_t length, size_t total_length)
 {
     if (ucs_likely(UCP_MEM_IS_ACCESSIBLE_FROM_CPU(req->recv.mem_type))) {
         UCS_PROFILE_NAMED_CALL("memcpy_recv", ucs_memcpy_relaxed, buf,
-                               data, length);
+                               data, length, UCS_ARCH_MEMCPY_NT_SOURCE,
+                               total_length);
     } else {
         ucp_mem_type_unpack(req->recv.worker, buf, data, length,
                             req->recv.mem_type);
@@ -610,7 +647,8 @@ ucp_request_recv_data_unpack(ucp_request_t *req, const void *data,
     case UCP_DATATYPE_CONTIG:
         ucp_request_unpack_contig(req,
                                   UCS_PTR_BYTE_OFFSET(req->recv.buffer, offset),
-                                  data, length);
+                                  data, length,
+                                  ucp_request_recv_msg_length(req));
         return UCS_OK;
 
     case UCP_DATATYPE_IOV:
@@ -629,6 +667,12 @@ ucp_request_recv_data_unpack(ucp_request_t *req, const void *data,
         req->recv.state.offset += length;
         return UCS_OK;
 
+    case UCP_DATATYPE_STRIDED:
+        UCS_PROFILE_CALL_VOID(ucp_dt_strided_unpack,
+                              ucp_dt_to_strided(req->recv.datatype),
+                              req->recv.buffer, offset, data, length);
+        return UCS_OK;
+
     case UCP_DATATYPE_GENERIC:
         dt_gen = ucp_dt_to_generic(req->recv.datatype);
         status = UCS_PROFILE_NAMED_CALL("dt_unpack", dt_gen->ops.unpack,
@@ -189,6 +189,12 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_ep_rkey_unpack, (ep, rkey_buffer, rkey_p),
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
+    /* Remote key is resolved according to endpoint lanes */
+    status = ucp_ep_resolve_lazy_connect(ep);
+    if (ucs_unlikely(status != UCS_OK)) {
+        goto out_unlock;
+    }
+
     ep_config = ucp_ep_config(ep);
 
     /* Count the number of remote MDs in the rkey buffer */
@@ -0,0 +1,1342 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "ucp_shared_iface.h"
+#include "ucp_context.h"
+#include "ucp_worker.h"
+
+#include <ucs/arch/atomic.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
+#include <ucs/sys/string.h>
+
+
+/* Size of the destination interface index which ends every message */
+#define UCP_SHARED_IFACE_ID_SIZE  sizeof(uint8_t)
+
+/* Capabilities of the transport interface which are exposed to the workers */
+#define UCP_SHARED_IFACE_CAP_FLAGS \
+    (UCT_IFACE_FLAG_AM_SHORT              | \
+     UCT_IFACE_FLAG_AM_BCOPY              | \
+     UCT_IFACE_FLAG_PENDING               | \
+     UCT_IFACE_FLAG_CONNECT_TO_IFACE      | \
+     UCT_IFACE_FLAG_EP_CHECK              | \
+     UCT_IFACE_FLAG_EP_KEEPALIVE          | \
+     UCT_IFACE_FLAG_AM_DUP                | \
+     UCT_IFACE_FLAG_CB_SYNC               | \
+     UCT_IFACE_FLAG_CB_ASYNC              | \
+     UCT_IFACE_FLAG_ERRHANDLE_SHORT_BUF   | \
+     UCT_IFACE_FLAG_ERRHANDLE_BCOPY_BUF   | \
+     UCT_IFACE_FLAG_ERRHANDLE_AM_ID       | \
+     UCT_IFACE_FLAG_ERRHANDLE_BCOPY_LEN   | \
+     UCT_IFACE_FLAG_ERRHANDLE_PEER_FAILURE)
+
+
+enum {
+    UCP_SHARED_CONN_FLAG_MATCH = UCS_BIT(0) /* Connection is in the matching
+                                               context, so new endpoints to the
+                                               same interface can use it */
+};
+
+
+typedef enum {
+    UCP_SHARED_EVENT_AM,    /* Received active message */
+    UCP_SHARED_EVENT_COMP,  /* Completed flush operation */
+    UCP_SHARED_EVENT_ERROR  /* Failed transport endpoint */
+} ucp_shared_event_type_t;
+
+
+/**
+ * Event which is added to the queue of a worker interface by the shared
+ * interface, and dispatched by the worker's progress.
+ */
+typedef struct {
+    ucs_queue_elem_t          queue;       /* Element in the event queue */
+    ucp_shared_ep_t           *ep;         /* Endpoint of COMP and ERROR */
+    ucs_status_t              status;      /* Status of COMP and ERROR */
+    unsigned                  length;      /* Length of AM data */
+    uint8_t                   type;        /* Event type */
+    uint8_t                   am_id;       /* Active message id */
+} ucp_shared_iface_event_t;
+
+
+/**
+ * Copy of a received message, or the headroom of a transport descriptor which
+ * holds it. It is followed by the receive headroom which was requested by the
+ * worker, and the message data.
+ */
+typedef struct {
+    ucp_shared_iface_event_t  event;
+    uct_recv_desc_t           *release_desc; /* Must be right before headroom */
+} ucp_shared_rx_desc_t;
+
+
+/**
+ * Flush completion of a transport endpoint.
+ */
+typedef struct {
+    uct_completion_t          super;
+    ucp_shared_iface_event_t  event;       /* Added when flush is completed, ep
+                                              is NULL if the endpoint was
+                                              destroyed */
+    uct_completion_t          *comp;       /* User completion */
+    ucs_list_link_t           list;        /* Element in connection completions */
+} ucp_shared_comp_t;
+
+
+/**
+ * Pack callback argument for bcopy messages.
+ */
+typedef struct {
+    uct_pack_callback_t       pack_cb;
+    void                      *arg;
+    uint8_t                   remote_id;
+} ucp_shared_pack_arg_t;
+
+
+static void ucp_shared_iface_close(uct_iface_h tl_iface);
+
+
+static UCS_F_ALWAYS_INLINE ucp_shared_iface_t *
+ucp_shared_ep_iface(ucp_shared_ep_t *ep)
+{
+    return ucs_derived_of(ep->super.super.iface, ucp_shared_iface_t);
+}
+
+static UCS_F_ALWAYS_INLINE void *
+ucp_shared_rx_desc_data(ucp_shared_tl_t *tl, ucp_shared_rx_desc_t *rx_desc)
+{
+    return UCS_PTR_BYTE_OFFSET(rx_desc + 1, tl->rx_headroom);
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_shared_rx_desc_put(ucp_shared_rx_desc_t *rx_desc)
+{
+    uct_iface_release_desc(rx_desc + 1);
+}
+
+static void ucp_shared_tl_release_desc(uct_recv_desc_t *self, void *desc)
+{
+    ucp_shared_tl_t *tl = ucs_container_of(self, ucp_shared_tl_t,
+                                           release_desc);
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    ucs_mpool_put_inline((ucp_shared_rx_desc_t*)desc - 1);
+    UCS_ASYNC_UNBLOCK(&tl->async);
+}
+
+static void ucp_shared_tl_release_uct_desc(uct_recv_desc_t *self, void *desc)
+{
+    ucp_shared_tl_t *tl = ucs_container_of(self, ucp_shared_tl_t,
+                                           uct_release_desc);
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    uct_iface_release_desc((ucp_shared_rx_desc_t*)desc - 1);
+    UCS_ASYNC_UNBLOCK(&tl->async);
+}
+
+static void ucp_shared_rx_desc_init(ucs_mpool_t *mp, void *obj, void *chunk)
+{
+    ucp_shared_tl_t *tl           = ucs_container_of(mp, ucp_shared_tl_t,
+                                                     rx_mp);
+    ucp_shared_rx_desc_t *rx_desc = obj;
+
+    rx_desc->release_desc = &tl->release_desc;
+}
+
+static ucs_mpool_ops_t ucp_shared_rx_mpool_ops = {
+    .chunk_alloc   = ucs_mpool_chunk_malloc,
+    .chunk_release = ucs_mpool_chunk_free,
+    .obj_init      = ucp_shared_rx_desc_init,
+    .obj_cleanup   = NULL
+};
+
+static void ucp_shared_iface_event_release(ucp_shared_iface_event_t *event)
+{
+    switch (event->type) {
+    case UCP_SHARED_EVENT_AM:
+        ucp_shared_rx_desc_put(ucs_container_of(event, ucp_shared_rx_desc_t,
+                                                event));
+        break;
+    case UCP_SHARED_EVENT_COMP:
+        ucs_free(ucs_container_of(event, ucp_shared_comp_t, event));
+        break;
+    default:
+        ucs_free(event);
+        break;
+    }
+}
+
+/* Remove the completion and error events of an endpoint from a queue */
+static void ucp_shared_iface_purge_events(ucs_queue_head_t *queue,
+                                          ucp_shared_ep_t *ep)
+{
+    ucp_shared_iface_event_t *event;
+    ucs_queue_iter_t iter;
+
+    ucs_queue_for_each_safe(event, iter, queue, queue) {
+        if ((event->type != UCP_SHARED_EVENT_AM) && (event->ep == ep)) {
+            ucs_queue_del_iter(queue, iter);
+            ucp_shared_iface_event_release(event);
+        }
+    }
+}
+
+/* Called with the shared async blocked */
+static void ucp_shared_iface_event_push(ucp_shared_iface_t *iface,
+                                        ucp_shared_iface_event_t *event)
+{
+    ucs_queue_push(&iface->event_q, &event->queue);
+    ucs_atomic_add32(&iface->num_events, 1);
+}
+
+static ucs_status_t ucp_shared_tl_am_handler(void *arg, void *data,
+                                             size_t length, unsigned flags)
+{
+    ucp_shared_tl_am_arg_t *am_arg = arg;
+    ucp_shared_tl_t *tl            = am_arg->tl;
+    ucs_status_t status            = UCS_OK;
+    ucp_shared_rx_desc_t *rx_desc;
+    ucp_shared_iface_t *iface;
+    uint8_t iface_id;
+
+    if (ucs_unlikely(length < UCP_SHARED_IFACE_ID_SIZE)) {
+        ucs_error("shared iface %p: dropping message with id %d and "
+                  "invalid length %zu", tl->uct_iface, am_arg->am_id, length);
+        return UCS_OK;
+    }
+
+    length  -= UCP_SHARED_IFACE_ID_SIZE;
+    iface_id = *(uint8_t*)UCS_PTR_BYTE_OFFSET(data, length);
+
+    UCS_ASYNC_BLOCK(&tl->async);
+
+    iface = tl->ifaces[iface_id];
+    if (iface == NULL) {
+        ucs_trace_data("shared iface %p: dropping message with id %d to "
+                       "closed iface %d", tl->uct_iface, am_arg->am_id,
+                       iface_id);
+        goto out;
+    }
+
+    rx_desc = ucs_mpool_get_inline(&tl->rx_mp);
+    if (ucs_likely(rx_desc != NULL)) {
+        memcpy(ucp_shared_rx_desc_data(tl, rx_desc), data, length);
+    } else if (flags & UCT_CB_PARAM_FLAG_DESC) {
+        /* Hold the transport descriptor, its headroom has room for the
+         * event and the headroom of the worker */
+        rx_desc               = UCS_PTR_BYTE_OFFSET(data,
+                                                    -(ptrdiff_t)
+                                                    (sizeof(*rx_desc) +
+                                                     tl->rx_headroom));
+        rx_desc->release_desc = &tl->uct_release_desc;
+        status                = UCS_INPROGRESS;
+    } else {
+        ucs_fatal("shared iface %p: failed to allocate receive descriptor",
+                  tl->uct_iface);
+    }
+
+    rx_desc->event.ep     = NULL;
+    rx_desc->event.status = UCS_OK;
+    rx_desc->event.length = length;
+    rx_desc->event.type   = UCP_SHARED_EVENT_AM;
+    rx_desc->event.am_id  = am_arg->am_id;
+    ucp_shared_iface_event_push(iface, &rx_desc->event);
+
+out:
+    UCS_ASYNC_UNBLOCK(&tl->async);
+    return status;
+}
+
+static ucs_status_t
+ucp_shared_tl_err_handler(void *arg, uct_ep_h uct_ep, ucs_status_t status)
+{
+    ucp_shared_tl_t *tl = arg;
+    ucp_shared_iface_event_t *event;
+    ucp_shared_conn_t *conn;
+    ucp_shared_ep_t *ep;
+
+    UCS_ASYNC_BLOCK(&tl->async);
+
+    ucs_list_for_each(conn, &tl->conns, list) {
+        if (conn->uct_ep == uct_ep) {
+            goto found;
+        }
+    }
+
+    ucs_debug("shared iface %p: ignoring error on unknown ep %p: %s",
+              tl->uct_iface, uct_ep, ucs_status_string(status));
+    goto out;
+
+found:
+    /* New endpoints should not use the failed connection */
+    if (conn->flags & UCP_SHARED_CONN_FLAG_MATCH) {
+        ucs_conn_match_remove_elem(&tl->conn_match, &conn->elem,
+                                   UCS_CONN_MATCH_QUEUE_EXP);
+        conn->flags &= ~UCP_SHARED_CONN_FLAG_MATCH;
+    }
+
+    ucs_list_for_each(ep, &conn->eps, list) {
+        event = ucs_malloc(sizeof(*event), "ucp_shared_event");
+        if (event == NULL) {
+            ucs_error("failed to allocate error event for ep %p", ep);
+            continue;
+        }
+
+        event->ep     = ep;
+        event->status = status;
+        event->length = 0;
+        event->type   = UCP_SHARED_EVENT_ERROR;
+        event->am_id  = 0;
+        ucp_shared_iface_event_push(ucp_shared_ep_iface(ep), event);
+    }
+
+out:
+    UCS_ASYNC_UNBLOCK(&tl->async);
+    return UCS_OK;
+}
+
+static void ucp_shared_comp_handler(uct_completion_t *self)
+{
+    ucp_shared_comp_t *scomp = ucs_container_of(self, ucp_shared_comp_t,
+                                                super);
+    ucp_shared_ep_t *ep      = scomp->event.ep;
+
+    ucs_list_del(&scomp->list);
+    if (ep == NULL) {
+        ucs_free(scomp);
+        return;
+    }
+
+    scomp->event.status = self->status;
+    ucp_shared_iface_event_push(ucp_shared_ep_iface(ep), &scomp->event);
+}
+
+static const void *
+ucp_shared_conn_get_address(const ucs_conn_match_elem_t *elem)
+{
+    return ucs_container_of(elem, ucp_shared_conn_t, elem)->address;
+}
+
+static ucs_conn_sn_t
+ucp_shared_conn_get_sn(const ucs_conn_match_elem_t *elem)
+{
+    return ucs_container_of(elem, ucp_shared_conn_t, elem)->path_index;
+}
+
+static const char *
+ucp_shared_conn_address_str(const ucs_conn_match_ctx_t *conn_match_ctx,
+                            const void *address, char *str, size_t max_size)
+{
+    return ucs_str_dump_hex(address, conn_match_ctx->address_length, str,
+                            max_size, SIZE_MAX);
+}
+
+static const ucs_conn_match_ops_t ucp_shared_conn_match_ops = {
+    .get_address = ucp_shared_conn_get_address,
+    .get_conn_sn = ucp_shared_conn_get_sn,
+    .address_str = ucp_shared_conn_address_str,
+    .purge_cb    = NULL
+};
+
+/* Called with the shared async blocked */
+static ucs_status_t ucp_shared_conn_get(ucp_shared_tl_t *tl,
+                                        const uct_ep_params_t *params,
+                                        ucp_shared_conn_t **conn_p)
+{
+    ucs_conn_sn_t path_index = UCT_EP_PARAMS_GET_PATH_INDEX(params);
+    size_t address_length    = tl->conn_match.address_length;
+    uint8_t *address;
+    ucs_conn_match_elem_t *elem;
+    uct_ep_params_t ep_params;
+    ucp_shared_conn_t *conn;
+    ucs_status_t status;
+
+    ep_params       = *params;
+    ep_params.iface = tl->uct_iface;
+
+    /* Endpoints to the same remote interface share the transport endpoint,
+     * since every message carries the destination interface */
+    address = ucs_alloca(address_length);
+    memcpy(address, params->dev_addr, tl->attr.device_addr_len);
+    memcpy(UCS_PTR_BYTE_OFFSET(address, tl->attr.device_addr_len),
+           params->iface_addr, tl->attr.iface_addr_len);
+
+    elem = ucs_conn_match_get_elem(&tl->conn_match, address, path_index,
+                                   UCS_CONN_MATCH_QUEUE_EXP, 0);
+    if (elem != NULL) {
+        conn = ucs_container_of(elem, ucp_shared_conn_t, elem);
+        ++conn->refcount;
+        *conn_p = conn;
+        return UCS_OK;
+    }
+
+    conn = ucs_malloc(sizeof(*conn) + address_length, "ucp_shared_conn");
+    if (conn == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    status = uct_ep_create(&ep_params, &conn->uct_ep);
+    if (status != UCS_OK) {
+        ucs_free(conn);
+        return status;
+    }
+
+    ucs_list_head_init(&conn->eps);
+    ucs_list_head_init(&conn->comps);
+    conn->refcount   = 1;
+    conn->flags      = 0;
+    conn->path_index = path_index;
+    memcpy(conn->address, address, address_length);
+    ucs_conn_match_insert(&tl->conn_match, conn->address, path_index,
+                          &conn->elem, UCS_CONN_MATCH_QUEUE_EXP);
+    conn->flags |= UCP_SHARED_CONN_FLAG_MATCH;
+
+    ucs_list_add_tail(&tl->conns, &conn->list);
+    *conn_p = conn;
+    return UCS_OK;
+}
+
+/* Called with the shared async blocked */
+static void ucp_shared_conn_put(ucp_shared_tl_t *tl, ucp_shared_conn_t *conn)
+{
+    ucp_shared_comp_t *scomp, *tmp;
+
+    if (--conn->refcount > 0) {
+        return;
+    }
+
+    if (conn->flags & UCP_SHARED_CONN_FLAG_MATCH) {
+        ucs_conn_match_remove_elem(&tl->conn_match, &conn->elem,
+                                   UCS_CONN_MATCH_QUEUE_EXP);
+    }
+
+    ucs_list_del(&conn->list);
+    uct_ep_destroy(conn->uct_ep);
+
+    /* Completions of canceled operations which were not called */
+    ucs_list_for_each_safe(scomp, tmp, &conn->comps, list) {
+        ucs_assert(scomp->event.ep == NULL);
+        ucs_list_del(&scomp->list);
+        ucs_free(scomp);
+    }
+
+    ucs_free(conn);
+}
+
+static UCS_F_ALWAYS_INLINE int ucp_shared_ep_is_blocked(ucp_shared_ep_t *ep)
+{
+    /* Keep the order with pending requests, unless called by one of them */
+    return !ucs_arbiter_group_is_empty(&ep->arb_group) &&
+           (ucp_shared_ep_iface(ep)->pending_ep != ep);
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_shared_iov_set(uct_iov_t *iov, const void *buffer, size_t length)
+{
+    iov->buffer = (void*)buffer;
+    iov->length = length;
+    iov->memh   = UCT_MEM_HANDLE_NULL;
+    iov->stride = 0;
+    iov->count  = 1;
+}
+
+static ucs_status_t ucp_shared_ep_am_short(uct_ep_h tl_ep, uint8_t id,
+                                           uint64_t header,
+                                           const void *payload,
+                                           unsigned length)
+{
+    ucp_shared_ep_t *ep = ucs_derived_of(tl_ep, ucp_shared_ep_t);
+    ucp_shared_tl_t *tl = ucp_shared_ep_iface(ep)->tl;
+    uct_iov_t iov[3];
+    ucs_status_t status;
+
+    if (ucp_shared_ep_is_blocked(ep)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    ucp_shared_iov_set(&iov[0], &header, sizeof(header));
+    ucp_shared_iov_set(&iov[1], payload, length);
+    ucp_shared_iov_set(&iov[2], &ep->remote_id, UCP_SHARED_IFACE_ID_SIZE);
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    status = uct_ep_am_short_iov(ep->conn->uct_ep, id, iov, 3);
+    UCS_ASYNC_UNBLOCK(&tl->async);
+
+    return status;
+}
+
+static ucs_status_t ucp_shared_ep_am_short_iov(uct_ep_h tl_ep, uint8_t id,
+                                               const uct_iov_t *iov,
+                                               size_t iovcnt)
+{
+    ucp_shared_ep_t *ep = ucs_derived_of(tl_ep, ucp_shared_ep_t);
+    ucp_shared_tl_t *tl = ucp_shared_ep_iface(ep)->tl;
+    uct_iov_t *shared_iov;
+    ucs_status_t status;
+
+    if (ucp_shared_ep_is_blocked(ep)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    shared_iov = ucs_alloca((iovcnt + 1) * sizeof(*shared_iov));
+    memcpy(shared_iov, iov, iovcnt * sizeof(*shared_iov));
+    ucp_shared_iov_set(&shared_iov[iovcnt], &ep->remote_id,
+                       UCP_SHARED_IFACE_ID_SIZE);
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    status = uct_ep_am_short_iov(ep->conn->uct_ep, id, shared_iov, iovcnt + 1);
+    UCS_ASYNC_UNBLOCK(&tl->async);
+
+    return status;
+}
+
+static size_t ucp_shared_ep_pack_cb(void *dest, void *arg)
+{
+    ucp_shared_pack_arg_t *pack_arg = arg;
+    size_t length;
+
+    length = pack_arg->pack_cb(dest, pack_arg->arg);
+    *(uint8_t*)UCS_PTR_BYTE_OFFSET(dest, length) = pack_arg->remote_id;
+    return length + UCP_SHARED_IFACE_ID_SIZE;
+}
+
+static ssize_t ucp_shared_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id,
+                                      uct_pack_callback_t pack_cb, void *arg,
+                                      unsigned flags)
+{
+    ucp_shared_ep_t *ep = ucs_derived_of(tl_ep, ucp_shared_ep_t);
+    ucp_shared_tl_t *tl = ucp_shared_ep_iface(ep)->tl;
+    ucp_shared_pack_arg_t pack_arg;
+    ssize_t packed_size;
+
+    if (ucp_shared_ep_is_blocked(ep)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    pack_arg.pack_cb   = pack_cb;
+    pack_arg.arg       = arg;
+    pack_arg.remote_id = ep->remote_id;
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    packed_size = uct_ep_am_bcopy(ep->conn->uct_ep, id, ucp_shared_ep_pack_cb,
+                                  &pack_arg, flags);
+    UCS_ASYNC_UNBLOCK(&tl->async);
+
+    if (packed_size < 0) {
+        return packed_size;
+    }
+
+    return packed_size - UCP_SHARED_IFACE_ID_SIZE;
+}
+
+static ucs_status_t ucp_shared_ep_pending_add(uct_ep_h tl_ep,
+                                              uct_pending_req_t *req,
+                                              unsigned flags)
+{
+    ucp_shared_ep_t *ep       = ucs_derived_of(tl_ep, ucp_shared_ep_t);
+    ucp_shared_iface_t *iface = ucp_shared_ep_iface(ep);
+
+    /* Resources of the transport interface are released by the progress of
+     * any worker, so the request is always queued and retried by progress */
+    UCS_STATIC_ASSERT(sizeof(uct_pending_req_priv_arb_t) <=
+                      UCT_PENDING_REQ_PRIV_LEN);
+    uct_pending_req_arb_group_push(&ep->arb_group, req);
+    ucs_arbiter_group_schedule(&iface->arbiter, &ep->arb_group);
+    UCT_TL_EP_STAT_PEND(&ep->super);
+
+    return UCS_OK;
+}
+
+static ucs_arbiter_cb_result_t
+ucp_shared_ep_process_pending(ucs_arbiter_t *arbiter,
+                              ucs_arbiter_group_t *group,
+                              ucs_arbiter_elem_t *elem, void *arg)
+{
+    ucp_shared_ep_t *ep       = ucs_container_of(group, ucp_shared_ep_t,
+                                                 arb_group);
+    ucp_shared_iface_t *iface = ucp_shared_ep_iface(ep);
+    unsigned *count           = (unsigned*)arg;
+    uct_pending_req_t *req;
+    ucs_status_t status;
+
+    req = ucs_container_of(elem, uct_pending_req_t, priv);
+
+    ucs_trace_data("progressing pending request %p", req);
+    iface->pending_ep = ep;
+    status            = req->func(req);
+    iface->pending_ep = NULL;
+    ucs_trace_data("status returned from progress pending: %s",
+                   ucs_status_string(status));
+
+    if (status == UCS_OK) {
+        (*count)++;
+        return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+    } else if (status == UCS_INPROGRESS) {
+        (*count)++;
+        return UCS_ARBITER_CB_RESULT_NEXT_GROUP;
+    } else {
+        return UCS_ARBITER_CB_RESULT_RESCHED_GROUP;
+    }
+}
+
+static ucs_arbiter_cb_result_t
+ucp_shared_ep_arbiter_purge_cb(ucs_arbiter_t *arbiter,
+                               ucs_arbiter_group_t *group,
+                               ucs_arbiter_elem_t *elem, void *arg)
+{
+    ucp_shared_ep_t *ep             = ucs_container_of(group, ucp_shared_ep_t,
+                                                       arb_group);
+    uct_purge_cb_args_t *cb_args    = arg;
+    uct_pending_purge_callback_t cb = cb_args->cb;
+    uct_pending_req_t *req;
+
+    req = ucs_container_of(elem, uct_pending_req_t, priv);
+    if (cb != NULL) {
+        cb(req, cb_args->arg);
+    } else {
+        ucs_warn("ep=%p canceling user pending request %p", ep, req);
+    }
+
+    return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+}
+
+static void ucp_shared_ep_pending_purge(uct_ep_h tl_ep,
+                                        uct_pending_purge_callback_t cb,
+                                        void *arg)
+{
+    ucp_shared_ep_t *ep       = ucs_derived_of(tl_ep, ucp_shared_ep_t);
+    ucp_shared_iface_t *iface = ucp_shared_ep_iface(ep);
+    uct_purge_cb_args_t args  = {cb, arg};
+
+    ucs_arbiter_group_purge(&iface->arbiter, &ep->arb_group,
+                            ucp_shared_ep_arbiter_purge_cb, &args);
+}
+
+/* Start an operation on the shared transport endpoint, whose completion is
+ * dispatched by the progress of the endpoint's worker. Called with the shared
+ * async blocked. */
+static ucs_status_t ucp_shared_ep_start_op(ucp_shared_ep_t *ep,
+                                           uct_ep_flush_func_t op,
+                                           unsigned flags,
+                                           uct_completion_t *comp)
+{
+    ucp_shared_conn_t *conn = ep->conn;
+    ucp_shared_comp_t *scomp;
+    ucs_status_t status;
+
+    if (comp == NULL) {
+        return op(conn->uct_ep, flags, NULL);
+    }
+
+    scomp = ucs_malloc(sizeof(*scomp), "ucp_shared_comp");
+    if (scomp == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    scomp->super.func   = ucp_shared_comp_handler;
+    scomp->super.count  = 1;
+    scomp->super.status = UCS_OK;
+    scomp->event.ep     = ep;
+    scomp->event.status = UCS_OK;
+    scomp->event.length = 0;
+    scomp->event.type   = UCP_SHARED_EVENT_COMP;
+    scomp->event.am_id  = 0;
+    scomp->comp         = comp;
+
+    status = op(conn->uct_ep, flags, &scomp->super);
+    if (status == UCS_INPROGRESS) {
+        ucs_list_add_tail(&conn->comps, &scomp->list);
+    } else {
+        ucs_free(scomp);
+    }
+
+    return status;
+}
+
+static ucs_status_t ucp_shared_ep_flush(uct_ep_h tl_ep, unsigned flags,
+                                        uct_completion_t *comp)
+{
+    ucp_shared_ep_t *ep     = ucs_derived_of(tl_ep, ucp_shared_ep_t);
+    ucp_shared_tl_t *tl     = ucp_shared_ep_iface(ep)->tl;
+    ucp_shared_conn_t *conn = ep->conn;
+    ucs_status_t status;
+
+    if (ucp_shared_ep_is_blocked(ep)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    UCS_ASYNC_BLOCK(&tl->async);
+
+    /* Operations of other endpoints on the connection must not be canceled */
+    if (conn->refcount > 1) {
+        flags &= ~UCT_FLUSH_FLAG_CANCEL;
+    }
+
+    status = ucp_shared_ep_start_op(ep, uct_ep_flush, flags, comp);
+    UCS_ASYNC_UNBLOCK(&tl->async);
+
+    return status;
+}
+
+static ucs_status_t ucp_shared_ep_fence(uct_ep_h tl_ep, unsigned flags)
+{
+    ucp_shared_ep_t *ep = ucs_derived_of(tl_ep, ucp_shared_ep_t);
+    ucp_shared_tl_t *tl = ucp_shared_ep_iface(ep)->tl;
+    ucs_status_t status;
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    status = uct_ep_fence(ep->conn->uct_ep, flags);
+    UCS_ASYNC_UNBLOCK(&tl->async);
+
+    return status;
+}
+
+static ucs_status_t ucp_shared_ep_check(uct_ep_h tl_ep, unsigned flags,
+                                        uct_completion_t *comp)
+{
+    ucp_shared_ep_t *ep = ucs_derived_of(tl_ep, ucp_shared_ep_t);
+    ucp_shared_tl_t *tl = ucp_shared_ep_iface(ep)->tl;
+    ucs_status_t status;
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    status = ucp_shared_ep_start_op(ep, uct_ep_check, flags, comp);
+    UCS_ASYNC_UNBLOCK(&tl->async);
+
+    return status;
+}
+
+static UCS_CLASS_INIT_FUNC(ucp_shared_ep_t, const uct_ep_params_t *params,
+                           int remote_shared)
+{
+    ucp_shared_iface_t *iface = ucs_derived_of(params->iface,
+                                               ucp_shared_iface_t);
+    ucp_shared_tl_t *tl       = iface->tl;
+    ucs_status_t status;
+
+    UCS_CLASS_CALL_SUPER_INIT(uct_base_ep_t, &iface->super);
+
+    ucs_arbiter_group_init(&self->arb_group);
+
+    if (!remote_shared) {
+        /* Messages to the remote interface must not carry the destination
+         * interface */
+        ucs_debug("shared iface %p: remote iface is not shared", iface);
+        status = UCS_ERR_UNREACHABLE;
+        goto err;
+    }
+
+    ucs_assert(params->field_mask & UCT_EP_PARAM_FIELD_IFACE_ADDR);
+    self->remote_id = *(const uint8_t*)UCS_PTR_BYTE_OFFSET(
+                              params->iface_addr, tl->attr.iface_addr_len);
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    status = ucp_shared_conn_get(tl, params, &self->conn);
+    if (status == UCS_OK) {
+        ucs_list_add_tail(&self->conn->eps, &self->list);
+    }
+    UCS_ASYNC_UNBLOCK(&tl->async);
+
+    if (status != UCS_OK) {
+        goto err;
+    }
+
+    ucs_debug("shared iface %p: created ep %p on transport ep %p (refcount %u)",
+              iface, self, self->conn->uct_ep, self->conn->refcount);
+    return UCS_OK;
+
+err:
+    ucs_arbiter_group_cleanup(&self->arb_group);
+    return status;
+}
+
+static UCS_CLASS_CLEANUP_FUNC(ucp_shared_ep_t)
+{
+    ucp_shared_iface_t *iface = ucp_shared_ep_iface(self);
+    ucp_shared_tl_t *tl       = iface->tl;
+    ucp_shared_comp_t *scomp;
+
+    ucp_shared_ep_pending_purge(&self->super.super, NULL, NULL);
+    ucs_arbiter_group_cleanup(&self->arb_group);
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    ucs_list_for_each(scomp, &self->conn->comps, list) {
+        if (scomp->event.ep == self) {
+            scomp->event.ep = NULL;
+        }
+    }
+
+    ucp_shared_iface_purge_events(&iface->event_q, self);
+    ucs_list_del(&self->list);
+    ucp_shared_conn_put(tl, self->conn);
+    UCS_ASYNC_UNBLOCK(&tl->async);
+
+    ucp_shared_iface_purge_events(&iface->ready_q, self);
+}
+
+UCS_CLASS_DEFINE(ucp_shared_ep_t, uct_base_ep_t);
+static UCS_CLASS_DEFINE_NEW_FUNC(ucp_shared_ep_t, uct_ep_t,
+                                 const uct_ep_params_t*, int);
+static UCS_CLASS_DEFINE_DELETE_FUNC(ucp_shared_ep_t, uct_ep_t);
+
+static ucs_status_t ucp_shared_ep_create(const uct_ep_params_t *params,
+                                         uct_ep_h *ep_p)
+{
+    /* The remote interface is not known to be shared */
+    return UCS_CLASS_NEW_FUNC_NAME(ucp_shared_ep_t)(params, 0, ep_p);
+}
+
+static void ucp_shared_iface_dispatch(ucp_shared_iface_t *iface,
+                                      ucp_shared_iface_event_t *event)
+{
+    ucp_shared_tl_t *tl = iface->tl;
+    ucp_shared_rx_desc_t *rx_desc;
+    ucp_shared_comp_t *scomp;
+    ucs_status_t status;
+
+    switch (event->type) {
+    case UCP_SHARED_EVENT_AM:
+        rx_desc = ucs_container_of(event, ucp_shared_rx_desc_t, event);
+        status  = uct_iface_invoke_am(&iface->super, event->am_id,
+                                      ucp_shared_rx_desc_data(tl, rx_desc),
+                                      event->length, UCT_CB_PARAM_FLAG_DESC);
+        if (status != UCS_INPROGRESS) {
+            ucp_shared_rx_desc_put(rx_desc);
+        }
+        break;
+    case UCP_SHARED_EVENT_COMP:
+        scomp = ucs_container_of(event, ucp_shared_comp_t, event);
+        uct_invoke_completion(scomp->comp, event->status);
+        ucs_free(scomp);
+        break;
+    case UCP_SHARED_EVENT_ERROR:
+        uct_iface_handle_ep_err(&iface->super.super, &event->ep->super.super,
+                                event->status);
+        ucs_free(event);
+        break;
+    }
+}
+
+static unsigned ucp_shared_iface_progress(uct_iface_h tl_iface)
+{
+    ucp_shared_iface_t *iface = ucs_derived_of(tl_iface, ucp_shared_iface_t);
+    ucp_shared_tl_t *tl       = iface->tl;
+    ucp_shared_iface_event_t *event;
+    unsigned count            = 0;
+
+    /* Only one worker progresses the transport interface, the others don't
+     * wait for it, since it adds their events to their queues */
+    if (ucs_atomic_cswap32(&tl->progressing, 0, 1) == 0) {
+        UCS_ASYNC_BLOCK(&tl->async);
+        uct_worker_progress(tl->uct_worker);
+        UCS_ASYNC_UNBLOCK(&tl->async);
+
+        ucs_async_check_miss(&tl->async);
+        tl->progressing = 0;
+    }
+
+    if (iface->num_events != 0) {
+        UCS_ASYNC_BLOCK(&tl->async);
+        ucs_queue_splice(&iface->ready_q, &iface->event_q);
+        iface->num_events = 0;
+        UCS_ASYNC_UNBLOCK(&tl->async);
+    }
+
+    /* Callbacks are called without the shared lock, and may destroy endpoints
+     * whose events are still in the ready queue */
+    while (!ucs_queue_is_empty(&iface->ready_q)) {
+        event = ucs_queue_pull_elem_non_empty(&iface->ready_q,
+                                              ucp_shared_iface_event_t, queue);
+        ucp_shared_iface_dispatch(iface, event);
+        ++count;
+    }
+
+    ucs_arbiter_dispatch(&iface->arbiter, 1, ucp_shared_ep_process_pending,
+                         &count);
+    return count;
+}
+
+static ucs_status_t ucp_shared_iface_flush(uct_iface_h tl_iface,
+                                           unsigned flags,
+                                           uct_completion_t *comp)
+{
+    ucp_shared_iface_t *iface = ucs_derived_of(tl_iface, ucp_shared_iface_t);
+    ucp_shared_tl_t *tl       = iface->tl;
+    ucs_status_t status;
+
+    if (comp != NULL) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    if (!ucs_arbiter_is_empty(&iface->arbiter)) {
+        return UCS_INPROGRESS;
+    }
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    status = uct_iface_flush(tl->uct_iface, flags, NULL);
+    UCS_ASYNC_UNBLOCK(&tl->async);
+
+    return status;
+}
+
+static ucs_status_t ucp_shared_iface_fence(uct_iface_h tl_iface,
+                                           unsigned flags)
+{
+    ucp_shared_iface_t *iface = ucs_derived_of(tl_iface, ucp_shared_iface_t);
+    ucp_shared_tl_t *tl       = iface->tl;
+    ucs_status_t status;
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    status = uct_iface_fence(tl->uct_iface, flags);
+    UCS_ASYNC_UNBLOCK(&tl->async);
+
+    return status;
+}
+
+static ucs_status_t ucp_shared_iface_query(uct_iface_h tl_iface,
+                                           uct_iface_attr_t *iface_attr)
+{
+    ucp_shared_iface_t *iface = ucs_derived_of(tl_iface, ucp_shared_iface_t);
+    uct_iface_attr_t *attr    = &iface->tl->attr;
+
+    *iface_attr                  = *attr;
+    iface_attr->cap.flags       &= UCP_SHARED_IFACE_CAP_FLAGS;
+    iface_attr->cap.event_flags  = 0;
+    memset(&iface_attr->cap.put, 0, sizeof(iface_attr->cap.put));
+    memset(&iface_attr->cap.get, 0, sizeof(iface_attr->cap.get));
+    memset(&iface_attr->cap.tag, 0, sizeof(iface_attr->cap.tag));
+    memset(&iface_attr->cap.atomic32, 0, sizeof(iface_attr->cap.atomic32));
+    memset(&iface_attr->cap.atomic64, 0, sizeof(iface_attr->cap.atomic64));
+
+    /* Every message ends with the destination interface index */
+    if (attr->cap.flags & UCT_IFACE_FLAG_AM_SHORT) {
+        iface_attr->cap.am.max_short = attr->cap.am.max_short -
+                                       UCP_SHARED_IFACE_ID_SIZE;
+    }
+    iface_attr->cap.am.max_bcopy = attr->cap.am.max_bcopy -
+                                   UCP_SHARED_IFACE_ID_SIZE;
+    iface_attr->cap.am.min_zcopy = 0;
+    iface_attr->cap.am.max_zcopy = 0;
+    iface_attr->cap.am.max_hdr   = 0;
+    iface_attr->cap.am.max_iov   = ucs_max(attr->cap.am.max_iov, 1) - 1;
+
+    /* Address of the shared interface, followed by the interface index */
+    iface_attr->iface_addr_len = attr->iface_addr_len +
+                                 UCP_SHARED_IFACE_ID_SIZE;
+    return UCS_OK;
+}
+
+static ucs_status_t
+ucp_shared_iface_get_device_address(uct_iface_h tl_iface,
+                                    uct_device_addr_t *addr)
+{
+    ucp_shared_iface_t *iface = ucs_derived_of(tl_iface, ucp_shared_iface_t);
+
+    return uct_iface_get_device_address(iface->tl->uct_iface, addr);
+}
+
+static ucs_status_t ucp_shared_iface_get_address(uct_iface_h tl_iface,
+                                                 uct_iface_addr_t *addr)
+{
+    ucp_shared_iface_t *iface = ucs_derived_of(tl_iface, ucp_shared_iface_t);
+    ucp_shared_tl_t *tl       = iface->tl;
+    ucs_status_t status;
+
+    status = uct_iface_get_address(tl->uct_iface, addr);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    *(uint8_t*)UCS_PTR_BYTE_OFFSET(addr, tl->attr.iface_addr_len) = iface->id;
+    return UCS_OK;
+}
+
+static int ucp_shared_iface_is_reachable(const uct_iface_h tl_iface,
+                                         const uct_device_addr_t *dev_addr,
+                                         const uct_iface_addr_t *iface_addr)
+{
+    ucp_shared_iface_t *iface = ucs_derived_of(tl_iface, ucp_shared_iface_t);
+
+    return uct_iface_is_reachable(iface->tl->uct_iface, dev_addr, iface_addr);
+}
+
+static uct_iface_ops_t ucp_shared_iface_ops = {
+    .ep_put_short             = (uct_ep_put_short_func_t)ucs_empty_function_return_unsupported,
+    .ep_put_bcopy             = (uct_ep_put_bcopy_func_t)ucs_empty_function_return_unsupported,
+    .ep_put_zcopy             = (uct_ep_put_zcopy_func_t)ucs_empty_function_return_unsupported,
+    .ep_get_short             = (uct_ep_get_short_func_t)ucs_empty_function_return_unsupported,
+    .ep_get_bcopy             = (uct_ep_get_bcopy_func_t)ucs_empty_function_return_unsupported,
+    .ep_get_zcopy             = (uct_ep_get_zcopy_func_t)ucs_empty_function_return_unsupported,
+    .ep_am_short              = ucp_shared_ep_am_short,
+    .ep_am_short_iov          = ucp_shared_ep_am_short_iov,
+    .ep_am_bcopy              = ucp_shared_ep_am_bcopy,
+    .ep_am_zcopy              = (uct_ep_am_zcopy_func_t)ucs_empty_function_return_unsupported,
+    .ep_atomic_cswap64        = (uct_ep_atomic_cswap64_func_t)ucs_empty_function_return_unsupported,
+    .ep_atomic_cswap32        = (uct_ep_atomic_cswap32_func_t)ucs_empty_function_return_unsupported,
+    .ep_atomic32_post         = (uct_ep_atomic32_post_func_t)ucs_empty_function_return_unsupported,
+    .ep_atomic64_post         = (uct_ep_atomic64_post_func_t)ucs_empty_function_return_unsupported,
+    .ep_atomic32_fetch        = (uct_ep_atomic32_fetch_func_t)ucs_empty_function_return_unsupported,
+    .ep_atomic64_fetch        = (uct_ep_atomic64_fetch_func_t)ucs_empty_function_return_unsupported,
+    .ep_pending_add           = ucp_shared_ep_pending_add,
+    .ep_pending_purge         = ucp_shared_ep_pending_purge,
+    .ep_flush                 = ucp_shared_ep_flush,
+    .ep_fence                 = ucp_shared_ep_fence,
+    .ep_check                 = ucp_shared_ep_check,
+    .ep_create                = ucp_shared_ep_create,
+    .ep_destroy               = UCS_CLASS_DELETE_FUNC_NAME(ucp_shared_ep_t),
+    .ep_get_address           = (uct_ep_get_address_func_t)ucs_empty_function_return_unsupported,
+    .ep_connect_to_ep         = (uct_ep_connect_to_ep_func_t)ucs_empty_function_return_unsupported,
+    .iface_flush              = ucp_shared_iface_flush,
+    .iface_fence              = ucp_shared_iface_fence,
+    .iface_progress_enable    = uct_base_iface_progress_enable,
+    .iface_progress_disable   = uct_base_iface_progress_disable,
+    .iface_progress           = ucp_shared_iface_progress,
+    .iface_event_fd_get       = (uct_iface_event_fd_get_func_t)ucs_empty_function_return_unsupported,
+    .iface_event_arm          = (uct_iface_event_arm_func_t)ucs_empty_function_return_unsupported,
+    .iface_close              = ucp_shared_iface_close,
+    .iface_query              = ucp_shared_iface_query,
+    .iface_get_device_address = ucp_shared_iface_get_device_address,
+    .iface_get_address        = ucp_shared_iface_get_address,
+    .iface_is_reachable       = ucp_shared_iface_is_reachable
+};
+
+static UCS_CLASS_INIT_FUNC(ucp_shared_iface_t, ucp_shared_tl_t *tl,
+                           uct_md_h md, uct_worker_h worker,
+                           const uct_iface_params_t *params,
+                           const uct_iface_config_t *config)
+{
+    unsigned id;
+
+    UCS_CLASS_CALL_SUPER_INIT(uct_base_iface_t, &ucp_shared_iface_ops, md,
+                              worker, params, config
+                              UCS_STATS_ARG((params->field_mask &
+                                             UCT_IFACE_PARAM_FIELD_STATS_ROOT) ?
+                                            params->stats_root : NULL)
+                              UCS_STATS_ARG(tl->context->tl_rscs[
+                                            tl->rsc_index].tl_rsc.tl_name));
+
+    /* Received messages are copied with the headroom of the first worker */
+    if (UCT_IFACE_PARAM_VALUE(params, rx_headroom, RX_HEADROOM, 0) !=
+        tl->rx_headroom) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    self->tl         = tl;
+    self->pending_ep = NULL;
+    self->num_events = 0;
+    ucs_queue_head_init(&self->event_q);
+    ucs_queue_head_init(&self->ready_q);
+    ucs_arbiter_init(&self->arbiter);
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    for (id = 0; id < UCP_SHARED_TL_MAX_IFACES; ++id) {
+        if (tl->ifaces[id] == NULL) {
+            self->id        = id;
+            tl->ifaces[id]  = self;
+            break;
+        }
+    }
+    UCS_ASYNC_UNBLOCK(&tl->async);
+
+    if (id == UCP_SHARED_TL_MAX_IFACES) {
+        ucs_error("shared iface %p: too many workers (max: %lu)", tl->uct_iface,
+                  UCP_SHARED_TL_MAX_IFACES);
+        ucs_arbiter_cleanup(&self->arbiter);
+        return UCS_ERR_EXCEEDS_LIMIT;
+    }
+
+    ucs_debug("shared iface %p: opened iface %p with id %d", tl->uct_iface,
+              self, self->id);
+    return UCS_OK;
+}
+
+static UCS_CLASS_CLEANUP_FUNC(ucp_shared_iface_t)
+{
+    ucp_shared_tl_t *tl = self->tl;
+    ucp_shared_iface_event_t *event;
+
+    uct_base_iface_progress_disable(&self->super.super,
+                                    UCT_PROGRESS_SEND | UCT_PROGRESS_RECV);
+
+    UCS_ASYNC_BLOCK(&tl->async);
+    tl->ifaces[self->id] = NULL;
+    ucs_queue_splice(&self->ready_q, &self->event_q);
+    UCS_ASYNC_UNBLOCK(&tl->async);
+
+    while (!ucs_queue_is_empty(&self->ready_q)) {
+        event = ucs_queue_pull_elem_non_empty(&self->ready_q,
+                                              ucp_shared_iface_event_t, queue);
+        ucp_shared_iface_event_release(event);
+    }
+
+    ucs_arbiter_cleanup(&self->arbiter);
+}
+
+UCS_CLASS_DEFINE(ucp_shared_iface_t, uct_base_iface_t);
+
+static ucs_status_t
+ucp_shared_tl_create(ucp_worker_h worker, ucp_rsc_index_t rsc_index,
+                     const uct_iface_params_t *worker_params,
+                     const uct_iface_config_t *iface_config,
+                     ucp_shared_tl_t **tl_p)
+{
+    ucp_context_h context            = worker->context;
+    ucp_tl_resource_desc_t *resource = &context->tl_rscs[rsc_index];
+    uct_md_h md                      = context->tl_mds[resource->md_index].md;
+    uct_iface_params_t iface_params;
+    ucp_shared_tl_t *tl;
+    ucs_status_t status;
+    uint8_t am_id;
+
+    tl = ucs_calloc(1, sizeof(*tl), "ucp_shared_tl");
+    if (tl == NULL) {
+        ucs_error("failed to allocate shared interface");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    tl->context         = context;
+    tl->rsc_index       = rsc_index;
+    tl->rx_headroom     = UCT_IFACE_PARAM_VALUE(worker_params, rx_headroom,
+                                                RX_HEADROOM, 0);
+    tl->release_desc.cb     = ucp_shared_tl_release_desc;
+    tl->uct_release_desc.cb = ucp_shared_tl_release_uct_desc;
+    tl->refcount            = 0;
+    ucs_list_head_init(&tl->conns);
+
+    status = ucs_async_context_init(&tl->async,
+                                    context->config.ext.use_mt_mutex ?
+                                    UCS_ASYNC_MODE_THREAD_MUTEX :
+                                    UCS_ASYNC_THREAD_LOCK_TYPE);
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
+    /* All access to the UCT worker is serialized by the async context */
+    status = uct_worker_create(&tl->async, UCS_THREAD_MODE_SERIALIZED,
+                               &tl->uct_worker);
+    if (status != UCS_OK) {
+        goto err_async_cleanup;
+    }
+
+    iface_params.field_mask        = worker_params->field_mask &
+                                     (UCT_IFACE_PARAM_FIELD_OPEN_MODE |
+                                      UCT_IFACE_PARAM_FIELD_DEVICE    |
+                                      UCT_IFACE_PARAM_FIELD_CPU_MASK  |
+                                      UCT_IFACE_PARAM_FIELD_KEEPALIVE_INTERVAL);
+    iface_params.field_mask       |= UCT_IFACE_PARAM_FIELD_RX_HEADROOM       |
+                                     UCT_IFACE_PARAM_FIELD_ERR_HANDLER_ARG   |
+                                     UCT_IFACE_PARAM_FIELD_ERR_HANDLER       |
+                                     UCT_IFACE_PARAM_FIELD_ERR_HANDLER_FLAGS;
+    iface_params.open_mode          = worker_params->open_mode;
+    iface_params.mode               = worker_params->mode;
+    iface_params.cpu_mask           = worker_params->cpu_mask;
+    iface_params.keepalive_interval = worker_params->keepalive_interval;
+    /* Leave room to hold a transport descriptor as a shared rx descriptor */
+    iface_params.rx_headroom        = sizeof(ucp_shared_rx_desc_t) +
+                                      tl->rx_headroom;
+    iface_params.err_handler_arg    = tl;
+    iface_params.err_handler        = ucp_shared_tl_err_handler;
+    iface_params.err_handler_flags  = UCT_CB_FLAG_ASYNC;
+
+    status = uct_iface_open(md, tl->uct_worker, &iface_params, iface_config,
+                            &tl->uct_iface);
+    if (status != UCS_OK) {
+        goto err_worker_destroy;
+    }
+
+    status = uct_iface_query(tl->uct_iface, &tl->attr);
+    if (status != UCS_OK) {
+        goto err_iface_close;
+    }
+
+    if (!ucs_test_all_flags(tl->attr.cap.flags,
+                            UCT_IFACE_FLAG_AM_BCOPY |
+                            UCT_IFACE_FLAG_CONNECT_TO_IFACE)) {
+        ucs_debug(UCT_TL_RESOURCE_DESC_FMT " does not support am_bcopy or "
+                  "connect to iface, can't be shared",
+                  UCT_TL_RESOURCE_DESC_ARG(&resource->tl_rsc));
+        status = UCS_ERR_UNSUPPORTED;
+        goto err_iface_close;
+    }
+
+    UCS_STATIC_ASSERT(ucs_offsetof(ucp_shared_rx_desc_t, release_desc) +
+                      sizeof(uct_recv_desc_t*) ==
+                      sizeof(ucp_shared_rx_desc_t));
+    status = ucs_mpool_init(&tl->rx_mp, 0,
+                            sizeof(ucp_shared_rx_desc_t) + tl->rx_headroom +
+                            ucs_max(tl->attr.cap.am.max_short,
+                                    tl->attr.cap.am.max_bcopy),
+                            sizeof(ucp_shared_rx_desc_t) + tl->rx_headroom,
+                            UCS_SYS_CACHE_LINE_SIZE, 128, UINT_MAX,
+                            &ucp_shared_rx_mpool_ops, "ucp_shared_rx_descs");
+    if (status != UCS_OK) {
+        goto err_iface_close;
+    }
+
+    ucs_conn_match_init(&tl->conn_match,
+                        tl->attr.device_addr_len + tl->attr.iface_addr_len,
+                        &ucp_shared_conn_match_ops);
+
+    for (am_id = 0; am_id < UCT_AM_ID_MAX; ++am_id) {
+        tl->am_args[am_id].tl    = tl;
+        tl->am_args[am_id].am_id = am_id;
+        status = uct_iface_set_am_handler(tl->uct_iface, am_id,
+                                          ucp_shared_tl_am_handler,
+                                          &tl->am_args[am_id],
+                                          UCT_CB_FLAG_ASYNC);
+        if (status != UCS_OK) {
+            goto err_conn_match_cleanup;
+        }
+    }
+
+    uct_iface_progress_enable(tl->uct_iface,
+                              UCT_PROGRESS_SEND | UCT_PROGRESS_RECV);
+
+    ucs_debug("opened shared iface %p for " UCT_TL_RESOURCE_DESC_FMT,
+              tl->uct_iface, UCT_TL_RESOURCE_DESC_ARG(&resource->tl_rsc));
+    *tl_p = tl;
+    return UCS_OK;
+
+err_conn_match_cleanup:
+    ucs_conn_match_cleanup(&tl->conn_match);
+    ucs_mpool_cleanup(&tl->rx_mp, 1);
+err_iface_close:
+    uct_iface_close(tl->uct_iface);
+err_worker_destroy:
+    uct_worker_destroy(tl->uct_worker);
+err_async_cleanup:
+    ucs_async_context_cleanup(&tl->async);
+err_free:
+    ucs_free(tl);
+    return status;
+}
+
+static void ucp_shared_tl_destroy(ucp_shared_tl_t *tl)
+{
+    ucs_debug("closing shared iface %p", tl->uct_iface);
+
+    ucs_assertv(ucs_list_is_empty(&tl->conns), "shared iface %p",
+                tl->uct_iface);
+    uct_iface_close(tl->uct_iface);
+    ucs_conn_match_cleanup(&tl->conn_match);
+    /* Like the worker's AM buffers, received messages may still be held by
+     * a destroyed worker */
+    ucs_mpool_cleanup(&tl->rx_mp, 0);
+    uct_worker_destroy(tl->uct_worker);
+    ucs_async_context_cleanup(&tl->async);
+    ucs_free(tl);
+}
+
+static void ucp_shared_iface_close(uct_iface_h tl_iface)
+{
+    ucp_shared_iface_t *iface = ucs_derived_of(tl_iface, ucp_shared_iface_t);
+    ucp_shared_tl_t *tl       = iface->tl;
+    ucp_context_h context     = tl->context;
+
+    UCS_CLASS_DELETE(ucp_shared_iface_t, iface);
+
+    pthread_mutex_lock(&context->shared_tls_lock);
+    if (--tl->refcount == 0) {
+        context->shared_tls[tl->rsc_index] = NULL;
+        ucp_shared_tl_destroy(tl);
+    }
+    pthread_mutex_unlock(&context->shared_tls_lock);
+}
+
+ucs_status_t ucp_shared_iface_open(ucp_worker_h worker,
+                                   ucp_rsc_index_t rsc_index,
+                                   const uct_iface_params_t *iface_params,
+                                   const uct_iface_config_t *iface_config,
+                                   uct_iface_h *iface_p)
+{
+    ucp_context_h context = worker->context;
+    uct_md_h md           = context->tl_mds[
+                                    context->tl_rscs[rsc_index].md_index].md;
+    ucp_shared_iface_t *iface;
+    ucp_shared_tl_t *tl;
+    ucs_status_t status;
+
+    if (context->shared_tls == NULL) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    pthread_mutex_lock(&context->shared_tls_lock);
+
+    if (!UCS_BITMAP_GET(context->shared_tl_bitmap, rsc_index)) {
+        status = UCS_ERR_UNSUPPORTED;
+        goto out;
+    }
+
+    tl = context->shared_tls[rsc_index];
+    if (tl == NULL) {
+        status = ucp_shared_tl_create(worker, rsc_index, iface_params,
+                                      iface_config, &tl);
+        if (status != UCS_OK) {
+            if (status == UCS_ERR_UNSUPPORTED) {
+                /* Let the next workers open their own interfaces */
+                UCS_BITMAP_UNSET(context->shared_tl_bitmap, rsc_index);
+            }
+            goto out;
+        }
+
+        context->shared_tls[rsc_index] = tl;
+    }
+
+    status = UCS_CLASS_NEW(ucp_shared_iface_t, &iface, tl, md, worker->uct,
+                           iface_params, iface_config);
+    if (status != UCS_OK) {
+        if (tl->refcount == 0) {
+            context->shared_tls[rsc_index] = NULL;
+            ucp_shared_tl_destroy(tl);
+        }
+        goto out;
+    }
+
+    ++tl->refcount;
+    *iface_p = &iface->super.super;
+
+out:
+    pthread_mutex_unlock(&context->shared_tls_lock);
+    return status;
+}
+
+int ucp_shared_iface_is_enabled(ucp_context_h context,
+                                ucp_rsc_index_t rsc_index)
+{
+    int enabled;
+
+    if (context->shared_tls == NULL) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&context->shared_tls_lock);
+    enabled = UCS_BITMAP_GET(context->shared_tl_bitmap, rsc_index);
+    pthread_mutex_unlock(&context->shared_tls_lock);
+    return enabled;
+}
+
+int ucp_shared_iface_test(uct_iface_h iface)
+{
+    return iface->ops.iface_close == ucp_shared_iface_close;
+}
+
+ucs_status_t ucp_shared_iface_ep_create(const uct_ep_params_t *params,
+                                        int remote_shared, uct_ep_h *ep_p)
+{
+    if (!ucp_shared_iface_test(params->iface)) {
+        return uct_ep_create(params, ep_p);
+    }
+
+    return UCS_CLASS_NEW_FUNC_NAME(ucp_shared_ep_t)(
+            params,
+            remote_shared &&
+            (params->field_mask & UCT_EP_PARAM_FIELD_IFACE_ADDR),
+            ep_p);
+}
@@ -0,0 +1,185 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_SHARED_IFACE_H_
+#define UCP_SHARED_IFACE_H_
+
+#include "ucp_types.h"
+
+#include <uct/base/uct_iface.h>
+#include <ucs/async/async.h>
+#include <ucs/datastruct/arbiter.h>
+#include <ucs/datastruct/conn_match.h>
+#include <ucs/datastruct/list.h>
+#include <ucs/datastruct/mpool.h>
+#include <ucs/datastruct/queue.h>
+
+
+/* Maximal number of workers which can share a transport interface, limited by
+ * the size of the worker index carried in every active message */
+#define UCP_SHARED_TL_MAX_IFACES  UCS_BIT(8 * sizeof(uint8_t))
+
+
+typedef struct ucp_shared_iface ucp_shared_iface_t;
+typedef struct ucp_shared_ep    ucp_shared_ep_t;
+
+
+/**
+ * Transport endpoint of a shared interface. Endpoints of all workers which
+ * connect to the same remote interface use a single transport endpoint.
+ */
+typedef struct ucp_shared_conn {
+    ucs_conn_match_elem_t     elem;        /* Element in the connections which
+                                              can be shared */
+    ucs_list_link_t           list;        /* Element in all connections */
+    uct_ep_h                  uct_ep;      /* Transport endpoint */
+    ucs_list_link_t           eps;         /* Endpoints using this connection */
+    ucs_list_link_t           comps;       /* Outstanding flush completions */
+    unsigned                  refcount;    /* Number of endpoints */
+    uint8_t                   flags;       /* Connection flags */
+    ucs_conn_sn_t             path_index;  /* Path index of the transport
+                                              endpoint */
+    uint8_t                   address[];   /* Remote device and interface
+                                              addresses, if can be shared */
+} ucp_shared_conn_t;
+
+
+/**
+ * Argument of an active message handler set on the transport interface.
+ */
+typedef struct ucp_shared_tl_am_arg {
+    ucp_shared_tl_t           *tl;
+    uint8_t                   am_id;
+} ucp_shared_tl_am_arg_t;
+
+
+/**
+ * Transport interface shared by the workers of a context. It is opened on
+ * a dedicated UCT worker when the first worker opens the resource, and closed
+ * when the last worker closes it.
+ *
+ * Every message sent on the shared interface ends with the index of the
+ * destination worker's interface. The receive handlers copy the message to
+ * the event queue of that interface, which is dispatched by the progress of
+ * its worker, so callbacks of a worker are never called by another thread.
+ *
+ * Only peers which advertise a shared interface in their worker address can
+ * reach it, and the workers reach only such peers by it. Other peers use
+ * another transport.
+ *
+ * The transport interface is progressed by one worker at a time. Other
+ * workers which call progress meanwhile only dispatch their own events,
+ * without taking the async lock unless they have events.
+ */
+struct ucp_shared_tl {
+    ucp_context_h             context;     /* Context the interface belongs to */
+    ucp_rsc_index_t           rsc_index;   /* Resource index */
+    ucs_async_context_t       async;       /* Serializes all access to the
+                                              transport interface */
+    uct_worker_h              uct_worker;  /* Progresses the interface */
+    uct_iface_h               uct_iface;   /* Transport interface */
+    uct_iface_attr_t          attr;        /* Transport interface attributes */
+    size_t                    rx_headroom; /* Headroom of received messages */
+    ucs_mpool_t               rx_mp;       /* Copies of received messages */
+    uct_recv_desc_t           release_desc;/* Releases received messages */
+    uct_recv_desc_t           uct_release_desc; /* Releases messages held in
+                                                   transport descriptors */
+    ucs_conn_match_ctx_t      conn_match;  /* Connections which can be shared */
+    ucs_list_link_t           conns;       /* All connections */
+    unsigned                  refcount;    /* Number of workers, protected by
+                                              the context shared_tls_lock */
+    volatile uint32_t         progressing; /* Nonzero while a worker
+                                              progresses the interface */
+    ucp_shared_iface_t        *ifaces[UCP_SHARED_TL_MAX_IFACES];
+    ucp_shared_tl_am_arg_t    am_args[UCT_AM_ID_MAX];
+};
+
+
+/**
+ * Interface of a single worker on a shared transport interface. It is exposed
+ * to the worker as a regular UCT interface, which supports active messages,
+ * pending queue and flush.
+ */
+struct ucp_shared_iface {
+    uct_base_iface_t          super;
+    ucp_shared_tl_t           *tl;         /* Shared transport interface */
+    uint8_t                   id;          /* Index in the shared interface */
+    ucs_queue_head_t          event_q;     /* Events added by any thread,
+                                              protected by the shared async */
+    volatile uint32_t         num_events;  /* Number of events added to
+                                              event_q, read without the
+                                              lock */
+    ucs_queue_head_t          ready_q;     /* Events being dispatched by the
+                                              worker's thread */
+    ucs_arbiter_t             arbiter;     /* Pending requests */
+    ucp_shared_ep_t           *pending_ep; /* Endpoint whose pending request is
+                                              being dispatched */
+};
+
+
+/**
+ * Endpoint on a shared interface.
+ */
+struct ucp_shared_ep {
+    uct_base_ep_t             super;
+    ucp_shared_conn_t         *conn;       /* Shared transport endpoint */
+    ucs_list_link_t           list;        /* Element in connection
+                                              endpoints */
+    ucs_arbiter_group_t       arb_group;   /* Pending requests */
+    uint8_t                   remote_id;   /* Index of the remote interface */
+};
+
+
+/**
+ * Open a worker interface on the shared transport interface of a resource,
+ * and open the shared interface if the worker is the first to use it.
+ *
+ * @param [in]  worker        Worker to open the interface on.
+ * @param [in]  rsc_index     Resource to open.
+ * @param [in]  iface_params  Parameters of the worker interface.
+ * @param [in]  iface_config  Transport configuration.
+ * @param [out] iface_p       Filled with the worker interface.
+ *
+ * @return UCS_ERR_UNSUPPORTED if the transport can't be shared, in which case
+ *         the worker should open its own interface.
+ */
+ucs_status_t ucp_shared_iface_open(ucp_worker_h worker,
+                                   ucp_rsc_index_t rsc_index,
+                                   const uct_iface_params_t *iface_params,
+                                   const uct_iface_config_t *iface_config,
+                                   uct_iface_h *iface_p);
+
+
+/**
+ * Check whether an interface was opened by @ref ucp_shared_iface_open.
+ */
+int ucp_shared_iface_test(uct_iface_h iface);
+
+
+/**
+ * Check whether workers of a context share the interface of a resource.
+ */
+int ucp_shared_iface_is_enabled(ucp_context_h context,
+                                ucp_rsc_index_t rsc_index);
+
+
+/**
+ * Create an endpoint connected to a remote interface. If the local interface
+ * is shared, the endpoint sends on a transport endpoint which is shared by the
+ * workers, and the remote interface must be shared as well. Otherwise it is a
+ * plain transport endpoint.
+ *
+ * @param [in]  params        Endpoint parameters.
+ * @param [in]  remote_shared Whether the remote interface is shared, as
+ *                            advertised by its worker address.
+ * @param [out] ep_p          Filled with the new endpoint.
+ *
+ * @return UCS_ERR_UNREACHABLE if only one of the interfaces is shared.
+ */
+ucs_status_t ucp_shared_iface_ep_create(const uct_ep_params_t *params,
+                                        int remote_shared, uct_ep_h *ep_p);
+
+#endif
@@ -38,10 +38,9 @@ typedef uint8_t                      ucp_lane_index_t;
 typedef uint8_t                      ucp_lane_map_t;
 
 /* Worker configuration index for endpoint and rkey */
-typedef uint8_t                      ucp_worker_cfg_index_t;
-#define UCP_WORKER_MAX_EP_CONFIG     64
+typedef uint16_t                     ucp_worker_cfg_index_t;
 #define UCP_WORKER_MAX_RKEY_CONFIG   128
-#define UCP_WORKER_CFG_INDEX_NULL    UINT8_MAX
+#define UCP_WORKER_CFG_INDEX_NULL    UINT16_MAX
 
 /* Forward declarations */
 typedef struct ucp_request              ucp_request_t;
@@ -60,6 +59,8 @@ typedef struct ucp_ep_config            ucp_ep_config_t;
 typedef struct ucp_ep_config_key        ucp_ep_config_key_t;
 typedef struct ucp_rkey_config_key      ucp_rkey_config_key_t;
 typedef struct ucp_proto                ucp_proto_t;
+typedef struct ucp_proto_cache          ucp_proto_cache_t;
+typedef struct ucp_shared_tl            ucp_shared_tl_t;
 
 
 /**
@@ -153,6 +154,16 @@ typedef enum {
                                           defined AM */
     UCP_AM_ID_SINGLE_REPLY      =  26, /* Single fragment user defined AM
                                           carrying remote ep for reply */
+    UCP_AM_ID_EAGER_CSUM_ONLY   =  27, /* Single packet eager TAG with payload
+                                          checksum */
+    UCP_AM_ID_EAGER_CSUM_FIRST  =  28, /* First eager fragment with payload
+                                          checksum */
+    UCP_AM_ID_EAGER_CSUM_SYNC_ONLY = 29, /* Single packet eager-sync with
+                                            payload checksum */
+    UCP_AM_ID_EAGER_CSUM_SYNC_FIRST = 30, /* First eager-sync fragment with
+                                             payload checksum */
+    UCP_AM_ID_AGGREGATE         =  31, /* Several single fragment user defined
+                                          AMs packed together */
     UCP_AM_ID_LAST
 } ucp_am_id_t;
 
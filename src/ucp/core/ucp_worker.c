@@ -12,6 +12,7 @@
 #include "ucp_am.h"
 #include "ucp_worker.h"
 #include "ucp_rkey.h"
+#include "ucp_shared_iface.h"
 #include "ucp_request.inl"
 
 #include <ucp/wireup/address.h>
@@ -21,6 +22,7 @@
 #include <ucp/tag/offload.h>
 #include <ucp/stream/stream.h>
 #include <ucs/config/parser.h>
+#include <ucs/datastruct/array.inl>
 #include <ucs/datastruct/mpool.inl>
 #include <ucs/datastruct/ptr_map.inl>
 #include <ucs/datastruct/queue.h>
@@ -35,6 +37,12 @@
 
 #define UCP_WORKER_KEEPALIVE_ITER_SKIP 32
 
+/* Number of keepalive wheel ticks in a keepalive interval */
+#define UCP_WORKER_KEEPALIVE_NUM_SLOTS 64
+
+/* Number of endpoint control extensions in a memory pool chunk */
+#define UCP_WORKER_EP_CONTROL_MPOOL_ELEMS 256
+
 #define UCP_WORKER_HEADROOM_SIZE \
     (sizeof(ucp_recv_desc_t) + UCP_WORKER_HEADROOM_PRIV_SIZE)
 
@@ -76,7 +84,11 @@ static ucs_stats_class_t ucp_worker_stats_class = {
         [UCP_WORKER_STAT_TAG_RX_RNDV_UNEXP]        = "rx_rndv_rts_unexp",
         [UCP_WORKER_STAT_TAG_RX_RNDV_GET_ZCOPY]    = "rx_rndv_get_zcopy",
         [UCP_WORKER_STAT_TAG_RX_RNDV_SEND_RTR]     = "rx_rndv_send_rtr",
-        [UCP_WORKER_STAT_TAG_RX_RNDV_RKEY_PTR]     = "rx_rndv_rkey_ptr"
+        [UCP_WORKER_STAT_TAG_RX_RNDV_RKEY_PTR]     = "rx_rndv_rkey_ptr",
+        [UCP_WORKER_STAT_WAIT_SPIN]                = "wait_spin",
+        [UCP_WORKER_STAT_WAIT_SLEEP]               = "wait_sleep",
+        [UCP_WORKER_STAT_WAIT_SLEEP_USEC]          = "wait_sleep_usec",
+        [UCP_WORKER_STAT_IFACE_LAZY_OPEN]          = "iface_lazy_open"
     }
 };
 #endif
@@ -109,6 +121,13 @@ static ucs_mpool_ops_t ucp_rkey_mpool_ops = {
     .obj_cleanup   = NULL
 };
 
+static ucs_mpool_ops_t ucp_ep_control_mpool_ops = {
+    .chunk_alloc   = ucs_mpool_chunk_malloc,
+    .chunk_release = ucs_mpool_chunk_free,
+    .obj_init      = NULL,
+    .obj_cleanup   = NULL
+};
+
 #define ucp_worker_discard_uct_ep_hash_key(_uct_ep) \
     kh_int64_hash_func((uintptr_t)(_uct_ep))
 
@@ -117,6 +136,14 @@ KHASH_IMPL(ucp_worker_discard_uct_ep_hash, uct_ep_h, ucp_request_t*, 1,
            ucp_worker_discard_uct_ep_hash_key, kh_int64_hash_equal);
 
 
+KHASH_IMPL(ucp_worker_ep_config, const ucp_ep_config_key_t*,
+           ucp_worker_cfg_index_t, 1, ucp_ep_config_key_hash,
+           ucp_ep_config_is_equal);
+
+
+UCS_ARRAY_IMPL(ucp_ep_configs, unsigned, ucp_ep_config_t*, static)
+
+
 static ucs_status_t ucp_worker_wakeup_ctl_fd(ucp_worker_h worker,
                                              ucp_worker_event_fd_op_t op,
                                              int event_fd)
@@ -220,7 +247,8 @@ static void ucp_worker_remove_am_handlers(ucp_worker_h worker)
 
     for (iface_id = 0; iface_id < worker->num_ifaces; ++iface_id) {
         wiface = worker->ifaces[iface_id];
-        if (!(wiface->attr.cap.flags & (UCT_IFACE_FLAG_AM_SHORT |
+        if ((wiface->iface == NULL) ||
+            !(wiface->attr.cap.flags & (UCT_IFACE_FLAG_AM_SHORT |
                                         UCT_IFACE_FLAG_AM_BCOPY |
                                         UCT_IFACE_FLAG_AM_ZCOPY))) {
             continue;
@@ -1015,6 +1043,152 @@ ucp_worker_select_best_ifaces(ucp_worker_h worker, ucp_tl_bitmap_t *tl_bitmap_p)
     }
 }
 
+static void
+ucp_worker_iface_resource_params(ucp_context_h context, ucp_rsc_index_t tl_id,
+                                 uct_iface_params_t *iface_params)
+{
+    ucp_tl_resource_desc_t *resource = &context->tl_rscs[tl_id];
+
+    iface_params->field_mask = UCT_IFACE_PARAM_FIELD_OPEN_MODE;
+    if (resource->flags & UCP_TL_RSC_FLAG_SOCKADDR) {
+        iface_params->open_mode            = UCT_IFACE_OPEN_MODE_SOCKADDR_CLIENT;
+    } else {
+        iface_params->open_mode            = UCT_IFACE_OPEN_MODE_DEVICE;
+        iface_params->field_mask          |= UCT_IFACE_PARAM_FIELD_DEVICE;
+        iface_params->mode.device.tl_name  = resource->tl_rsc.tl_name;
+        iface_params->mode.device.dev_name = resource->tl_rsc.dev_name;
+    }
+}
+
+static ucp_worker_iface_t *
+ucp_worker_iface_alloc(ucp_worker_h worker, ucp_rsc_index_t tl_id)
+{
+    ucp_worker_iface_t *wiface;
+
+    wiface = ucs_calloc(1, sizeof(*wiface), "ucp_iface");
+    if (wiface == NULL) {
+        return NULL;
+    }
+
+    wiface->rsc_index        = tl_id;
+    wiface->worker           = worker;
+    wiface->event_fd         = -1;
+    wiface->activate_count   = 0;
+    wiface->check_events_id  = UCS_CALLBACKQ_ID_NULL;
+    wiface->proxy_recv_count = 0;
+    wiface->post_count       = 0;
+    wiface->flags            = 0;
+    return wiface;
+}
+
+static int
+ucp_worker_iface_can_open_lazy(ucp_worker_h worker, ucp_rsc_index_t tl_id)
+{
+    ucp_context_h context = worker->context;
+    ucp_tl_iface_cache_t *cache;
+    uint64_t cap_flags;
+    int valid;
+
+    if ((context->tl_iface_cache == NULL) ||
+        (context->tl_rscs[tl_id].flags & UCP_TL_RSC_FLAG_SOCKADDR) ||
+        ucp_shared_iface_is_enabled(context, tl_id)) {
+        return 0;
+    }
+
+    cache = &context->tl_iface_cache[tl_id];
+
+    UCP_THREAD_CS_ENTER(&context->mt_lock);
+    valid     = cache->valid;
+    cap_flags = cache->attr.cap.flags;
+    UCP_THREAD_CS_EXIT(&context->mt_lock);
+
+    /* Peers of a point-to-point transport connect to endpoint addresses, which
+     * are created after the interface is opened, so the saved interface
+     * address can be advertised instead. Tag offload requires posting receive
+     * buffers to the interface in advance. */
+    return valid && (cap_flags & UCT_IFACE_FLAG_CONNECT_TO_EP) &&
+           !(cap_flags & (UCT_IFACE_FLAG_CONNECT_TO_IFACE |
+                          UCT_IFACE_FLAG_TAG_EAGER_BCOPY  |
+                          UCT_IFACE_FLAG_TAG_RNDV_ZCOPY));
+}
+
+static ucs_status_t
+ucp_worker_iface_create_lazy(ucp_worker_h worker, ucp_rsc_index_t tl_id,
+                             ucp_worker_iface_t **wiface_p)
+{
+    ucp_context_h context = worker->context;
+    ucp_worker_iface_t *wiface;
+
+    wiface = ucp_worker_iface_alloc(worker, tl_id);
+    if (wiface == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    wiface->iface = NULL;
+    wiface->attr  = context->tl_iface_cache[tl_id].attr;
+
+    ucs_debug("deferred opening interface[%d] using "UCT_TL_RESOURCE_DESC_FMT
+              " on worker %p", tl_id,
+              UCT_TL_RESOURCE_DESC_ARG(&context->tl_rscs[tl_id].tl_rsc),
+              worker);
+
+    *wiface_p = wiface;
+    return UCS_OK;
+}
+
+/* Save the attributes and addresses of an opened interface on the context, to
+ * let next workers open it lazily */
+static void ucp_worker_iface_cache_save(ucp_worker_iface_t *wiface)
+{
+    ucp_context_h context = wiface->worker->context;
+    ucp_tl_iface_cache_t *cache;
+    ucs_status_t status;
+    void *dev_addr;
+
+    if ((context->tl_iface_cache == NULL) ||
+        (context->tl_rscs[wiface->rsc_index].flags &
+         UCP_TL_RSC_FLAG_SOCKADDR)) {
+        return;
+    }
+
+    cache = &context->tl_iface_cache[wiface->rsc_index];
+
+    UCP_THREAD_CS_ENTER(&context->mt_lock);
+    if (cache->valid) {
+        goto out;
+    }
+
+    /* Allocate at least one byte, to distinguish from allocation failure */
+    dev_addr = ucs_malloc(wiface->attr.device_addr_len +
+                          wiface->attr.iface_addr_len + 1,
+                          "ucp_tl_iface_cache_addr");
+    if (dev_addr == NULL) {
+        goto out;
+    }
+
+    status = uct_iface_get_device_address(wiface->iface, dev_addr);
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
+    cache->iface_addr = UCS_PTR_BYTE_OFFSET(dev_addr,
+                                            wiface->attr.device_addr_len);
+    status = uct_iface_get_address(wiface->iface, cache->iface_addr);
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
+    cache->dev_addr = dev_addr;
+    cache->attr     = wiface->attr;
+    cache->valid    = 1;
+    goto out;
+
+err_free:
+    ucs_free(dev_addr);
+out:
+    UCP_THREAD_CS_EXIT(&context->mt_lock);
+}
+
 /**
  * @brief  Open all resources as interfaces on this worker
  *
@@ -1031,7 +1205,6 @@ ucp_worker_select_best_ifaces(ucp_worker_h worker, ucp_tl_bitmap_t *tl_bitmap_p)
 static ucs_status_t ucp_worker_add_resource_ifaces(ucp_worker_h worker)
 {
     ucp_context_h context = worker->context;
-    ucp_tl_resource_desc_t *resource;
     uct_iface_params_t iface_params;
     ucp_rsc_index_t tl_id, iface_id;
     ucp_worker_iface_t *wiface;
@@ -1062,20 +1235,14 @@ static ucs_status_t ucp_worker_add_resource_ifaces(ucp_worker_h worker)
     iface_id           = 0;
 
     UCS_BITMAP_FOR_EACH_BIT(tl_bitmap, tl_id) {
-        iface_params.field_mask = UCT_IFACE_PARAM_FIELD_OPEN_MODE;
-        resource = &context->tl_rscs[tl_id];
-
-        if (resource->flags & UCP_TL_RSC_FLAG_SOCKADDR) {
-            iface_params.open_mode            = UCT_IFACE_OPEN_MODE_SOCKADDR_CLIENT;
+        if (ucp_worker_iface_can_open_lazy(worker, tl_id)) {
+            status = ucp_worker_iface_create_lazy(worker, tl_id,
+                                                  &worker->ifaces[iface_id++]);
         } else {
-            iface_params.open_mode            = UCT_IFACE_OPEN_MODE_DEVICE;
-            iface_params.field_mask          |= UCT_IFACE_PARAM_FIELD_DEVICE;
-            iface_params.mode.device.tl_name  = resource->tl_rsc.tl_name;
-            iface_params.mode.device.dev_name = resource->tl_rsc.dev_name;
+            ucp_worker_iface_resource_params(context, tl_id, &iface_params);
+            status = ucp_worker_iface_open(worker, tl_id, &iface_params,
+                                           &worker->ifaces[iface_id++]);
         }
-
-        status = ucp_worker_iface_open(worker, tl_id, &iface_params,
-                                       &worker->ifaces[iface_id++]);
         if (status != UCS_OK) {
             goto err_close_ifaces;
         }
@@ -1112,11 +1279,18 @@ static ucs_status_t ucp_worker_add_resource_ifaces(ucp_worker_h worker)
 
     iface_id = 0;
     UCS_BITMAP_FOR_EACH_BIT(tl_bitmap, tl_id) {
-        status = ucp_worker_iface_init(worker, tl_id,
-                                       worker->ifaces[iface_id++]);
+        wiface = worker->ifaces[iface_id++];
+        if (wiface->iface == NULL) {
+            /* Will be initialized when opened */
+            continue;
+        }
+
+        status = ucp_worker_iface_init(worker, tl_id, wiface);
         if (status != UCS_OK) {
             goto err_cleanup_ifaces;
         }
+
+        ucp_worker_iface_cache_save(wiface);
     }
 
     return UCS_OK;
@@ -1182,33 +1356,20 @@ ucp_worker_get_sys_device_distance(ucp_context_h context,
     return UCS_ERR_NO_RESOURCE;
 }
 
-ucs_status_t ucp_worker_iface_open(ucp_worker_h worker, ucp_rsc_index_t tl_id,
-                                   uct_iface_params_t *iface_params,
-                                   ucp_worker_iface_t **wiface_p)
+static ucs_status_t
+ucp_worker_uct_iface_open(ucp_worker_iface_t *wiface,
+                          uct_iface_params_t *iface_params)
 {
+    ucp_worker_h worker              = wiface->worker;
+    ucp_rsc_index_t tl_id            = wiface->rsc_index;
     ucp_context_h context            = worker->context;
     ucp_tl_resource_desc_t *resource = &context->tl_rscs[tl_id];
     uct_md_h md                      = context->tl_mds[resource->md_index].md;
     ucs_sys_dev_distance_t distance  = {.latency = 0, .bandwidth = 0};
     uct_iface_config_t *iface_config;
     const char *cfg_tl_name;
-    ucp_worker_iface_t *wiface;
     ucs_status_t status;
 
-    wiface = ucs_calloc(1, sizeof(*wiface), "ucp_iface");
-    if (wiface == NULL) {
-        return UCS_ERR_NO_MEMORY;
-    }
-
-    wiface->rsc_index        = tl_id;
-    wiface->worker           = worker;
-    wiface->event_fd         = -1;
-    wiface->activate_count   = 0;
-    wiface->check_events_id  = UCS_CALLBACKQ_ID_NULL;
-    wiface->proxy_recv_count = 0;
-    wiface->post_count       = 0;
-    wiface->flags            = 0;
-
     /* Read interface or md configuration */
     if (resource->flags & UCP_TL_RSC_FLAG_SOCKADDR) {
         cfg_tl_name = NULL;
@@ -1217,7 +1378,7 @@ ucs_status_t ucp_worker_iface_open(ucp_worker_h worker, ucp_rsc_index_t tl_id,
     }
     status = uct_md_iface_config_read(md, cfg_tl_name, NULL, NULL, &iface_config);
     if (status != UCS_OK) {
-        goto err_free_iface;
+        return status;
     }
 
     UCS_STATIC_ASSERT(UCP_WORKER_HEADROOM_PRIV_SIZE >= sizeof(ucp_eager_sync_hdr_t));
@@ -1256,13 +1417,21 @@ ucs_status_t ucp_worker_iface_open(ucp_worker_h worker, ucp_rsc_index_t tl_id,
         iface_params->keepalive_interval = context->config.keepalive_interval;
     }
 
-    /* Open UCT interface */
-    status = uct_iface_open(md, worker->uct, iface_params, iface_config,
-                            &wiface->iface);
+    /* Open UCT interface, or use the shared interface of the context */
+    status = ucp_shared_iface_open(worker, tl_id, iface_params, iface_config,
+                                   &wiface->iface);
+    if (status == UCS_OK) {
+        wiface->flags |= UCP_WORKER_IFACE_FLAG_SHARED;
+    }
+
+    if (status == UCS_ERR_UNSUPPORTED) {
+        status = uct_iface_open(md, worker->uct, iface_params, iface_config,
+                                &wiface->iface);
+    }
     uct_config_release(iface_config);
 
     if (status != UCS_OK) {
-       goto err_free_iface;
+       return status;
     }
 
     VALGRIND_MAKE_MEM_UNDEFINED(&wiface->attr, sizeof(wiface->attr));
@@ -1286,17 +1455,36 @@ ucs_status_t ucp_worker_iface_open(ucp_worker_h worker, ucp_rsc_index_t tl_id,
               tl_id, wiface->iface, UCT_TL_RESOURCE_DESC_ARG(&resource->tl_rsc),
               worker);
 
-    *wiface_p = wiface;
-
     return UCS_OK;
 
 err_close_iface:
     uct_iface_close(wiface->iface);
-err_free_iface:
-    ucs_free(wiface);
+    wiface->iface = NULL;
     return status;
 }
 
+ucs_status_t ucp_worker_iface_open(ucp_worker_h worker, ucp_rsc_index_t tl_id,
+                                   uct_iface_params_t *iface_params,
+                                   ucp_worker_iface_t **wiface_p)
+{
+    ucp_worker_iface_t *wiface;
+    ucs_status_t status;
+
+    wiface = ucp_worker_iface_alloc(worker, tl_id);
+    if (wiface == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    status = ucp_worker_uct_iface_open(wiface, iface_params);
+    if (status != UCS_OK) {
+        ucs_free(wiface);
+        return status;
+    }
+
+    *wiface_p = wiface;
+    return UCS_OK;
+}
+
 static void ucp_worker_iface_remove_event_handler(ucp_worker_iface_t *wiface)
 {
     ucs_status_t status;
@@ -1380,6 +1568,53 @@ err:
     return status;
 }
 
+ucs_status_t ucp_worker_iface_open_lazy(ucp_worker_iface_t *wiface)
+{
+    ucp_worker_h worker            = wiface->worker;
+    ucp_tl_iface_cache_t *cache    = &worker->context->tl_iface_cache[
+                                                              wiface->rsc_index];
+    size_t iface_addr_len          = wiface->attr.iface_addr_len;
+    size_t device_addr_len         = wiface->attr.device_addr_len;
+    uct_iface_params_t iface_params;
+    ucs_status_t status;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    if (wiface->iface != NULL) {
+        status = UCS_OK;
+        goto out;
+    }
+
+    ucp_worker_iface_resource_params(worker->context, wiface->rsc_index,
+                                     &iface_params);
+    status = ucp_worker_uct_iface_open(wiface, &iface_params);
+    if (status != UCS_OK) {
+        /* Keep advertising the saved attributes */
+        wiface->attr = cache->attr;
+        goto out;
+    }
+
+    /* The interface was advertised with the saved addresses */
+    ucs_assertv((wiface->attr.iface_addr_len == iface_addr_len) &&
+                (wiface->attr.device_addr_len == device_addr_len),
+                "iface_addr_len=%zu/%zu device_addr_len=%zu/%zu",
+                wiface->attr.iface_addr_len, iface_addr_len,
+                wiface->attr.device_addr_len, device_addr_len);
+
+    status = ucp_worker_iface_init(worker, wiface->rsc_index, wiface);
+    if (status != UCS_OK) {
+        ucp_worker_uct_iface_close(wiface);
+        wiface->attr = cache->attr;
+        goto out;
+    }
+
+    UCS_STATS_UPDATE_COUNTER(worker->stats, UCP_WORKER_STAT_IFACE_LAZY_OPEN, 1);
+
+out:
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return status;
+}
+
 void ucp_worker_iface_cleanup(ucp_worker_iface_t *wiface)
 {
     uct_worker_progress_unregister_safe(wiface->worker->uct,
@@ -1691,6 +1926,12 @@ char *ucp_worker_print_used_tls(const ucp_ep_config_key_t *key,
             }
         }
 
+        if ((ucp_ep_config_get_multi_lane_prio(key->rma_bw_lanes, lane) >= 0) &&
+            (context->config.features & UCP_FEATURE_STREAM)) {
+            /* large stream sends use rendezvous over RMA bandwidth lanes */
+            stream_lanes_map |= UCS_BIT(lane);
+        }
+
         if (key->tag_lane == lane) {
             /* tag_lane is initialized if TAG feature is requested */
             ucs_assert(context->config.features & UCP_FEATURE_TAG);
@@ -1771,6 +2012,9 @@ static ucs_status_t ucp_worker_init_mpools(ucp_worker_h worker)
         goto err_rkey_mp_cleanup;
     }
 
+    ucs_mpool_set_chunk_placement(&worker->am_mp,
+                                  &context->config.ext.am_mpool_placement);
+
     /* Create memory pool of bounce buffers */
     status = ucs_mpool_init(&worker->reg_mp, 0,
                             context->config.ext.seg_size + sizeof(ucp_mem_desc_t),
@@ -1780,6 +2024,9 @@ static ucs_status_t ucp_worker_init_mpools(ucp_worker_h worker)
         goto err_am_mp_cleanup;
     }
 
+    ucs_mpool_set_chunk_placement(&worker->reg_mp,
+                                  &context->config.ext.reg_mpool_placement);
+
     /* Create memory pool for pipelined rndv fragments */
     status = ucs_mpool_init(&worker->rndv_frag_mp, 0,
                             context->config.ext.rndv_frag_size + sizeof(ucp_mem_desc_t),
@@ -1789,6 +2036,9 @@ static ucs_status_t ucp_worker_init_mpools(ucp_worker_h worker)
         goto err_reg_mp_cleanup;
     }
 
+    ucs_mpool_set_chunk_placement(&worker->rndv_frag_mp,
+                                  &context->config.ext.rndv_frag_mpool_placement);
+
     return UCS_OK;
 
 err_reg_mp_cleanup:
@@ -1830,27 +2080,43 @@ ucp_worker_get_ep_config(ucp_worker_h worker, const ucp_ep_config_key_t *key,
     ucp_memtype_thresh_t *max_eager_short;
     ucs_status_t status;
     char tl_info[256];
+    khiter_t khiter;
+    int khret;
 
-    /* Search for the given key in the ep_config array */
-    for (ep_cfg_index = 0; ep_cfg_index < worker->ep_config_count;
-         ++ep_cfg_index) {
-        if (ucp_ep_config_is_equal(&worker->ep_config[ep_cfg_index].key, key)) {
-            goto out;
-        }
+    /* Search for the given key in the ep_config hash */
+    khiter = kh_get(ucp_worker_ep_config, &worker->ep_config_hash, key);
+    if (khiter != kh_end(&worker->ep_config_hash)) {
+        ep_cfg_index = kh_value(&worker->ep_config_hash, khiter);
+        goto out;
     }
 
-    if (worker->ep_config_count >= UCP_WORKER_MAX_EP_CONFIG) {
-        ucs_error("too many ep configurations: %d (max: %d)",
-                  worker->ep_config_count, UCP_WORKER_MAX_EP_CONFIG);
+    if (ucs_array_length(&worker->ep_config) >= UCP_WORKER_CFG_INDEX_NULL) {
+        ucs_error("too many ep configurations: %u (max: %d)",
+                  ucs_array_length(&worker->ep_config),
+                  UCP_WORKER_CFG_INDEX_NULL);
         return UCS_ERR_EXCEEDS_LIMIT;
     }
 
+    ep_config = ucs_malloc(sizeof(*ep_config), "ucp_ep_config");
+    if (ep_config == NULL) {
+        ucs_error("failed to allocate ep configuration");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    /* Add the new configuration before initializing it, since protocol
+     * selection accesses it by index */
+    ep_cfg_index = ucs_array_length(&worker->ep_config);
+    status       = ucs_array_append(ucp_ep_configs, &worker->ep_config);
+    if (status != UCS_OK) {
+        goto err_free_config;
+    }
+
+    ucs_array_elem(&worker->ep_config, ep_cfg_index) = ep_config;
+
     /* Create new configuration */
-    ep_cfg_index = worker->ep_config_count;
-    ep_config    = &worker->ep_config[ep_cfg_index];
-    status       = ucp_ep_config_init(worker, ep_config, key);
+    status = ucp_ep_config_init(worker, ep_config, key);
     if (status != UCS_OK) {
-        return status;
+        goto err_remove_config;
     }
 
     if (context->config.ext.proto_enable) {
@@ -1879,16 +2145,32 @@ ucp_worker_get_ep_config(ucp_worker_h worker, const ucp_ep_config_key_t *key,
         max_eager_short->memtype_on  = tag_short.max_length_host_mem;
     }
 
+    khiter = kh_put(ucp_worker_ep_config, &worker->ep_config_hash,
+                    &ep_config->key, &khret);
+    if (khret == UCS_KH_PUT_FAILED) {
+        status = UCS_ERR_NO_MEMORY;
+        goto err_config_cleanup;
+    }
+
+    ucs_assert_always(khret != UCS_KH_PUT_KEY_PRESENT);
+    kh_value(&worker->ep_config_hash, khiter) = ep_cfg_index;
+
     if (print_cfg) {
         ucs_info("%s", ucp_worker_print_used_tls(key, context, ep_cfg_index,
                                                  tl_info, sizeof(tl_info)));
     }
 
-    ++worker->ep_config_count;
-
 out:
     *cfg_index_p = ep_cfg_index;
     return UCS_OK;
+
+err_config_cleanup:
+    ucp_ep_config_cleanup(worker, ep_config);
+err_remove_config:
+    ucs_array_set_length(&worker->ep_config, ep_cfg_index);
+err_free_config:
+    ucs_free(ep_config);
+    return status;
 }
 
 ucs_status_t
@@ -1952,19 +2234,72 @@ err:
     return status;
 }
 
-static UCS_F_ALWAYS_INLINE void ucp_worker_keepalive_reset(ucp_worker_h worker)
+static ucs_status_t ucp_worker_keepalive_init(ucp_worker_h worker)
 {
-    worker->keepalive.iter = &worker->all_eps;
+    ucs_time_t interval = worker->context->config.keepalive_interval;
+    ucs_status_t status;
+
+    worker->keepalive.cb_id      = UCS_CALLBACKQ_ID_NULL;
+    worker->keepalive.ep_count   = 0;
+    worker->keepalive.iter_count = 0;
+    worker->keepalive.next_slot  = 0;
+    worker->keepalive.num_slots  = 1;
+
+    if (!ucp_worker_keepalive_is_enabled(worker)) {
+        return UCS_OK;
+    }
+
+    /* Keepalive deadlines are tracked with a resolution of a fraction of the
+     * interval, so EPs are checked in small batches instead of a full walk
+     * over all EPs every interval */
+    status = ucs_twheel_init(&worker->keepalive.twheel,
+                             ucs_max(interval / UCP_WORKER_KEEPALIVE_NUM_SLOTS,
+                                     1),
+                             ucs_get_time());
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    worker->keepalive.num_slots = ucs_max(interval /
+                                          worker->keepalive.twheel.res, 1);
+    return UCS_OK;
+}
+
+static void ucp_worker_wait_init(ucp_worker_h worker)
+{
+    ucp_context_h context = worker->context;
+
+    if (context->config.ext.wait_spin == UCS_TIME_AUTO) {
+        /* Start with the maximal spin time, and adapt it to the traffic */
+        worker->wait.spin_time      = context->config.ext.wait_spin_max;
+        worker->wait.avg_event_time = context->config.ext.wait_spin_max / 2;
+    } else {
+        worker->wait.spin_time      = context->config.ext.wait_spin;
+        worker->wait.avg_event_time = 0;
+    }
+
+    worker->wait.spin_count  = 0;
+    worker->wait.sleep_count = 0;
+    worker->wait.sleep_time  = 0;
+}
+
+static void ucp_worker_keepalive_cleanup(ucp_worker_h worker)
+{
+    if (ucp_worker_keepalive_is_enabled(worker)) {
+        ucs_twheel_cleanup(&worker->keepalive.twheel);
+    }
 }
 
 static void ucp_worker_destroy_configs(ucp_worker_h worker)
 {
     unsigned i;
 
-    for (i = 0; i < worker->ep_config_count; ++i) {
-        ucp_ep_config_cleanup(worker, &worker->ep_config[i]);
+    kh_destroy_inplace(ucp_worker_ep_config, &worker->ep_config_hash);
+    for (i = 0; i < ucs_array_length(&worker->ep_config); ++i) {
+        ucp_ep_config_cleanup(worker, ucs_array_elem(&worker->ep_config, i));
+        ucs_free(ucs_array_elem(&worker->ep_config, i));
     }
-    worker->ep_config_count = 0;
+    ucs_array_cleanup_dynamic(&worker->ep_config);
 
     for (i = 0; i < worker->rkey_config_count; ++i) {
         ucp_proto_select_cleanup(&worker->rkey_config[i].proto_select);
@@ -2005,6 +2340,43 @@ static void ucp_worker_vfs_show_thread_mode(void *obj,
     UCS_ASYNC_UNBLOCK(&worker->async);
 }
 
+static void ucp_worker_vfs_show_wait_spin_time(void *obj,
+                                               ucs_string_buffer_t *strb)
+{
+    ucp_worker_h worker = obj;
+
+    ucs_string_buffer_appendf(strb, "%.3f us\n",
+                              ucs_time_to_usec(worker->wait.spin_time));
+}
+
+static void ucp_worker_vfs_show_wait_spin_count(void *obj,
+                                                ucs_string_buffer_t *strb)
+{
+    ucp_worker_h worker = obj;
+
+    ucs_string_buffer_appendf(strb, "%" PRIu64 "\n", worker->wait.spin_count);
+}
+
+static void ucp_worker_vfs_show_wait_sleep_count(void *obj,
+                                                 ucs_string_buffer_t *strb)
+{
+    ucp_worker_h worker = obj;
+
+    ucs_string_buffer_appendf(strb, "%" PRIu64 "\n", worker->wait.sleep_count);
+}
+
+static void ucp_worker_vfs_show_wait_sleep_time(void *obj,
+                                                ucs_string_buffer_t *strb)
+{
+    ucp_worker_h worker  = obj;
+    uint64_t sleep_count = worker->wait.sleep_count;
+
+    ucs_string_buffer_appendf(strb, "%.3f us\n",
+                              (sleep_count == 0) ? 0.0 :
+                              ucs_time_to_usec(worker->wait.sleep_time) /
+                              sleep_count);
+}
+
 void ucp_worker_create_vfs(ucp_context_h context, ucp_worker_h worker)
 {
     ucs_vfs_obj_add_dir(context, worker, "worker/%s", worker->name);
@@ -2014,6 +2386,14 @@ void ucp_worker_create_vfs(ucp_context_h context, ucp_worker_h worker)
                             "address_name");
     ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_thread_mode,
                             "thread_mode");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_wait_spin_time,
+                            "wait/spin_time");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_wait_spin_count,
+                            "wait/spin_count");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_wait_sleep_count,
+                            "wait/sleep_count");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_wait_sleep_time,
+                            "wait/avg_sleep_time");
 }
 
 ucs_status_t ucp_worker_create(ucp_context_h context,
@@ -2035,23 +2415,20 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     worker->flush_ops_count      = 0;
     worker->inprogress           = 0;
     worker->rkey_config_count    = 0;
-    worker->ep_config_count      = 0;
     worker->num_active_ifaces    = 0;
     worker->num_ifaces           = 0;
     worker->am_message_id        = ucs_generate_uuid(0);
     worker->rkey_ptr_cb_id       = UCS_CALLBACKQ_ID_NULL;
-    worker->keepalive.cb_id      = UCS_CALLBACKQ_ID_NULL;
-    worker->keepalive.last_round = 0;
-    worker->keepalive.lane_map   = 0;
-    worker->keepalive.ep_count   = 0;
-    worker->keepalive.iter_count = 0;
-    ucp_worker_keepalive_reset(worker);
+    ucp_worker_wait_init(worker);
     ucs_queue_head_init(&worker->rkey_ptr_reqs);
     ucs_list_head_init(&worker->arm_ifaces);
     ucs_list_head_init(&worker->stream_ready_eps);
     ucs_list_head_init(&worker->all_eps);
     kh_init_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
+    kh_init_inplace(ucp_worker_ep_config, &worker->ep_config_hash);
+    ucs_array_init_dynamic(&worker->ep_config);
     kh_init_inplace(ucp_worker_discard_uct_ep_hash, &worker->discard_uct_ep_hash);
+    ucp_address_dicts_init(worker);
 
     /* Copy user flags, and mask-out unsupported flags for compatibility */
     worker->flags = UCP_PARAM_VALUE(WORKER, params, flags, FLAGS, 0) &
@@ -2095,6 +2472,16 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
         ucs_strided_alloc_init(&worker->ep_alloc, sizeof(ucp_ep_t), 2);
     }
 
+    /* Control extensions are allocated from a pool, rather than by malloc, to
+     * avoid the heap overhead with a large number of endpoints */
+    status = ucs_mpool_init(&worker->ep_control_mp, 0,
+                            sizeof(ucp_ep_ext_control_t), 0, 1,
+                            UCP_WORKER_EP_CONTROL_MPOOL_ELEMS, UINT_MAX,
+                            &ucp_ep_control_mpool_ops, "ucp_ep_control");
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
     worker->user_data = UCP_PARAM_VALUE(WORKER, params, user_data, USER_DATA,
                                         NULL);
 
@@ -2113,14 +2500,19 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
 
     status = ucs_ptr_map_init(&worker->ptr_map);
     if (status != UCS_OK) {
-        goto err_free;
+        goto err_ep_control_mp_cleanup;
+    }
+
+    status = ucp_worker_keepalive_init(worker);
+    if (status != UCS_OK) {
+        goto err_destroy_ptr_map;
     }
 
     /* Create statistics */
     status = UCS_STATS_NODE_ALLOC(&worker->stats, &ucp_worker_stats_class,
                                   ucs_stats_get_root(), "-%p", worker);
     if (status != UCS_OK) {
-        goto err_destroy_ptr_map;
+        goto err_keepalive_cleanup;
     }
 
     status = UCS_STATS_NODE_ALLOC(&worker->tm_offload_stats,
@@ -2230,10 +2622,15 @@ err_free_tm_offload_stats:
     UCS_STATS_NODE_FREE(worker->tm_offload_stats);
 err_free_stats:
     UCS_STATS_NODE_FREE(worker->stats);
+err_keepalive_cleanup:
+    ucp_worker_keepalive_cleanup(worker);
 err_destroy_ptr_map:
     ucs_ptr_map_destroy(&worker->ptr_map);
+err_ep_control_mp_cleanup:
+    ucs_mpool_cleanup(&worker->ep_control_mp, 1);
 err_free:
     ucs_strided_alloc_cleanup(&worker->ep_alloc);
+    ucp_address_dicts_cleanup(worker);
     kh_destroy_inplace(ucp_worker_discard_uct_ep_hash,
                        &worker->discard_uct_ep_hash);
     kh_destroy_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
@@ -2435,8 +2832,11 @@ void ucp_worker_destroy(ucp_worker_h worker)
     ucs_async_context_cleanup(&worker->async);
     UCS_STATS_NODE_FREE(worker->tm_offload_stats);
     UCS_STATS_NODE_FREE(worker->stats);
+    ucp_worker_keepalive_cleanup(worker);
     ucs_ptr_map_destroy(&worker->ptr_map);
+    ucs_mpool_cleanup(&worker->ep_control_mp, 1);
     ucs_strided_alloc_cleanup(&worker->ep_alloc);
+    ucp_address_dicts_cleanup(worker);
     kh_destroy_inplace(ucp_worker_discard_uct_ep_hash,
                        &worker->discard_uct_ep_hash);
     kh_destroy_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
@@ -2444,11 +2844,18 @@ void ucp_worker_destroy(ucp_worker_h worker)
     ucs_free(worker);
 }
 
+size_t ucp_worker_ep_memory_size(ucp_worker_h worker)
+{
+    return (worker->ep_alloc.stride_count * worker->ep_alloc.elem_size) +
+           ucs_mpool_elem_size(&worker->ep_control_mp);
+}
+
 ucs_status_t ucp_worker_query(ucp_worker_h worker,
                               ucp_worker_attr_t *attr)
 {
     ucp_context_h context = worker->context;
     ucs_status_t status   = UCS_OK;
+    unsigned pack_flags   = UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT;
     ucp_tl_bitmap_t tl_bitmap;
     ucp_rsc_index_t tl_id;
 
@@ -2470,10 +2877,14 @@ ucs_status_t ucp_worker_query(ucp_worker_h worker,
                     }
                 }
             }
+
+            if (attr->address_flags & UCP_WORKER_ADDRESS_FLAG_COMPACT) {
+                pack_flags = (pack_flags & ~UCP_ADDRESS_PACK_FLAG_EP_ADDR) |
+                             UCP_ADDRESS_PACK_FLAG_COMPACT;
+            }
         }
 
-        status = ucp_address_pack(worker, NULL, &tl_bitmap,
-                                  UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT, NULL,
+        status = ucp_address_pack(worker, NULL, &tl_bitmap, pack_flags, NULL,
                                   &attr->address_length,
                                   (void**)&attr->address);
     }
@@ -2616,11 +3027,76 @@ void ucp_worker_wait_mem(ucp_worker_h worker, void *address)
     ucs_arch_wait_mem(address);
 }
 
+/* Busy-poll the worker for up to the spin time, return nonzero if some event
+ * was found */
+static unsigned ucp_worker_wait_spin(ucp_worker_h worker, ucs_time_t start)
+{
+    ucs_time_t spin_time = worker->wait.spin_time;
+    ucs_time_t deadline;
+    unsigned count;
+
+    if (spin_time == 0) {
+        return 0;
+    }
+
+    deadline = (spin_time == UCS_TIME_INFINITY) ? UCS_TIME_INFINITY :
+               (start + spin_time);
+    do {
+        count = ucp_worker_progress(worker);
+        if (count != 0) {
+            return count;
+        }
+    } while (ucs_get_time() < deadline);
+
+    return 0;
+}
+
+/* Adapt the spin time to the time it took an event to arrive */
+static void ucp_worker_wait_adapt(ucp_worker_h worker, ucs_time_t elapsed)
+{
+    ucp_context_h context = worker->context;
+    ucs_time_t spin_time;
+
+    if (context->config.ext.wait_spin != UCS_TIME_AUTO) {
+        return;
+    }
+
+    /* Moving average with weight 1/8 for the last event */
+    worker->wait.avg_event_time += (elapsed / 8) -
+                                   (worker->wait.avg_event_time / 8);
+
+    /* Spin for twice the average time it takes an event to arrive; if events
+     * arrive slower than the maximal spin time, spinning only burns the CPU */
+    spin_time              = 2 * worker->wait.avg_event_time;
+    worker->wait.spin_time = (spin_time <= context->config.ext.wait_spin_max) ?
+                             spin_time : 0;
+}
+
+static void
+ucp_worker_wait_update(ucp_worker_h worker, ucs_time_t start, int slept)
+{
+    ucs_time_t elapsed = ucs_get_time() - start;
+
+    if (slept) {
+        ++worker->wait.sleep_count;
+        worker->wait.sleep_time += elapsed;
+        UCS_STATS_UPDATE_COUNTER(worker->stats, UCP_WORKER_STAT_WAIT_SLEEP, 1);
+        UCS_STATS_UPDATE_COUNTER(worker->stats, UCP_WORKER_STAT_WAIT_SLEEP_USEC,
+                                 ucs_time_to_usec(elapsed));
+    } else {
+        ++worker->wait.spin_count;
+        UCS_STATS_UPDATE_COUNTER(worker->stats, UCP_WORKER_STAT_WAIT_SPIN, 1);
+    }
+
+    ucp_worker_wait_adapt(worker, elapsed);
+}
+
 ucs_status_t ucp_worker_wait(ucp_worker_h worker)
 {
     ucp_worker_iface_t *wiface;
     struct pollfd *pfd;
     ucs_status_t status;
+    ucs_time_t start;
     nfds_t nfds;
     int ret;
 
@@ -2629,10 +3105,19 @@ ucs_status_t ucp_worker_wait(ucp_worker_h worker)
     UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_WAKEUP,
                                     return UCS_ERR_INVALID_PARAM);
 
+    start = ucs_get_time();
+    if (ucp_worker_wait_spin(worker, start)) {
+        ucp_worker_wait_update(worker, start, 0);
+        return UCS_OK;
+    }
+
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
     status = ucp_worker_arm(worker);
     if (status == UCS_ERR_BUSY) { /* if UCS_ERR_BUSY returned - no poll() must called */
+        /* An event is pending, but spinning did not progress it, so it is not
+         * a spin hit; only account for its arrival time */
+        ucp_worker_wait_adapt(worker, ucs_get_time() - start);
         status = UCS_OK;
         goto out_unlock;
     } else if (status != UCS_OK) {
@@ -2670,6 +3155,7 @@ ucs_status_t ucp_worker_wait(ucp_worker_h worker)
         ret = poll(pfd, nfds, -1);
         if (ret >= 0) {
             ucs_assertv(ret == 1, "ret=%d", ret);
+            ucp_worker_wait_update(worker, start, 1);
             status = UCS_OK;
             goto out;
         } else {
@@ -2716,6 +3202,18 @@ void ucp_worker_release_address(ucp_worker_h worker, ucp_address_t *address)
     ucs_free(address);
 }
 
+ucs_status_t ucp_worker_add_address_dict(ucp_worker_h worker,
+                                         const ucp_address_t *address)
+{
+    ucs_status_t status;
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+    status = ucp_address_dict_add(worker, address);
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+
+    return status;
+}
+
 void ucp_worker_print_info(ucp_worker_h worker, FILE *stream)
 {
     ucp_context_h context = worker->context;
@@ -2773,89 +3271,67 @@ void ucp_worker_print_info(ucp_worker_h worker, FILE *stream)
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
 }
 
-static UCS_F_ALWAYS_INLINE ucp_ep_h
-ucp_worker_keepalive_current_ep(ucp_worker_h worker)
+static void ucp_worker_keepalive_timer_cb(ucs_wtimer_t *timer)
 {
-    ucp_ep_ext_gen_t *ep_ext = ucs_container_of(worker->keepalive.iter,
-                                                ucp_ep_ext_gen_t, ep_list);
-    return ucp_ep_from_ext_gen(ep_ext);
-}
+    ucp_ep_ext_control_t *ep_ext = ucs_container_of(timer, ucp_ep_ext_control_t,
+                                                    keepalive.timer);
+    ucp_ep_h ep                  = ep_ext->keepalive.ep;
+    ucp_worker_h worker          = ep->worker;
+    ucs_twheel_t *twheel         = &worker->keepalive.twheel;
 
-static UCS_F_ALWAYS_INLINE void
-ucp_worker_keepalive_next_ep(ucp_worker_h worker)
-{
-    ucp_ep_h ep;
+    if (ep->flags & UCP_EP_FLAG_FAILED) {
+        /* error was already detected, nothing to check anymore */
+        ep_ext->keepalive.lane_map = 0;
+        return;
+    }
+
+    if (worker->keepalive.ep_count >=
+        worker->context->config.ext.keepalive_num_eps) {
+        /* limit the work done in a single sweep, the rest of the expired EPs
+         * are postponed to the next tick of the wheel */
+        ucs_wtimer_add(twheel, timer, twheel->res);
+        return;
+    }
 
-    worker->keepalive.iter = worker->keepalive.iter->next;
-    if (worker->keepalive.iter == &worker->all_eps) {
-        /* if next list item points to all_eps then step one more time */
-        worker->keepalive.iter = worker->keepalive.iter->next;
+    if (ep_ext->keepalive.lane_map == 0) {
+        ep_ext->keepalive.lane_map = ucp_ep_config(ep)->key.ep_check_map;
     }
 
-    ucs_assert(worker->keepalive.iter != &worker->all_eps);
-    ep                         = ucp_worker_keepalive_current_ep(worker);
-    worker->keepalive.lane_map = ((ep->cfg_index != UCP_WORKER_CFG_INDEX_NULL) &&
-                                  !(ep->flags & UCP_EP_FLAG_FAILED)) ?
-                                 ucp_ep_config(ep)->key.ep_check_map : 0;
+    ucs_trace_func("worker %p: do keepalive on ep %p lane_map 0x%x", worker,
+                   ep, ep_ext->keepalive.lane_map);
+    ucp_ep_do_keepalive(ep, &ep_ext->keepalive.lane_map);
+    ++worker->keepalive.ep_count;
+
+    if (ep_ext->keepalive.lane_map != 0) {
+        /* in case if EP has no resources to send keepalive message, retry
+         * the remaining lanes on the next tick */
+        ucs_wtimer_add(twheel, timer, twheel->res);
+    } else {
+        ucs_wtimer_add(twheel, timer,
+                       worker->context->config.keepalive_interval);
+    }
 }
 
 static UCS_F_NOINLINE unsigned
 ucp_worker_do_keepalive_progress(ucp_worker_h worker)
 {
-    ucs_time_t now;
-    ucs_list_link_t *iter_begin;
-    ucp_ep_h ep;
-
     ucs_assert(worker->context->config.ext.keepalive_num_eps != 0);
 
-    now = ucs_get_time();
-    if (ucs_likely((now - worker->keepalive.last_round) <
-                   worker->context->config.keepalive_interval)) {
-        return 0;
-    }
-
-    ucs_trace_func("worker %p: keepalive round", worker);
-
-    if (ucs_unlikely(ucs_list_is_empty(&worker->all_eps))) {
-        ucs_assert(worker->keepalive.iter == &worker->all_eps);
-        ucs_trace("worker %p: keepalive ep list is empty - disabling", worker);
+    if (ucs_unlikely(ucs_twheel_is_empty(&worker->keepalive.twheel))) {
+        ucs_trace("worker %p: keepalive wheel is empty - disabling", worker);
         uct_worker_progress_unregister_safe(worker->uct,
                                             &worker->keepalive.cb_id);
         return 0;
     }
 
-    if (ucs_unlikely(worker->keepalive.iter == &worker->all_eps)) {
-        ucp_worker_keepalive_next_ep(worker);
-    }
-
-    iter_begin = worker->keepalive.iter;
-    /* use own loop for elements because standard for_each skips
-     * head element */
-    /* TODO: use more optimal algo to enumerate EPs to keepalive
-     * (linked list) */
-    do {
-        ep = ucp_worker_keepalive_current_ep(worker);
-        ucs_trace_func("worker %p: do keepalive on ep %p lane_map 0x%x", worker, ep,
-                        worker->keepalive.lane_map);
-        ucp_ep_do_keepalive(ep, &worker->keepalive.lane_map);
-        if (worker->keepalive.lane_map != 0) {
-            /* in case if EP has no resources to send keepalive message
-             * then just return without update of last_round timestamp,
-             * on next progress iteration we will continue from this point */
-            goto out_no_resources;
-        }
-
-        worker->keepalive.ep_count++;
-        ucp_worker_keepalive_next_ep(worker);
-    } while ((iter_begin != worker->keepalive.iter) &&
-             (worker->keepalive.ep_count < worker->context->config.ext.keepalive_num_eps));
+    worker->keepalive.ep_count = 0;
+    ucs_twheel_sweep(&worker->keepalive.twheel, ucs_get_time());
 
-    ucs_trace("worker %p: sent keepalive on %u endpoints", worker,
-              worker->keepalive.ep_count);
-    worker->keepalive.last_round = now;
-    worker->keepalive.ep_count   = 0;
+    if (worker->keepalive.ep_count != 0) {
+        ucs_trace("worker %p: sent keepalive on %u endpoints", worker,
+                  worker->keepalive.ep_count);
+    }
 
-out_no_resources:
     return worker->keepalive.ep_count;
 }
 
@@ -2872,7 +3348,10 @@ static unsigned ucp_worker_keepalive_progress(void *arg)
 
 void ucp_worker_keepalive_add_ep(ucp_ep_h ep)
 {
-    ucp_worker_h worker = ep->worker;
+    ucp_worker_h worker          = ep->worker;
+    ucp_ep_ext_control_t *ep_ext = ucp_ep_ext_control(ep);
+    ucs_twheel_t *twheel         = &worker->keepalive.twheel;
+    unsigned slot;
 
     ucs_assert(ep->cfg_index != UCP_WORKER_CFG_INDEX_NULL);
 
@@ -2886,6 +3365,25 @@ void ucp_worker_keepalive_add_ep(ucp_ep_h ep)
         return;
     }
 
+    if (ep_ext->keepalive.timer.is_active) {
+        /* EP configuration was updated, the next keepalive takes the new
+         * ep_check_map */
+        return;
+    }
+
+    /* Spread the first keepalive of EPs which are connected at the same time
+     * over the whole interval, to avoid bursts of keepalive messages */
+    slot = worker->keepalive.next_slot++ % worker->keepalive.num_slots;
+
+    ep_ext->keepalive.ep       = ep;
+    ep_ext->keepalive.lane_map = 0;
+    ucs_wtimer_init(&ep_ext->keepalive.timer, ucp_worker_keepalive_timer_cb);
+    /* The wheel is updated only by the progress, so add the time elapsed
+     * since its last sweep */
+    ucs_wtimer_add(twheel, &ep_ext->keepalive.timer,
+                   (ucs_get_time() - ucs_twheel_get_time(twheel)) +
+                   (twheel->res * (slot + 1)));
+
     ucs_trace("ep %p flags 0x%x: adding to keepalive lane_map 0x%x", ep,
               ep->flags, ucp_ep_config(ep)->key.ep_check_map);
     uct_worker_progress_register_safe(worker->uct,
@@ -2902,20 +3400,12 @@ void ucp_worker_keepalive_remove_ep(ucp_ep_h ep)
     ucs_assert(!(ep->flags & UCP_EP_FLAG_INTERNAL));
 
     if (!ucp_worker_keepalive_is_enabled(worker)) {
-        ucs_assert(worker->keepalive.iter == &worker->all_eps);
+        ucs_assert(!ucp_ep_ext_control(ep)->keepalive.timer.is_active);
         return;
     }
 
-    ucs_assert(!ucs_list_is_empty(&worker->all_eps));
-
-    if (ucs_list_is_only(&worker->all_eps, &ucp_ep_ext_gen(ep)->ep_list)) {
-        /* this is the last EP in worker */
-        worker->keepalive.iter = &worker->all_eps;
-    } else if (worker->keepalive.iter == &ucp_ep_ext_gen(ep)->ep_list) {
-        /* if iterator points into EP to be removed - then
-         * step to next EP */
-        ucp_worker_keepalive_next_ep(worker);
-    }
+    ucs_wtimer_remove(&worker->keepalive.twheel,
+                      &ucp_ep_ext_control(ep)->keepalive.timer);
 }
 
 static void ucp_worker_discard_tl_uct_ep(ucp_ep_h ucp_ep, uct_ep_h uct_ep,
@@ -106,9 +106,12 @@ enum {
                                                                of arm_ifaces list, so
                                                                it needs to be armed
                                                                in ucp_worker_arm(). */
-    UCP_WORKER_IFACE_FLAG_UNUSED            = UCS_BIT(2)  /**< There is another UCP iface
+    UCP_WORKER_IFACE_FLAG_UNUSED            = UCS_BIT(2), /**< There is another UCP iface
                                                                with the same caps, but
                                                                with better performance */
+    UCP_WORKER_IFACE_FLAG_SHARED            = UCS_BIT(3)  /**< UCP iface uses a transport
+                                                               interface shared by the
+                                                               workers of the context */
 };
 
 
@@ -134,6 +137,15 @@ enum {
     UCP_WORKER_STAT_TAG_RX_RNDV_SEND_RTR,
     UCP_WORKER_STAT_TAG_RX_RNDV_RKEY_PTR,
 
+    /* Number of ucp_worker_wait() calls which found an event by busy-polling,
+     * and number of calls which went to sleep and total time slept (usec) */
+    UCP_WORKER_STAT_WAIT_SPIN,
+    UCP_WORKER_STAT_WAIT_SLEEP,
+    UCP_WORKER_STAT_WAIT_SLEEP_USEC,
+
+    /* Number of transport interfaces which were opened on first use */
+    UCP_WORKER_STAT_IFACE_LAZY_OPEN,
+
     UCP_WORKER_STAT_LAST
 };
 
@@ -192,11 +204,28 @@ KHASH_TYPE(ucp_worker_rkey_config, ucp_rkey_config_key_t, ucp_worker_cfg_index_t
 typedef khash_t(ucp_worker_rkey_config) ucp_worker_rkey_config_hash_t;
 
 
+/* Hash map to find ep config index by ep config key. The key points to the
+ * key of the configuration itself. */
+KHASH_TYPE(ucp_worker_ep_config, const ucp_ep_config_key_t*,
+           ucp_worker_cfg_index_t);
+typedef khash_t(ucp_worker_ep_config) ucp_worker_ep_config_hash_t;
+
+
+/* Array of endpoint configurations. Every configuration is allocated
+ * separately, so its address does not change when the array grows. */
+UCS_ARRAY_DECLARE_TYPE(ucp_ep_configs, unsigned, ucp_ep_config_t*)
+
+
 /* Hash map of UCT EPs that are being discarded on UCP Worker */
 KHASH_TYPE(ucp_worker_discard_uct_ep_hash, uct_ep_h, ucp_request_t*);
 typedef khash_t(ucp_worker_discard_uct_ep_hash) ucp_worker_discard_uct_ep_hash_t;
 
 
+/* Hash map of address dictionaries for unpacking compact addresses */
+KHASH_TYPE(ucp_worker_address_dict, uint64_t, ucp_unpacked_address_t*);
+typedef khash_t(ucp_worker_address_dict) ucp_worker_address_dict_hash_t;
+
+
 /**
  * UCP worker iface, which encapsulates UCT iface, its attributes and
  * some auxiliary info needed for tag matching offloads.
@@ -258,6 +287,7 @@ typedef struct ucp_worker {
 
     void                             *user_data;          /* User-defined data */
     ucs_strided_alloc_t              ep_alloc;            /* Endpoint allocator */
+    ucs_mpool_t                      ep_control_mp;       /* Endpoint control extensions */
     ucs_list_link_t                  stream_ready_eps;    /* List of EPs with received stream data */
     ucs_list_link_t                  all_eps;             /* List of all endpoints */
     ucs_conn_match_ctx_t             conn_match_ctx;      /* Endpoint-to-endpoint matching context */
@@ -276,6 +306,13 @@ typedef struct ucp_worker {
     ucp_tag_match_t                  tm;                  /* Tag-matching queues and offload info */
     ucs_array_t(ucp_am_cbs)          am;                  /* Array of AM callbacks and their data */
     uint64_t                         am_message_id;       /* For matching long AMs */
+    struct {
+        ucs_mpool_t                  mp;                  /* Buffers of aggregated AMs */
+        ucs_list_link_t              descs;               /* Aggregates which were not
+                                                           * sent yet, oldest first */
+        uct_worker_cb_id_t           prog_id;             /* Progress callback which
+                                                           * sends the aggregates */
+    } am_agg;
     ucp_ep_h                         mem_type_ep[UCS_MEMORY_TYPE_LAST]; /* Memory type EPs */
 
     UCS_STATS_NODE_DECLARE(stats)
@@ -286,23 +323,36 @@ typedef struct ucp_worker {
 
     ucp_worker_rkey_config_hash_t    rkey_config_hash;    /* RKEY config key -> index */
     ucp_worker_discard_uct_ep_hash_t discard_uct_ep_hash; /* Hash of discarded UCT EPs */
+    ucp_worker_address_dict_hash_t   address_dicts;       /* Dictionary id -> address */
     ucs_ptr_map_t                    ptr_map;             /* UCP objects key to ptr mapping */
 
-    unsigned                         ep_config_count;     /* Current number of ep configurations */
-    ucp_ep_config_t                  ep_config[UCP_WORKER_MAX_EP_CONFIG];
+    ucp_worker_ep_config_hash_t      ep_config_hash;      /* EP config key -> index */
+    ucs_array_t(ucp_ep_configs)      ep_config;           /* EP configurations by index */
 
     unsigned                         rkey_config_count;   /* Current number of rkey configurations */
     ucp_rkey_config_t                rkey_config[UCP_WORKER_MAX_RKEY_CONFIG];
 
     struct {
         uct_worker_cb_id_t           cb_id;               /* Keepalive callback id */
-        ucs_time_t                   last_round;          /* Last round timespamp */
-        ucs_list_link_t              *iter;               /* Last EP processed keepalive */
-        ucp_lane_map_t               lane_map;            /* Lane map used to retry after no-resources */
-        unsigned                     ep_count;            /* Number of EPs processed in current time slot */
+        ucs_twheel_t                 twheel;              /* Keepalive deadlines of EPs */
+        unsigned                     num_slots;           /* Number of wheel ticks in
+                                                           * keepalive interval */
+        unsigned                     next_slot;           /* Slot of the first keepalive
+                                                           * of the next added EP */
+        unsigned                     ep_count;            /* Number of EPs processed in current sweep */
         unsigned                     iter_count;          /* Number of progress iterations to skip,
                                                            * used to minimize call of ucs_get_time */
     } keepalive;
+
+    struct {
+        ucs_time_t                   spin_time;           /* Time to busy-poll before sleeping */
+        ucs_time_t                   avg_event_time;      /* Moving average of time until
+                                                           * an event arrives */
+        uint64_t                     spin_count;          /* Number of waits which found an
+                                                           * event by busy-polling */
+        uint64_t                     sleep_count;         /* Number of waits which slept */
+        ucs_time_t                   sleep_time;          /* Total time slept */
+    } wait;
 } ucp_worker_t;
 
 
@@ -327,6 +377,8 @@ ucs_status_t ucp_worker_iface_open(ucp_worker_h worker, ucp_rsc_index_t tl_id,
                                    uct_iface_params_t *iface_params,
                                    ucp_worker_iface_t **wiface);
 
+ucs_status_t ucp_worker_iface_open_lazy(ucp_worker_iface_t *wiface);
+
 ucs_status_t ucp_worker_iface_init(ucp_worker_h worker, ucp_rsc_index_t tl_id,
                                    ucp_worker_iface_t *wiface);
 
@@ -347,6 +399,8 @@ ucs_status_t ucp_worker_set_ep_failed(ucp_worker_h worker, ucp_ep_h ucp_ep,
                                       uct_ep_h uct_ep, ucp_lane_index_t lane,
                                       ucs_status_t status);
 
+size_t ucp_worker_ep_memory_size(ucp_worker_h worker);
+
 void ucp_worker_keepalive_add_ep(ucp_ep_h );
 
 /* EP should be removed from worker all_eps prior to call this function */
@@ -368,6 +422,13 @@ char *ucp_worker_print_used_tls(const ucp_ep_config_key_t *key,
                                 ucp_worker_cfg_index_t config_idx, char *info,
                                 size_t max);
 
+static UCS_F_ALWAYS_INLINE ucp_ep_config_t *
+ucp_worker_ep_config(ucp_worker_h worker, ucp_worker_cfg_index_t ep_cfg_index)
+{
+    ucs_assert(ep_cfg_index < ucs_array_length(&worker->ep_config));
+    return ucs_array_elem(&worker->ep_config, ep_cfg_index);
+}
+
 static UCS_F_ALWAYS_INLINE void
 ucp_worker_flush_ops_count_inc(ucp_worker_h worker)
 {
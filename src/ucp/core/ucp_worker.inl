@@ -95,6 +95,19 @@ ucp_worker_iface_get_attr(ucp_worker_h worker, ucp_rsc_index_t rsc_index)
     return &ucp_worker_iface(worker, rsc_index)->attr;
 }
 
+/**
+ * Open the interface if its opening was deferred until it's used.
+ */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_worker_iface_check_open(ucp_worker_iface_t *wiface)
+{
+    if (ucs_likely(wiface->iface != NULL)) {
+        return UCS_OK;
+    }
+
+    return ucp_worker_iface_open_lazy(wiface);
+}
+
 /**
  * @return worker's iface bandwidth resource index
  */
@@ -9,6 +9,7 @@
 
 #include "dt.h"
 #include "dt_generic.h"
+#include "dt_strided.h"
 
 #include <ucp/api/ucp.h>
 #include <ucs/memory/memtype_cache.h>
@@ -33,6 +34,10 @@ typedef struct {
             ucp_dt_generic_t      *dt_gen;    /* Generic datatype handle */
             void                  *state;     /* User-defined state */
         } generic;
+        struct {
+            void                  *buffer;    /* User buffer */
+            ucp_dt_strided_t      *dt_strided; /* Strided datatype handle */
+        } strided;
         struct {
             const ucp_dt_iov_t    *iov;       /* IOV list */
             size_t                iov_index;  /* Index of current IOV item */
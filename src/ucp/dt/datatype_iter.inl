@@ -52,7 +52,7 @@ ucp_datatype_iov_iter_init(ucp_context_h context, void *buffer, size_t count,
 
     if (ucs_likely(count > 0)) {
         *sg_count         = ucs_min(count, (size_t)UINT8_MAX);
-        ucp_memory_detect(context, iov->buffer, iov->length, &dt_iter->mem_info);
+        ucp_memory_detect_iov(context, iov, count, &dt_iter->mem_info);
     } else {
         *sg_count = 1;
         ucp_memory_info_set_host(&dt_iter->mem_info);
@@ -74,6 +74,21 @@ ucp_datatype_generic_iter_init(ucp_context_h context, void *buffer, size_t count
     ucp_memory_info_set_host(&dt_iter->mem_info);
 }
 
+static UCS_F_ALWAYS_INLINE void
+ucp_datatype_strided_iter_init(ucp_context_h context, void *buffer, size_t count,
+                               ucp_datatype_t datatype,
+                               ucp_datatype_iter_t *dt_iter)
+{
+    ucp_dt_strided_t *dt_strided = ucp_dt_to_strided(datatype);
+
+    dt_iter->length                  = ucp_dt_strided_length(dt_strided, count);
+    dt_iter->type.strided.buffer     = buffer;
+    dt_iter->type.strided.dt_strided = dt_strided;
+    ucp_memory_detect(context, buffer,
+                      ucp_dt_strided_span(dt_strided, dt_iter->length),
+                      &dt_iter->mem_info);
+}
+
 /*
  * Initialize a datatype iterator, also returns number of scatter-gather entries
  * for protocol selection.
@@ -93,6 +108,10 @@ ucp_datatype_iter_init(ucp_context_h context, void *buffer, size_t count,
     } else if (dt_iter->dt_class == UCP_DATATYPE_IOV) {
         ucp_datatype_iov_iter_init(context, buffer, count, datatype, dt_iter,
                                    sg_count);
+    } else if (dt_iter->dt_class == UCP_DATATYPE_STRIDED) {
+        ucp_datatype_strided_iter_init(context, buffer, count, datatype,
+                                       dt_iter);
+        *sg_count = 1;
     } else {
         ucs_assert(dt_iter->dt_class == UCP_DATATYPE_GENERIC);
         ucp_datatype_generic_iter_init(context, buffer, count, datatype, dt_iter);
@@ -131,7 +150,8 @@ ucp_datatype_iter_next_pack(const ucp_datatype_iter_t *dt_iter,
         src    = UCS_PTR_BYTE_OFFSET(dt_iter->type.contig.buffer,
                                      dt_iter->offset);
         ucp_dt_contig_pack(worker, dest, src, length,
-                           (ucs_memory_type_t)dt_iter->mem_info.type);
+                           (ucs_memory_type_t)dt_iter->mem_info.type,
+                           dt_iter->length);
         break;
     case UCP_DATATYPE_IOV:
         length = ucs_min(dt_iter->length - dt_iter->offset, max_length);
@@ -141,6 +161,13 @@ ucp_datatype_iter_next_pack(const ucp_datatype_iter_t *dt_iter,
                               length, &next_iter->type.iov.iov_offset,
                               &next_iter->type.iov.iov_index);
         break;
+    case UCP_DATATYPE_STRIDED:
+        length = ucs_min(dt_iter->length - dt_iter->offset, max_length);
+        UCS_PROFILE_CALL_VOID(ucp_dt_strided_pack,
+                              dt_iter->type.strided.dt_strided,
+                              dt_iter->type.strided.buffer, dt_iter->offset,
+                              dest, length);
+        break;
     case UCP_DATATYPE_GENERIC:
         if (max_length != 0) {
             dt_gen = dt_iter->type.generic.dt_gen;
@@ -180,7 +207,8 @@ ucp_datatype_iter_next_unpack(const ucp_datatype_iter_t *dt_iter,
         ucs_assert(dt_iter->mem_info.type < UCS_MEMORY_TYPE_LAST);
         dest = UCS_PTR_BYTE_OFFSET(dt_iter->type.contig.buffer, dt_iter->offset);
         ucp_dt_contig_unpack(worker, dest, src, length,
-                             (ucs_memory_type_t)dt_iter->mem_info.type);
+                             (ucs_memory_type_t)dt_iter->mem_info.type,
+                             dt_iter->length);
         status = UCS_OK;
         break;
     case UCP_DATATYPE_IOV:
@@ -192,6 +220,13 @@ ucp_datatype_iter_next_unpack(const ucp_datatype_iter_t *dt_iter,
                               &next_iter->type.iov.iov_index);
         status = UCS_OK;
         break;
+    case UCP_DATATYPE_STRIDED:
+        UCS_PROFILE_CALL_VOID(ucp_dt_strided_unpack,
+                              dt_iter->type.strided.dt_strided,
+                              dt_iter->type.strided.buffer, dt_iter->offset,
+                              src, length);
+        status = UCS_OK;
+        break;
     case UCP_DATATYPE_GENERIC:
         if (length != 0) {
             dt_gen = dt_iter->type.generic.dt_gen;
@@ -10,10 +10,13 @@
 
 #include "dt.h"
 #include "dt_iov.h"
+#include "dt_generic.h"
+#include "dt_strided.h"
 
 #include <ucp/core/ucp_ep.inl>
 #include <ucp/core/ucp_request.h>
 #include <ucp/core/ucp_mm.h>
+#include <ucs/algorithm/crc.h>
 #include <ucs/profile/profile.h>
 
 
@@ -105,7 +108,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_mem_type_pack,
 
 size_t ucp_dt_pack(ucp_worker_h worker, ucp_datatype_t datatype,
                    ucs_memory_type_t mem_type, void *dest, const void *src,
-                   ucp_dt_state_t *state, size_t length)
+                   ucp_dt_state_t *state, size_t length, size_t total_length)
 {
     size_t result_len = 0;
     ucp_dt_generic_t *dt;
@@ -118,7 +121,8 @@ size_t ucp_dt_pack(ucp_worker_h worker, ucp_datatype_t datatype,
     case UCP_DATATYPE_CONTIG:
         if (UCP_MEM_IS_ACCESSIBLE_FROM_CPU(mem_type)) {
             UCS_PROFILE_CALL(ucs_memcpy_relaxed, dest,
-                             UCS_PTR_BYTE_OFFSET(src, state->offset), length);
+                             UCS_PTR_BYTE_OFFSET(src, state->offset), length,
+                             UCS_ARCH_MEMCPY_NT_DEST, total_length);
         } else {
             ucp_mem_type_pack(worker, dest,
                               UCS_PTR_BYTE_OFFSET(src, state->offset),
@@ -134,7 +138,20 @@ size_t ucp_dt_pack(ucp_worker_h worker, ucp_datatype_t datatype,
         result_len = length;
         break;
 
+    case UCP_DATATYPE_STRIDED:
+        UCS_PROFILE_CALL_VOID(ucp_dt_strided_pack, ucp_dt_to_strided(datatype),
+                              src, state->offset, dest, length);
+        result_len = length;
+        break;
+
     case UCP_DATATYPE_GENERIC:
+        if (state->dt.generic.pack_job != NULL) {
+            result_len = UCS_PROFILE_CALL(ucp_dt_generic_pack_job_copy,
+                                          state->dt.generic.pack_job,
+                                          state->offset, dest, length);
+            break;
+        }
+
         dt         = ucp_dt_to_generic(datatype);
         result_len = UCS_PROFILE_NAMED_CALL("dt_pack", dt->ops.pack,
                                             state->dt.generic.state,
@@ -148,3 +165,27 @@ size_t ucp_dt_pack(ucp_worker_h worker, ucp_datatype_t datatype,
     state->offset += result_len;
     return result_len;
 }
+
+uint32_t ucp_dt_crc32c(ucp_datatype_t datatype, const void *buffer,
+                       size_t length)
+{
+    const ucp_dt_iov_t *iov;
+    size_t iov_length;
+    uint32_t crc;
+
+    switch (datatype & UCP_DATATYPE_CLASS_MASK) {
+    case UCP_DATATYPE_CONTIG:
+        return ucs_crc32c(0, buffer, length);
+    case UCP_DATATYPE_IOV:
+        crc = 0;
+        for (iov = buffer; length > 0; ++iov) {
+            iov_length = ucs_min(iov->length, length);
+            crc        = ucs_crc32c(crc, iov->buffer, iov_length);
+            length    -= iov_length;
+        }
+        return crc;
+    default:
+        ucs_error("Invalid data type for checksum 0x%"PRIx64, datatype);
+        return 0;
+    }
+}
@@ -42,7 +42,9 @@ typedef struct ucp_dt_state {
             ucp_dt_reg_t          *dt_reg;        /* Pointer to IOV memh[iovcnt] */
         } iov;
         struct {
-            void                  *state;
+            void                      *state;
+            /* Packing by helper threads, NULL if not used */
+            struct ucp_dt_generic_pack_job *pack_job;
         } generic;
     } dt;
 } ucp_dt_state_t;
@@ -50,9 +52,20 @@ typedef struct ucp_dt_state {
 
 extern const char *ucp_datatype_class_names[];
 
+/**
+ * Pack @a length bytes of a transfer of @a total_length bytes to @a dest,
+ * starting from the offset in @a state.
+ */
 size_t ucp_dt_pack(ucp_worker_h worker, ucp_datatype_t datatype,
                    ucs_memory_type_t mem_type, void *dest, const void *src,
-                   ucp_dt_state_t *state, size_t length);
+                   ucp_dt_state_t *state, size_t length, size_t total_length);
+
+/**
+ * Calculate the CRC32C checksum of the packed data of a contiguous or IOV
+ * buffer in host memory.
+ */
+uint32_t ucp_dt_crc32c(ucp_datatype_t datatype, const void *buffer,
+                       size_t length);
 
 ucs_status_t ucp_mem_type_pack(ucp_worker_h worker, void *dest,
                                const void *src, size_t length,
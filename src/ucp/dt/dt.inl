@@ -11,6 +11,7 @@
 #include "dt_contig.h"
 #include "dt_generic.h"
 #include "dt_iov.h"
+#include "dt_strided.h"
 
 #include <ucp/core/ucp_mm.h>
 #include <ucs/profile/profile.h>
@@ -47,6 +48,9 @@ size_t ucp_dt_length(ucp_datatype_t datatype, size_t count,
         ucs_assert(NULL != iov);
         return ucp_dt_iov_length(iov, count);
 
+    case UCP_DATATYPE_STRIDED:
+        return ucp_dt_strided_length(ucp_dt_to_strided(datatype), count);
+
     case UCP_DATATYPE_GENERIC:
         dt_gen = ucp_dt_to_generic(datatype);
         ucs_assert(NULL != state);
@@ -66,6 +70,7 @@ ucp_dt_unpack_only(ucp_worker_h worker, void *buffer, size_t count,
                    const void *data, size_t length, int truncation)
 {
     size_t iov_offset, iovcnt_offset;
+    ucp_dt_strided_t *dt_strided;
     ucp_dt_generic_t *dt_gen;
     ucs_status_t status;
     size_t buffer_size;
@@ -78,7 +83,9 @@ ucp_dt_unpack_only(ucp_worker_h worker, void *buffer, size_t count,
             goto err_truncated;
         }
         if (ucs_likely(UCP_MEM_IS_ACCESSIBLE_FROM_CPU(mem_type))) {
-            UCS_PROFILE_NAMED_CALL("memcpy_recv", ucs_memcpy_relaxed, buffer, data, length);
+            UCS_PROFILE_NAMED_CALL("memcpy_recv", ucs_memcpy_relaxed, buffer,
+                                   data, length, UCS_ARCH_MEMCPY_NT_SOURCE,
+                                   ucp_contig_dt_length(datatype, count));
         } else {
             ucp_mem_type_unpack(worker, buffer, data, length, mem_type);
         }
@@ -96,6 +103,16 @@ ucp_dt_unpack_only(ucp_worker_h worker, void *buffer, size_t count,
                          data, length, &iov_offset, &iovcnt_offset);
         return UCS_OK;
 
+    case UCP_DATATYPE_STRIDED:
+        dt_strided  = ucp_dt_to_strided(datatype);
+        buffer_size = ucp_dt_strided_length(dt_strided, count);
+        if (truncation && ucs_unlikely(length > buffer_size)) {
+            goto err_truncated;
+        }
+        UCS_PROFILE_CALL_VOID(ucp_dt_strided_unpack, dt_strided, buffer, 0,
+                              data, length);
+        return UCS_OK;
+
     case UCP_DATATYPE_GENERIC:
         dt_gen = ucp_dt_to_generic(datatype);
         state  = UCS_PROFILE_NAMED_CALL("dt_start", dt_gen->ops.start_unpack,
@@ -128,6 +145,7 @@ ucp_dt_recv_state_init(ucp_dt_state_t *dt_state, void *buffer,
 
     switch (dt & UCP_DATATYPE_CLASS_MASK) {
     case UCP_DATATYPE_CONTIG:
+    case UCP_DATATYPE_STRIDED:
         dt_state->dt.contig.md_map     = 0;
         break;
    case UCP_DATATYPE_IOV:
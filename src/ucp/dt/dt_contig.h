@@ -44,10 +44,12 @@ static inline size_t ucp_contig_dt_length(ucp_datatype_t datatype, size_t count)
 
 static inline void
 ucp_dt_contig_pack(ucp_worker_h worker, void *dest, const void *src,
-                   size_t length, ucs_memory_type_t mem_type)
+                   size_t length, ucs_memory_type_t mem_type,
+                   size_t total_length)
 {
     if (ucs_likely(UCP_MEM_IS_ACCESSIBLE_FROM_CPU(mem_type))) {
-        UCS_PROFILE_CALL(ucs_memcpy_relaxed, dest, src, length);
+        UCS_PROFILE_CALL(ucs_memcpy_relaxed, dest, src, length,
+                         UCS_ARCH_MEMCPY_NT_DEST, total_length);
     } else {
         UCS_PROFILE_CALL(ucp_mem_type_pack, worker, dest, src, length,
                          mem_type);
@@ -56,10 +58,12 @@ ucp_dt_contig_pack(ucp_worker_h worker, void *dest, const void *src,
 
 static inline void
 ucp_dt_contig_unpack(ucp_worker_h worker, void *dest, const void *src,
-                     size_t length, ucs_memory_type_t mem_type)
+                     size_t length, ucs_memory_type_t mem_type,
+                     size_t total_length)
 {
     if (ucs_likely(UCP_MEM_IS_ACCESSIBLE_FROM_CPU(mem_type))) {
-        UCS_PROFILE_CALL(ucs_memcpy_relaxed, dest, src, length);
+        UCS_PROFILE_CALL(ucs_memcpy_relaxed, dest, src, length,
+                         UCS_ARCH_MEMCPY_NT_SOURCE, total_length);
     } else {
         UCS_PROFILE_CALL(ucp_mem_type_unpack, worker, dest, src, length,
                          mem_type);
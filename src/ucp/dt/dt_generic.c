@@ -9,9 +9,58 @@
 #endif
 
 #include "dt_generic.h"
+#include "dt_strided.h"
 
-#include <ucs/sys/math.h>
+#include <ucs/datastruct/list.h>
+#include <ucs/debug/log.h>
 #include <ucs/debug/memtrack.h>
+#include <ucs/sys/math.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <string.h>
+
+
+/* Size of the data packed by a helper thread at once */
+#define UCP_DT_GENERIC_PACK_CHUNK_SIZE (256 * UCS_KBYTE)
+
+/* How many chunks per thread may be packed ahead of the sender */
+#define UCP_DT_GENERIC_PACK_WINDOW     4
+
+
+struct ucp_dt_generic_pool {
+    pthread_mutex_t           lock;
+    pthread_cond_t            cond;        /* Signaled when a job has chunks
+                                              to pack, or a chunk is packed */
+    ucs_list_link_t           jobs;        /* Jobs which may have chunks to
+                                              pack */
+    int                       stop;
+    unsigned                  num_threads;
+    pthread_t                 threads[0];
+};
+
+
+/*
+ * The chunks are packed in order to a staging ring of 'window' slots. A chunk
+ * is packed only after the chunk which used the same slot was copied out by
+ * the sender. All fields except the constant ones are protected by the pool
+ * lock.
+ */
+struct ucp_dt_generic_pack_job {
+    ucs_list_link_t           list;        /* Entry in pool->jobs */
+    ucp_dt_generic_pool_t     *pool;
+    ucp_dt_generic_t          *dt_gen;
+    void                      *state;      /* User pack state */
+    size_t                    length;      /* Total packed size */
+    size_t                    num_chunks;
+    size_t                    window;      /* Number of slots in the ring */
+    void                      *buffer;     /* Staging ring */
+    size_t                    next_chunk;  /* Next chunk to pack */
+    size_t                    consumed;    /* Chunks copied out by the sender */
+    unsigned                  active;      /* Chunks being packed now */
+    int                       queued;      /* Whether the job is in pool->jobs */
+    size_t                    slot_chunk[0]; /* Chunk packed to each slot,
+                                                SIZE_MAX if none */
+};
 
 
 ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *context,
@@ -29,6 +78,7 @@ ucs_status_t ucp_dt_create_generic(const ucp_generic_dt_ops_t *ops, void *contex
 
     dt_gen->ops     = *ops;
     dt_gen->context = context;
+    dt_gen->flags   = 0;
     *datatype_p     = ucp_dt_from_generic(dt_gen);
     return UCS_OK;
 }
@@ -44,7 +94,316 @@ void ucp_dt_destroy(ucp_datatype_t datatype)
         dt_gen = ucp_dt_to_generic(datatype);
         ucs_free(dt_gen);
         break;
+    case UCP_DATATYPE_STRIDED:
+        ucs_free(ucp_dt_to_strided(datatype));
+        break;
     default:
         break;
     }
 }
+
+ucs_status_t ucp_dt_generic_set_flags(ucp_datatype_t datatype, uint64_t flags)
+{
+    if (!UCP_DT_IS_GENERIC(datatype)) {
+        ucs_error("datatype 0x%" PRIx64 " is not generic", datatype);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    ucp_dt_to_generic(datatype)->flags = flags;
+    return UCS_OK;
+}
+
+static void ucp_dt_generic_job_dequeue(ucp_dt_generic_pack_job_t *job)
+{
+    if (job->queued) {
+        ucs_list_del(&job->list);
+        job->queued = 0;
+    }
+}
+
+/* Called with the pool lock held */
+static int ucp_dt_generic_job_claim(ucp_dt_generic_pack_job_t *job,
+                                    size_t *chunk_p)
+{
+    if ((job->next_chunk >= job->num_chunks) ||
+        (job->next_chunk >= (job->consumed + job->window))) {
+        return 0;
+    }
+
+    *chunk_p = job->next_chunk++;
+    ++job->active;
+    if (job->next_chunk == job->num_chunks) {
+        ucp_dt_generic_job_dequeue(job);
+    }
+
+    return 1;
+}
+
+/* Called with the pool lock held, releases it while packing */
+static void ucp_dt_generic_job_pack_chunk(ucp_dt_generic_pack_job_t *job,
+                                          size_t chunk)
+{
+    ucp_dt_generic_pool_t *pool = job->pool;
+    size_t slot                 = chunk % job->window;
+    size_t offset               = chunk * UCP_DT_GENERIC_PACK_CHUNK_SIZE;
+    size_t length               = ucs_min(UCP_DT_GENERIC_PACK_CHUNK_SIZE,
+                                          job->length - offset);
+    void *dest                  = UCS_PTR_BYTE_OFFSET(job->buffer, slot *
+                                                      UCP_DT_GENERIC_PACK_CHUNK_SIZE);
+    size_t packed;
+
+    pthread_mutex_unlock(&pool->lock);
+    packed = job->dt_gen->ops.pack(job->state, offset, dest, length);
+    if (packed != length) {
+        ucs_error("generic datatype %p packed %zu bytes instead of %zu at"
+                  " offset %zu", job->dt_gen, packed, length, offset);
+    }
+    pthread_mutex_lock(&pool->lock);
+
+    job->slot_chunk[slot] = chunk;
+    --job->active;
+    pthread_cond_broadcast(&pool->cond);
+}
+
+static void *ucp_dt_generic_pool_thread_func(void *arg)
+{
+    ucp_dt_generic_pool_t *pool = arg;
+    ucp_dt_generic_pack_job_t *job;
+    size_t chunk;
+
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stop) {
+        ucs_list_for_each(job, &pool->jobs, list) {
+            if (ucp_dt_generic_job_claim(job, &chunk)) {
+                ucp_dt_generic_job_pack_chunk(job, chunk);
+                goto next;
+            }
+        }
+
+        pthread_cond_wait(&pool->cond, &pool->lock);
+next:
+        ;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+ucs_status_t ucp_dt_generic_pool_create(unsigned num_threads,
+                                        ucp_dt_generic_pool_t **pool_p)
+{
+    ucp_dt_generic_pool_t *pool;
+    ucs_status_t status;
+    unsigned i;
+    int ret;
+
+    pool = ucs_malloc(sizeof(*pool) + (num_threads * sizeof(pthread_t)),
+                      "generic_dt_pool");
+    if (pool == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+    ucs_list_head_init(&pool->jobs);
+    pool->stop        = 0;
+    pool->num_threads = 0;
+
+    for (i = 0; i < num_threads; ++i) {
+        ret = pthread_create(&pool->threads[i], NULL,
+                             ucp_dt_generic_pool_thread_func, pool);
+        if (ret != 0) {
+            ucs_error("pthread_create() returned %d: %m", ret);
+            status = UCS_ERR_IO_ERROR;
+            goto err_destroy;
+        }
+
+        ++pool->num_threads;
+    }
+
+    ucs_debug("created generic datatype pack pool %p with %u threads", pool,
+              num_threads);
+    *pool_p = pool;
+    return UCS_OK;
+
+err_destroy:
+    ucp_dt_generic_pool_destroy(pool);
+    return status;
+}
+
+void ucp_dt_generic_pool_destroy(ucp_dt_generic_pool_t *pool)
+{
+    unsigned i;
+
+    pthread_mutex_lock(&pool->lock);
+    ucs_assert(ucs_list_is_empty(&pool->jobs));
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (i = 0; i < pool->num_threads; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->cond);
+    pthread_mutex_destroy(&pool->lock);
+    ucs_free(pool);
+}
+
+ucp_dt_generic_pack_job_t *
+ucp_dt_generic_pack_job_start(ucp_dt_generic_pool_t *pool,
+                              ucp_dt_generic_t *dt_gen, void *state,
+                              size_t thresh)
+{
+    ucp_dt_generic_pack_job_t *job;
+    size_t length, num_chunks, window, i;
+
+    if ((pool == NULL) ||
+        !(dt_gen->flags & UCP_DT_GENERIC_FLAG_PARALLEL_PACK)) {
+        return NULL;
+    }
+
+    length = dt_gen->ops.packed_size(state);
+    if (length < ucs_max(thresh, UCP_DT_GENERIC_PACK_CHUNK_SIZE)) {
+        return NULL;
+    }
+
+    num_chunks = ucs_div_round_up(length, UCP_DT_GENERIC_PACK_CHUNK_SIZE);
+    window     = ucs_min(num_chunks,
+                         UCP_DT_GENERIC_PACK_WINDOW * pool->num_threads);
+
+    job = ucs_malloc(sizeof(*job) + (window * sizeof(*job->slot_chunk)),
+                     "generic_dt_pack_job");
+    if (job == NULL) {
+        goto err;
+    }
+
+    job->buffer = ucs_malloc(window * UCP_DT_GENERIC_PACK_CHUNK_SIZE,
+                             "generic_dt_pack_buffer");
+    if (job->buffer == NULL) {
+        goto err_free_job;
+    }
+
+    job->pool       = pool;
+    job->dt_gen     = dt_gen;
+    job->state      = state;
+    job->length     = length;
+    job->num_chunks = num_chunks;
+    job->window     = window;
+    job->next_chunk = 0;
+    job->consumed   = 0;
+    job->active     = 0;
+    for (i = 0; i < window; ++i) {
+        job->slot_chunk[i] = SIZE_MAX;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    ucs_list_add_tail(&pool->jobs, &job->list);
+    job->queued = 1;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    ucs_trace("generic datatype %p state %p: started pack job %p length %zu",
+              dt_gen, state, job, length);
+    return job;
+
+err_free_job:
+    ucs_free(job);
+err:
+    /* Not fatal, the data will be packed by the sender */
+    ucs_debug("failed to allocate generic datatype pack job");
+    return NULL;
+}
+
+/*
+ * Wait until a chunk is packed to its slot, helping to pack the chunks in the
+ * meanwhile. Called with the pool lock held.
+ *
+ * @return Whether the chunk is available in the staging ring.
+ */
+static int ucp_dt_generic_job_wait(ucp_dt_generic_pack_job_t *job, size_t chunk)
+{
+    size_t slot = chunk % job->window;
+    size_t claimed;
+
+    if ((chunk < job->consumed) || (chunk >= (job->consumed + job->window))) {
+        /* The slot was reused, or will not be packed before we consume */
+        return 0;
+    }
+
+    while (job->slot_chunk[slot] != chunk) {
+        if (ucp_dt_generic_job_claim(job, &claimed)) {
+            ucp_dt_generic_job_pack_chunk(job, claimed);
+        } else {
+            pthread_cond_wait(&job->pool->cond, &job->pool->lock);
+        }
+    }
+
+    return 1;
+}
+
+size_t ucp_dt_generic_pack_job_copy(ucp_dt_generic_pack_job_t *job,
+                                    size_t offset, void *dest, size_t length)
+{
+    ucp_dt_generic_pool_t *pool = job->pool;
+    size_t end                  = ucs_min(offset + length, job->length);
+    size_t copied               = 0;
+    size_t chunk, chunk_offset, seg_length, packed;
+    int available;
+
+    while (offset < end) {
+        chunk        = offset / UCP_DT_GENERIC_PACK_CHUNK_SIZE;
+        chunk_offset = offset % UCP_DT_GENERIC_PACK_CHUNK_SIZE;
+        seg_length   = ucs_min(UCP_DT_GENERIC_PACK_CHUNK_SIZE - chunk_offset,
+                               end - offset);
+
+        pthread_mutex_lock(&pool->lock);
+        available = ucp_dt_generic_job_wait(job, chunk);
+        pthread_mutex_unlock(&pool->lock);
+
+        if (available) {
+            memcpy(UCS_PTR_BYTE_OFFSET(dest, copied),
+                   UCS_PTR_BYTE_OFFSET(job->buffer,
+                                       ((chunk % job->window) *
+                                        UCP_DT_GENERIC_PACK_CHUNK_SIZE) +
+                                       chunk_offset),
+                   seg_length);
+        } else {
+            packed = job->dt_gen->ops.pack(job->state, offset,
+                                           UCS_PTR_BYTE_OFFSET(dest, copied),
+                                           seg_length);
+            ucs_assert(packed == seg_length);
+        }
+
+        offset += seg_length;
+        copied += seg_length;
+
+        if (available && ((offset == job->length) ||
+                          ((offset % UCP_DT_GENERIC_PACK_CHUNK_SIZE) == 0))) {
+            /* The whole chunk was copied out, release its slot */
+            pthread_mutex_lock(&pool->lock);
+            job->consumed = ucs_max(job->consumed, chunk + 1);
+            pthread_cond_broadcast(&pool->cond);
+            pthread_mutex_unlock(&pool->lock);
+        }
+    }
+
+    return copied;
+}
+
+void ucp_dt_generic_pack_job_destroy(ucp_dt_generic_pack_job_t *job)
+{
+    ucp_dt_generic_pool_t *pool = job->pool;
+
+    pthread_mutex_lock(&pool->lock);
+    job->next_chunk = job->num_chunks;
+    ucp_dt_generic_job_dequeue(job);
+    while (job->active > 0) {
+        pthread_cond_wait(&pool->cond, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    ucs_trace("destroying generic datatype pack job %p", job);
+    ucs_free(job->buffer);
+    ucs_free(job);
+}
@@ -17,9 +17,22 @@
 typedef struct ucp_dt_generic {
     void                     *context;
     ucp_generic_dt_ops_t     ops;
+    uint64_t                 flags; /* Bitmap of ucp_dt_generic_flags */
 } ucp_dt_generic_t;
 
 
+/**
+ * Pool of threads which pack generic datatypes ahead of sending them.
+ */
+typedef struct ucp_dt_generic_pool ucp_dt_generic_pool_t;
+
+
+/**
+ * Parallel packing of a single send request.
+ */
+typedef struct ucp_dt_generic_pack_job ucp_dt_generic_pack_job_t;
+
+
 #define UCP_DT_IS_GENERIC(_datatype) \
     (((_datatype) & UCP_DATATYPE_CLASS_MASK) == UCP_DATATYPE_GENERIC)
 
@@ -37,4 +50,35 @@ ucp_datatype_t ucp_dt_from_generic(ucp_dt_generic_t* dt_gen)
     return ((uintptr_t)dt_gen) | UCP_DATATYPE_GENERIC;
 }
 
+
+ucs_status_t ucp_dt_generic_pool_create(unsigned num_threads,
+                                        ucp_dt_generic_pool_t **pool_p);
+
+
+void ucp_dt_generic_pool_destroy(ucp_dt_generic_pool_t *pool);
+
+
+/**
+ * Start packing the data of a generic datatype by the threads of @a pool.
+ *
+ * @return The new job, or NULL if the data should be packed by the caller.
+ */
+ucp_dt_generic_pack_job_t *
+ucp_dt_generic_pack_job_start(ucp_dt_generic_pool_t *pool,
+                              ucp_dt_generic_t *dt_gen, void *state,
+                              size_t thresh);
+
+
+/**
+ * Copy packed data at the range [@a offset, @a offset + @a length) to @a dest,
+ * waiting for the helper threads if needed.
+ *
+ * @return Number of bytes copied.
+ */
+size_t ucp_dt_generic_pack_job_copy(ucp_dt_generic_pack_job_t *job,
+                                    size_t offset, void *dest, size_t length);
+
+
+void ucp_dt_generic_pack_job_destroy(ucp_dt_generic_pack_job_t *job);
+
 #endif
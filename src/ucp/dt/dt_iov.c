@@ -11,6 +11,7 @@
 #include "dt_iov.h"
 
 #include <ucs/debug/assert.h>
+#include <ucs/sys/iovec.inl>
 #include <ucs/sys/math.h>
 
 #include <string.h>
@@ -20,55 +21,91 @@
 void ucp_dt_iov_gather(void *dest, const ucp_dt_iov_t *iov, size_t length,
                        size_t *iov_offset, size_t *iovcnt_offset)
 {
-    size_t item_len, item_reminder, item_len_to_copy;
-    size_t length_it = 0;
-
+    size_t iov_it      = *iovcnt_offset;
+    size_t offset      = *iov_offset;
+    size_t length_it   = 0;
+    size_t run_length  = 0;
+    const void *run_src = NULL;
+    size_t item_len_to_copy;
+    const void *src;
+
+    /* Entries which are adjacent in memory are copied by a single call */
     while (length_it < length) {
-        item_len      = iov[*iovcnt_offset].length;
-        item_reminder = item_len - *iov_offset;
-
-        item_len_to_copy = item_reminder -
-                           ucs_max((ssize_t)((length_it + item_reminder) - length), 0);
-        memcpy(UCS_PTR_BYTE_OFFSET(dest, length_it),
-               UCS_PTR_BYTE_OFFSET(iov[*iovcnt_offset].buffer, *iov_offset),
-               item_len_to_copy);
-        length_it += item_len_to_copy;
+        item_len_to_copy = ucs_min(iov[iov_it].length - offset,
+                                   length - length_it);
+        if (item_len_to_copy > 0) {
+            src = UCS_PTR_BYTE_OFFSET(iov[iov_it].buffer, offset);
+            if (UCS_PTR_BYTE_OFFSET(run_src, run_length) != src) {
+                ucs_iov_memcpy(UCS_PTR_BYTE_OFFSET(dest, length_it - run_length),
+                               run_src, run_length);
+                run_src    = src;
+                run_length = 0;
+            }
+
+            run_length += item_len_to_copy;
+            length_it  += item_len_to_copy;
+        }
 
         ucs_assert(length_it <= length);
         if (length_it < length) {
-            *iov_offset = 0;
-            ++(*iovcnt_offset);
+            offset = 0;
+            ++iov_it;
         } else {
-            *iov_offset += item_len_to_copy;
+            offset += item_len_to_copy;
         }
     }
+
+    ucs_iov_memcpy(UCS_PTR_BYTE_OFFSET(dest, length_it - run_length), run_src,
+                   run_length);
+    *iov_offset    = offset;
+    *iovcnt_offset = iov_it;
 }
 
 size_t ucp_dt_iov_scatter(const ucp_dt_iov_t *iov, size_t iovcnt, const void *src,
                           size_t length, size_t *iov_offset, size_t *iovcnt_offset)
 {
+    size_t iov_it      = *iovcnt_offset;
+    size_t offset      = *iov_offset;
+    size_t length_it   = 0;
+    size_t run_length  = 0;
+    void *run_dest     = NULL;
     size_t item_len, item_len_to_copy;
-    size_t length_it = 0;
+    void *dest;
 
-    while ((length_it < length) && (*iovcnt_offset < iovcnt)) {
-        item_len         = iov[*iovcnt_offset].length;
-        item_len_to_copy = ucs_min(ucs_max((ssize_t)(item_len - *iov_offset), 0),
+    /* Entries which are adjacent in memory are copied by a single call */
+    while ((length_it < length) && (iov_it < iovcnt)) {
+        item_len         = iov[iov_it].length;
+        item_len_to_copy = ucs_min(ucs_max((ssize_t)(item_len - offset), 0),
                                    length - length_it);
-        ucs_assert(*iov_offset <= item_len);
-
-        memcpy(UCS_PTR_BYTE_OFFSET(iov[*iovcnt_offset].buffer, *iov_offset),
-               UCS_PTR_BYTE_OFFSET(src, length_it),
-               item_len_to_copy);
-        length_it += item_len_to_copy;
+        ucs_assert(offset <= item_len);
+
+        if (item_len_to_copy > 0) {
+            dest = UCS_PTR_BYTE_OFFSET(iov[iov_it].buffer, offset);
+            if (UCS_PTR_BYTE_OFFSET(run_dest, run_length) != dest) {
+                ucs_iov_memcpy(run_dest,
+                               UCS_PTR_BYTE_OFFSET(src, length_it - run_length),
+                               run_length);
+                run_dest   = dest;
+                run_length = 0;
+            }
+
+            run_length += item_len_to_copy;
+            length_it  += item_len_to_copy;
+        }
 
         ucs_assert(length_it <= length);
         if (length_it < length) {
-            *iov_offset = 0;
-            ++(*iovcnt_offset);
+            offset = 0;
+            ++iov_it;
         } else {
-            *iov_offset += item_len_to_copy;
+            offset += item_len_to_copy;
         }
     }
+
+    ucs_iov_memcpy(run_dest, UCS_PTR_BYTE_OFFSET(src, length_it - run_length),
+                   run_length);
+    *iov_offset    = offset;
+    *iovcnt_offset = iov_it;
     return length_it;
 }
 
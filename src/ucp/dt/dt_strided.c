@@ -0,0 +1,291 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "dt_strided.h"
+
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
+#include <ucs/sys/math.h>
+#include <string.h>
+
+
+/* Position of a contiguous block in a strided buffer */
+typedef struct {
+    void   *ptr;                               /* Start of the block */
+    size_t idx[UCP_DT_STRIDED_MAX_DIMS + 1];   /* Index in every dimension */
+} ucp_dt_strided_pos_t;
+
+
+ucs_status_t ucp_dt_create_strided(size_t elem_size,
+                                   const ucp_dt_strided_dim_t *dims,
+                                   unsigned num_dims,
+                                   ucp_datatype_t *datatype_p)
+{
+    ucp_dt_strided_t *dt_strided;
+    ucp_dt_strided_dim_t *last;
+    size_t extent;
+    unsigned i;
+    int ret;
+
+    if ((elem_size == 0) || (num_dims == 0) ||
+        (num_dims > UCP_DT_STRIDED_MAX_DIMS)) {
+        ucs_error("invalid strided datatype: elem_size %zu num_dims %u",
+                  elem_size, num_dims);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    ret = ucs_posix_memalign((void **)&dt_strided,
+                             ucs_max(sizeof(void *), UCS_BIT(UCP_DATATYPE_SHIFT)),
+                             sizeof(*dt_strided), "strided_dt");
+    if (ret != 0) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    dt_strided->block_size  = elem_size;
+    dt_strided->packed_size = elem_size;
+    dt_strided->num_dims    = 0;
+    extent                  = elem_size;
+
+    for (i = 0; i < num_dims; ++i) {
+        if ((dims[i].count == 0) ||
+            ((dims[i].count > 1) && (dims[i].stride < extent))) {
+            ucs_error("invalid strided datatype dimension %u: count %zu "
+                      "stride %zu extent %zu", i, dims[i].count,
+                      dims[i].stride, extent);
+            ucs_free(dt_strided);
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        dt_strided->packed_size *= dims[i].count;
+        if (dims[i].count == 1) {
+            continue;
+        }
+
+        /* Merge the dimension with the previous one if they are contiguous */
+        if (dt_strided->num_dims == 0) {
+            if (dims[i].stride == dt_strided->block_size) {
+                dt_strided->block_size *= dims[i].count;
+            } else {
+                dt_strided->dims[dt_strided->num_dims++] = dims[i];
+            }
+        } else {
+            last = &dt_strided->dims[dt_strided->num_dims - 1];
+            if (dims[i].stride == (last->count * last->stride)) {
+                last->count *= dims[i].count;
+            } else {
+                dt_strided->dims[dt_strided->num_dims++] = dims[i];
+            }
+        }
+
+        extent += (dims[i].count - 1) * dims[i].stride;
+    }
+
+    /* Items of the user buffer follow each other */
+    dt_strided->extent                               = extent;
+    dt_strided->dims[dt_strided->num_dims].count     = SIZE_MAX;
+    dt_strided->dims[dt_strided->num_dims++].stride  = extent;
+
+    ucs_debug("created strided datatype %p: block %zu packed %zu extent %zu "
+              "dims %u", dt_strided, dt_strided->block_size,
+              dt_strided->packed_size, dt_strided->extent,
+              dt_strided->num_dims);
+
+    *datatype_p = ucp_dt_from_strided(dt_strided);
+    return UCS_OK;
+}
+
+static void ucp_dt_strided_seek(const ucp_dt_strided_t *dt_strided,
+                                const void *buffer, size_t block_index,
+                                ucp_dt_strided_pos_t *pos)
+{
+    unsigned i;
+
+    pos->ptr = (void*)buffer;
+    for (i = 0; i < dt_strided->num_dims; ++i) {
+        pos->idx[i]  = block_index % dt_strided->dims[i].count;
+        block_index /= dt_strided->dims[i].count;
+        pos->ptr     = UCS_PTR_BYTE_OFFSET(pos->ptr,
+                                           pos->idx[i] *
+                                           dt_strided->dims[i].stride);
+    }
+}
+
+/* Move forward by up to the number of blocks left in the innermost dimension */
+static UCS_F_ALWAYS_INLINE void
+ucp_dt_strided_advance(const ucp_dt_strided_t *dt_strided,
+                       ucp_dt_strided_pos_t *pos, size_t num_blocks)
+{
+    const ucp_dt_strided_dim_t *dims = dt_strided->dims;
+    unsigned i;
+
+    ucs_assert(pos->idx[0] + num_blocks <= dims[0].count);
+
+    pos->idx[0] += num_blocks;
+    pos->ptr     = UCS_PTR_BYTE_OFFSET(pos->ptr, num_blocks * dims[0].stride);
+
+    for (i = 0; (i + 1 < dt_strided->num_dims) &&
+                (pos->idx[i] == dims[i].count); ++i) {
+        pos->ptr       = UCS_PTR_BYTE_OFFSET(pos->ptr,
+                                             (ptrdiff_t)dims[i + 1].stride -
+                                             (ptrdiff_t)(dims[i].count *
+                                                         dims[i].stride));
+        pos->idx[i]    = 0;
+        pos->idx[i + 1]++;
+    }
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_dt_strided_copy_blocks(void *dst, size_t dst_stride, const void *src,
+                           size_t src_stride, size_t block_size,
+                           size_t num_blocks)
+{
+    size_t i;
+
+    for (i = 0; i < num_blocks; ++i) {
+        memcpy(UCS_PTR_BYTE_OFFSET(dst, i * dst_stride),
+               UCS_PTR_BYTE_OFFSET(src, i * src_stride), block_size);
+    }
+}
+
+/*
+ * Common element sizes get their own copy of the loop with a constant block
+ * size, so the compiler emits plain (and when possible, vector) loads and
+ * stores instead of a memcpy call per block.
+ */
+static void
+ucp_dt_strided_copy_blocks_dispatch(void *dst, size_t dst_stride,
+                                    const void *src, size_t src_stride,
+                                    size_t block_size, size_t num_blocks)
+{
+    switch (block_size) {
+    case 1:
+        ucp_dt_strided_copy_blocks(dst, dst_stride, src, src_stride, 1,
+                                   num_blocks);
+        break;
+    case 2:
+        ucp_dt_strided_copy_blocks(dst, dst_stride, src, src_stride, 2,
+                                   num_blocks);
+        break;
+    case 4:
+        ucp_dt_strided_copy_blocks(dst, dst_stride, src, src_stride, 4,
+                                   num_blocks);
+        break;
+    case 8:
+        ucp_dt_strided_copy_blocks(dst, dst_stride, src, src_stride, 8,
+                                   num_blocks);
+        break;
+    case 16:
+        ucp_dt_strided_copy_blocks(dst, dst_stride, src, src_stride, 16,
+                                   num_blocks);
+        break;
+    case 32:
+        ucp_dt_strided_copy_blocks(dst, dst_stride, src, src_stride, 32,
+                                   num_blocks);
+        break;
+    default:
+        ucp_dt_strided_copy_blocks(dst, dst_stride, src, src_stride,
+                                   block_size, num_blocks);
+        break;
+    }
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_dt_strided_copy_range(void *ptr, size_t stride, void *packed,
+                          size_t block_size, size_t num_blocks, int pack)
+{
+    if (pack) {
+        ucp_dt_strided_copy_blocks_dispatch(packed, block_size, ptr, stride,
+                                            block_size, num_blocks);
+    } else {
+        ucp_dt_strided_copy_blocks_dispatch(ptr, stride, packed, block_size,
+                                            block_size, num_blocks);
+    }
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_dt_strided_copy(const ucp_dt_strided_t *dt_strided, const void *buffer,
+                    size_t offset, void *packed, size_t length, int pack)
+{
+    size_t block_size = dt_strided->block_size;
+    ucp_dt_strided_pos_t pos;
+    size_t block_offset, num_blocks, frag;
+
+    block_offset = offset % block_size;
+    ucp_dt_strided_seek(dt_strided, buffer, offset / block_size, &pos);
+
+    /* Tail of the first block */
+    if (block_offset != 0) {
+        frag = ucs_min(block_size - block_offset, length);
+        ucp_dt_strided_copy_range(UCS_PTR_BYTE_OFFSET(pos.ptr, block_offset),
+                                  0, packed, frag, 1, pack);
+        packed  = UCS_PTR_BYTE_OFFSET(packed, frag);
+        length -= frag;
+        ucp_dt_strided_advance(dt_strided, &pos, 1);
+    }
+
+    /* Whole blocks, as long runs of the innermost dimension */
+    while (length >= block_size) {
+        num_blocks = ucs_min(length / block_size,
+                             dt_strided->dims[0].count - pos.idx[0]);
+        ucp_dt_strided_copy_range(pos.ptr, dt_strided->dims[0].stride, packed,
+                                  block_size, num_blocks, pack);
+        packed  = UCS_PTR_BYTE_OFFSET(packed, num_blocks * block_size);
+        length -= num_blocks * block_size;
+        ucp_dt_strided_advance(dt_strided, &pos, num_blocks);
+    }
+
+    /* Head of the last block */
+    if (length > 0) {
+        ucp_dt_strided_copy_range(pos.ptr, 0, packed, length, 1, pack);
+    }
+}
+
+void ucp_dt_strided_pack(const ucp_dt_strided_t *dt_strided, const void *buffer,
+                         size_t offset, void *dest, size_t length)
+{
+    ucp_dt_strided_copy(dt_strided, buffer, offset, dest, length, 1);
+}
+
+void ucp_dt_strided_unpack(const ucp_dt_strided_t *dt_strided, void *buffer,
+                           size_t offset, const void *src, size_t length)
+{
+    ucp_dt_strided_copy(dt_strided, buffer, offset, (void*)src, length, 0);
+}
+
+size_t ucp_dt_strided_to_uct_iov(const ucp_dt_strided_t *dt_strided,
+                                 void *buffer, size_t offset, size_t length,
+                                 uct_mem_h memh, uct_iov_t *iov,
+                                 size_t max_iov, size_t *iovcnt)
+{
+    size_t block_size = dt_strided->block_size;
+    size_t length_it  = 0;
+    size_t iov_it     = 0;
+    ucp_dt_strided_pos_t pos;
+    size_t block_offset;
+
+    block_offset = offset % block_size;
+    ucp_dt_strided_seek(dt_strided, buffer, offset / block_size, &pos);
+
+    while ((length_it < length) && (iov_it < max_iov)) {
+        iov[iov_it].buffer = UCS_PTR_BYTE_OFFSET(pos.ptr, block_offset);
+        iov[iov_it].length = ucs_min(block_size - block_offset,
+                                     length - length_it);
+        iov[iov_it].memh   = memh;
+        iov[iov_it].stride = 0;
+        iov[iov_it].count  = 1;
+        length_it         += iov[iov_it].length;
+        block_offset       = 0;
+        ++iov_it;
+        ucp_dt_strided_advance(dt_strided, &pos, 1);
+    }
+
+    *iovcnt = iov_it;
+    return length_it;
+}
@@ -0,0 +1,123 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_DT_STRIDED_H_
+#define UCP_DT_STRIDED_H_
+
+#include <ucp/api/ucp.h>
+#include <uct/api/uct.h>
+#include <ucs/debug/assert.h>
+
+
+/**
+ * Strided datatype, after merging dimensions which are contiguous in memory.
+ * The last dimension describes the items of the user buffer, so there is
+ * always at least one dimension.
+ */
+typedef struct ucp_dt_strided {
+    size_t                   block_size;  /* Length of a contiguous block */
+    size_t                   packed_size; /* Packed length of a single item */
+    size_t                   extent;      /* Distance between items */
+    unsigned                 num_dims;    /* Number of entries in 'dims' */
+    ucp_dt_strided_dim_t     dims[UCP_DT_STRIDED_MAX_DIMS + 1]; /* Dimensions of
+                                                                   blocks */
+} ucp_dt_strided_t;
+
+
+#define UCP_DT_IS_STRIDED(_datatype) \
+    (((_datatype) & UCP_DATATYPE_CLASS_MASK) == UCP_DATATYPE_STRIDED)
+
+
+static UCS_F_ALWAYS_INLINE
+ucp_dt_strided_t* ucp_dt_to_strided(ucp_datatype_t datatype)
+{
+    return (ucp_dt_strided_t*)(void*)(datatype & ~UCP_DATATYPE_CLASS_MASK);
+}
+
+
+static UCS_F_ALWAYS_INLINE
+ucp_datatype_t ucp_dt_from_strided(ucp_dt_strided_t *dt_strided)
+{
+    return ((uintptr_t)dt_strided) | UCP_DATATYPE_STRIDED;
+}
+
+
+/**
+ * Get the packed length of @a count items of a strided datatype
+ */
+static UCS_F_ALWAYS_INLINE size_t
+ucp_dt_strided_length(const ucp_dt_strided_t *dt_strided, size_t count)
+{
+    return count * dt_strided->packed_size;
+}
+
+
+/**
+ * Get the length of the memory region which contains the packed length
+ * @a length of a strided datatype
+ */
+static UCS_F_ALWAYS_INLINE size_t
+ucp_dt_strided_span(const ucp_dt_strided_t *dt_strided, size_t length)
+{
+    ucs_assert((length % dt_strided->packed_size) == 0);
+    return (length / dt_strided->packed_size) * dt_strided->extent;
+}
+
+
+/**
+ * Get the number of contiguous blocks in the packed range
+ * [@a offset, @a offset + @a length) of a strided datatype
+ */
+static UCS_F_ALWAYS_INLINE size_t
+ucp_dt_strided_block_count(const ucp_dt_strided_t *dt_strided, size_t offset,
+                           size_t length)
+{
+    if (length == 0) {
+        return 0;
+    }
+
+    return ((offset + length - 1) / dt_strided->block_size) -
+           (offset / dt_strided->block_size) + 1;
+}
+
+
+/**
+ * Copy the packed range [@a offset, @a offset + @a length) of a strided buffer
+ * to the contiguous buffer @a dest
+ */
+void ucp_dt_strided_pack(const ucp_dt_strided_t *dt_strided, const void *buffer,
+                         size_t offset, void *dest, size_t length);
+
+
+/**
+ * Copy the contiguous buffer @a src to the packed range
+ * [@a offset, @a offset + @a length) of a strided buffer
+ */
+void ucp_dt_strided_unpack(const ucp_dt_strided_t *dt_strided, void *buffer,
+                           size_t offset, const void *src, size_t length);
+
+
+/**
+ * Fill UCT iov entries, one per contiguous block, which describe the packed
+ * range of a strided buffer starting at @a offset.
+ *
+ * @param [in]  dt_strided  Strided datatype.
+ * @param [in]  buffer      User buffer.
+ * @param [in]  offset      Packed offset to start from.
+ * @param [in]  length      Maximal packed length to describe.
+ * @param [in]  memh        Memory handle of the whole buffer.
+ * @param [out] iov         Filled with the blocks.
+ * @param [in]  max_iov     Maximal number of entries in @a iov.
+ * @param [out] iovcnt      Filled with the number of entries in @a iov.
+ *
+ * @return Packed length described by @a iov.
+ */
+size_t ucp_dt_strided_to_uct_iov(const ucp_dt_strided_t *dt_strided,
+                                 void *buffer, size_t offset, size_t length,
+                                 uct_mem_h memh, uct_iov_t *iov,
+                                 size_t max_iov, size_t *iovcnt);
+
+#endif
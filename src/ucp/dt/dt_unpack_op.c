@@ -0,0 +1,285 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "dt_generic.h"
+
+#include <ucs/algorithm/reduce.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/debug/assert.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
+#include <ucs/sys/math.h>
+#include <string.h>
+
+
+/* Maximal size of an element in the packed format */
+#define UCP_DT_UNPACK_OP_MAX_ELEM_SIZE 8
+
+
+/* Element which was split between received fragments */
+typedef struct {
+    uint8_t  data[UCP_DT_UNPACK_OP_MAX_ELEM_SIZE];
+    size_t   length;    /* Number of bytes received so far */
+} ucp_dt_unpack_op_partial_t;
+
+
+KHASH_INIT(ucp_dt_unpack_op_partial, uint64_t, ucp_dt_unpack_op_partial_t, 1,
+           kh_int64_hash_func, kh_int64_hash_equal);
+
+
+/* The generic datatype is the first field, so ucp_dt_destroy() releases the
+ * whole structure */
+typedef struct {
+    ucp_dt_generic_t         super;
+    ucp_dt_unpack_op_t       op;
+    ucs_reduce_type_t        reduce_type;
+    size_t                   elem_size;     /* Element size in packed data */
+    size_t                   buf_elem_size; /* Element size in user buffer */
+} ucp_dt_unpack_op_dt_t;
+
+
+typedef struct {
+    const ucp_dt_unpack_op_dt_t   *dt;
+    void                          *buffer;
+    size_t                        count;
+    /* Elements split between fragments, by element index */
+    khash_t(ucp_dt_unpack_op_partial) partial;
+} ucp_dt_unpack_op_state_t;
+
+
+static void *ucp_dt_unpack_op_start(void *context, const void *buffer,
+                                    size_t count)
+{
+    ucp_dt_unpack_op_state_t *state;
+
+    state = ucs_malloc(sizeof(*state), "dt_unpack_op_state");
+    if (state == NULL) {
+        ucs_error("failed to allocate unpack operator state");
+        return NULL;
+    }
+
+    state->dt     = context;
+    state->buffer = (void*)buffer;
+    state->count  = count;
+    kh_init_inplace(ucp_dt_unpack_op_partial, &state->partial);
+    return state;
+}
+
+static void *
+ucp_dt_unpack_op_start_pack(void *context, const void *buffer, size_t count)
+{
+    return ucp_dt_unpack_op_start(context, buffer, count);
+}
+
+static void *
+ucp_dt_unpack_op_start_unpack(void *context, void *buffer, size_t count)
+{
+    return ucp_dt_unpack_op_start(context, buffer, count);
+}
+
+static size_t ucp_dt_unpack_op_packed_size(void *state)
+{
+    ucp_dt_unpack_op_state_t *op_state = state;
+
+    return op_state->count * op_state->dt->elem_size;
+}
+
+static size_t ucp_dt_unpack_op_pack(void *state, size_t offset, void *dest,
+                                    size_t max_length)
+{
+    ucp_dt_unpack_op_state_t *op_state = state;
+    const ucp_dt_unpack_op_dt_t *dt    = op_state->dt;
+    size_t length, packed, idx, elem_offset, count;
+    float value;
+
+    length = ucs_min(max_length, ucp_dt_unpack_op_packed_size(state) - offset);
+
+    if (dt->op != UCP_DT_UNPACK_OP_TO_FLOAT16) {
+        memcpy(dest, UCS_PTR_BYTE_OFFSET(op_state->buffer, offset), length);
+        return length;
+    }
+
+    /* Convert the half precision buffer back to the packed single precision
+     * format; the first and the last elements may be packed partially */
+    for (packed = 0; packed < length;) {
+        idx         = (offset + packed) / sizeof(value);
+        elem_offset = (offset + packed) % sizeof(value);
+        if ((elem_offset != 0) || ((length - packed) < sizeof(value))) {
+            ucs_half_to_float(&value,
+                              UCS_PTR_BYTE_OFFSET(op_state->buffer,
+                                                  idx * dt->buf_elem_size),
+                              1);
+            count = ucs_min(sizeof(value) - elem_offset, length - packed);
+            memcpy(UCS_PTR_BYTE_OFFSET(dest, packed),
+                   UCS_PTR_BYTE_OFFSET(&value, elem_offset), count);
+            packed += count;
+        } else {
+            count = (length - packed) / sizeof(value);
+            ucs_half_to_float(UCS_PTR_BYTE_OFFSET(dest, packed),
+                              UCS_PTR_BYTE_OFFSET(op_state->buffer,
+                                                  idx * dt->buf_elem_size),
+                              count);
+            packed += count * sizeof(value);
+        }
+    }
+
+    return length;
+}
+
+static void ucp_dt_unpack_op_apply(ucp_dt_unpack_op_state_t *op_state,
+                                   size_t idx, const void *src, size_t count)
+{
+    const ucp_dt_unpack_op_dt_t *dt = op_state->dt;
+    void *dst = UCS_PTR_BYTE_OFFSET(op_state->buffer,
+                                    idx * dt->buf_elem_size);
+
+    ucs_assert((idx + count) <= op_state->count);
+
+    if (dt->op == UCP_DT_UNPACK_OP_TO_FLOAT16) {
+        ucs_float_to_half(dst, src, count);
+    } else {
+        ucs_reduce((ucs_reduce_op_t)dt->op, dt->reduce_type, dst, src, count);
+    }
+}
+
+/* Collect the bytes of an element which is split between fragments, which may
+ * arrive in any order, and apply the operation when it is complete */
+static ucs_status_t
+ucp_dt_unpack_op_partial(ucp_dt_unpack_op_state_t *op_state, size_t idx,
+                         size_t elem_offset, const void *src, size_t length)
+{
+    ucp_dt_unpack_op_partial_t *partial;
+    khiter_t iter;
+    int ret;
+
+    iter = kh_put(ucp_dt_unpack_op_partial, &op_state->partial, idx, &ret);
+    if (ret == UCS_KH_PUT_FAILED) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    partial = &kh_value(&op_state->partial, iter);
+    if (ret != UCS_KH_PUT_KEY_PRESENT) {
+        partial->length = 0;
+    }
+
+    memcpy(&partial->data[elem_offset], src, length);
+    partial->length += length;
+    ucs_assert(partial->length <= op_state->dt->elem_size);
+
+    if (partial->length == op_state->dt->elem_size) {
+        ucp_dt_unpack_op_apply(op_state, idx, partial->data, 1);
+        kh_del(ucp_dt_unpack_op_partial, &op_state->partial, iter);
+    }
+
+    return UCS_OK;
+}
+
+static ucs_status_t ucp_dt_unpack_op_unpack(void *state, size_t offset,
+                                            const void *src, size_t length)
+{
+    ucp_dt_unpack_op_state_t *op_state = state;
+    size_t elem_size                   = op_state->dt->elem_size;
+    size_t idx, elem_offset, count;
+    ucs_status_t status;
+
+    while (length > 0) {
+        idx         = offset / elem_size;
+        elem_offset = offset % elem_size;
+        if ((elem_offset != 0) || (length < elem_size)) {
+            count  = ucs_min(elem_size - elem_offset, length);
+            status = ucp_dt_unpack_op_partial(op_state, idx, elem_offset, src,
+                                              count);
+            if (status != UCS_OK) {
+                return status;
+            }
+        } else {
+            count = (length / elem_size) * elem_size;
+            ucp_dt_unpack_op_apply(op_state, idx, src, count / elem_size);
+        }
+
+        offset += count;
+        src     = UCS_PTR_BYTE_OFFSET(src, count);
+        length -= count;
+    }
+
+    return UCS_OK;
+}
+
+static void ucp_dt_unpack_op_finish(void *state)
+{
+    ucp_dt_unpack_op_state_t *op_state = state;
+
+    if (kh_size(&op_state->partial) > 0) {
+        /* Can happen if the message was truncated */
+        ucs_debug("unpack operator state %p: %u incomplete elements dropped",
+                  op_state, kh_size(&op_state->partial));
+    }
+
+    kh_destroy_inplace(ucp_dt_unpack_op_partial, &op_state->partial);
+    ucs_free(op_state);
+}
+
+static const ucp_generic_dt_ops_t ucp_dt_unpack_op_ops = {
+    .start_pack   = ucp_dt_unpack_op_start_pack,
+    .start_unpack = ucp_dt_unpack_op_start_unpack,
+    .packed_size  = ucp_dt_unpack_op_packed_size,
+    .pack         = ucp_dt_unpack_op_pack,
+    .unpack       = ucp_dt_unpack_op_unpack,
+    .finish       = ucp_dt_unpack_op_finish
+};
+
+ucs_status_t ucp_dt_create_unpack_op(ucp_dt_unpack_op_t op,
+                                     ucp_dt_elem_type_t elem_type,
+                                     ucp_datatype_t *datatype_p)
+{
+    static const struct {
+        ucs_reduce_type_t reduce_type;
+        size_t            size;
+    } elem_types[] = {
+        [UCP_DT_ELEM_TYPE_INT32]   = {UCS_REDUCE_TYPE_INT32,  sizeof(int32_t)},
+        [UCP_DT_ELEM_TYPE_INT64]   = {UCS_REDUCE_TYPE_INT64,  sizeof(int64_t)},
+        [UCP_DT_ELEM_TYPE_FLOAT32] = {UCS_REDUCE_TYPE_FLOAT,  sizeof(float)},
+        [UCP_DT_ELEM_TYPE_FLOAT64] = {UCS_REDUCE_TYPE_DOUBLE, sizeof(double)}
+    };
+    ucp_dt_unpack_op_dt_t *dt;
+    int ret;
+
+    UCS_STATIC_ASSERT((int)UCP_DT_UNPACK_OP_SUM == (int)UCS_REDUCE_OP_SUM);
+    UCS_STATIC_ASSERT((int)UCP_DT_UNPACK_OP_MAX == (int)UCS_REDUCE_OP_MAX);
+
+    if ((elem_type >= ucs_static_array_size(elem_types)) ||
+        (op > UCP_DT_UNPACK_OP_TO_FLOAT16) ||
+        ((op == UCP_DT_UNPACK_OP_TO_FLOAT16) &&
+         (elem_type != UCP_DT_ELEM_TYPE_FLOAT32))) {
+        ucs_error("invalid unpack operator %d for element type %d", op,
+                  elem_type);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    ret = ucs_posix_memalign((void**)&dt,
+                             ucs_max(sizeof(void*), UCS_BIT(UCP_DATATYPE_SHIFT)),
+                             sizeof(*dt), "unpack_op_dt");
+    if (ret != 0) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    dt->op            = op;
+    dt->reduce_type   = elem_types[elem_type].reduce_type;
+    dt->elem_size     = elem_types[elem_type].size;
+    dt->buf_elem_size = (op == UCP_DT_UNPACK_OP_TO_FLOAT16) ?
+                        sizeof(uint16_t) : dt->elem_size;
+    dt->super.ops     = ucp_dt_unpack_op_ops;
+    dt->super.context = dt;
+    /* Packing has no state, and always packs the requested length */
+    dt->super.flags   = UCP_DT_GENERIC_FLAG_PARALLEL_PACK;
+
+    *datatype_p = ucp_dt_from_generic(&dt->super);
+    return UCS_OK;
+}
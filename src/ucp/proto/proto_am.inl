@@ -142,45 +142,65 @@ size_t ucp_dt_iov_copy_iov_uct(uct_iov_t *iov, size_t *iovcnt,
                                ucp_md_index_t md_index, uint64_t md_flags)
 {
     size_t length_it = 0;
-    size_t iov_offset, max_src_iov, src_it, dst_it;
+    size_t iov_offset, max_src_iov, src_it, dst_it, src_length, length;
     ucp_md_index_t memh_index;
+    uct_mem_h memh;
+    void *buffer;
+
+    iov_offset  = state->dt.iov.iov_offset;
+    max_src_iov = state->dt.iov.iovcnt;
+    src_it      = state->dt.iov.iovcnt_offset;
+    dst_it      = 0;
+
+    while ((src_it < max_src_iov) && (length_it < length_max)) {
+        src_length = src_iov[src_it].length - iov_offset;
+        if (src_length == 0) {
+            iov_offset = 0;
+            ++src_it;
+            continue;
+        }
 
-    iov_offset               = state->dt.iov.iov_offset;
-    max_src_iov              = state->dt.iov.iovcnt;
-    src_it                   = state->dt.iov.iovcnt_offset;
-    dst_it                   = 0;
-    state->dt.iov.iov_offset = 0;
-
-    while ((dst_it < max_dst_iov) && (src_it < max_src_iov)) {
-        if (src_iov[src_it].length != 0) {
-            iov[dst_it].buffer   = UCS_PTR_BYTE_OFFSET(src_iov[src_it].buffer,
-                                                       iov_offset);
-            iov[dst_it].length   = src_iov[src_it].length - iov_offset;
-            if (md_flags & UCT_MD_FLAG_NEED_MEMH) {
-                ucs_assert(state->dt.iov.dt_reg != NULL);
-                memh_index       = ucs_bitmap2idx(state->dt.iov.dt_reg[src_it].md_map,
-                                                  md_index);
-                iov[dst_it].memh = state->dt.iov.dt_reg[src_it].memh[memh_index];
-            } else {
-                ucs_assert(state->dt.iov.dt_reg == NULL);
-                iov[dst_it].memh = UCT_MEM_HANDLE_NULL;
-            }
-            iov[dst_it].stride   = 0;
-            iov[dst_it].count    = 1;
-            length_it           += iov[dst_it].length;
+        buffer = UCS_PTR_BYTE_OFFSET(src_iov[src_it].buffer, iov_offset);
+        length = ucs_min(src_length, length_max - length_it);
+        if (md_flags & UCT_MD_FLAG_NEED_MEMH) {
+            ucs_assert(state->dt.iov.dt_reg != NULL);
+            memh_index = ucs_bitmap2idx(state->dt.iov.dt_reg[src_it].md_map,
+                                        md_index);
+            memh       = state->dt.iov.dt_reg[src_it].memh[memh_index];
+        } else {
+            ucs_assert(state->dt.iov.dt_reg == NULL);
+            memh       = UCT_MEM_HANDLE_NULL;
+        }
 
+        if ((dst_it > 0) && (iov[dst_it - 1].memh == memh) &&
+            (UCS_PTR_BYTE_OFFSET(iov[dst_it - 1].buffer,
+                                 iov[dst_it - 1].length) == buffer)) {
+            /* Coalesce with the previous entry, which ends where this one
+             * starts and is covered by the same memory handle */
+            iov[dst_it - 1].length += length;
+        } else if (dst_it < max_dst_iov) {
+            iov[dst_it].buffer = buffer;
+            iov[dst_it].length = length;
+            iov[dst_it].memh   = memh;
+            iov[dst_it].stride = 0;
+            iov[dst_it].count  = 1;
             ++dst_it;
-            if (length_it >= length_max) {
-                iov[dst_it - 1].length  -= (length_it - length_max);
-                length_it                = length_max;
-                state->dt.iov.iov_offset = iov_offset + iov[dst_it - 1].length;
-                break;
-            }
+        } else {
+            break;
+        }
+
+        length_it += length;
+        if (length < src_length) {
+            /* Continue from the middle of the entry in the next call */
+            iov_offset += length;
+            break;
         }
+
         iov_offset = 0;
         ++src_it;
     }
 
+    state->dt.iov.iov_offset    = iov_offset;
     state->dt.iov.iovcnt_offset = src_it;
     *iovcnt                     = dst_it;
 
@@ -197,6 +217,7 @@ void ucp_dt_iov_copy_uct(ucp_context_h context, uct_iov_t *iov, size_t *iovcnt,
     uint64_t md_flags = context->tl_mds[md_index].attr.cap.flags;
     size_t length_it  = 0;
     ucp_md_index_t memh_index;
+    uct_mem_h memh;
 
     ucs_assert((context->tl_mds[md_index].attr.cap.flags & UCT_MD_FLAG_REG) ||
                !(md_flags & UCT_MD_FLAG_NEED_MEMH));
@@ -227,6 +248,18 @@ void ucp_dt_iov_copy_uct(ucp_context_h context, uct_iov_t *iov, size_t *iovcnt,
                                             src_iov, length_max, md_index,
                                             md_flags);
         break;
+    case UCP_DATATYPE_STRIDED:
+        if (md_flags & UCT_MD_FLAG_NEED_MEMH) {
+            memh_index = ucs_bitmap2idx(state->dt.contig.md_map, md_index);
+            memh       = state->dt.contig.memh[memh_index];
+        } else {
+            memh       = UCT_MEM_HANDLE_NULL;
+        }
+        length_it = ucp_dt_strided_to_uct_iov(ucp_dt_to_strided(datatype),
+                                              (void*)src_iov, state->offset,
+                                              length_max, memh, iov,
+                                              max_dst_iov, iovcnt);
+        break;
     default:
         ucs_error("Invalid data type");
     }
@@ -374,6 +407,10 @@ ucs_status_t ucp_do_am_zcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
             /* This flag should guarantee middle stage usage if iovcnt exceeded */
             flag_iov_mid = ((state.dt.iov.iovcnt_offset + max_iov) <
                             state.dt.iov.iovcnt);
+        } else if (UCP_DT_IS_STRIDED(req->send.datatype)) {
+            flag_iov_mid = ucp_dt_strided_block_count(
+                                   ucp_dt_to_strided(req->send.datatype), offset,
+                                   req->send.length - offset) > max_iov;
         } else {
             ucs_assert(UCP_DT_IS_CONTIG(req->send.datatype));
         }
@@ -384,9 +421,14 @@ ucs_status_t ucp_do_am_zcopy_multi(uct_pending_req_t *self, uint8_t am_id_first,
             ucs_assert(am_id_first != UCP_AM_ID_LAST);
             ucs_assert(hdr_first != NULL);
 
+            /* Adjacent IOV entries are coalesced, so the first stage could
+             * cover the whole message; leave some data for the next stage */
             status = ucp_am_zcopy_common(req, hdr_first, hdr_size_first,
                                          user_hdr_desc, user_hdr_size, iov, max_iov,
-                                         max_middle - hdr_size_first + hdr_size_middle,
+                                         ucs_min(max_middle - hdr_size_first +
+                                                 hdr_size_middle,
+                                                 req->send.length - 1 +
+                                                 user_hdr_size),
                                          am_id_first, &state);
 
             ucs_assertv(state.offset != 0, "state must be changed on 1st stage");
@@ -510,6 +552,15 @@ ucp_proto_get_zcopy_threshold(const ucp_request_t *req,
                               worker->context,
                               ucp_worker_iface_bandwidth(worker, rsc_index));
         }
+        return ucs_min(max_zcopy, zcopy_thresh);
+    } else if (UCP_DT_IS_STRIDED(req->send.datatype)) {
+        /* Zero-copy pays off only if the contiguous blocks are large enough
+         * to be worth zero-copy on their own */
+        zcopy_thresh = msg_config->mem_type_zcopy_thresh[req->send.mem_type];
+        if (ucp_dt_to_strided(req->send.datatype)->block_size < zcopy_thresh) {
+            return max_zcopy;
+        }
+
         return ucs_min(max_zcopy, zcopy_thresh);
     } else if (UCP_DT_IS_GENERIC(req->send.datatype)) {
         return max_zcopy;
@@ -0,0 +1,430 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "proto_cache.h"
+
+#include <ucp/core/ucp_context.h>
+#include <ucp/core/ucp_ep.h>
+#include <ucp/core/ucp_rkey.h>
+#include <ucp/core/ucp_worker.h>
+#include <ucs/algorithm/crc.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/debug/log.h>
+#include <ucs/sys/string.h>
+#include <ucs/sys/sys.h>
+#include <ucs/sys/topo.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+
+#define UCP_PROTO_CACHE_MAGIC       "ucx_proto_cache"
+#define UCP_PROTO_CACHE_VERSION     1
+
+
+KHASH_MAP_INIT_INT64(ucp_proto_cache, ucp_proto_cache_elem_t*)
+
+
+struct ucp_proto_cache {
+    ucp_context_h            context;  /* Context whose lock protects the hash */
+    khash_t(ucp_proto_cache) hash;     /* Saved decisions by key */
+    uint64_t                 seed;     /* Initial value of every key */
+    char                     *filename; /* File to save the decisions to */
+    int                      dirty;    /* Decisions were added after loading */
+};
+
+
+static uint64_t ucp_proto_cache_hash_str(uint64_t hash, const char *str)
+{
+    return ucs_fnv1a64(hash, str, strlen(str) + 1);
+}
+
+static ucp_proto_id_t ucp_proto_cache_find_proto(const char *name)
+{
+    ucp_proto_id_t proto_id;
+
+    for (proto_id = 0; proto_id < ucp_protocols_count; ++proto_id) {
+        if (!strcmp(ucp_proto_id_field(proto_id, name), name)) {
+            return proto_id;
+        }
+    }
+
+    return UCP_PROTO_ID_INVALID;
+}
+
+static ucp_proto_cache_elem_t *
+ucp_proto_cache_elem_alloc(unsigned num_thresholds, unsigned num_perf_ranges)
+{
+    ucp_proto_cache_elem_t *elem;
+
+    elem = ucs_malloc(sizeof(*elem) +
+                      (num_thresholds * sizeof(*elem->thresholds)) +
+                      (num_perf_ranges * sizeof(*elem->perf_ranges)),
+                      "ucp_proto_cache_elem");
+    if (elem == NULL) {
+        return NULL;
+    }
+
+    elem->num_thresholds  = num_thresholds;
+    elem->num_perf_ranges = num_perf_ranges;
+    elem->thresholds      = (ucp_proto_threshold_tmp_elem_t*)(elem + 1);
+    elem->perf_ranges     = (ucp_proto_perf_range_t*)(elem->thresholds +
+                                                      num_thresholds);
+    return elem;
+}
+
+static int ucp_proto_cache_insert(ucp_proto_cache_t *cache, uint64_t key,
+                                  ucp_proto_cache_elem_t *elem)
+{
+    khiter_t khiter;
+    int khret;
+
+    khiter = kh_put(ucp_proto_cache, &cache->hash, key, &khret);
+    if ((khret == UCS_KH_PUT_FAILED) || (khret == UCS_KH_PUT_KEY_PRESENT)) {
+        return 0;
+    }
+
+    kh_value(&cache->hash, khiter) = elem;
+    return 1;
+}
+
+static ucp_proto_cache_elem_t *ucp_proto_cache_read_elem(FILE *stream,
+                                                         uint64_t *key_p)
+{
+    unsigned i, num_thresholds, num_perf_ranges;
+    char line[256], proto_name[64];
+    ucp_proto_cache_elem_t *elem;
+    size_t max_length, prev;
+    ucp_proto_id_t proto_id;
+    double c, m;
+
+    if ((fgets(line, sizeof(line), stream) == NULL) ||
+        (sscanf(line, "elem %" SCNx64 " %u %u", key_p, &num_thresholds,
+                &num_perf_ranges) != 3) ||
+        (num_thresholds == 0) || (num_thresholds > UCP_PROTO_MAX_COUNT) ||
+        (num_perf_ranges == 0) ||
+        (num_perf_ranges > UCP_PROTO_MAX_COUNT * UCP_PROTO_MAX_PERF_RANGES)) {
+        return NULL;
+    }
+
+    elem = ucp_proto_cache_elem_alloc(num_thresholds, num_perf_ranges);
+    if (elem == NULL) {
+        return NULL;
+    }
+
+    prev = 0;
+    for (i = 0; i < num_thresholds; ++i) {
+        if ((fgets(line, sizeof(line), stream) == NULL) ||
+            (sscanf(line, "thresh %zu %63s", &max_length, proto_name) != 2) ||
+            ((i > 0) && (max_length <= prev))) {
+            goto err_free;
+        }
+
+        proto_id = ucp_proto_cache_find_proto(proto_name);
+        if (proto_id == UCP_PROTO_ID_INVALID) {
+            ucs_debug("protocol '%s' is not available", proto_name);
+            goto err_free;
+        }
+
+        elem->thresholds[i].max_length = max_length;
+        elem->thresholds[i].proto_id   = proto_id;
+        prev                           = max_length;
+    }
+
+    for (i = 0; i < num_perf_ranges; ++i) {
+        if ((fgets(line, sizeof(line), stream) == NULL) ||
+            (sscanf(line, "perf %zu %la %la", &max_length, &c, &m) != 3) ||
+            ((i > 0) && (max_length <= prev))) {
+            goto err_free;
+        }
+
+        elem->perf_ranges[i].max_length = max_length;
+        elem->perf_ranges[i].perf       = ucs_linear_func_make(c, m);
+        prev                            = max_length;
+    }
+
+    /* Both arrays must cover all message sizes */
+    if ((elem->thresholds[num_thresholds - 1].max_length != SIZE_MAX) ||
+        (elem->perf_ranges[num_perf_ranges - 1].max_length != SIZE_MAX)) {
+        goto err_free;
+    }
+
+    return elem;
+
+err_free:
+    ucs_free(elem);
+    return NULL;
+}
+
+static void ucp_proto_cache_load(ucp_proto_cache_t *cache)
+{
+    ucp_proto_cache_elem_t *elem;
+    unsigned version, count;
+    char line[256];
+    uint64_t key;
+    FILE *stream;
+
+    stream = fopen(cache->filename, "r");
+    if (stream == NULL) {
+        ucs_debug("protocol cache %s is not available: %m", cache->filename);
+        return;
+    }
+
+    if ((fgets(line, sizeof(line), stream) == NULL) ||
+        (sscanf(line, UCP_PROTO_CACHE_MAGIC " %u", &version) != 1) ||
+        (version != UCP_PROTO_CACHE_VERSION)) {
+        ucs_debug("ignoring protocol cache %s with invalid header",
+                  cache->filename);
+        goto out;
+    }
+
+    count = 0;
+    while (!feof(stream)) {
+        elem = ucp_proto_cache_read_elem(stream, &key);
+        if (elem == NULL) {
+            break;
+        }
+
+        if (!ucp_proto_cache_insert(cache, key, elem)) {
+            ucs_free(elem);
+            continue;
+        }
+
+        ++count;
+    }
+
+    if (!feof(stream)) {
+        ucs_debug("protocol cache %s: stopped loading at invalid entry",
+                  cache->filename);
+        /* Rewrite the file without the invalid entries */
+        cache->dirty = 1;
+    }
+
+    ucs_debug("loaded %u protocol selections from %s", count,
+              cache->filename);
+out:
+    fclose(stream);
+}
+
+static ucs_status_t ucp_proto_cache_write(FILE *stream, void *ctx)
+{
+    ucp_proto_cache_t *cache = ctx;
+    const ucp_proto_cache_elem_t *elem;
+    uint64_t key;
+    unsigned i;
+
+    fprintf(stream, UCP_PROTO_CACHE_MAGIC " %u\n", UCP_PROTO_CACHE_VERSION);
+    kh_foreach(&cache->hash, key, elem, {
+        fprintf(stream, "elem %016" PRIx64 " %u %u\n", key, elem->num_thresholds,
+                elem->num_perf_ranges);
+        for (i = 0; i < elem->num_thresholds; ++i) {
+            fprintf(stream, "thresh %zu %s\n", elem->thresholds[i].max_length,
+                    ucp_proto_id_field(elem->thresholds[i].proto_id, name));
+        }
+        for (i = 0; i < elem->num_perf_ranges; ++i) {
+            fprintf(stream, "perf %zu %a %a\n",
+                    elem->perf_ranges[i].max_length,
+                    elem->perf_ranges[i].perf.c, elem->perf_ranges[i].perf.m);
+        }
+    })
+
+    return UCS_OK;
+}
+
+static void ucp_proto_cache_save(ucp_proto_cache_t *cache)
+{
+    ucs_status_t status;
+
+    status = ucs_sys_write_file_atomic(cache->filename, ucp_proto_cache_write,
+                                       cache);
+    if (status != UCS_OK) {
+        ucs_debug("failed to save protocol cache %s", cache->filename);
+        return;
+    }
+
+    ucs_debug("saved %u protocol selections to %s", kh_size(&cache->hash),
+              cache->filename);
+}
+
+ucs_status_t ucp_proto_cache_create(ucp_context_h context, const char *filename,
+                                    ucp_proto_cache_t **cache_p)
+{
+    ucp_proto_cache_t *cache;
+    uint32_t env_crc;
+
+    cache = ucs_malloc(sizeof(*cache), "ucp_proto_cache");
+    if (cache == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    cache->filename = ucs_strdup(filename, "ucp_proto_cache_filename");
+    if (cache->filename == NULL) {
+        ucs_free(cache);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    cache->context = context;
+    cache->dirty   = 0;
+    env_crc        = ucp_config_env_crc32(0);
+    cache->seed    = ucs_fnv1a64(UCS_FNV1A64_INIT, &env_crc,
+                                 sizeof(env_crc));
+    kh_init_inplace(ucp_proto_cache, &cache->hash);
+
+    ucp_proto_cache_load(cache);
+
+    *cache_p = cache;
+    return UCS_OK;
+}
+
+void ucp_proto_cache_destroy(ucp_proto_cache_t *cache)
+{
+    ucp_proto_cache_elem_t *elem;
+
+    if (cache->dirty) {
+        ucp_proto_cache_save(cache);
+    }
+
+    kh_foreach_value(&cache->hash, elem, {
+        ucs_free(elem);
+    })
+    kh_destroy_inplace(ucp_proto_cache, &cache->hash);
+    ucs_free(cache->filename);
+    ucs_free(cache);
+}
+
+uint64_t ucp_proto_cache_key(ucp_worker_h worker,
+                             ucp_worker_cfg_index_t ep_cfg_index,
+                             ucp_worker_cfg_index_t rkey_cfg_index,
+                             const ucp_proto_select_param_t *select_param)
+{
+    ucp_context_h context          = worker->context;
+    const ucp_ep_config_key_t *key =
+            &ucp_worker_ep_config(worker, ep_cfg_index)->key;
+    const ucp_rkey_config_key_t *rkey_config_key;
+    const uct_tl_resource_desc_t *tl_rsc;
+    ucp_proto_select_param_t param;
+    char sys_dev_name[32];
+    ucp_lane_index_t lane;
+    ucp_rsc_index_t cmpt_index;
+    unsigned i, num_dst_mds;
+    uint64_t hash;
+
+    /* Use transport and device names rather than the resource indexes, which
+     * depend on the order of resources in the process */
+    hash = ucs_fnv1a64(context->proto_cache->seed, &key->num_lanes,
+                       sizeof(key->num_lanes));
+    for (lane = 0; lane < key->num_lanes; ++lane) {
+        if (key->lanes[lane].rsc_index == UCP_NULL_RESOURCE) {
+            hash = ucp_proto_cache_hash_str(hash, "");
+        } else {
+            tl_rsc = &context->tl_rscs[key->lanes[lane].rsc_index].tl_rsc;
+            hash   = ucp_proto_cache_hash_str(hash, tl_rsc->tl_name);
+            hash   = ucp_proto_cache_hash_str(hash, tl_rsc->dev_name);
+        }
+        hash = ucs_fnv1a64(hash, &key->lanes[lane].dst_md_index,
+                           sizeof(key->lanes[lane].dst_md_index));
+        hash = ucs_fnv1a64(hash, &key->lanes[lane].path_index,
+                           sizeof(key->lanes[lane].path_index));
+        hash = ucs_fnv1a64(hash, &key->lanes[lane].lane_types,
+                           sizeof(key->lanes[lane].lane_types));
+    }
+
+    hash = ucs_fnv1a64(hash, &key->am_lane, sizeof(key->am_lane));
+    hash = ucs_fnv1a64(hash, &key->tag_lane, sizeof(key->tag_lane));
+    hash = ucs_fnv1a64(hash, &key->wireup_msg_lane,
+                       sizeof(key->wireup_msg_lane));
+    hash = ucs_fnv1a64(hash, &key->cm_lane, sizeof(key->cm_lane));
+    hash = ucs_fnv1a64(hash, key->rma_lanes, sizeof(key->rma_lanes));
+    hash = ucs_fnv1a64(hash, key->rma_bw_lanes,
+                       sizeof(key->rma_bw_lanes));
+    hash = ucs_fnv1a64(hash, &key->rkey_ptr_lane,
+                       sizeof(key->rkey_ptr_lane));
+    hash = ucs_fnv1a64(hash, key->amo_lanes, sizeof(key->amo_lanes));
+    hash = ucs_fnv1a64(hash, key->am_bw_lanes,
+                       sizeof(key->am_bw_lanes));
+    hash = ucs_fnv1a64(hash, &key->rma_bw_md_map,
+                       sizeof(key->rma_bw_md_map));
+    hash = ucs_fnv1a64(hash, &key->reachable_md_map,
+                       sizeof(key->reachable_md_map));
+
+    num_dst_mds = ucs_popcount(key->reachable_md_map);
+    for (i = 0; i < num_dst_mds; ++i) {
+        cmpt_index = key->dst_md_cmpts[i];
+        hash       = ucp_proto_cache_hash_str(
+                hash, context->tl_cmpts[cmpt_index].attr.name);
+    }
+
+    hash = ucs_fnv1a64(hash, &key->ep_check_map,
+                       sizeof(key->ep_check_map));
+    hash = ucs_fnv1a64(hash, &key->err_mode, sizeof(key->err_mode));
+
+    if (rkey_cfg_index != UCP_WORKER_CFG_INDEX_NULL) {
+        rkey_config_key = &worker->rkey_config[rkey_cfg_index].key;
+        hash = ucs_fnv1a64(hash, &rkey_config_key->md_map,
+                           sizeof(rkey_config_key->md_map));
+        hash = ucs_fnv1a64(hash, &rkey_config_key->mem_type,
+                           sizeof(rkey_config_key->mem_type));
+    }
+
+    /* System device index is local to the process, use its bus name */
+    param = *select_param;
+    if (param.sys_dev != UCS_SYS_DEVICE_ID_UNKNOWN) {
+        hash = ucp_proto_cache_hash_str(
+                hash, ucs_topo_sys_device_bdf_name(param.sys_dev, sys_dev_name,
+                                                   sizeof(sys_dev_name)));
+        param.sys_dev = UCS_SYS_DEVICE_ID_UNKNOWN;
+    }
+
+    return ucs_fnv1a64(hash, &param, sizeof(param));
+}
+
+const ucp_proto_cache_elem_t *
+ucp_proto_cache_lookup(ucp_proto_cache_t *cache, uint64_t key)
+{
+    const ucp_proto_cache_elem_t *elem = NULL;
+    khiter_t khiter;
+
+    UCP_THREAD_CS_ENTER(&cache->context->mt_lock);
+    khiter = kh_get(ucp_proto_cache, &cache->hash, key);
+    if (khiter != kh_end(&cache->hash)) {
+        elem = kh_value(&cache->hash, khiter);
+    }
+    UCP_THREAD_CS_EXIT(&cache->context->mt_lock);
+
+    return elem;
+}
+
+void ucp_proto_cache_add(ucp_proto_cache_t *cache, uint64_t key,
+                         const ucp_proto_threshold_tmp_elem_t *thresholds,
+                         unsigned num_thresholds,
+                         const ucp_proto_perf_range_t *perf_ranges,
+                         unsigned num_perf_ranges)
+{
+    ucp_proto_cache_elem_t *elem;
+
+    elem = ucp_proto_cache_elem_alloc(num_thresholds, num_perf_ranges);
+    if (elem == NULL) {
+        return;
+    }
+
+    memcpy(elem->thresholds, thresholds,
+           num_thresholds * sizeof(*elem->thresholds));
+    memcpy(elem->perf_ranges, perf_ranges,
+           num_perf_ranges * sizeof(*elem->perf_ranges));
+
+    UCP_THREAD_CS_ENTER(&cache->context->mt_lock);
+    if (ucp_proto_cache_insert(cache, key, elem)) {
+        cache->dirty = 1;
+        elem         = NULL;
+    }
+    UCP_THREAD_CS_EXIT(&cache->context->mt_lock);
+
+    /* Another worker may have added the same decision */
+    ucs_free(elem);
+}
@@ -0,0 +1,73 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_PROTO_CACHE_H_
+#define UCP_PROTO_CACHE_H_
+
+#include "proto_select.h"
+
+
+/**
+ * Protocol selection decision saved in the persistent cache: which protocol is
+ * used for each message size range, and the estimated performance.
+ */
+typedef struct {
+    unsigned                       num_thresholds;  /* Size of 'thresholds' */
+    unsigned                       num_perf_ranges; /* Size of 'perf_ranges' */
+    ucp_proto_threshold_tmp_elem_t *thresholds;     /* Selected protocols */
+    ucp_proto_perf_range_t         *perf_ranges;    /* Performance estimation */
+} ucp_proto_cache_elem_t;
+
+
+/**
+ * Create the protocol selection cache of a context, and load the decisions
+ * saved in the cache file, if it exists.
+ *
+ * @param [in]  context   Context to create the cache for.
+ * @param [in]  filename  Cache file to load from, and save to on destroy.
+ * @param [out] cache_p   Filled with the new cache.
+ */
+ucs_status_t ucp_proto_cache_create(ucp_context_h context, const char *filename,
+                                    ucp_proto_cache_t **cache_p);
+
+
+/**
+ * Save the cache to its file if new decisions were added, and destroy it.
+ */
+void ucp_proto_cache_destroy(ucp_proto_cache_t *cache);
+
+
+/**
+ * Compute the cache key of a protocol selection. The key does not depend on
+ * process-local indexes, so it is the same in all processes which use the same
+ * transports and configuration.
+ */
+uint64_t ucp_proto_cache_key(ucp_worker_h worker,
+                             ucp_worker_cfg_index_t ep_cfg_index,
+                             ucp_worker_cfg_index_t rkey_cfg_index,
+                             const ucp_proto_select_param_t *select_param);
+
+
+/**
+ * Find a protocol selection decision in the cache.
+ *
+ * @return The saved decision, or NULL if not found. The decision is valid
+ *         until the cache is destroyed.
+ */
+const ucp_proto_cache_elem_t *
+ucp_proto_cache_lookup(ucp_proto_cache_t *cache, uint64_t key);
+
+
+/**
+ * Add a protocol selection decision to the cache.
+ */
+void ucp_proto_cache_add(ucp_proto_cache_t *cache, uint64_t key,
+                         const ucp_proto_threshold_tmp_elem_t *thresholds,
+                         unsigned num_thresholds,
+                         const ucp_proto_perf_range_t *perf_ranges,
+                         unsigned num_perf_ranges);
+
+#endif
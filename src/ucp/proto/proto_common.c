@@ -145,8 +145,9 @@ ucp_proto_common_find_lanes_internal(const ucp_proto_init_params_t *params,
 
     if (flags & UCP_PROTO_COMMON_INIT_FLAG_SEND_ZCOPY) {
         if ((select_param->dt_class == UCP_DATATYPE_GENERIC) ||
-            (select_param->dt_class == UCP_DATATYPE_IOV)) {
-            /* Generic/IOV datatype cannot be used with zero-copy send */
+            (select_param->dt_class == UCP_DATATYPE_IOV) ||
+            (select_param->dt_class == UCP_DATATYPE_STRIDED)) {
+            /* Generic/IOV/strided datatype cannot be used with zero-copy send */
             /* TODO support IOV registration */
             ucs_trace("datatype %s cannot be used with zcopy",
                       ucp_datatype_class_names[select_param->dt_class]);
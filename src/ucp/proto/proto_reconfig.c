@@ -29,7 +29,7 @@ static ucs_status_t ucp_proto_reconfig_select_progress(uct_pending_req_t *self)
      */
     prev_rkey_cfg_index = req->send.proto_config->rkey_cfg_index;
     if (prev_rkey_cfg_index == UCP_WORKER_CFG_INDEX_NULL) {
-        proto_select   = &worker->ep_config[ep->cfg_index].proto_select;
+        proto_select   = &ucp_ep_config(ep)->proto_select;
         rkey_cfg_index = UCP_WORKER_CFG_INDEX_NULL;
     } else {
         rkey_config_key = worker->rkey_config[prev_rkey_cfg_index].key;
@@ -8,6 +8,7 @@
 #  include "config.h"
 #endif
 
+#include "proto_cache.h"
 #include "proto_select.h"
 #include "proto_select.inl"
 #include "proto_single.h"
@@ -37,13 +38,6 @@ typedef struct {
                                                                          area in 'priv_buf' */
 } ucp_proto_select_init_protocols_t;
 
-/* Temporary list of constructed protocol thresholds */
-typedef struct {
-    size_t                         max_length; /* Maximal message size */
-    ucp_proto_id_t                 proto_id;   /* Selected protocol up to 'max_length' */
-} ucp_proto_threshold_tmp_elem_t;
-
-
 UCS_ARRAY_DEFINE_INLINE(ucp_proto_thresh, unsigned,
                         ucp_proto_threshold_tmp_elem_t);
 UCS_ARRAY_DEFINE_INLINE(ucp_proto_perf, unsigned, ucp_proto_perf_range_t);
@@ -351,6 +345,7 @@ ucp_proto_select_init_protocols(ucp_worker_h worker,
                                 ucp_worker_cfg_index_t ep_cfg_index,
                                 ucp_worker_cfg_index_t rkey_cfg_index,
                                 const ucp_proto_select_param_t *select_param,
+                                ucp_proto_id_mask_t proto_mask,
                                 ucp_proto_select_init_protocols_t *proto_init)
 {
     ucp_proto_init_params_t init_params;
@@ -368,7 +363,8 @@ ucp_proto_select_init_protocols(ucp_worker_h worker,
     init_params.worker        = worker;
     init_params.select_param  = select_param;
     init_params.ep_cfg_index  = ep_cfg_index;
-    init_params.ep_config_key = &worker->ep_config[ep_cfg_index].key;
+    init_params.ep_config_key = &ucp_worker_ep_config(worker,
+                                                      ep_cfg_index)->key;
 
     if (rkey_cfg_index == UCP_WORKER_CFG_INDEX_NULL) {
         init_params.rkey_config_key = NULL;
@@ -394,7 +390,7 @@ ucp_proto_select_init_protocols(ucp_worker_h worker,
     }
 
     offset = 0;
-    for (proto_id = 0; proto_id < ucp_protocols_count; ++proto_id) {
+    ucs_for_each_bit(proto_id, proto_mask) {
         proto_caps            = &proto_init->caps[proto_id];
         init_params.priv      = UCS_PTR_BYTE_OFFSET(proto_init->priv_buf,
                                                           offset);
@@ -472,25 +468,85 @@ err:
     return status;
 }
 
+static ucs_status_t ucp_proto_select_elem_set(
+        ucp_proto_select_elem_t *select_elem,
+        const ucp_proto_select_init_protocols_t *proto_init,
+        ucp_worker_cfg_index_t ep_cfg_index,
+        ucp_worker_cfg_index_t rkey_cfg_index,
+        const ucp_proto_threshold_tmp_elem_t *tmp_thresholds,
+        unsigned num_thresholds, const ucp_proto_perf_range_t *tmp_perf_ranges,
+        unsigned num_perf_ranges)
+{
+    ucp_proto_threshold_elem_t *thresholds;
+    ucp_proto_perf_range_t *perf_ranges;
+    ucp_proto_config_t *proto_config;
+    ucp_proto_id_t proto_id;
+    size_t priv_offset;
+    unsigned i;
+
+    ucs_assert_always(num_thresholds > 0);
+    ucs_assert_always(tmp_thresholds[num_thresholds - 1].max_length ==
+                      SIZE_MAX);
+
+    /* Set pointer to priv buffer (to release it during cleanup) */
+    select_elem->priv_buf   = proto_init->priv_buf;
+
+    /* Allocate thresholds array */
+    thresholds = ucs_calloc(num_thresholds, sizeof(*select_elem->thresholds),
+                            "ucp_proto_thresholds");
+    if (thresholds == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    select_elem->thresholds = thresholds;
+
+    /* Copy the temporary thresholds list to an array inside select_elem */
+    for (i = 0; i < num_thresholds; ++i) {
+        proto_id                     = tmp_thresholds[i].proto_id;
+        priv_offset                  = proto_init->priv_offsets[proto_id];
+        thresholds[i].max_msg_length = tmp_thresholds[i].max_length;
+
+        proto_config                 = &thresholds[i].proto_config;
+        proto_config->select_param   = *proto_init->select_param;
+        proto_config->ep_cfg_index   = ep_cfg_index;
+        proto_config->rkey_cfg_index = rkey_cfg_index;
+        proto_config->proto          = ucp_protocols[proto_id];
+        proto_config->priv           = UCS_PTR_BYTE_OFFSET(select_elem->priv_buf,
+                                                           priv_offset);
+    }
+
+    ucs_assert_always(num_perf_ranges > 0);
+    ucs_assert_always(tmp_perf_ranges[num_perf_ranges - 1].max_length ==
+                      SIZE_MAX);
+
+    /* Allocate performance functions array */
+    perf_ranges = ucs_calloc(num_perf_ranges, sizeof(*select_elem->perf_ranges),
+                             "ucp_proto_perf");
+    if (perf_ranges == NULL) {
+        ucs_free((void*)select_elem->thresholds);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    select_elem->perf_ranges = perf_ranges;
+
+    /* Copy the performance elements */
+    memcpy(perf_ranges, tmp_perf_ranges, num_perf_ranges * sizeof(*perf_ranges));
+    return UCS_OK;
+}
+
 static ucs_status_t ucp_proto_select_elem_init_thresh(
         ucp_proto_select_elem_t *select_elem,
         const ucp_proto_select_init_protocols_t *proto_init,
         ucp_worker_cfg_index_t ep_cfg_index,
-        ucp_worker_cfg_index_t rkey_cfg_index)
+        ucp_worker_cfg_index_t rkey_cfg_index, ucp_proto_cache_t *proto_cache,
+        uint64_t cache_key)
 {
     UCS_ARRAY_DEFINE_ONSTACK(tmp_thresh_list, ucp_proto_thresh,
                              UCP_PROTO_MAX_COUNT);
     UCS_ARRAY_DEFINE_ONSTACK(tmp_perf_list, ucp_proto_perf,
                              UCP_PROTO_MAX_PERF_RANGES);
-    ucp_proto_perf_range_t *perf_ranges, *tmp_perf_elem;
-    ucp_proto_threshold_tmp_elem_t *tmp_thresh_elem;
-    ucp_proto_threshold_elem_t *thresholds;
     size_t msg_length, max_length;
-    ucp_proto_config_t *proto_config;
-    ucp_proto_id_t proto_id;
     ucs_status_t status;
-    size_t priv_offset;
-    unsigned i;
 
     /*
      * Select a protocol for every message size interval, until we cover all
@@ -511,71 +567,94 @@ static ucs_status_t ucp_proto_select_elem_init_thresh(
             if (status == UCS_ERR_UNSUPPORTED) {
                 ucs_debug("no protocol for msg_length %zu", msg_length);
             }
-            goto err;
+            return status;
         }
 
         msg_length = max_length + 1;
     } while (max_length < SIZE_MAX);
 
-    /* Set pointer to priv buffer (to release it during cleanup) */
-    select_elem->priv_buf   = proto_init->priv_buf;
-
-    ucs_assert_always(!ucs_array_is_empty(&tmp_thresh_list));
-    ucs_assert_always(ucs_array_last(&tmp_thresh_list)->max_length ==
-                      SIZE_MAX);
+    status = ucp_proto_select_elem_set(select_elem, proto_init, ep_cfg_index,
+                                       rkey_cfg_index,
+                                       ucs_array_begin(&tmp_thresh_list),
+                                       ucs_array_length(&tmp_thresh_list),
+                                       ucs_array_begin(&tmp_perf_list),
+                                       ucs_array_length(&tmp_perf_list));
+    if (status != UCS_OK) {
+        return status;
+    }
 
-    /* Allocate thresholds array */
-    thresholds = ucs_calloc(ucs_array_length(&tmp_thresh_list),
-                            sizeof(*select_elem->thresholds),
-                            "ucp_proto_thresholds");
-    if (thresholds == NULL) {
-        status = UCS_ERR_NO_MEMORY;
-        goto err;
+    if (proto_cache != NULL) {
+        ucp_proto_cache_add(proto_cache, cache_key,
+                            ucs_array_begin(&tmp_thresh_list),
+                            ucs_array_length(&tmp_thresh_list),
+                            ucs_array_begin(&tmp_perf_list),
+                            ucs_array_length(&tmp_perf_list));
     }
 
-    select_elem->thresholds = thresholds;
+    return UCS_OK;
+}
 
-    /* Copy the temporary thresholds list to an array inside select_elem */
-    i = 0;
-    ucs_array_for_each(tmp_thresh_elem, &tmp_thresh_list) {
-        proto_id                     = tmp_thresh_elem->proto_id;
-        priv_offset                  = proto_init->priv_offsets[proto_id];
-        thresholds[i].max_msg_length = tmp_thresh_elem->max_length;
+/*
+ * Initialize only the protocols selected by a saved decision, and check that
+ * each of them still supports the message sizes it was selected for.
+ */
+static ucs_status_t ucp_proto_select_elem_init_cached(
+        ucp_worker_h worker, ucp_worker_cfg_index_t ep_cfg_index,
+        ucp_worker_cfg_index_t rkey_cfg_index,
+        const ucp_proto_select_param_t *select_param,
+        const ucp_proto_cache_elem_t *cache_elem,
+        ucp_proto_select_init_protocols_t *proto_init,
+        ucp_proto_select_elem_t *select_elem)
+{
+    ucp_proto_id_mask_t proto_mask = 0;
+    const ucp_proto_caps_t *caps;
+    ucp_proto_id_t proto_id;
+    ucs_status_t status;
+    size_t msg_length;
+    unsigned i;
 
-        proto_config                 = &thresholds[i].proto_config;
-        proto_config->select_param   = *proto_init->select_param;
-        proto_config->ep_cfg_index   = ep_cfg_index;
-        proto_config->rkey_cfg_index = rkey_cfg_index;
-        proto_config->proto          = ucp_protocols[proto_id];
-        proto_config->priv           = UCS_PTR_BYTE_OFFSET(select_elem->priv_buf,
-                                                           priv_offset);
-        ++i;
+    for (i = 0; i < cache_elem->num_thresholds; ++i) {
+        proto_mask |= UCS_BIT(cache_elem->thresholds[i].proto_id);
     }
 
-    ucs_assert_always(!ucs_array_is_empty(&tmp_perf_list));
-    ucs_assert_always(ucs_array_last(&tmp_perf_list)->max_length == SIZE_MAX);
-
-    /* Allocate performance functions array */
-    perf_ranges = ucs_calloc(ucs_array_length(&tmp_perf_list),
-                             sizeof(*select_elem->perf_ranges), "ucp_proto_perf");
-    if (perf_ranges == NULL) {
-        status = UCS_ERR_NO_MEMORY;
-        goto err_free_thresholds;
+    status = ucp_proto_select_init_protocols(worker, ep_cfg_index,
+                                             rkey_cfg_index, select_param,
+                                             proto_mask, proto_init);
+    if (status != UCS_OK) {
+        return status;
     }
 
-    select_elem->perf_ranges = perf_ranges;
+    msg_length = 0;
+    for (i = 0; i < cache_elem->num_thresholds; ++i) {
+        proto_id = cache_elem->thresholds[i].proto_id;
+        caps     = &proto_init->caps[proto_id];
+        if (!(proto_init->mask & UCS_BIT(proto_id)) ||
+            (msg_length < caps->min_length) ||
+            (cache_elem->thresholds[i].max_length >
+             caps->ranges[caps->num_ranges - 1].max_length)) {
+            ucs_debug("saved selection of %s up to %zu is not supported",
+                      ucp_proto_id_field(proto_id, name),
+                      cache_elem->thresholds[i].max_length);
+            status = UCS_ERR_UNSUPPORTED;
+            goto err_free_priv;
+        }
 
-    /* Copy the performance elements */
-    i = 0;
-    ucs_array_for_each(tmp_perf_elem, &tmp_perf_list) {
-        perf_ranges[i++] = *tmp_perf_elem;
+        msg_length = cache_elem->thresholds[i].max_length + 1;
+    }
+
+    status = ucp_proto_select_elem_set(select_elem, proto_init, ep_cfg_index,
+                                       rkey_cfg_index, cache_elem->thresholds,
+                                       cache_elem->num_thresholds,
+                                       cache_elem->perf_ranges,
+                                       cache_elem->num_perf_ranges);
+    if (status != UCS_OK) {
+        goto err_free_priv;
     }
 
     return UCS_OK;
 
-err_free_thresholds:
-    ucs_free((void*)select_elem->thresholds);
-err:
+err_free_priv:
+    ucs_free(proto_init->priv_buf);
     return status;
 }
 
@@ -587,7 +666,10 @@ ucp_proto_select_elem_init(ucp_worker_h worker,
                            ucp_proto_select_elem_t *select_elem)
 {
     UCS_STRING_BUFFER_ONSTACK(sel_param_strb, UCP_PROTO_SELECT_PARAM_STR_MAX);
+    const ucp_proto_cache_elem_t *cache_elem;
     ucp_proto_select_init_protocols_t *proto_init;
+    ucp_proto_cache_t *proto_cache;
+    uint64_t cache_key = 0;
     ucs_status_t status;
 
     ucp_proto_select_param_str(select_param, &sel_param_strb);
@@ -608,15 +690,39 @@ ucp_proto_select_elem_init(ucp_worker_h worker,
         goto out;
     }
 
+    proto_cache = worker->context->proto_cache;
+    if (proto_cache != NULL) {
+        cache_key  = ucp_proto_cache_key(worker, ep_cfg_index, rkey_cfg_index,
+                                         select_param);
+        cache_elem = ucp_proto_cache_lookup(proto_cache, cache_key);
+        if (cache_elem != NULL) {
+            status = ucp_proto_select_elem_init_cached(worker, ep_cfg_index,
+                                                       rkey_cfg_index,
+                                                       select_param, cache_elem,
+                                                       proto_init, select_elem);
+            if (status == UCS_OK) {
+                ucs_trace("using saved selection 0x%" PRIx64, cache_key);
+                goto out_free_proto_init;
+            }
+
+            ucs_debug("saved selection 0x%" PRIx64 " is not usable: %s",
+                      cache_key, ucs_status_string(status));
+            /* Don't overwrite the saved decision */
+            proto_cache = NULL;
+        }
+    }
+
     status = ucp_proto_select_init_protocols(worker, ep_cfg_index,
                                              rkey_cfg_index, select_param,
+                                             UCS_MASK_SAFE(ucp_protocols_count),
                                              proto_init);
     if (status != UCS_OK) {
         goto out_free_proto_init;
     }
 
     status = ucp_proto_select_elem_init_thresh(select_elem, proto_init,
-                                               ep_cfg_index, rkey_cfg_index);
+                                               ep_cfg_index, rkey_cfg_index,
+                                               proto_cache, cache_key);
     if (status != UCS_OK) {
         goto err_cleanup_protocols;
     }
@@ -692,6 +798,32 @@ out:
     return select_elem;
 }
 
+void ucp_proto_select_prefill(ucp_worker_h worker,
+                              ucp_worker_cfg_index_t ep_cfg_index)
+{
+    static const ucp_operation_id_t op_ids[] = {
+        UCP_OP_ID_TAG_SEND, UCP_OP_ID_TAG_SEND_SYNC
+    };
+    static const uint32_t op_attr_masks[] = {0, UCP_OP_ATTR_FLAG_FAST_CMPL};
+    ucp_proto_select_t *proto_select =
+            &ucp_worker_ep_config(worker, ep_cfg_index)->proto_select;
+    ucp_proto_select_param_t select_param;
+    ucs_memory_info_t mem_info;
+    unsigned i, j;
+
+    ucp_memory_info_set_host(&mem_info);
+    for (i = 0; i < ucs_static_array_size(op_ids); ++i) {
+        for (j = 0; j < ucs_static_array_size(op_attr_masks); ++j) {
+            ucp_proto_select_param_init(&select_param, op_ids[i],
+                                        op_attr_masks[j], UCP_DATATYPE_CONTIG,
+                                        &mem_info, 1);
+            ucp_proto_select_lookup_slow(worker, proto_select, ep_cfg_index,
+                                         UCP_WORKER_CFG_INDEX_NULL,
+                                         &select_param);
+        }
+    }
+}
+
 ucs_status_t ucp_proto_select_init(ucp_proto_select_t *proto_select)
 {
     kh_init_inplace(ucp_proto_select_hash, &proto_select->hash);
@@ -740,6 +872,7 @@ ucp_proto_select_dump_all(ucp_worker_h worker,
 
     status = ucp_proto_select_init_protocols(worker, ep_cfg_index,
                                              rkey_cfg_index, select_param,
+                                             UCS_MASK_SAFE(ucp_protocols_count),
                                              proto_init);
     if (status != UCS_OK) {
         goto out_free;
@@ -908,7 +1041,8 @@ void ucp_proto_select_dump(ucp_worker_h worker,
     ucp_proto_select_key_t key;
     char info[256];
 
-    ucp_worker_print_used_tls(&worker->ep_config[ep_cfg_index].key,
+    ucp_worker_print_used_tls(&ucp_worker_ep_config(worker,
+                                                    ep_cfg_index)->key,
                               worker->context, ep_cfg_index, info,
                               sizeof(info));
     ucs_string_buffer_appendf(strb, "\nProtocol selection for %s", info);
@@ -33,6 +33,15 @@ typedef struct {
 } ucp_proto_threshold_elem_t;
 
 
+/**
+ * Temporary list of constructed protocol thresholds
+ */
+typedef struct {
+    size_t                      max_length; /* Maximal message size */
+    ucp_proto_id_t              proto_id;   /* Selected protocol up to 'max_length' */
+} ucp_proto_threshold_tmp_elem_t;
+
+
 /**
  * Protocol selection per a particular buffer type and operation
  */
@@ -107,6 +116,14 @@ ucp_proto_select_lookup_slow(ucp_worker_h worker,
                              const ucp_proto_select_param_t *select_param);
 
 
+/**
+ * Select the protocols for contiguous host memory tag send operations on an
+ * endpoint configuration, to populate the protocol selection cache.
+ */
+void ucp_proto_select_prefill(ucp_worker_h worker,
+                              ucp_worker_cfg_index_t ep_cfg_index);
+
+
 const ucp_proto_threshold_elem_t*
 ucp_proto_thresholds_search_slow(const ucp_proto_threshold_elem_t *thresholds,
                                  size_t msg_length);
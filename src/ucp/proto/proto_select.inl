@@ -104,10 +104,8 @@ ucp_proto_select_param_init(ucp_proto_select_param_t *select_param,
                             ucp_dt_class_t dt_class,
                             const ucs_memory_info_t *mem_info, uint8_t sg_count)
 {
-    if (dt_class == UCP_DATATYPE_CONTIG) {
+    if (dt_class != UCP_DATATYPE_IOV) {
         ucs_assert(sg_count == 1);
-    } else if (dt_class != UCP_DATATYPE_IOV) {
-        ucs_assert(sg_count == 0);
     }
 
     /* construct a protocol lookup key based on all operation parameters
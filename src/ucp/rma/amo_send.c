@@ -182,6 +182,12 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_atomic_op_nbx,
                             return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM));
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
 
+    status = ucp_ep_resolve_lazy_connect(ep);
+    if (ucs_unlikely(status != UCS_OK)) {
+        status_p = UCS_STATUS_PTR(status);
+        goto out;
+    }
+
     ucs_trace_req("atomic_op_nbx opcode %d buffer %p result %p "
                   "datatype 0x%"PRIx64" remote_addr 0x%"PRIx64
                   " rkey %p to %s cb %p", opcode, buffer,
@@ -233,6 +239,11 @@ ucs_status_t ucp_atomic_post(ucp_ep_h ep, ucp_atomic_post_op_t opcode, uint64_t
                         UCP_ATOMIC_POST_OP_LAST, return UCS_ERR_INVALID_PARAM);
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
 
+    status = ucp_ep_resolve_lazy_connect(ep);
+    if (ucs_unlikely(status != UCS_OK)) {
+        goto out;
+    }
+
     ucs_trace_req("atomic_post opcode %d value %"PRIu64" size %zu "
                   "remote_addr %"PRIx64" rkey %p to %s",
                   opcode, value, op_size, remote_addr, rkey,
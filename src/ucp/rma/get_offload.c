@@ -19,7 +19,17 @@ static void ucp_proto_get_offload_bcopy_unpack(void *arg, const void *data,
                                                size_t length)
 {
     void *dest = arg;
-    ucs_memcpy_relaxed(dest, data, length);
+    ucs_memcpy_relaxed(dest, data, length, UCS_ARCH_MEMCPY_NT_NONE, length);
+}
+
+/* The unpack argument is the fragment destination, so the total length of the
+ * transfer is checked when the fragment is posted */
+static void ucp_proto_get_offload_bcopy_unpack_nt(void *arg, const void *data,
+                                                  size_t length)
+{
+    void *dest = arg;
+    ucs_memcpy_relaxed(dest, data, length, UCS_ARCH_MEMCPY_NT_SOURCE,
+                       SIZE_MAX);
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
@@ -29,14 +39,19 @@ ucp_proto_get_offload_bcopy_send_func(ucp_request_t *req,
 {
     uct_rkey_t tl_rkey = ucp_rma_request_get_tl_rkey(req,
                                                      lpriv->super.rkey_index);
+    uct_unpack_callback_t unpack_cb;
     size_t max_length, length;
     void *dest;
 
     max_length = ucp_proto_multi_max_payload(req, lpriv, 0);
     length     = ucp_datatype_iter_next_ptr(&req->send.state.dt_iter,
                                             max_length, next_iter, &dest);
+    unpack_cb  = ucs_memcpy_relaxed_is_nt(UCS_ARCH_MEMCPY_NT_SOURCE,
+                                          req->send.state.dt_iter.length) ?
+                 ucp_proto_get_offload_bcopy_unpack_nt :
+                 ucp_proto_get_offload_bcopy_unpack;
     return uct_ep_get_bcopy(req->send.ep->uct_eps[lpriv->super.lane],
-                            ucp_proto_get_offload_bcopy_unpack, dest, length,
+                            unpack_cb, dest, length,
                             req->send.rma.remote_addr +
                             req->send.state.dt_iter.offset,
                             tl_rkey, &req->send.state.uct_comp);
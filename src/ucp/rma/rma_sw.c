@@ -155,7 +155,8 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_put_handler, (arg, data, length, am_flags),
     UCP_WORKER_GET_EP_BY_ID(&ep, worker, puth->ep_id, return UCS_OK,
                             "SW PUT request");
     ucp_dt_contig_unpack(worker, (void*)puth->address, puth + 1,
-                         length - sizeof(*puth), puth->mem_type);
+                         length - sizeof(*puth), puth->mem_type,
+                         length - sizeof(*puth));
     ucp_rma_sw_send_cmpl(ep);
     return UCS_OK;
 }
@@ -187,7 +188,7 @@ static size_t ucp_rma_sw_pack_get_reply(void *dest, void *arg)
                           sizeof(*hdr));
     hdr->req_id = req->send.get_reply.remote_req_id;
     ucp_dt_contig_pack(req->send.ep->worker, hdr + 1, req->send.buffer, length,
-                       req->send.mem_type);
+                       req->send.mem_type, req->send.length);
 
     return sizeof(*hdr) + length;
 }
@@ -272,7 +273,8 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_get_rep_handler, (arg, data, length, am_flags
         ptr = UCS_PTR_BYTE_OFFSET(req->send.state.dt_iter.type.contig.buffer,
                                   req->send.state.dt_iter.offset);
         ucp_dt_contig_unpack(ep->worker, ptr, getreph + 1, frag_length,
-                             req->send.state.dt_iter.mem_info.type);
+                             req->send.state.dt_iter.mem_info.type,
+                             req->send.state.dt_iter.length);
         req->send.state.dt_iter.offset += frag_length;
         if (req->send.state.dt_iter.offset == req->send.state.dt_iter.length) {
             ucp_request_id_release(req);
@@ -17,6 +17,7 @@
 #include <ucp/tag/tag_rndv.h>
 #include <ucp/tag/tag_match.inl>
 #include <ucp/tag/offload.h>
+#include <ucp/stream/stream.h>
 #include <ucp/proto/proto_am.inl>
 #include <ucs/datastruct/queue.h>
 
@@ -291,6 +292,27 @@ void ucp_rndv_req_send_ack(ucp_request_t *ack_req, ucp_request_t *req,
     ucp_request_send(ack_req, 0);
 }
 
+void ucp_rndv_send_ats(ucp_worker_h worker, const ucp_rndv_rts_hdr_t *rts_hdr,
+                       ucs_status_t status)
+{
+    ucp_request_t *req;
+    ucp_ep_h ep;
+
+    UCP_WORKER_GET_EP_BY_ID(&ep, worker, rts_hdr->sreq.ep_id, return,
+                            "RNDV ATS");
+    req = ucp_request_get(worker);
+    if (ucs_unlikely(req == NULL)) {
+        ucs_error("failed to allocate request for RNDV ATS");
+        return;
+    }
+
+    req->send.ep = ep;
+    req->flags   = 0;
+
+    ucp_rndv_req_send_ack(req, NULL, rts_hdr->sreq.req_id, status,
+                          UCP_AM_ID_RNDV_ATS, "send_ats");
+}
+
 static UCS_F_ALWAYS_INLINE void
 ucp_rndv_recv_req_complete(ucp_request_t *req, ucs_status_t status)
 {
@@ -1447,6 +1469,8 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_rts_handler,
 
     if (rts_hdr->flags & UCP_RNDV_RTS_FLAG_TAG) {
         return ucp_tag_rndv_process_rts(worker, rts_hdr, length, tl_flags);
+    } else if (rts_hdr->flags & UCP_RNDV_RTS_FLAG_STREAM) {
+        return ucp_stream_rndv_process_rts(worker, rts_hdr, length, tl_flags);
     } else {
         ucs_assert(rts_hdr->flags & UCP_RNDV_RTS_FLAG_AM);
         return ucp_am_rndv_process_rts(arg, data, length, tl_flags);
@@ -1511,7 +1535,8 @@ static size_t ucp_rndv_pack_data(void *dest, void *arg)
 
     return sizeof(*hdr) + ucp_dt_pack(sreq->send.ep->worker, sreq->send.datatype,
                                       sreq->send.mem_type, hdr + 1, sreq->send.buffer,
-                                      &sreq->send.state.dt, length);
+                                      &sreq->send.state.dt, length,
+                                      sreq->send.length);
 }
 
 UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_progress_am_bcopy, (self),
@@ -2021,11 +2046,15 @@ static void ucp_rndv_dump(ucp_worker_h worker, uct_am_trace_type_t type,
             rkey_buf = am_rts + 1;
             ucs_string_buffer_appendf(&rts_info, "AM am_id %u",
                                       am_rts->am.am_id);
+        } else if (rndv_rts_hdr->flags & UCP_RNDV_RTS_FLAG_STREAM) {
+            rkey_buf = (void*)(rndv_rts_hdr + 1);
+            ucs_string_buffer_appendf(&rts_info, "STREAM");
         } else {
             ucs_assert(rndv_rts_hdr->flags & UCP_RNDV_RTS_FLAG_TAG);
 
             tag_rts  = ucs_derived_of(rndv_rts_hdr, ucp_tag_rndv_rts_hdr_t);
-            rkey_buf = tag_rts + 1;
+            rkey_buf = UCS_PTR_BYTE_OFFSET(
+                    tag_rts, ucp_tag_rndv_rts_hdr_size(rndv_rts_hdr->flags));
 
             ucs_string_buffer_appendf(&rts_info, "TAG tag %"PRIx64"",
                                       tag_rts->tag.tag);
@@ -2071,15 +2100,20 @@ static void ucp_rndv_dump(ucp_worker_h worker, uct_am_trace_type_t type,
     }
 }
 
-UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM, UCP_AM_ID_RNDV_RTS,
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_STREAM,
+              UCP_AM_ID_RNDV_RTS,
               ucp_rndv_rts_handler, ucp_rndv_dump, 0);
-UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM, UCP_AM_ID_RNDV_ATS,
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_STREAM,
+              UCP_AM_ID_RNDV_ATS,
               ucp_rndv_ats_handler, ucp_rndv_dump, 0);
-UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM, UCP_AM_ID_RNDV_ATP,
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_STREAM,
+              UCP_AM_ID_RNDV_ATP,
               ucp_rndv_atp_handler, ucp_rndv_dump, 0);
-UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM, UCP_AM_ID_RNDV_RTR,
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_STREAM,
+              UCP_AM_ID_RNDV_RTR,
               ucp_rndv_rtr_handler, ucp_rndv_dump, 0);
-UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM, UCP_AM_ID_RNDV_DATA,
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_STREAM,
+              UCP_AM_ID_RNDV_DATA,
               ucp_rndv_data_handler, ucp_rndv_dump, 0);
 
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_RNDV_RTS);
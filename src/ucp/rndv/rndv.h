@@ -13,8 +13,10 @@
 
 
 enum ucp_rndv_rts_flags {
-    UCP_RNDV_RTS_FLAG_TAG = UCS_BIT(0),
-    UCP_RNDV_RTS_FLAG_AM  = UCS_BIT(1)
+    UCP_RNDV_RTS_FLAG_TAG    = UCS_BIT(0),
+    UCP_RNDV_RTS_FLAG_AM     = UCS_BIT(1),
+    UCP_RNDV_RTS_FLAG_CSUM   = UCS_BIT(2), /* RTS carries the payload checksum */
+    UCP_RNDV_RTS_FLAG_STREAM = UCS_BIT(3)
 };
 
 
@@ -59,6 +61,9 @@ void ucp_rndv_req_send_ack(ucp_request_t *ack_req, ucp_request_t *req,
                            ucs_ptr_map_key_t remote_req_id, ucs_status_t status,
                            ucp_am_id_t am_id, const char *ack_str);
 
+void ucp_rndv_send_ats(ucp_worker_h worker, const ucp_rndv_rts_hdr_t *rts_hdr,
+                       ucs_status_t status);
+
 ucs_status_t ucp_rndv_progress_rma_get_zcopy(uct_pending_req_t *self);
 
 ucs_status_t ucp_rndv_progress_rma_put_zcopy(uct_pending_req_t *self);
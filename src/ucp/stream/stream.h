@@ -10,6 +10,7 @@
 #include <ucp/core/ucp_ep.h>
 #include <ucp/core/ucp_ep.inl>
 #include <ucp/core/ucp_worker.h>
+#include <ucp/rndv/rndv.h>
 
 
 typedef struct {
@@ -25,12 +26,42 @@ typedef struct {
 } ucp_stream_am_data_t;
 
 
+/*
+ * Stream data received by rendezvous protocol. The data is staged in a
+ * malloc'd descriptor, which is delivered to the stream in the order the RTS
+ * arrived relative to eager stream data. If the data can be received directly
+ * to a posted receive request, the descriptor only keeps its place in the
+ * stream until the data arrives.
+ */
+typedef struct {
+    ucp_ep_h                 ep;        /* Receiving endpoint, NULL if the
+                                           endpoint was cleaned up before the
+                                           data arrived */
+    ucs_status_t             status;    /* UCS_INPROGRESS until the data is
+                                           received */
+    ucp_request_t            *recv_req; /* Receive request which the data is
+                                           received to directly, or NULL */
+    ucp_recv_desc_t          super;     /* Followed by ucp_stream_am_data_t
+                                           and the payload, if the data is
+                                           staged */
+} ucp_stream_rndv_desc_t;
+
+
+/* Largest stream send which can use rendezvous protocol, since the received
+ * data is described by a single receive descriptor */
+#define UCP_STREAM_RNDV_MAX_LENGTH (UINT32_MAX - UCS_KBYTE)
+
+
 void ucp_stream_ep_init(ucp_ep_h ep);
 
 void ucp_stream_ep_cleanup(ucp_ep_h ep);
 
 void ucp_stream_ep_activate(ucp_ep_h ep);
 
+ucs_status_t ucp_stream_rndv_process_rts(ucp_worker_h worker,
+                                         ucp_rndv_rts_hdr_t *rts_hdr,
+                                         size_t length, unsigned tl_flags);
+
 
 static UCS_F_ALWAYS_INLINE int ucp_stream_ep_is_queued(ucp_ep_ext_proto_t *ep_ext)
 {
@@ -60,6 +60,17 @@
     ((ucp_stream_am_data_t *)_data - 1)->rdesc
 
 
+static UCS_F_ALWAYS_INLINE void ucp_stream_rdesc_release(ucp_recv_desc_t *rdesc)
+{
+    if (ucs_unlikely(rdesc->flags & UCP_RECV_DESC_FLAG_MALLOC)) {
+        /* data received by rendezvous protocol */
+        ucs_free(ucs_container_of(rdesc, ucp_stream_rndv_desc_t, super));
+    } else {
+        ucp_recv_desc_release(rdesc);
+    }
+}
+
+
 static UCS_F_ALWAYS_INLINE ucp_recv_desc_t *
 ucp_stream_rdesc_dequeue(ucp_ep_ext_proto_t *ep_ext)
 {
@@ -134,7 +145,7 @@ ucp_stream_rdesc_dequeue_and_release(ucp_recv_desc_t *rdesc,
                                                       ucp_recv_desc_t,
                                                       stream_queue));
     ucp_stream_rdesc_dequeue(ep_ext);
-    ucp_recv_desc_release(rdesc);
+    ucp_stream_rdesc_release(rdesc);
 }
 
 UCS_PROFILE_FUNC_VOID(ucp_stream_data_release, (ep, data),
@@ -144,9 +155,48 @@ UCS_PROFILE_FUNC_VOID(ucp_stream_data_release, (ep, data),
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
 
-    ucp_recv_desc_release(rdesc);
+    ucp_stream_rdesc_release(rdesc);
+
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(ep->worker);
+}
+
+UCS_PROFILE_FUNC(ucs_status_t, ucp_stream_recv_data_iov,
+                 (ep, iov, iovcnt_p, length_p),
+                 ucp_ep_h ep, ucp_dt_iov_t *iov, size_t *iovcnt_p,
+                 size_t *length_p)
+{
+    ucp_ep_ext_proto_t *ep_ext = ucp_ep_ext_proto(ep);
+    size_t iovcnt              = 0;
+    size_t length              = 0;
+    ucp_recv_desc_t *rdesc;
+
+    UCP_CONTEXT_CHECK_FEATURE_FLAGS(ep->worker->context, UCP_FEATURE_STREAM,
+                                    return UCS_ERR_INVALID_PARAM);
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
+
+    /* match_q holds descriptors only if the ep has data, otherwise it holds
+     * posted receive requests */
+    if (ucp_stream_ep_has_data(ep_ext)) {
+        ucs_queue_for_each(rdesc, &ep_ext->stream.match_q, stream_queue) {
+            if (iovcnt == *iovcnt_p) {
+                break;
+            }
+
+            iov[iovcnt].buffer = ucp_stream_rdesc_payload(rdesc);
+            iov[iovcnt].length = rdesc->length;
+            length            += rdesc->length;
+            ++iovcnt;
+        }
+    }
 
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(ep->worker);
+
+    ucs_trace_data("ep %p: %zu stream bytes in %zu iov entries", ep, length,
+                   iovcnt);
+    *iovcnt_p = iovcnt;
+    *length_p = length;
+    return UCS_OK;
 }
 
 static UCS_F_ALWAYS_INLINE ssize_t
@@ -196,6 +246,37 @@ ucp_stream_rdesc_advance(ucp_recv_desc_t *rdesc, ssize_t offset,
     return UCS_OK;
 }
 
+UCS_PROFILE_FUNC(ucs_status_t, ucp_stream_data_consume, (ep, length),
+                 ucp_ep_h ep, size_t length)
+{
+    ucp_ep_ext_proto_t *ep_ext = ucp_ep_ext_proto(ep);
+    ucs_status_t status        = UCS_OK;
+    ucp_recv_desc_t *rdesc;
+    size_t consumed;
+
+    UCP_CONTEXT_CHECK_FEATURE_FLAGS(ep->worker->context, UCP_FEATURE_STREAM,
+                                    return UCS_ERR_INVALID_PARAM);
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
+
+    while (length > 0) {
+        if (ucs_unlikely(!ucp_stream_ep_has_data(ep_ext))) {
+            ucs_error("ep %p: consuming %zu bytes more than received stream "
+                      "data", ep, length);
+            status = UCS_ERR_INVALID_PARAM;
+            break;
+        }
+
+        rdesc    = ucp_stream_rdesc_get(ep_ext);
+        consumed = ucs_min(length, rdesc->length);
+        ucp_stream_rdesc_advance(rdesc, consumed, ep_ext);
+        length  -= consumed;
+    }
+
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(ep->worker);
+    return status;
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_t ucp_stream_process_rdesc_inplace(
         ucp_recv_desc_t *rdesc, ucp_datatype_t dt, void *buffer, size_t count,
         size_t length, const ucp_request_param_t *param,
@@ -400,74 +481,398 @@ out:
     return req;
 }
 
-static UCS_F_ALWAYS_INLINE ucs_status_t
-ucp_stream_am_data_process(ucp_worker_t *worker, ucp_ep_ext_proto_t *ep_ext,
-                           ucp_stream_am_data_t *am_data, size_t length,
-                           unsigned am_flags)
+/* Unpack received data to the posted receive requests, the payload starts at
+ * rdesc->payload_offset from 'base'. Returns nonzero if all data was consumed.
+ */
+static UCS_F_ALWAYS_INLINE int
+ucp_stream_rdesc_match_requests(ucp_ep_ext_proto_t *ep_ext,
+                                ucp_recv_desc_t *rdesc, void *base)
 {
-    ucp_recv_desc_t  rdesc_tmp;
-    void            *payload;
-    ucp_recv_desc_t *rdesc;
-    ucp_request_t   *req;
-    ssize_t          unpacked;
+    void          *payload;
+    ucp_request_t *req;
+    ssize_t        unpacked;
 
-    rdesc_tmp.length         = length;
-    rdesc_tmp.payload_offset = sizeof(*am_data); /* add sizeof(*rdesc) only if
-                                                    am_data wont be handled in
-                                                    place */
+    ucs_assert(!ucp_stream_ep_has_data(ep_ext));
 
-    /* First, process expected requests */
-    if (!ucp_stream_ep_has_data(ep_ext)) {
-        while (!ucs_queue_is_empty(&ep_ext->stream.match_q)) {
-            req      = ucs_queue_head_elem_non_empty(&ep_ext->stream.match_q,
-                                                     ucp_request_t, recv.queue);
-            payload  = UCS_PTR_BYTE_OFFSET(am_data, rdesc_tmp.payload_offset);
-            unpacked = ucp_stream_rdata_unpack(payload, rdesc_tmp.length, req);
-            if (ucs_unlikely(unpacked < 0)) {
-                ucs_fatal("failed to unpack from am_data %p with offset %u to request %p",
-                          am_data, rdesc_tmp.payload_offset, req);
-            } else if (unpacked == rdesc_tmp.length) {
-                if (ucp_request_can_complete_stream_recv(req)) {
-                    ucp_request_complete_stream_recv(req, ep_ext, UCS_OK);
-                }
-                return UCS_OK;
+    while (!ucs_queue_is_empty(&ep_ext->stream.match_q)) {
+        req      = ucs_queue_head_elem_non_empty(&ep_ext->stream.match_q,
+                                                 ucp_request_t, recv.queue);
+        payload  = UCS_PTR_BYTE_OFFSET(base, rdesc->payload_offset);
+        unpacked = ucp_stream_rdata_unpack(payload, rdesc->length, req);
+        if (ucs_unlikely(unpacked < 0)) {
+            ucs_fatal("failed to unpack from %p with offset %u to request %p",
+                      base, rdesc->payload_offset, req);
+        } else if (unpacked == rdesc->length) {
+            if (ucp_request_can_complete_stream_recv(req)) {
+                ucp_request_complete_stream_recv(req, ep_ext, UCS_OK);
             }
-            ucp_stream_rdesc_advance(&rdesc_tmp, unpacked, ep_ext);
-            /* This request is full, try next one */
-            ucs_assert(ucp_request_can_complete_stream_recv(req));
-            ucp_request_complete_stream_recv(req, ep_ext, UCS_OK);
+            return 1;
         }
+        ucp_stream_rdesc_advance(rdesc, unpacked, ep_ext);
+        /* This request is full, try next one */
+        ucs_assert(ucp_request_can_complete_stream_recv(req));
+        ucp_request_complete_stream_recv(req, ep_ext, UCS_OK);
     }
 
-    ucs_assert(rdesc_tmp.length > 0);
+    return 0;
+}
+
+static UCS_F_ALWAYS_INLINE ucp_recv_desc_t *
+ucp_stream_rdesc_init(ucp_worker_t *worker, ucp_stream_am_data_t *am_data,
+                      const ucp_recv_desc_t *rdesc_tmp, unsigned am_flags)
+{
+    ucp_recv_desc_t *rdesc;
 
-    /* Now, enqueue the rest of data */
     if (ucs_likely(!(am_flags & UCT_CB_PARAM_FLAG_DESC))) {
         rdesc = (ucp_recv_desc_t*)ucs_mpool_get_inline(&worker->am_mp);
         ucs_assertv_always(rdesc != NULL,
                            "ucp recv descriptor is not allocated");
-        rdesc->length         = rdesc_tmp.length;
+        rdesc->length         = rdesc_tmp->length;
         /* reset offset to improve locality */
         rdesc->payload_offset = sizeof(*rdesc) + sizeof(*am_data);
         rdesc->flags          = 0;
         memcpy(ucp_stream_rdesc_payload(rdesc),
-               UCS_PTR_BYTE_OFFSET(am_data, rdesc_tmp.payload_offset),
-               rdesc_tmp.length);
+               UCS_PTR_BYTE_OFFSET(am_data, rdesc_tmp->payload_offset),
+               rdesc_tmp->length);
     } else {
         /* slowpath */
         rdesc                  = (ucp_recv_desc_t *)am_data - 1;
-        rdesc->length          = rdesc_tmp.length;
-        rdesc->payload_offset  = rdesc_tmp.payload_offset + sizeof(*rdesc);
+        rdesc->length          = rdesc_tmp->length;
+        rdesc->payload_offset  = rdesc_tmp->payload_offset + sizeof(*rdesc);
         rdesc->uct_desc_offset = UCP_WORKER_HEADROOM_PRIV_SIZE;
         rdesc->flags           = UCP_RECV_DESC_FLAG_UCT_DESC;
     }
 
+    return rdesc;
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_stream_rdesc_enqueue(ucp_ep_ext_proto_t *ep_ext, ucp_recv_desc_t *rdesc)
+{
     ucp_ep_from_ext_proto(ep_ext)->flags |= UCP_EP_FLAG_STREAM_HAS_DATA;
     ucs_queue_push(&ep_ext->stream.match_q, &rdesc->stream_queue);
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_stream_ep_set_ready(ucp_ep_ext_proto_t *ep_ext, ucp_worker_h worker)
+{
+    if (ucp_stream_ep_has_data(ep_ext) && !ucp_stream_ep_is_queued(ep_ext) &&
+        (ucp_ep_from_ext_proto(ep_ext)->flags & UCP_EP_FLAG_USED)) {
+        ucp_stream_ep_enqueue(ep_ext, worker);
+    }
+}
+
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_stream_am_data_process(ucp_worker_t *worker, ucp_ep_ext_proto_t *ep_ext,
+                           ucp_stream_am_data_t *am_data, size_t length,
+                           unsigned am_flags)
+{
+    ucp_recv_desc_t  rdesc_tmp;
+    ucp_recv_desc_t *rdesc;
+
+    rdesc_tmp.length         = length;
+    rdesc_tmp.payload_offset = sizeof(*am_data); /* add sizeof(*rdesc) only if
+                                                    am_data wont be handled in
+                                                    place */
+
+    if (ucs_unlikely(!ucs_queue_is_empty(&ep_ext->stream.reorder_q))) {
+        /* Rendezvous data which precedes this data is not received yet */
+        rdesc = ucp_stream_rdesc_init(worker, am_data, &rdesc_tmp, am_flags);
+        ucs_queue_push(&ep_ext->stream.reorder_q, &rdesc->stream_queue);
+        return UCS_INPROGRESS;
+    }
+
+    /* First, process expected requests */
+    if (!ucp_stream_ep_has_data(ep_ext) &&
+        ucp_stream_rdesc_match_requests(ep_ext, &rdesc_tmp, am_data)) {
+        return UCS_OK;
+    }
+
+    ucs_assert(rdesc_tmp.length > 0);
+
+    /* Now, enqueue the rest of data */
+    rdesc = ucp_stream_rdesc_init(worker, am_data, &rdesc_tmp, am_flags);
+    ucp_stream_rdesc_enqueue(ep_ext, rdesc);
 
     return UCS_INPROGRESS;
 }
 
+/* Deliver the data, which completed reordering, to the stream */
+static void ucp_stream_reorder_progress(ucp_ep_h ep)
+{
+    ucp_ep_ext_proto_t *ep_ext = ucp_ep_ext_proto(ep);
+    ucp_stream_rndv_desc_t *rndv_desc;
+    ucp_recv_desc_t *rdesc;
+
+    while (!ucs_queue_is_empty(&ep_ext->stream.reorder_q)) {
+        rdesc = ucs_queue_head_elem_non_empty(&ep_ext->stream.reorder_q,
+                                              ucp_recv_desc_t, stream_queue);
+        if (rdesc->flags & UCP_RECV_DESC_FLAG_MALLOC) {
+            rndv_desc = ucs_container_of(rdesc, ucp_stream_rndv_desc_t, super);
+            if (rndv_desc->status == UCS_INPROGRESS) {
+                break;
+            }
+        }
+
+        ucs_queue_pull_non_empty(&ep_ext->stream.reorder_q);
+
+        if ((rdesc->length == 0) ||
+            (!ucp_stream_ep_has_data(ep_ext) &&
+             ucp_stream_rdesc_match_requests(ep_ext, rdesc, rdesc))) {
+            ucp_stream_rdesc_release(rdesc);
+        } else {
+            ucp_stream_rdesc_enqueue(ep_ext, rdesc);
+        }
+    }
+
+    ucp_stream_ep_set_ready(ep_ext, ep->worker);
+}
+
+/* Drop the data which waits for reordering, descriptors of rendezvous
+ * receives in progress are released when the receive completes */
+static void ucp_stream_reorder_purge(ucp_ep_ext_proto_t *ep_ext)
+{
+    ucp_stream_rndv_desc_t *rndv_desc;
+    ucp_recv_desc_t *rdesc;
+
+    while (!ucs_queue_is_empty(&ep_ext->stream.reorder_q)) {
+        rdesc = ucs_queue_pull_elem_non_empty(&ep_ext->stream.reorder_q,
+                                              ucp_recv_desc_t, stream_queue);
+        if (rdesc->flags & UCP_RECV_DESC_FLAG_MALLOC) {
+            rndv_desc = ucs_container_of(rdesc, ucp_stream_rndv_desc_t, super);
+            if (rndv_desc->status == UCS_INPROGRESS) {
+                rndv_desc->ep = NULL;
+                continue;
+            }
+        }
+
+        ucp_stream_rdesc_release(rdesc);
+    }
+}
+
+/* The data which follows a failed rendezvous receive can't be delivered in
+ * order, so fail the pending receives and the endpoint */
+static void ucp_stream_rndv_recv_failed(ucp_stream_rndv_desc_t *rndv_desc,
+                                        ucs_status_t status)
+{
+    ucp_ep_h ep                = rndv_desc->ep;
+    ucp_ep_ext_proto_t *ep_ext = ucp_ep_ext_proto(ep);
+    ucp_request_t *req;
+
+    ucs_diag("ep %p: failed to receive %u stream bytes: %s", ep,
+             rndv_desc->super.length, ucs_status_string(status));
+
+    rndv_desc->status = status;
+    ucp_stream_reorder_purge(ep_ext);
+
+    while (!ucs_queue_is_empty(&ep_ext->stream.match_q)) {
+        req = ucs_queue_head_elem_non_empty(&ep_ext->stream.match_q,
+                                            ucp_request_t, recv.queue);
+        ucp_request_complete_stream_recv(req, ep_ext, status);
+    }
+
+    UCS_ASYNC_BLOCK(&ep->worker->async);
+    ucp_worker_set_ep_failed(ep->worker, ep, NULL, UCP_NULL_LANE, status);
+    UCS_ASYNC_UNBLOCK(&ep->worker->async);
+}
+
+static void ucp_stream_rndv_recv_completed(void *request, ucs_status_t status,
+                                           size_t length, void *user_data)
+{
+    ucp_stream_rndv_desc_t *rndv_desc = user_data;
+    ucp_request_t *recv_req           = rndv_desc->recv_req;
+    ucp_ep_ext_proto_t *ep_ext;
+
+    if (rndv_desc->ep == NULL) {
+        /* The endpoint was cleaned up during the receive, drop the data */
+        if (recv_req != NULL) {
+            recv_req->recv.stream.length = recv_req->recv.stream.offset;
+            ucp_request_complete(recv_req, recv.stream.cb, UCS_ERR_CANCELED,
+                                 recv_req->recv.stream.length,
+                                 recv_req->user_data);
+        }
+        ucs_free(rndv_desc);
+        return;
+    }
+
+    ep_ext = ucp_ep_ext_proto(rndv_desc->ep);
+    if (recv_req != NULL) {
+        /* Return the request to the head of the posted receives, no other
+         * data was delivered to the stream during the receive */
+        ucs_assert(!ucp_stream_ep_has_data(ep_ext));
+        ucs_queue_push_head(&ep_ext->stream.match_q, &recv_req->recv.queue);
+    }
+
+    if (ucs_unlikely(status != UCS_OK)) {
+        ucp_stream_rndv_recv_failed(rndv_desc, status);
+        return;
+    }
+
+    ucs_trace_data("ep %p: received %u stream bytes by rendezvous",
+                   rndv_desc->ep, rndv_desc->super.length);
+    rndv_desc->status = status;
+
+    if (recv_req != NULL) {
+        recv_req->recv.stream.offset += length;
+        rndv_desc->super.length       = 0;
+        if (ucp_request_can_complete_stream_recv(recv_req)) {
+            ucp_request_complete_stream_recv(recv_req, ep_ext, UCS_OK);
+        }
+    }
+
+    ucp_stream_reorder_progress(rndv_desc->ep);
+}
+
+/* Returns the posted receive request which rendezvous data of 'length' bytes
+ * can be received to directly, or NULL if the data should be staged. This is
+ * possible if the data is the next one to be delivered to the stream, and it
+ * fits into the first posted request.
+ */
+static UCS_F_ALWAYS_INLINE ucp_request_t *
+ucp_stream_rndv_direct_req(ucp_ep_ext_proto_t *ep_ext, size_t length)
+{
+    ucp_request_t *req;
+
+    if (!ucs_queue_is_empty(&ep_ext->stream.reorder_q) ||
+        ucp_stream_ep_has_data(ep_ext) ||
+        ucs_queue_is_empty(&ep_ext->stream.match_q)) {
+        return NULL;
+    }
+
+    req = ucs_queue_head_elem_non_empty(&ep_ext->stream.match_q,
+                                        ucp_request_t, recv.queue);
+    if (!UCP_DT_IS_CONTIG(req->recv.datatype) ||
+        (length > (req->recv.length - req->recv.stream.offset))) {
+        return NULL;
+    }
+
+    return req;
+}
+
+ucs_status_t ucp_stream_rndv_process_rts(ucp_worker_h worker,
+                                         ucp_rndv_rts_hdr_t *rts_hdr,
+                                         size_t length, unsigned tl_flags)
+{
+    ucp_stream_rndv_desc_t *rndv_desc;
+    ucp_ep_ext_proto_t *ep_ext;
+    ucp_request_t *recv_req;
+    ucp_recv_desc_t *desc;
+    ucp_request_t *req;
+    ucs_status_t status;
+    ucp_ep_h ep;
+
+    UCP_WORKER_GET_VALID_EP_BY_ID(&ep, worker, rts_hdr->sreq.ep_id,
+                                  { status = UCS_ERR_CANCELED;
+                                    goto err_send_ats; },
+                                  "stream RTS");
+
+    if (ucs_unlikely(ep->flags & (UCP_EP_FLAG_CLOSED | UCP_EP_FLAG_FAILED))) {
+        ucs_trace_data("ep %p: stream is invalid", ep);
+        status = UCS_ERR_CANCELED;
+        goto err_send_ats;
+    }
+
+    if (ucs_unlikely(rts_hdr->size > UCP_STREAM_RNDV_MAX_LENGTH)) {
+        ucs_error("ep %p: stream rendezvous length %zu exceeds %zu", ep,
+                  rts_hdr->size, (size_t)UCP_STREAM_RNDV_MAX_LENGTH);
+        status = UCS_ERR_MESSAGE_TRUNCATED;
+        goto err_send_ats;
+    }
+
+    /* The data is received directly to the first posted receive request if
+     * it's the next data in the stream and fits into the request. Otherwise,
+     * it's received to a staging descriptor, since stream receive requests
+     * are matched by byte offset only after all preceding data is delivered:
+     * a request may be completed by earlier data, or be filled partially by
+     * this one (ucp_stream_recv_nb() without WAITALL), and such requests
+     * can't be known until the reordering is done. Staged data is then
+     * unpacked to the posted requests, or returned by
+     * ucp_stream_recv_data_nb()/ucp_stream_recv_data_iov() without a copy. */
+    ep_ext    = ucp_ep_ext_proto(ep);
+    recv_req  = ucp_stream_rndv_direct_req(ep_ext, rts_hdr->size);
+    rndv_desc = ucs_malloc(sizeof(*rndv_desc) +
+                           ((recv_req == NULL) ?
+                            (sizeof(ucp_stream_am_data_t) + rts_hdr->size) : 0),
+                           "ucp stream rndv desc");
+    if (rndv_desc == NULL) {
+        ucs_error("ep %p: failed to allocate stream rendezvous descriptor of "
+                  "%zu bytes", ep, rts_hdr->size);
+        status = UCS_ERR_NO_MEMORY;
+        goto err_send_ats;
+    }
+
+    /* RTS descriptor is kept until the receive completes */
+    status = ucp_recv_desc_init(worker, rts_hdr, length, 0, tl_flags, 0,
+                                UCP_RECV_DESC_FLAG_RNDV |
+                                UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS, 0, &desc);
+    if (ucs_unlikely(UCS_STATUS_IS_ERR(status))) {
+        goto err_free_rndv_desc;
+    }
+
+    req = ucp_request_get(worker);
+    if (ucs_unlikely(req == NULL)) {
+        ucs_error("failed to allocate stream rendezvous receive request");
+        if (!(desc->flags & UCP_RECV_DESC_FLAG_UCT_DESC)) {
+            ucp_recv_desc_release(desc);
+        }
+        status = UCS_ERR_NO_MEMORY;
+        goto err_free_rndv_desc;
+    }
+
+    rndv_desc->ep                   = ep;
+    rndv_desc->status               = UCS_INPROGRESS;
+    rndv_desc->recv_req             = recv_req;
+    rndv_desc->super.length         = rts_hdr->size;
+    rndv_desc->super.payload_offset = sizeof(rndv_desc->super) +
+                                      sizeof(ucp_stream_am_data_t);
+    rndv_desc->super.flags          = UCP_RECV_DESC_FLAG_MALLOC;
+    ucs_queue_push(&ep_ext->stream.reorder_q, &rndv_desc->super.stream_queue);
+
+    /* Use AM receive request completion, which releases the RTS descriptor */
+    req->flags         = UCP_REQUEST_FLAG_RECV_AM | UCP_REQUEST_FLAG_RELEASED;
+    req->status        = UCS_OK;
+    req->recv.worker   = worker;
+    req->recv.datatype = ucp_dt_make_contig(1);
+    req->recv.length   = rts_hdr->size;
+    req->recv.am.desc  = desc;
+    if (recv_req != NULL) {
+        /* The receive request is held by the descriptor until the data
+         * arrives, and the data which follows waits in the reorder queue */
+        ucs_queue_pull_non_empty(&ep_ext->stream.match_q);
+        req->recv.buffer   = UCS_PTR_BYTE_OFFSET(recv_req->recv.buffer,
+                                                 recv_req->recv.stream.offset);
+        req->recv.mem_type = recv_req->recv.mem_type;
+    } else {
+        req->recv.buffer   = ucp_stream_rdesc_payload(&rndv_desc->super);
+        req->recv.mem_type = UCS_MEMORY_TYPE_HOST;
+    }
+    ucp_dt_recv_state_init(&req->recv.state, req->recv.buffer,
+                           req->recv.datatype, rts_hdr->size);
+    ucp_request_set_callback(req, recv.am.cb, ucp_stream_rndv_recv_completed,
+                             rndv_desc);
+
+    ucp_rndv_receive(worker, req, rts_hdr, rts_hdr + 1);
+
+    if (desc->flags & UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS) {
+        /* Receive is in progress, RTS descriptor is released on completion */
+        desc->flags &= ~UCP_RECV_DESC_FLAG_AM_CB_INPROGRESS;
+        return status;
+    }
+
+    /* Receive is already completed */
+    if (!(desc->flags & UCP_RECV_DESC_FLAG_UCT_DESC)) {
+        ucp_recv_desc_release(desc);
+    }
+
+    return UCS_OK;
+
+err_free_rndv_desc:
+    ucs_free(rndv_desc);
+err_send_ats:
+    ucp_rndv_send_ats(worker, rts_hdr, status);
+    return UCS_OK;
+}
+
 void ucp_stream_ep_init(ucp_ep_h ep)
 {
     ucp_ep_ext_proto_t *ep_ext = ucp_ep_ext_proto(ep);
@@ -476,6 +881,7 @@ void ucp_stream_ep_init(ucp_ep_h ep)
         ep_ext->stream.ready_list.prev = NULL;
         ep_ext->stream.ready_list.next = NULL;
         ucs_queue_head_init(&ep_ext->stream.match_q);
+        ucs_queue_head_init(&ep_ext->stream.reorder_q);
     }
 }
 
@@ -490,14 +896,15 @@ void ucp_stream_ep_cleanup(ucp_ep_h ep)
         return;
     }
 
+    ep_ext = ucp_ep_ext_proto(ep);
+    ucp_stream_reorder_purge(ep_ext);
+
     /* drop unmatched data */
     while ((data = ucp_stream_recv_data_nb_nolock(ep, &length)) != NULL) {
         ucs_assert_always(!UCS_PTR_IS_ERR(data));
         ucp_stream_data_release(ep, data);
     }
 
-    ep_ext = ucp_ep_ext_proto(ep);
-
     if (ucp_stream_ep_is_queued(ep_ext)) {
         ucp_stream_ep_dequeue(ep_ext);
     }
@@ -553,10 +960,7 @@ ucp_stream_am_handler(void *am_arg, void *am_data, size_t am_length,
     }
 
     ucs_assert(status == UCS_INPROGRESS);
-
-    if (!ucp_stream_ep_is_queued(ep_ext) && (ep->flags & UCP_EP_FLAG_USED)) {
-        ucp_stream_ep_enqueue(ep_ext, worker);
-    }
+    ucp_stream_ep_set_ready(ep_ext, worker);
 
     return (am_flags & UCT_CB_PARAM_FLAG_DESC) ? UCS_INPROGRESS : UCS_OK;
 }
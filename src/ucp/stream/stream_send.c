@@ -13,6 +13,7 @@
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_context.h>
 #include <ucp/proto/proto_am.inl>
+#include <ucp/rndv/rndv.h>
 #include <ucp/stream/stream.h>
 #include <ucp/dt/dt.h>
 #include <ucp/dt/dt.inl>
@@ -38,7 +39,7 @@ static void ucp_stream_send_req_init(ucp_request_t *req, ucp_ep_h ep,
                                      size_t count, uint32_t flags,
                                      const ucp_request_param_t *param)
 {
-    req->flags             = flags;
+    req->flags             = flags | UCP_REQUEST_FLAG_SEND_STREAM;
     req->send.ep           = ep;
     req->send.buffer       = (void*)buffer;
     req->send.datatype     = datatype;
@@ -54,22 +55,80 @@ static void ucp_stream_send_req_init(ucp_request_t *req, ucp_ep_h ep,
                                 sizeof(req->send.msg_proto.tag));
 }
 
+static size_t ucp_stream_rndv_rts_pack(void *dest, void *arg)
+{
+    return ucp_rndv_rts_pack(arg, dest, sizeof(ucp_rndv_rts_hdr_t),
+                             UCP_RNDV_RTS_FLAG_STREAM);
+}
+
+UCS_PROFILE_FUNC(ucs_status_t, ucp_stream_proto_progress_rndv_rts, (self),
+                 uct_pending_req_t *self)
+{
+    ucp_request_t *sreq = ucs_container_of(self, ucp_request_t, send.uct);
+
+    /* RTS is sent on the AM lane, so it is ordered with eager stream data */
+    return ucp_rndv_send_rts(sreq, ucp_stream_rndv_rts_pack,
+                             sizeof(ucp_rndv_rts_hdr_t));
+}
+
+static ucs_status_t ucp_stream_send_start_rndv(ucp_request_t *sreq)
+{
+    ucp_trace_req(sreq, "stream start_rndv to %s buffer %p length %zu",
+                  ucp_ep_peer_name(sreq->send.ep), sreq->send.buffer,
+                  sreq->send.length);
+    UCS_PROFILE_REQUEST_EVENT(sreq, "start_rndv", sreq->send.length);
+
+    ucp_request_id_alloc(sreq);
+
+    sreq->send.uct.func = ucp_stream_proto_progress_rndv_rts;
+    return ucp_rndv_reg_send_buffer(sreq);
+}
+
+static UCS_F_ALWAYS_INLINE size_t
+ucp_stream_rndv_thresh(ucp_request_t *req, const ucp_request_param_t *param)
+{
+    ucp_ep_config_t *ep_config = ucp_ep_config(req->send.ep);
+    size_t rndv_rma_thresh, rndv_am_thresh;
+
+    /* Stream rendezvous is implemented only by the protocols v1, so stream
+     * messages are sent by eager protocols when the protocols v2 are enabled */
+    if (ucs_unlikely((req->send.length > UCP_STREAM_RNDV_MAX_LENGTH) ||
+                     req->send.ep->worker->context->config.ext.proto_enable)) {
+        return SIZE_MAX;
+    }
+
+    ucp_request_param_rndv_thresh(req, param, &ep_config->rndv.rma_thresh,
+                                  &ep_config->rndv.am_thresh, &rndv_rma_thresh,
+                                  &rndv_am_thresh);
+    return ucs_min(rndv_rma_thresh, rndv_am_thresh);
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_ptr_t
 ucp_stream_send_req(ucp_request_t *req, size_t count,
                     const ucp_ep_msg_config_t* msg_config,
                     const ucp_request_param_t *param,
                     const ucp_request_send_proto_t *proto)
 {
+    size_t rndv_thresh  = ucp_stream_rndv_thresh(req, param);
     size_t zcopy_thresh = ucp_proto_get_zcopy_threshold(req, msg_config,
-                                                        count, SIZE_MAX);
+                                                        count, rndv_thresh);
     ssize_t max_short   = ucp_proto_get_short_max(req, msg_config);
 
     ucs_status_t status = ucp_request_send_start(req, max_short, zcopy_thresh,
-                                                 SIZE_MAX, count, 0,
+                                                 rndv_thresh, count, 0,
                                                  req->send.length, msg_config,
                                                  proto);
     if (status != UCS_OK) {
-        return UCS_STATUS_PTR(status);
+        if (ucs_unlikely(status != UCS_ERR_NO_PROGRESS)) {
+            return UCS_STATUS_PTR(status);
+        }
+
+        ucs_assert(req->send.length >= rndv_thresh);
+
+        status = ucp_stream_send_start_rndv(req);
+        if (status != UCS_OK) {
+            return UCS_STATUS_PTR(status);
+        }
     }
 
     /*
@@ -134,6 +193,12 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_send_nbx,
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
 
+    status = ucp_ep_resolve_lazy_connect(ep);
+    if (ucs_unlikely(status != UCS_OK)) {
+        ret = UCS_STATUS_PTR(status);
+        goto out;
+    }
+
     flags = ucp_request_param_flags(param);
 
     ucs_trace_req("stream_send_nbx buffer %p count %zu to %s cb %p flags %u",
@@ -215,7 +280,8 @@ static size_t ucp_stream_pack_am_single_dt(void *dest, void *arg)
 
     length = ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                          req->send.mem_type, hdr + 1, req->send.buffer,
-                         &req->send.state.dt, req->send.length);
+                         &req->send.state.dt, req->send.length,
+                         req->send.length);
     ucs_assert(length == req->send.length);
     return sizeof(*hdr) + length;
 }
@@ -241,7 +307,8 @@ static size_t ucp_stream_pack_am_first_dt(void *dest, void *arg)
     ucs_assert(req->send.state.dt.offset == 0);
     return sizeof(*hdr) + ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                                       req->send.mem_type, hdr + 1, req->send.buffer,
-                                      &req->send.state.dt, length);
+                                      &req->send.state.dt, length,
+                                      req->send.length);
 }
 
 static size_t ucp_stream_pack_am_middle_dt(void *dest, void *arg)
@@ -255,7 +322,8 @@ static size_t ucp_stream_pack_am_middle_dt(void *dest, void *arg)
                          req->send.length - req->send.state.dt.offset);
     return sizeof(*hdr) + ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                                       req->send.mem_type, hdr + 1, req->send.buffer,
-                                      &req->send.state.dt, length);
+                                      &req->send.state.dt, length,
+                                      req->send.length);
 }
 
 static ucs_status_t ucp_stream_bcopy_multi(uct_pending_req_t *self)
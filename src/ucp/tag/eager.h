@@ -61,6 +61,12 @@ typedef struct {
 } UCS_S_PACKED ucp_eager_sync_first_hdr_t;
 
 
+/*
+ * CRC32C of the payload, which follows the header of EAGER_CSUM_* messages
+ */
+typedef uint32_t ucp_eager_csum_t;
+
+
 extern const ucp_request_send_proto_t ucp_tag_eager_proto;
 extern const ucp_request_send_proto_t ucp_tag_eager_sync_proto;
 
@@ -72,6 +78,9 @@ void ucp_tag_eager_sync_completion(ucp_request_t *req, uint32_t flag,
 void ucp_proto_eager_sync_ack_handler(ucp_worker_h worker,
                                       const ucp_reply_hdr_t *rep_hdr);
 
+ucs_status_t ucp_eager_only_csum_check(const void *hdr, size_t hdr_len,
+                                       size_t recv_len);
+
 void ucp_tag_eager_zcopy_completion(uct_completion_t *self);
 
 void ucp_tag_eager_zcopy_req_complete(ucp_request_t *req, ucs_status_t status);
@@ -80,6 +89,24 @@ void ucp_tag_eager_sync_zcopy_req_complete(ucp_request_t *req, ucs_status_t stat
 
 void ucp_tag_eager_sync_zcopy_completion(uct_completion_t *self);
 
+static UCS_F_ALWAYS_INLINE ucp_eager_csum_t
+ucp_eager_hdr_csum(const void *hdr, size_t hdr_len)
+{
+    return *(const ucp_eager_csum_t*)UCS_PTR_BYTE_OFFSET(
+            hdr, hdr_len - sizeof(ucp_eager_csum_t));
+}
+
+/* Save the payload checksum of a message to verify it on completion */
+static UCS_F_ALWAYS_INLINE void
+ucp_eager_first_csum_init(ucp_request_t *req, const void *hdr, size_t hdr_len,
+                          uint16_t recv_flags)
+{
+    if (ucs_unlikely(recv_flags & UCP_RECV_DESC_FLAG_EAGER_CSUM)) {
+        req->flags        |= UCP_REQUEST_FLAG_CSUM;
+        req->recv.tag.csum = ucp_eager_hdr_csum(hdr, hdr_len);
+    }
+}
+
 static UCS_F_ALWAYS_INLINE int
 ucp_proto_eager_check_op_id(const ucp_proto_init_params_t *init_params,
                             int offload_enabled)
@@ -16,6 +16,7 @@
 #include <ucp/core/ucp_worker.h>
 #include <ucs/datastruct/queue.h>
 #include <ucp/core/ucp_request.inl>
+#include <ucs/algorithm/crc.h>
 
 static UCS_F_ALWAYS_INLINE void
 ucp_eager_expected_handler(ucp_worker_t *worker, ucp_request_t *req,
@@ -101,11 +102,16 @@ ucp_eager_tagged_handler(void *arg, void *data, size_t length, unsigned am_flags
             status = ucp_request_recv_data_unpack(req,
                                                   UCS_PTR_BYTE_OFFSET(data, hdr_len),
                                                   recv_len, 0, 1);
+            if (ucs_unlikely(flags & UCP_RECV_DESC_FLAG_EAGER_CSUM) &&
+                (status == UCS_OK)) {
+                status = ucp_eager_only_csum_check(data, hdr_len, recv_len);
+            }
             ucp_request_complete_tag_recv(req, status);
         } else {
             eagerf_hdr                = data;
             req->recv.tag.info.length =
             req->recv.remaining       = eagerf_hdr->total_len;
+            ucp_eager_first_csum_init(req, data, hdr_len, flags);
 
             status = ucp_tag_request_process_recv_data(req,
                                                        UCS_PTR_BYTE_OFFSET(data, hdr_len),
@@ -225,6 +231,29 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_middle_handler,
                                            0);
 }
 
+UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_csum_only_handler,
+                 (arg, data, length, am_flags),
+                 void *arg, void *data, size_t length, unsigned am_flags)
+{
+    return ucp_eager_tagged_handler(arg, data, length, am_flags,
+                                    UCP_RECV_DESC_FLAG_EAGER |
+                                    UCP_RECV_DESC_FLAG_EAGER_ONLY |
+                                    UCP_RECV_DESC_FLAG_EAGER_CSUM,
+                                    sizeof(ucp_eager_hdr_t) +
+                                    sizeof(ucp_eager_csum_t), 0);
+}
+
+UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_csum_first_handler,
+                 (arg, data, length, am_flags),
+                 void *arg, void *data, size_t length, unsigned am_flags)
+{
+    return ucp_eager_tagged_handler(arg, data, length, am_flags,
+                                    UCP_RECV_DESC_FLAG_EAGER |
+                                    UCP_RECV_DESC_FLAG_EAGER_CSUM,
+                                    sizeof(ucp_eager_first_hdr_t) +
+                                    sizeof(ucp_eager_csum_t), 0);
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_sync_only_handler,
                  (arg, data, length, am_flags),
                  void *arg, void *data, size_t length, unsigned am_flags)
@@ -246,6 +275,42 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_sync_first_handler,
                                     sizeof(ucp_eager_sync_first_hdr_t), 0);
 }
 
+UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_csum_sync_only_handler,
+                 (arg, data, length, am_flags),
+                 void *arg, void *data, size_t length, unsigned am_flags)
+{
+    return ucp_eager_tagged_handler(arg, data, length, am_flags,
+                                    UCP_RECV_DESC_FLAG_EAGER|
+                                    UCP_RECV_DESC_FLAG_EAGER_ONLY|
+                                    UCP_RECV_DESC_FLAG_EAGER_SYNC|
+                                    UCP_RECV_DESC_FLAG_EAGER_CSUM,
+                                    sizeof(ucp_eager_sync_hdr_t) +
+                                    sizeof(ucp_eager_csum_t), 0);
+}
+
+UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_csum_sync_first_handler,
+                 (arg, data, length, am_flags),
+                 void *arg, void *data, size_t length, unsigned am_flags)
+{
+    return ucp_eager_tagged_handler(arg, data, length, am_flags,
+                                    UCP_RECV_DESC_FLAG_EAGER|
+                                    UCP_RECV_DESC_FLAG_EAGER_SYNC|
+                                    UCP_RECV_DESC_FLAG_EAGER_CSUM,
+                                    sizeof(ucp_eager_sync_first_hdr_t) +
+                                    sizeof(ucp_eager_csum_t), 0);
+}
+
+ucs_status_t ucp_eager_only_csum_check(const void *hdr, size_t hdr_len,
+                                       size_t recv_len)
+{
+    ucp_eager_csum_t csum = ucs_crc32c(0, UCS_PTR_BYTE_OFFSET(hdr, hdr_len),
+                                       recv_len);
+
+    return ucp_request_csum_verify(((const ucp_eager_hdr_t*)hdr)->super.tag,
+                                   recv_len, csum,
+                                   ucp_eager_hdr_csum(hdr, hdr_len));
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucp_eager_offload_sync_ack_handler,
                  (arg, data, length, am_flags),
                  void *arg, void *data, size_t length, unsigned am_flags)
@@ -485,6 +550,38 @@ static void ucp_eager_dump(ucp_worker_h worker, uct_am_trace_type_t type,
                  eagers_first_hdr->req.req_id);
         header_len = sizeof(*eagers_first_hdr);
         break;
+    case UCP_AM_ID_EAGER_CSUM_ONLY:
+        header_len = sizeof(*eager_hdr) + sizeof(ucp_eager_csum_t);
+        snprintf(buffer, max, "EGR_O tag %"PRIx64" csum 0x%08x",
+                 eager_hdr->super.tag, ucp_eager_hdr_csum(data, header_len));
+        break;
+    case UCP_AM_ID_EAGER_CSUM_FIRST:
+        header_len = sizeof(*eager_first_hdr) + sizeof(ucp_eager_csum_t);
+        snprintf(buffer, max, "EGR_F tag %"PRIx64" msgid %"PRIx64" len %zu "
+                 "csum 0x%08x", eager_first_hdr->super.super.tag,
+                 eager_first_hdr->msg_id, eager_first_hdr->total_len,
+                 ucp_eager_hdr_csum(data, header_len));
+        break;
+    case UCP_AM_ID_EAGER_CSUM_SYNC_ONLY:
+        header_len = sizeof(*eagers_hdr) + sizeof(ucp_eager_csum_t);
+        snprintf(buffer, max,
+                 "EGRS tag %" PRIx64 " ep_id 0x%" PRIx64 " req_id 0x%" PRIx64
+                 " len %zu csum 0x%08x",
+                 eagers_hdr->super.super.tag, eagers_hdr->req.ep_id,
+                 eagers_hdr->req.req_id, length - header_len,
+                 ucp_eager_hdr_csum(data, header_len));
+        break;
+    case UCP_AM_ID_EAGER_CSUM_SYNC_FIRST:
+        header_len = sizeof(*eagers_first_hdr) + sizeof(ucp_eager_csum_t);
+        snprintf(buffer, max, "EGRS_F tag %"PRIx64" msgid %"PRIx64" len %zu "
+                 "ep_id 0x%"PRIx64" req_id 0x%"PRIx64" csum 0x%08x",
+                 eagers_first_hdr->super.super.super.tag,
+                 eagers_first_hdr->super.msg_id,
+                 eagers_first_hdr->super.total_len,
+                 eagers_first_hdr->req.ep_id,
+                 eagers_first_hdr->req.req_id,
+                 ucp_eager_hdr_csum(data, header_len));
+        break;
     case UCP_AM_ID_EAGER_SYNC_ACK:
         snprintf(buffer, max, "EGRS_A req_id %"PRIx64" status '%s'",
                  rep_hdr->req_id, ucs_status_string(rep_hdr->status));
@@ -516,6 +613,14 @@ UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_SYNC_FIRST,
               ucp_eager_sync_first_handler, ucp_eager_dump, 0);
 UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_SYNC_ACK,
               ucp_eager_sync_ack_handler, ucp_eager_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_CSUM_ONLY,
+              ucp_eager_csum_only_handler, ucp_eager_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_CSUM_FIRST,
+              ucp_eager_csum_first_handler, ucp_eager_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_CSUM_SYNC_ONLY,
+              ucp_eager_csum_sync_only_handler, ucp_eager_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_EAGER_CSUM_SYNC_FIRST,
+              ucp_eager_csum_sync_first_handler, ucp_eager_dump, 0);
 UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_OFFLOAD_SYNC_ACK,
               ucp_eager_offload_sync_ack_handler, ucp_eager_dump, 0);
 
@@ -525,4 +630,8 @@ UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_MIDDLE);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_SYNC_ONLY);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_SYNC_FIRST);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_SYNC_ACK);
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_CSUM_ONLY);
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_CSUM_FIRST);
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_CSUM_SYNC_ONLY);
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_EAGER_CSUM_SYNC_FIRST);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_OFFLOAD_SYNC_ACK);
@@ -15,8 +15,59 @@
 #include <ucp/proto/proto_am.inl>
 
 
+/* Active message id of the first fragment, with or without payload checksum */
+#define UCP_TAG_EAGER_AM_ID(_req, _name) \
+    (((_req)->flags & UCP_REQUEST_FLAG_CSUM) ? \
+     UCP_AM_ID_EAGER_CSUM_##_name : UCP_AM_ID_EAGER_##_name)
+
+
+/* Eager headers followed by the payload checksum, for zero-copy sends */
+typedef struct {
+    ucp_eager_hdr_t            hdr;
+    ucp_eager_csum_t           csum;
+} UCS_S_PACKED ucp_eager_csum_hdr_t;
+
+typedef struct {
+    ucp_eager_first_hdr_t      hdr;
+    ucp_eager_csum_t           csum;
+} UCS_S_PACKED ucp_eager_csum_first_hdr_t;
+
+typedef struct {
+    ucp_eager_sync_hdr_t       hdr;
+    ucp_eager_csum_t           csum;
+} UCS_S_PACKED ucp_eager_csum_sync_hdr_t;
+
+typedef struct {
+    ucp_eager_sync_first_hdr_t hdr;
+    ucp_eager_csum_t           csum;
+} UCS_S_PACKED ucp_eager_csum_sync_first_hdr_t;
+
+
 /* packing start */
 
+static UCS_F_ALWAYS_INLINE ucp_eager_csum_t
+ucp_tag_eager_csum(ucp_request_t *req)
+{
+    return ucp_dt_crc32c(req->send.datatype, req->send.buffer,
+                         req->send.length);
+}
+
+/* Append the payload checksum to the header, if needed, and return the
+ * resulting header length */
+static UCS_F_ALWAYS_INLINE size_t
+ucp_tag_eager_pack_csum(ucp_request_t *req, void *hdr, size_t hdr_length)
+{
+    ucp_eager_csum_t csum;
+
+    if (ucs_likely(!(req->flags & UCP_REQUEST_FLAG_CSUM))) {
+        return hdr_length;
+    }
+
+    csum = ucp_tag_eager_csum(req);
+    memcpy(UCS_PTR_BYTE_OFFSET(hdr, hdr_length), &csum, sizeof(csum));
+    return hdr_length + sizeof(csum);
+}
+
 static UCS_F_ALWAYS_INLINE size_t
 ucp_tag_pack_eager_common(ucp_request_t *req, void *dest,
                           size_t length, size_t hdr_length,
@@ -30,7 +81,7 @@ ucp_tag_pack_eager_common(ucp_request_t *req, void *dest,
 
     packed_length = ucp_dt_pack(req->send.ep->worker, req->send.datatype,
                                 req->send.mem_type, dest, req->send.buffer,
-                                &req->send.state.dt, length);
+                                &req->send.state.dt, length, req->send.length);
     return packed_length + hdr_length;
 }
 
@@ -38,63 +89,72 @@ static size_t ucp_tag_pack_eager_only_dt(void *dest, void *arg)
 {
     ucp_eager_hdr_t *hdr = dest;
     ucp_request_t *req   = arg;
+    size_t hdr_length;
 
     hdr->super.tag = req->send.msg_proto.tag;
+    hdr_length     = ucp_tag_eager_pack_csum(req, hdr, sizeof(*hdr));
 
-    return ucp_tag_pack_eager_common(req, hdr + 1, req->send.length,
-                                     sizeof(*hdr), 1);
+    return ucp_tag_pack_eager_common(req, UCS_PTR_BYTE_OFFSET(hdr, hdr_length),
+                                     req->send.length, hdr_length, 1);
 }
 
 static size_t ucp_tag_pack_eager_sync_only_dt(void *dest, void *arg)
 {
     ucp_eager_sync_hdr_t *hdr = dest;
     ucp_request_t *req        = arg;
+    size_t hdr_length;
 
     hdr->super.super.tag = req->send.msg_proto.tag;
     hdr->req.ep_id       = ucp_send_request_get_ep_remote_id(req);
     hdr->req.req_id      = ucp_request_get_id(req);
+    hdr_length           = ucp_tag_eager_pack_csum(req, hdr, sizeof(*hdr));
 
-    return ucp_tag_pack_eager_common(req, hdr + 1, req->send.length,
-                                     sizeof(*hdr), 1);
+    return ucp_tag_pack_eager_common(req, UCS_PTR_BYTE_OFFSET(hdr, hdr_length),
+                                     req->send.length, hdr_length, 1);
 }
 
 static size_t ucp_tag_pack_eager_first_dt(void *dest, void *arg)
 {
     ucp_eager_first_hdr_t *hdr = dest;
     ucp_request_t *req = arg;
-    size_t length;
+    size_t length, hdr_length;
 
     ucs_assert(req->send.lane == ucp_ep_get_am_lane(req->send.ep));
 
-    length               = ucp_ep_get_max_bcopy(req->send.ep, req->send.lane) -
-                           sizeof(*hdr);
-    length               = ucs_min(length, req->send.length);
     hdr->super.super.tag = req->send.msg_proto.tag;
     hdr->total_len       = req->send.length;
     hdr->msg_id          = req->send.msg_proto.message_id;
+    hdr_length           = ucp_tag_eager_pack_csum(req, hdr, sizeof(*hdr));
+    length               = ucp_ep_get_max_bcopy(req->send.ep, req->send.lane) -
+                           hdr_length;
+    length               = ucs_min(length, req->send.length);
 
-    return ucp_tag_pack_eager_common(req, hdr + 1, length, sizeof(*hdr), 1);
+    return ucp_tag_pack_eager_common(req, UCS_PTR_BYTE_OFFSET(hdr, hdr_length),
+                                     length, hdr_length, 1);
 }
 
 static size_t ucp_tag_pack_eager_sync_first_dt(void *dest, void *arg)
 {
     ucp_eager_sync_first_hdr_t *hdr = dest;
     ucp_request_t *req              = arg;
-    size_t length;
+    size_t length, hdr_length;
 
     ucs_assert(req->send.lane == ucp_ep_get_am_lane(req->send.ep));
 
-    length                     = ucp_ep_get_max_bcopy(req->send.ep,
-                                                      req->send.lane) -
-                                 sizeof(*hdr);
-    length                     = ucs_min(length, req->send.length);
     hdr->super.super.super.tag = req->send.msg_proto.tag;
     hdr->super.total_len       = req->send.length;
     hdr->req.ep_id             = ucp_send_request_get_ep_remote_id(req);
     hdr->super.msg_id          = req->send.msg_proto.message_id;
     hdr->req.req_id            = ucp_request_get_id(req);
+    hdr_length                 = ucp_tag_eager_pack_csum(req, hdr,
+                                                         sizeof(*hdr));
+    length                     = ucp_ep_get_max_bcopy(req->send.ep,
+                                                      req->send.lane) -
+                                 hdr_length;
+    length                     = ucs_min(length, req->send.length);
 
-    return ucp_tag_pack_eager_common(req, hdr + 1, length, sizeof(*hdr), 1);
+    return ucp_tag_pack_eager_common(req, UCS_PTR_BYTE_OFFSET(hdr, hdr_length),
+                                     length, hdr_length, 1);
 }
 
 static size_t ucp_tag_pack_eager_middle_dt(void *dest, void *arg)
@@ -130,16 +190,18 @@ static ucs_status_t ucp_tag_eager_contig_short(uct_pending_req_t *self)
 
 static ucs_status_t ucp_tag_eager_bcopy_single(uct_pending_req_t *self)
 {
-    ucs_status_t status = ucp_do_am_bcopy_single(self, UCP_AM_ID_EAGER_ONLY,
-                                                 ucp_tag_pack_eager_only_dt);
+    ucp_request_t *req  = ucs_container_of(self, ucp_request_t, send.uct);
+    ucs_status_t status = ucp_do_am_bcopy_single(
+            self, UCP_TAG_EAGER_AM_ID(req, ONLY), ucp_tag_pack_eager_only_dt);
 
     return ucp_am_bcopy_handle_status_from_pending(self, 0, 0, status);
 }
 
 static ucs_status_t ucp_tag_eager_bcopy_multi(uct_pending_req_t *self)
 {
+    ucp_request_t *req  = ucs_container_of(self, ucp_request_t, send.uct);
     ucs_status_t status = ucp_do_am_bcopy_multi(self,
-                                                UCP_AM_ID_EAGER_FIRST,
+                                                UCP_TAG_EAGER_AM_ID(req, FIRST),
                                                 UCP_AM_ID_EAGER_MIDDLE,
                                                 ucp_tag_pack_eager_first_dt,
                                                 ucp_tag_pack_eager_middle_dt, 1);
@@ -150,29 +212,37 @@ static ucs_status_t ucp_tag_eager_bcopy_multi(uct_pending_req_t *self)
 static ucs_status_t ucp_tag_eager_zcopy_single(uct_pending_req_t *self)
 {
     ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
-    ucp_eager_hdr_t hdr;
+    ucp_eager_csum_hdr_t hdr;
 
-    hdr.super.tag = req->send.msg_proto.tag;
-    return ucp_do_am_zcopy_single(self, UCP_AM_ID_EAGER_ONLY, &hdr, sizeof(hdr),
+    hdr.hdr.super.tag = req->send.msg_proto.tag;
+    return ucp_do_am_zcopy_single(self, UCP_TAG_EAGER_AM_ID(req, ONLY), &hdr,
+                                  ucp_tag_eager_pack_csum(req, &hdr,
+                                                          sizeof(hdr.hdr)),
                                   NULL, 0ul, ucp_proto_am_zcopy_req_complete);
 }
 
 static ucs_status_t ucp_tag_eager_zcopy_multi(uct_pending_req_t *self)
 {
-    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
-    ucp_eager_first_hdr_t first_hdr;
+    ucp_request_t *req    = ucs_container_of(self, ucp_request_t, send.uct);
+    size_t first_hdr_size = sizeof(ucp_eager_first_hdr_t);
+    ucp_eager_csum_first_hdr_t first_hdr;
     ucp_eager_middle_hdr_t middle_hdr;
 
-    first_hdr.super.super.tag = req->send.msg_proto.tag;
-    first_hdr.total_len       = req->send.length;
-    first_hdr.msg_id          = req->send.msg_proto.message_id;
-    middle_hdr.msg_id         = req->send.msg_proto.message_id;
-    middle_hdr.offset         = req->send.state.dt.offset;
+    first_hdr.hdr.super.super.tag = req->send.msg_proto.tag;
+    first_hdr.hdr.total_len       = req->send.length;
+    first_hdr.hdr.msg_id          = req->send.msg_proto.message_id;
+    middle_hdr.msg_id             = req->send.msg_proto.message_id;
+    middle_hdr.offset             = req->send.state.dt.offset;
+
+    if (req->send.state.dt.offset == 0) {
+        first_hdr_size = ucp_tag_eager_pack_csum(req, &first_hdr,
+                                                 first_hdr_size);
+    }
 
     return ucp_do_am_zcopy_multi(self,
-                                 UCP_AM_ID_EAGER_FIRST,
+                                 UCP_TAG_EAGER_AM_ID(req, FIRST),
                                  UCP_AM_ID_EAGER_MIDDLE,
-                                 &first_hdr, sizeof(first_hdr),
+                                 &first_hdr, first_hdr_size,
                                  &middle_hdr, sizeof(middle_hdr),
                                  NULL, 0ul, ucp_proto_am_zcopy_req_complete, 1);
 }
@@ -206,16 +276,20 @@ void ucp_tag_eager_sync_completion(ucp_request_t *req, uint32_t flag,
 
 static ucs_status_t ucp_tag_eager_sync_bcopy_single(uct_pending_req_t *self)
 {
-    ucs_status_t status = ucp_do_am_bcopy_single(self, UCP_AM_ID_EAGER_SYNC_ONLY,
-                                                 ucp_tag_pack_eager_sync_only_dt);
+    ucp_request_t *req  = ucs_container_of(self, ucp_request_t, send.uct);
+    ucs_status_t status = ucp_do_am_bcopy_single(
+            self, UCP_TAG_EAGER_AM_ID(req, SYNC_ONLY),
+            ucp_tag_pack_eager_sync_only_dt);
 
     return ucp_am_bcopy_handle_status_from_pending(self, 0, 1, status);
 }
 
 static ucs_status_t ucp_tag_eager_sync_bcopy_multi(uct_pending_req_t *self)
 {
+    ucp_request_t *req  = ucs_container_of(self, ucp_request_t, send.uct);
     ucs_status_t status = ucp_do_am_bcopy_multi(self,
-                                                UCP_AM_ID_EAGER_SYNC_FIRST,
+                                                UCP_TAG_EAGER_AM_ID(req,
+                                                                    SYNC_FIRST),
                                                 UCP_AM_ID_EAGER_MIDDLE,
                                                 ucp_tag_pack_eager_sync_first_dt,
                                                 ucp_tag_pack_eager_middle_dt, 1);
@@ -249,21 +323,24 @@ void ucp_tag_eager_sync_zcopy_completion(uct_completion_t *self)
 static ucs_status_t ucp_tag_eager_sync_zcopy_single(uct_pending_req_t *self)
 {
     ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
-    ucp_eager_sync_hdr_t hdr;
+    ucp_eager_csum_sync_hdr_t hdr;
 
-    hdr.super.super.tag = req->send.msg_proto.tag;
-    hdr.req.ep_id       = ucp_send_request_get_ep_remote_id(req);
-    hdr.req.req_id      = ucp_request_get_id(req);
+    hdr.hdr.super.super.tag = req->send.msg_proto.tag;
+    hdr.hdr.req.ep_id       = ucp_send_request_get_ep_remote_id(req);
+    hdr.hdr.req.req_id      = ucp_request_get_id(req);
 
-    return ucp_do_am_zcopy_single(self, UCP_AM_ID_EAGER_SYNC_ONLY, &hdr,
-                                  sizeof(hdr), NULL, 0ul,
+    return ucp_do_am_zcopy_single(self, UCP_TAG_EAGER_AM_ID(req, SYNC_ONLY),
+                                  &hdr,
+                                  ucp_tag_eager_pack_csum(req, &hdr,
+                                                          sizeof(hdr.hdr)),
+                                  NULL, 0ul,
                                   ucp_tag_eager_sync_zcopy_req_complete);
 }
 
 static ucs_status_t ucp_tag_eager_sync_zcopy_multi(uct_pending_req_t *self)
 {
     ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
-    ucp_eager_sync_first_hdr_t first_hdr;
+    ucp_eager_csum_sync_first_hdr_t first_hdr;
     ucp_eager_middle_hdr_t middle_hdr;
 
     if (req->send.state.dt.offset != 0) {
@@ -276,14 +353,16 @@ static ucs_status_t ucp_tag_eager_sync_zcopy_multi(uct_pending_req_t *self)
                                      ucp_tag_eager_sync_zcopy_req_complete, 1);
     }
     
-    first_hdr.super.super.super.tag = req->send.msg_proto.tag;
-    first_hdr.super.total_len       = req->send.length;
-    first_hdr.req.ep_id             = ucp_send_request_get_ep_remote_id(req);
-    first_hdr.req.req_id            = ucp_request_get_id(req);
-    first_hdr.super.msg_id          = req->send.msg_proto.message_id;
-
-    return ucp_do_am_zcopy_multi(self, UCP_AM_ID_EAGER_SYNC_FIRST,
-                                 UCP_AM_ID_LAST, &first_hdr, sizeof(first_hdr),
+    first_hdr.hdr.super.super.super.tag = req->send.msg_proto.tag;
+    first_hdr.hdr.super.total_len       = req->send.length;
+    first_hdr.hdr.req.ep_id             = ucp_send_request_get_ep_remote_id(req);
+    first_hdr.hdr.req.req_id            = ucp_request_get_id(req);
+    first_hdr.hdr.super.msg_id          = req->send.msg_proto.message_id;
+
+    return ucp_do_am_zcopy_multi(self, UCP_TAG_EAGER_AM_ID(req, SYNC_FIRST),
+                                 UCP_AM_ID_LAST, &first_hdr,
+                                 ucp_tag_eager_pack_csum(req, &first_hdr,
+                                                         sizeof(first_hdr.hdr)),
                                  NULL, 0, NULL, 0ul,
                                  ucp_tag_eager_sync_zcopy_req_complete, 1);
 }
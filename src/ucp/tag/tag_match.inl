@@ -261,10 +261,12 @@ ucp_request_recv_offload_data(ucp_request_t *req, const void *data,
         goto out;
     }
 
+    /* The message length is not known yet, so the receive buffer length is
+     * used to choose the copy method */
     if (UCP_DT_IS_CONTIG(req->recv.datatype)) {
         ucp_request_unpack_contig(req,
                                   UCS_PTR_BYTE_OFFSET(req->recv.buffer, offset),
-                                  data, length);
+                                  data, length, req->recv.length);
     } else {
         /* For non-contig data need to assemble the whole message
          * before calling unpack. */
@@ -280,7 +282,7 @@ ucp_request_recv_offload_data(ucp_request_t *req, const void *data,
         ucp_request_unpack_contig(req,
                                   UCS_PTR_BYTE_OFFSET(req->recv.tag.non_contig_buf,
                                                       offset),
-                                  data, length);
+                                  data, length, req->recv.length);
     }
 
     req->status = UCS_OK;
@@ -64,6 +64,10 @@ ucp_tag_recv_common(ucp_worker_h worker, void *buffer, size_t count,
                                          memory_type,
                                          UCS_PTR_BYTE_OFFSET(rdesc + 1, hdr_len),
                                          recv_len, 1);
+        if (ucs_unlikely(rdesc->flags & UCP_RECV_DESC_FLAG_EAGER_CSUM) &&
+            (status == UCS_OK)) {
+            status = ucp_eager_only_csum_check(rdesc + 1, hdr_len, recv_len);
+        }
         ucp_recv_desc_release(rdesc);
 
         req->status = status;
@@ -147,6 +151,8 @@ ucp_tag_recv_common(ucp_worker_h worker, void *buffer, size_t count,
     req->recv.tag.info.sender_tag = ucp_rdesc_get_tag(rdesc);
     req->recv.tag.info.length     =
     req->recv.remaining           = eagerf_hdr->total_len;
+    ucp_eager_first_csum_init(req, eagerf_hdr, rdesc->payload_offset,
+                              rdesc->flags);
 
     /* process first fragment */
     UCP_WORKER_STAT_EAGER_CHUNK(worker, UNEXP);
@@ -18,16 +18,24 @@
 void ucp_tag_rndv_matched(ucp_worker_h worker, ucp_request_t *rreq,
                           const ucp_tag_rndv_rts_hdr_t *rts_hdr)
 {
+    size_t hdr_size = ucp_tag_rndv_rts_hdr_size(rts_hdr->super.flags);
+
     ucs_assert(rts_hdr->super.flags & UCP_RNDV_RTS_FLAG_TAG);
 
     /* rreq is the receive request on the receiver's side */
     rreq->recv.tag.info.sender_tag = rts_hdr->tag.tag;
     rreq->recv.tag.info.length     = rts_hdr->super.size;
 
+    if (ucs_unlikely(rts_hdr->super.flags & UCP_RNDV_RTS_FLAG_CSUM)) {
+        rreq->flags        |= UCP_REQUEST_FLAG_CSUM;
+        rreq->recv.tag.csum = *(const ucp_tag_rndv_rts_csum_t*)(rts_hdr + 1);
+    }
+
     if (worker->context->config.ext.proto_enable) {
-        ucp_proto_rndv_receive(worker, rreq, &rts_hdr->super, sizeof(*rts_hdr));
+        ucp_proto_rndv_receive(worker, rreq, &rts_hdr->super, hdr_size);
     } else {
-        ucp_rndv_receive(worker, rreq, &rts_hdr->super, rts_hdr + 1);
+        ucp_rndv_receive(worker, rreq, &rts_hdr->super,
+                         UCS_PTR_BYTE_OFFSET(rts_hdr, hdr_size));
     }
 }
 
@@ -55,7 +63,7 @@ ucs_status_t ucp_tag_rndv_process_rts(ucp_worker_h worker,
         return UCS_OK;
     }
 
-    ucs_assert(length >= sizeof(*rts_hdr));
+    ucs_assert(length >= ucp_tag_rndv_rts_hdr_size(rts_hdr->super.flags));
 
     /* Include tag before the header as well, to keep ucp_rdesc_get_tag() fast
      * (and therefore keep fast search by ucp_tag_unexp_search())
@@ -77,20 +85,30 @@ size_t ucp_tag_rndv_rts_pack(void *dest, void *arg)
 {
     ucp_request_t *sreq                 = arg;
     ucp_tag_rndv_rts_hdr_t *tag_rts_hdr = dest;
+    uint16_t flags                      = UCP_RNDV_RTS_FLAG_TAG;
 
     tag_rts_hdr->tag.tag = sreq->send.msg_proto.tag;
 
-    return ucp_rndv_rts_pack(sreq, &tag_rts_hdr->super, sizeof(*tag_rts_hdr),
-                             UCP_RNDV_RTS_FLAG_TAG);
+    if (ucs_unlikely(sreq->flags & UCP_REQUEST_FLAG_CSUM)) {
+        *(ucp_tag_rndv_rts_csum_t*)(tag_rts_hdr + 1) =
+                ucp_dt_crc32c(sreq->send.datatype, sreq->send.buffer,
+                              sreq->send.length);
+        flags |= UCP_RNDV_RTS_FLAG_CSUM;
+    }
+
+    return ucp_rndv_rts_pack(sreq, &tag_rts_hdr->super,
+                             ucp_tag_rndv_rts_hdr_size(flags), flags);
 }
 
 UCS_PROFILE_FUNC(ucs_status_t, ucp_proto_progress_rndv_rts, (self),
                  uct_pending_req_t *self)
 {
     ucp_request_t *sreq = ucs_container_of(self, ucp_request_t, send.uct);
+    uint16_t flags      = (sreq->flags & UCP_REQUEST_FLAG_CSUM) ?
+                          UCP_RNDV_RTS_FLAG_CSUM : 0;
 
     return ucp_rndv_send_rts(sreq, ucp_tag_rndv_rts_pack,
-                             sizeof(ucp_tag_rndv_rts_hdr_t));
+                             ucp_tag_rndv_rts_hdr_size(flags));
 }
 
 ucs_status_t ucp_tag_send_start_rndv(ucp_request_t *sreq)
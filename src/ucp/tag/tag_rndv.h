@@ -18,10 +18,17 @@
 typedef struct {
     ucp_rndv_rts_hdr_t        super;
     ucp_tag_hdr_t             tag;
+    /* payload checksum follows if UCP_RNDV_RTS_FLAG_CSUM is set */
     /* packed rkeys follows */
 } UCS_S_PACKED ucp_tag_rndv_rts_hdr_t;
 
 
+/*
+ * Payload checksum of TAG API Rendezvous RTS
+ */
+typedef uint32_t ucp_tag_rndv_rts_csum_t;
+
+
 ucs_status_t ucp_tag_send_start_rndv(ucp_request_t *req);
 
 void ucp_tag_rndv_matched(ucp_worker_h worker, ucp_request_t *req,
@@ -33,6 +40,17 @@ ucs_status_t ucp_tag_rndv_process_rts(ucp_worker_h worker,
 
 size_t ucp_tag_rndv_rts_pack(void *dest, void *arg);
 
+
+/* Size of the TAG RTS header including the optional payload checksum, the
+ * packed rkeys start at this offset
+ */
+static UCS_F_ALWAYS_INLINE size_t ucp_tag_rndv_rts_hdr_size(uint16_t flags)
+{
+    return sizeof(ucp_tag_rndv_rts_hdr_t) +
+           ((flags & UCP_RNDV_RTS_FLAG_CSUM) ?
+            sizeof(ucp_tag_rndv_rts_csum_t) : 0);
+}
+
 /* In case of RNDV, there is a tag(ucp_tag_t) right after rdesc and before
  * the TAG RTS header (ucp_tag_rndv_rts_hdr_t). It is needed to unify all
  * TAG API protocol headers and make search in unexpected queue fast.
@@ -43,7 +61,8 @@ ucp_tag_rndv_rts_from_rdesc(ucp_recv_desc_t *rdesc)
     ucs_assert(rdesc->payload_offset ==
                (sizeof(ucp_tag_rndv_rts_hdr_t) + sizeof(ucp_tag_t)));
 
-    return UCS_PTR_BYTE_OFFSET(rdesc + 1, sizeof(ucp_tag_t));
+    return (ucp_tag_rndv_rts_hdr_t*)UCS_PTR_BYTE_OFFSET(rdesc + 1,
+                                                        sizeof(ucp_tag_t));
 }
 
 #endif
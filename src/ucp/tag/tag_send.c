@@ -37,6 +37,14 @@ ucp_tag_get_rndv_threshold(const ucp_request_t *req, size_t count,
         /* Fall through */
     case UCP_DATATYPE_CONTIG:
         return ucs_min(rndv_rma_thresh, rndv_am_thresh);
+    case UCP_DATATYPE_STRIDED:
+        if ((ucp_dt_strided_block_count(ucp_dt_to_strided(req->send.datatype),
+                                        0, req->send.length) > max_iov) &&
+            ucp_ep_config_key_has_tag_lane(&ucp_ep_config(req->send.ep)->key)) {
+            /* Tag offload does not support multi-packet eager protocols */
+            return 1;
+        }
+        /* Fall through */
     case UCP_DATATYPE_GENERIC:
         return rndv_am_thresh;
     default:
@@ -142,6 +150,15 @@ ucp_tag_send_req_init(ucp_request_t *req, ucp_ep_h ep, const void *buffer,
                                                          req->send.length, param);
     req->send.lane         = ucp_ep_config(ep)->tag.lane;
     req->send.pending_lane = UCP_NULL_LANE;
+
+    /* Checksum is carried by the eager and rendezvous headers of the software
+     * tag matching protocols, over data which can be read by the CPU */
+    if (ucs_unlikely(ep->worker->context->config.ext.payload_checksum) &&
+        !ucp_ep_config_key_has_tag_lane(&ucp_ep_config(ep)->key) &&
+        UCP_MEM_IS_HOST(req->send.mem_type) &&
+        (UCP_DT_IS_CONTIG(datatype) || UCP_DT_IS_IOV(datatype))) {
+        req->flags |= UCP_REQUEST_FLAG_CSUM;
+    }
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
@@ -242,6 +259,12 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_nbx,
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
 
+    status = ucp_ep_resolve_lazy_connect(ep);
+    if (ucs_unlikely(status != UCS_OK)) {
+        ret = UCS_STATUS_PTR(status);
+        goto out;
+    }
+
     ucs_trace_req("send_nbx buffer %p count %zu tag %"PRIx64" to %s",
                   buffer, count, tag, ucp_ep_peer_name(ep));
 
@@ -311,6 +334,12 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_sync_nbx,
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
+    status = ucp_ep_resolve_lazy_connect(ep);
+    if (ucs_unlikely(status != UCS_OK)) {
+        ret = UCS_STATUS_PTR(status);
+        goto out;
+    }
+
     ucs_trace_req("send_sync_nbx buffer %p count %zu tag %"PRIx64" to %s",
                   buffer, count, tag, ucp_ep_peer_name(ep));
 
@@ -13,6 +13,7 @@
 
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_ep.inl>
+#include <ucs/algorithm/crc.h>
 #include <ucs/arch/bitops.h>
 #include <ucs/debug/log.h>
 #include <inttypes.h>
@@ -44,6 +45,23 @@
  *     UCP_ADDRESS_FLAG_LAST. For unified mode, there could not be more than one
  *     ep address.
  *   * For any mode, ep address is followed by a lane index.
+ *
+ *
+ * Compact address layout:
+ *
+ * [ header(8bit) | uuid(64bit) | worker_name(string) | dict_id(64bit) ]
+ *    [ tl1_dict_index(8bit) | tl1_address_length(8bit) | tl1_address(var) ]
+ *    [ tl2_dict_index(8bit) | tl2_address_length(8bit) | tl2_address(var) ]
+ *    ...
+ *
+ *   * Device addresses, transport name checksums and iface attributes are
+ *     taken from the entry with index dict_index in a full address (the
+ *     dictionary) which was added to the unpacking worker by
+ *     ucp_worker_add_address_dict(). The dictionary is identified by the hash
+ *     of its device and transport descriptors, excluding worker-specific
+ *     interface addresses.
+ *   * LAST flag is set in the address length of the last transport.
+ *   * Compact address does not contain ep addresses.
  */
 
 
@@ -62,10 +80,11 @@ typedef struct {
     float            bandwidth;
     float            lat_ovh;
     uint32_t         prio_cap_flags; /* 8 lsb : prio
-                                      * 22 msb:
+                                      * 21 msb:
                                       *        - iface flags
                                       *        - iface event flags
-                                      * 2 hsb :
+                                      * 3 hsb :
+                                      *        - shared iface
                                       *        - amo32
                                       *        - amo64 */
 } UCS_S_PACKED ucp_address_packed_iface_attr_t;
@@ -89,6 +108,8 @@ typedef struct {
 } UCS_S_PACKED ucp_address_unified_iface_attr_t;
 
 
+#define UCP_ADDRESS_FLAG_SHARED_IFACE UCS_BIT(29) /* Interface is shared by the
+                                                     workers of the peer */
 #define UCP_ADDRESS_FLAG_ATOMIC32     UCS_BIT(30) /* 32bit atomic operations */
 #define UCP_ADDRESS_FLAG_ATOMIC64     UCS_BIT(31) /* 64bit atomic operations */
 
@@ -116,6 +137,8 @@ typedef struct {
 
 #define UCP_ADDRESS_HEADER_VERSION_MASK     UCS_MASK(4) /* Version - 4 bits */
 #define UCP_ADDRESS_HEADER_FLAG_DEBUG_INFO  UCS_BIT(4)  /* Address has debug info */
+#define UCP_ADDRESS_HEADER_FLAG_COMPACT     UCS_BIT(5)  /* Address refers to a
+                                                           dictionary */
 
 /* Enumeration of UCP address versions.
  * Every release which changes the address binary format must bump this number.
@@ -127,6 +150,24 @@ enum {
 };
 
 
+/* Address dictionary, holds a copy of the packed full address */
+typedef struct {
+    ucp_unpacked_address_t unpacked;
+    uint8_t                buffer[0];
+} ucp_address_dict_t;
+
+
+KHASH_IMPL(ucp_worker_address_dict, uint64_t, ucp_unpacked_address_t*, 1,
+           kh_int64_hash_func, kh_int64_hash_equal);
+
+
+static ucs_status_t
+ucp_address_do_unpack(ucp_worker_t *worker, const void *buffer,
+                      unsigned unpack_flags,
+                      ucp_unpacked_address_t *unpacked_address,
+                      uint64_t *dict_id_p);
+
+
 static size_t ucp_address_iface_attr_size(ucp_worker_t *worker,
                                           uint64_t flags)
 {
@@ -376,6 +417,7 @@ static int ucp_address_pack_iface_attr(ucp_worker_h worker, void *ptr,
     int packed_len;
     ucp_address_packed_iface_attr_t  *packed;
     ucp_address_unified_iface_attr_t *unified;
+    ucp_worker_iface_t *wiface;
 
     /* check if at least one of bandwidth values is 0 */
     if ((iface_attr->bandwidth.dedicated * iface_attr->bandwidth.shared) != 0) {
@@ -404,7 +446,7 @@ static int ucp_address_pack_iface_attr(ucp_worker_h worker, void *ptr,
     packed->lat_ovh        = iface_attr->latency.c;
 
     ucs_assert((ucs_popcount(UCP_ADDRESS_IFACE_FLAGS) +
-                ucs_popcount(UCP_ADDRESS_IFACE_EVENT_FLAGS)) <= 22);
+                ucs_popcount(UCP_ADDRESS_IFACE_EVENT_FLAGS)) <= 21);
 
     /* Keep only the bits defined by UCP_ADDRESS_IFACE_FLAGS
      * to shrink address. */
@@ -430,6 +472,13 @@ static int ucp_address_pack_iface_attr(ucp_worker_h worker, void *ptr,
         }
     }
 
+    /* A shared interface address can be used only by peers with shared
+     * interfaces */
+    wiface = ucp_worker_iface(worker, rsc_index);
+    if (wiface->flags & UCP_WORKER_IFACE_FLAG_SHARED) {
+        packed->prio_cap_flags |= UCP_ADDRESS_FLAG_SHARED_IFACE;
+    }
+
     packed_len = sizeof(*packed);
 
     if (pack_flags & UCP_ADDRESS_PACK_FLAG_TL_RSC_IDX) {
@@ -474,6 +523,8 @@ ucp_address_unpack_iface_attr(ucp_worker_t *worker,
         iface_attr->overhead      = wiface->attr.overhead;
         iface_attr->bandwidth     = wiface->attr.bandwidth;
         iface_attr->dst_rsc_index = rsc_idx;
+        iface_attr->shared        = !!(wiface->flags &
+                                       UCP_WORKER_IFACE_FLAG_SHARED);
         if (signbit(unified->lat_ovh)) {
             iface_attr->atomic.atomic32.op_flags  = wiface->attr.cap.atomic32.op_flags;
             iface_attr->atomic.atomic32.fop_flags = wiface->attr.cap.atomic32.fop_flags;
@@ -515,6 +566,9 @@ ucp_address_unpack_iface_attr(ucp_worker_t *worker,
         iface_attr->atomic.atomic64.fop_flags |= UCP_ATOMIC_FOP_MASK;
     }
 
+    iface_attr->shared = !!(packed->prio_cap_flags &
+                            UCP_ADDRESS_FLAG_SHARED_IFACE);
+
     *size_p = sizeof(*packed);
 
     if (unpack_flags & UCP_ADDRESS_PACK_FLAG_TL_RSC_IDX) {
@@ -599,6 +653,66 @@ ucp_address_unpack_length(ucp_worker_h worker, const void* flags_ptr, const void
     return UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
 }
 
+static ucs_status_t
+ucp_address_get_device_address(ucp_worker_iface_t *wiface, void *ptr)
+{
+    ucp_context_h context = wiface->worker->context;
+
+    if (wiface->iface == NULL) {
+        /* Interface was not opened yet, use the address saved by the first
+         * worker which opened it */
+        memcpy(ptr, context->tl_iface_cache[wiface->rsc_index].dev_addr,
+               wiface->attr.device_addr_len);
+        return UCS_OK;
+    }
+
+    return uct_iface_get_device_address(wiface->iface,
+                                        (uct_device_addr_t*)ptr);
+}
+
+static ucs_status_t
+ucp_address_get_iface_address(ucp_worker_iface_t *wiface, void *ptr)
+{
+    ucp_context_h context = wiface->worker->context;
+
+    if (wiface->iface == NULL) {
+        memcpy(ptr, context->tl_iface_cache[wiface->rsc_index].iface_addr,
+               wiface->attr.iface_addr_len);
+        return UCS_OK;
+    }
+
+    return uct_iface_get_address(wiface->iface, (uct_iface_addr_t*)ptr);
+}
+
+static void *
+ucp_address_pack_header(ucp_worker_h worker, void *ptr, unsigned pack_flags,
+                        uint8_t header_flags)
+{
+    uint8_t *address_header_p;
+
+    address_header_p  = ptr;
+    *address_header_p = UCP_ADDRESS_VERSION_CURRENT | header_flags;
+    ptr               = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
+
+    if (pack_flags & UCP_ADDRESS_PACK_FLAG_WORKER_UUID) {
+        *(uint64_t*)ptr = worker->uuid;
+        ptr             = UCS_PTR_TYPE_OFFSET(ptr, worker->uuid);
+    }
+
+    if (worker->context->config.ext.address_debug_info) {
+        /* Add debug information to the packed address, and set the corresponding
+         * flag in address header.
+         */
+        *address_header_p |= UCP_ADDRESS_HEADER_FLAG_DEBUG_INFO;
+
+        if (pack_flags & UCP_ADDRESS_PACK_FLAG_WORKER_NAME) {
+            ptr            = ucp_address_pack_worker_address_name(worker, ptr);
+        }
+    }
+
+    return ptr;
+}
+
 static ucs_status_t
 ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
                     unsigned pack_flags, const ucp_lane_index_t *lanes2remote,
@@ -608,7 +722,6 @@ ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
     ucp_context_h context       = worker->context;
     uint64_t md_flags_pack_mask = (UCT_MD_FLAG_REG | UCT_MD_FLAG_ALLOC);
     const ucp_address_packed_device_t *dev;
-    uint8_t *address_header_p;
     uct_iface_attr_t *iface_attr;
     ucp_md_index_t md_index;
     ucp_worker_iface_t *wiface;
@@ -627,27 +740,8 @@ ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
     void *ptr;
     int enable_amo;
 
-    ptr               = buffer;
-    addr_index        = 0;
-    address_header_p  = ptr;
-    *address_header_p = UCP_ADDRESS_VERSION_CURRENT;
-    ptr               = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
-
-    if (pack_flags & UCP_ADDRESS_PACK_FLAG_WORKER_UUID) {
-        *(uint64_t*)ptr = worker->uuid;
-        ptr             = UCS_PTR_TYPE_OFFSET(ptr, worker->uuid);
-    }
-
-    if (worker->context->config.ext.address_debug_info) {
-        /* Add debug information to the packed address, and set the corresponding
-         * flag in address header.
-         */
-        *address_header_p |= UCP_ADDRESS_HEADER_FLAG_DEBUG_INFO;
-
-        if (pack_flags & UCP_ADDRESS_PACK_FLAG_WORKER_NAME) {
-            ptr            = ucp_address_pack_worker_address_name(worker, ptr);
-        }
-    }
+    addr_index = 0;
+    ptr        = ucp_address_pack_header(worker, buffer, pack_flags, 0);
 
     if (num_devices == 0) {
         *((uint8_t*)ptr) = UCP_NULL_RESOURCE;
@@ -703,8 +797,7 @@ ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
         /* Device address */
         if (pack_flags & UCP_ADDRESS_PACK_FLAG_DEVICE_ADDR) {
             wiface = ucp_worker_iface(worker, dev->rsc_index);
-            status = uct_iface_get_device_address(wiface->iface,
-                                                  (uct_device_addr_t*)ptr);
+            status = ucp_address_get_device_address(wiface, ptr);
             if (status != UCS_OK) {
                 return status;
             }
@@ -750,8 +843,7 @@ ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
             /* Pack iface address */
             ptr = ucp_address_pack_length(worker, ptr, iface_addr_len);
             if (pack_flags & UCP_ADDRESS_PACK_FLAG_IFACE_ADDR) {
-                status = uct_iface_get_address(wiface->iface,
-                                               (uct_iface_addr_t*)ptr);
+                status = ucp_address_get_iface_address(wiface, ptr);
                 if (status != UCS_OK) {
                     return status;
                 }
@@ -862,6 +954,126 @@ out:
     return UCS_OK;
 }
 
+static size_t
+ucp_address_compact_packed_size(ucp_worker_h worker,
+                                const ucp_address_packed_device_t *devices,
+                                ucp_rsc_index_t num_devices,
+                                unsigned pack_flags)
+{
+    ucp_context_h context = worker->context;
+    const ucp_address_packed_device_t *dev;
+    ucp_tl_bitmap_t dev_tl_bitmap;
+    ucp_rsc_index_t rsc_index;
+    size_t size;
+
+    /* header, worker uuid and name are the same as in full address */
+    size  = ucp_address_packed_size(worker, NULL, 0, pack_flags) - 1;
+    size += sizeof(uint64_t); /* dictionary id */
+
+    for (dev = devices; dev < (devices + num_devices); ++dev) {
+        dev_tl_bitmap = UCS_BITMAP_AND(context->tl_bitmap, dev->tl_bitmap,
+                                       UCP_MAX_RESOURCES);
+        UCS_BITMAP_FOR_EACH_BIT(dev_tl_bitmap, rsc_index) {
+            size += 1; /* dictionary index */
+            size += 1; /* iface address length */
+            size += ucp_worker_iface_get_attr(worker, rsc_index)->iface_addr_len;
+        }
+    }
+
+    return size;
+}
+
+static ucs_status_t
+ucp_address_do_pack_compact(ucp_worker_h worker, void *buffer, size_t size,
+                            unsigned pack_flags, uint64_t dict_id,
+                            const ucp_address_packed_device_t *devices,
+                            ucp_rsc_index_t num_devices)
+{
+    ucp_context_h context = worker->context;
+    uint8_t *length_ptr   = NULL;
+    const ucp_address_packed_device_t *dev;
+    ucp_tl_bitmap_t dev_tl_bitmap;
+    ucp_worker_iface_t *wiface;
+    ucp_rsc_index_t rsc_index;
+    size_t iface_addr_len;
+    unsigned dict_index;
+    ucs_status_t status;
+    void *ptr;
+
+    ptr = ucp_address_pack_header(worker, buffer, pack_flags,
+                                  UCP_ADDRESS_HEADER_FLAG_COMPACT);
+
+    *(uint64_t*)ptr = dict_id;
+    ptr             = UCS_PTR_TYPE_OFFSET(ptr, dict_id);
+
+    /* Transports are packed in the same order as in the full address, so
+     * their index in the dictionary is the running index */
+    dict_index = 0;
+    for (dev = devices; dev < (devices + num_devices); ++dev) {
+        dev_tl_bitmap = UCS_BITMAP_AND(context->tl_bitmap, dev->tl_bitmap,
+                                       UCP_MAX_RESOURCES);
+        UCS_BITMAP_FOR_EACH_BIT(dev_tl_bitmap, rsc_index) {
+            wiface         = ucp_worker_iface(worker, rsc_index);
+            iface_addr_len = wiface->attr.iface_addr_len;
+
+            ucs_assertv(dict_index <= UINT8_MAX, "dict_index=%u", dict_index);
+            *(uint8_t*)ptr = dict_index++;
+            ptr            = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
+
+            ucs_assertv(iface_addr_len <= UCP_ADDRESS_FLAG_LEN_MASK,
+                        "iface_addr_len=%zu", iface_addr_len);
+            length_ptr     = ptr;
+            *length_ptr    = iface_addr_len;
+            ptr            = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
+
+            status = ucp_address_get_iface_address(wiface, ptr);
+            if (status != UCS_OK) {
+                return status;
+            }
+
+            ucp_address_memcheck(context, ptr, iface_addr_len, rsc_index);
+            ptr = UCS_PTR_BYTE_OFFSET(ptr, iface_addr_len);
+        }
+    }
+
+    ucs_assert(length_ptr != NULL);
+    *length_ptr |= UCP_ADDRESS_FLAG_LAST;
+
+    ucs_assertv(UCS_PTR_BYTE_OFFSET(buffer, size) == ptr,
+                "buffer=%p size=%zu ptr=%p ptr-buffer=%zd",
+                buffer, size, ptr, UCS_PTR_BYTE_DIFF(buffer, ptr));
+    return UCS_OK;
+}
+
+/* Calculate the id of the dictionary which describes the given transports */
+static ucs_status_t
+ucp_address_pack_dict_id(ucp_worker_h worker, const ucp_tl_bitmap_t *tl_bitmap,
+                         uint64_t *dict_id_p)
+{
+    unsigned pack_flags = UCP_ADDRESS_PACK_FLAG_DEVICE_ADDR |
+                          UCP_ADDRESS_PACK_FLAG_IFACE_ADDR |
+                          UCP_ADDRESS_PACK_FLAG_NO_TRACE;
+    ucp_unpacked_address_t unpacked;
+    ucs_status_t status;
+    void *buffer;
+    size_t size;
+
+    status = ucp_address_pack(worker, NULL, tl_bitmap, pack_flags, NULL,
+                              &size, &buffer);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = ucp_address_do_unpack(worker, buffer, pack_flags, &unpacked,
+                                   dict_id_p);
+    if (status == UCS_OK) {
+        ucs_free(unpacked.address_list);
+    }
+
+    ucs_free(buffer);
+    return status;
+}
+
 ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
                               const ucp_tl_bitmap_t *tl_bitmap,
                               unsigned pack_flags,
@@ -871,6 +1083,7 @@ ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
     ucp_address_packed_device_t *devices;
     ucp_rsc_index_t num_devices;
     ucs_status_t status;
+    uint64_t dict_id;
     void *buffer;
     size_t size;
 
@@ -885,8 +1098,25 @@ ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
         goto out;
     }
 
-    /* Calculate packed size */
-    size = ucp_address_packed_size(worker, devices, num_devices, pack_flags);
+    /* In unified mode the address has no iface attributes to omit */
+    if ((pack_flags & UCP_ADDRESS_PACK_FLAG_COMPACT) &&
+        !ucp_worker_is_unified_mode(worker) && (num_devices > 0)) {
+        ucs_assert(!(pack_flags & UCP_ADDRESS_PACK_FLAG_EP_ADDR));
+        ucs_assert(pack_flags & UCP_ADDRESS_PACK_FLAG_IFACE_ADDR);
+
+        status = ucp_address_pack_dict_id(worker, tl_bitmap, &dict_id);
+        if (status != UCS_OK) {
+            goto out_free_devices;
+        }
+
+        size = ucp_address_compact_packed_size(worker, devices, num_devices,
+                                               pack_flags);
+    } else {
+        pack_flags &= ~UCP_ADDRESS_PACK_FLAG_COMPACT;
+        dict_id     = 0;
+        size        = ucp_address_packed_size(worker, devices, num_devices,
+                                              pack_flags);
+    }
 
     /* Allocate address */
     buffer = ucs_malloc(size, "ucp_address");
@@ -898,8 +1128,13 @@ ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
     memset(buffer, 0, size);
 
     /* Pack the address */
-    status = ucp_address_do_pack(worker, ep, buffer, size, pack_flags,
-                                 lanes2remote, devices, num_devices);
+    if (pack_flags & UCP_ADDRESS_PACK_FLAG_COMPACT) {
+        status = ucp_address_do_pack_compact(worker, buffer, size, pack_flags,
+                                             dict_id, devices, num_devices);
+    } else {
+        status = ucp_address_do_pack(worker, ep, buffer, size, pack_flags,
+                                     lanes2remote, devices, num_devices);
+    }
     if (status != UCS_OK) {
         ucs_free(buffer);
         goto out_free_devices;
@@ -917,10 +1152,106 @@ out:
     return status;
 }
 
-ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
-                                unsigned unpack_flags,
-                                ucp_unpacked_address_t *unpacked_address)
+static ucs_status_t
+ucp_address_unpack_compact(ucp_worker_t *worker, const void *buffer,
+                           const void *ptr, unsigned unpack_flags,
+                           ucp_unpacked_address_t *unpacked_address)
+{
+    ucp_address_entry_t *address_list, *address;
+    const ucp_address_entry_t *dict_entry;
+    const ucp_unpacked_address_t *dict;
+    size_t iface_addr_len;
+    unsigned dict_index;
+    uint64_t dict_id;
+    khiter_t iter;
+    int last_tl;
+
+    dict_id = *(uint64_t*)ptr;
+    ptr     = UCS_PTR_TYPE_OFFSET(ptr, dict_id);
+
+    iter = kh_get(ucp_worker_address_dict, &worker->address_dicts, dict_id);
+    if (iter == kh_end(&worker->address_dicts)) {
+        if (!(unpack_flags & UCP_ADDRESS_PACK_FLAG_NO_TRACE)) {
+            ucs_error("address dictionary 0x%"PRIx64" of %s was not added to"
+                      " worker %s", dict_id, unpacked_address->name,
+                      ucp_worker_get_address_name(worker));
+        }
+        return UCS_ERR_NO_ELEM;
+    }
+
+    dict = kh_val(&worker->address_dicts, iter);
+    if (dict->address_count == 0) {
+        goto err_invalid;
+    }
+
+    address_list = ucs_malloc(sizeof(*address_list) * dict->address_count,
+                              "ucp_address_list");
+    if (address_list == NULL) {
+        ucs_error("failed to allocate address list");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    address = address_list;
+    do {
+        dict_index = *(uint8_t*)ptr;
+        ptr        = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
+        if ((dict_index >= dict->address_count) ||
+            (address >= &address_list[dict->address_count])) {
+            ucs_free(address_list);
+            goto err_invalid;
+        }
+
+        /* Take device and transport descriptors from the dictionary */
+        dict_entry             = &dict->address_list[dict_index];
+        address->dev_addr      = dict_entry->dev_addr;
+        address->dev_addr_len  = dict_entry->dev_addr_len;
+        address->iface_attr    = dict_entry->iface_attr;
+        address->md_flags      = dict_entry->md_flags;
+        address->dev_num_paths = dict_entry->dev_num_paths;
+        address->tl_name_csum  = dict_entry->tl_name_csum;
+        address->md_index      = dict_entry->md_index;
+        address->dev_index     = dict_entry->dev_index;
+        address->num_ep_addrs  = 0;
+
+        iface_addr_len         = *(uint8_t*)ptr & UCP_ADDRESS_FLAG_LEN_MASK;
+        last_tl                = *(uint8_t*)ptr & UCP_ADDRESS_FLAG_LAST;
+        ptr                    = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
+        address->iface_addr    = (iface_addr_len > 0) ? ptr : NULL;
+        ptr                    = UCS_PTR_BYTE_OFFSET(ptr, iface_addr_len);
+
+        if (!(unpack_flags & UCP_ADDRESS_PACK_FLAG_NO_TRACE)) {
+            ucs_trace("unpack addr[%d] : dict 0x%"PRIx64"[%u] iface_addr_len"
+                      " %zu", (int)(address - address_list), dict_id,
+                      dict_index, iface_addr_len);
+        }
+
+        ++address;
+    } while (!last_tl);
+
+    unpacked_address->address_count = address - address_list;
+    unpacked_address->address_list  = address_list;
+    unpacked_address->packed_length = UCS_PTR_BYTE_DIFF(buffer, ptr);
+    return UCS_OK;
+
+err_invalid:
+    if (!(unpack_flags & UCP_ADDRESS_PACK_FLAG_NO_TRACE)) {
+        ucs_error("failed to parse address: invalid index in dictionary"
+                  " 0x%"PRIx64, dict_id);
+    }
+    return UCS_ERR_INVALID_PARAM;
+}
+
+/*
+ * If dict_id_p is not NULL, it is set to the hash of the device and transport
+ * descriptors of the address, which identifies it as a dictionary.
+ */
+static ucs_status_t
+ucp_address_do_unpack(ucp_worker_t *worker, const void *buffer,
+                      unsigned unpack_flags,
+                      ucp_unpacked_address_t *unpacked_address,
+                      uint64_t *dict_id_p)
 {
+    uint64_t dict_id = UCS_FNV1A64_INIT;
     ucp_address_entry_t *address_list, *address;
     uint8_t address_header, address_version;
     ucp_address_entry_ep_addr_t *ep_addr;
@@ -939,10 +1270,12 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
     uint8_t md_byte;
     const void *ptr;
     const void *flags_ptr;
+    const void *desc_ptr;
 
     /* Initialize the unpacked address to empty */
     unpacked_address->address_count = 0;
     unpacked_address->address_list  = NULL;
+    unpacked_address->packed_length = 0;
 
     ptr                             = buffer;
     address_header                  = *(const uint8_t *)ptr;
@@ -972,8 +1305,23 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
                          sizeof(unpacked_address->name));
     }
 
+    if (address_header & UCP_ADDRESS_HEADER_FLAG_COMPACT) {
+        if (dict_id_p != NULL) {
+            ucs_error("compact address cannot be used as a dictionary");
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        return ucp_address_unpack_compact(worker, buffer, ptr, unpack_flags,
+                                          unpacked_address);
+    }
+
     /* Empty address list */
     if (*(uint8_t*)ptr == UCP_NULL_RESOURCE) {
+        ptr = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
+        unpacked_address->packed_length = UCS_PTR_BYTE_DIFF(buffer, ptr);
+        if (dict_id_p != NULL) {
+            *dict_id_p = dict_id;
+        }
         return UCS_OK;
     }
 
@@ -990,6 +1338,8 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
     dev_index = 0;
 
     do {
+        desc_ptr     = ptr;
+
         /* md_index */
         md_byte      = (*(uint8_t*)ptr);
         md_index     = md_byte & UCP_ADDRESS_FLAG_MD_MASK;
@@ -1012,6 +1362,11 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
         dev_addr = ptr;
         ptr      = UCS_PTR_BYTE_OFFSET(ptr, dev_addr_len);
 
+        if (dict_id_p != NULL) {
+            dict_id = ucs_fnv1a64(dict_id, desc_ptr,
+                                  UCS_PTR_BYTE_DIFF(desc_ptr, ptr));
+        }
+
         last_tl = empty_dev;
         while (!last_tl) {
             if (address >= &address_list[UCP_MAX_RESOURCES]) {
@@ -1022,11 +1377,14 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
                 goto err_free;
             }
 
+            desc_ptr = ptr;
+
             /* tl_name_csum */
             address->tl_name_csum = *(uint16_t*)ptr;
             ptr = UCS_PTR_TYPE_OFFSET(ptr, address->tl_name_csum);
 
             address->dev_addr      = (dev_addr_len > 0) ? dev_addr : NULL;
+            address->dev_addr_len  = dev_addr_len;
             address->md_index      = md_index;
             address->dev_index     = dev_index;
             address->md_flags      = md_flags;
@@ -1040,6 +1398,12 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
 
             flags_ptr = ucp_address_iface_flags_ptr(worker, (void*)ptr, attr_len);
             ptr       = UCS_PTR_BYTE_OFFSET(ptr, attr_len);
+
+            if (dict_id_p != NULL) {
+                dict_id = ucs_fnv1a64(dict_id, desc_ptr,
+                                      UCS_PTR_BYTE_DIFF(desc_ptr, ptr));
+            }
+
             ptr       = ucp_address_unpack_length(worker, flags_ptr, ptr,
                                                   &iface_addr_len, 0, &last_tl);
             address->iface_addr   = (iface_addr_len > 0) ? ptr : NULL;
@@ -1102,9 +1466,95 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
 
     unpacked_address->address_count = address - address_list;
     unpacked_address->address_list  = address_list;
+    unpacked_address->packed_length = UCS_PTR_BYTE_DIFF(buffer, ptr);
+    if (dict_id_p != NULL) {
+        *dict_id_p = dict_id;
+    }
     return UCS_OK;
 
 err_free:
     ucs_free(address_list);
     return UCS_ERR_INVALID_PARAM;
 }
+
+ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
+                                unsigned unpack_flags,
+                                ucp_unpacked_address_t *unpacked_address)
+{
+    return ucp_address_do_unpack(worker, buffer, unpack_flags,
+                                 unpacked_address, NULL);
+}
+
+void ucp_address_dicts_init(ucp_worker_h worker)
+{
+    kh_init_inplace(ucp_worker_address_dict, &worker->address_dicts);
+}
+
+void ucp_address_dicts_cleanup(ucp_worker_h worker)
+{
+    ucp_unpacked_address_t *unpacked;
+
+    kh_foreach_value(&worker->address_dicts, unpacked, {
+        ucs_free(unpacked->address_list);
+        ucs_free(ucs_container_of(unpacked, ucp_address_dict_t, unpacked));
+    })
+
+    kh_destroy_inplace(ucp_worker_address_dict, &worker->address_dicts);
+}
+
+ucs_status_t ucp_address_dict_add(ucp_worker_h worker, const void *buffer)
+{
+    unsigned unpack_flags = UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT;
+    ucp_unpacked_address_t unpacked;
+    ucp_address_dict_t *dict;
+    ucs_status_t status;
+    uint64_t dict_id;
+    khiter_t iter;
+    int khret;
+
+    status = ucp_address_do_unpack(worker, buffer, unpack_flags, &unpacked,
+                                   &dict_id);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ucs_free(unpacked.address_list);
+
+    iter = kh_put(ucp_worker_address_dict, &worker->address_dicts, dict_id,
+                  &khret);
+    if (khret == UCS_KH_PUT_FAILED) {
+        return UCS_ERR_NO_MEMORY;
+    } else if (khret == UCS_KH_PUT_KEY_PRESENT) {
+        return UCS_OK;
+    }
+
+    /* Keep a copy of the packed dictionary, since unpacked entries point to
+     * its device addresses */
+    dict = ucs_malloc(sizeof(*dict) + unpacked.packed_length,
+                      "ucp_address_dict");
+    if (dict == NULL) {
+        ucs_error("failed to allocate address dictionary");
+        status = UCS_ERR_NO_MEMORY;
+        goto err_del;
+    }
+
+    memcpy(dict->buffer, buffer, unpacked.packed_length);
+    status = ucp_address_do_unpack(worker, dict->buffer,
+                                   unpack_flags | UCP_ADDRESS_PACK_FLAG_NO_TRACE,
+                                   &dict->unpacked, NULL);
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
+    kh_val(&worker->address_dicts, iter) = &dict->unpacked;
+    ucs_debug("worker %p: added address dictionary 0x%"PRIx64" from %s with"
+              " %u entries", worker, dict_id, dict->unpacked.name,
+              dict->unpacked.address_count);
+    return UCS_OK;
+
+err_free:
+    ucs_free(dict);
+err_del:
+    kh_del(ucp_worker_address_dict, &worker->address_dicts, iter);
+    return status;
+}
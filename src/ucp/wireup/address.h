@@ -62,7 +62,12 @@ enum {
     UCP_ADDRESS_PACK_FLAGS_CM_DEFAULT     = UCP_ADDRESS_PACK_FLAG_IFACE_ADDR |
                                             UCP_ADDRESS_PACK_FLAG_EP_ADDR,
 
-    UCP_ADDRESS_PACK_FLAG_NO_TRACE        = UCS_BIT(16) /* Suppress debug tracing */
+    UCP_ADDRESS_PACK_FLAG_NO_TRACE        = UCS_BIT(16), /* Suppress debug tracing */
+
+    UCP_ADDRESS_PACK_FLAG_COMPACT         = UCS_BIT(17)  /* Pack only interface
+                                                            addresses and refer
+                                                            to a dictionary for
+                                                            the rest */
 };
 
 
@@ -78,6 +83,8 @@ struct ucp_address_iface_attr {
     double                      lat_ovh;      /* Latency overhead */
     ucp_rsc_index_t             dst_rsc_index;/* Destination resource index */
     ucp_tl_iface_atomic_flags_t atomic;       /* Atomic operations */
+    int                         shared;       /* Interface is shared by the
+                                                 remote workers */
 };
 
 typedef struct ucp_address_entry_ep_addr {
@@ -90,6 +97,7 @@ typedef struct ucp_address_entry_ep_addr {
  */
 struct ucp_address_entry {
     const uct_device_addr_t     *dev_addr;      /* Points to device address */
+    size_t                      dev_addr_len;   /* Device address length */
     const uct_iface_addr_t      *iface_addr;    /* Interface address, NULL if not available */
     unsigned                    num_ep_addrs;   /* How many endpoint address are in ep_addrs */
     ucp_address_entry_ep_addr_t ep_addrs[UCP_MAX_LANES]; /* Endpoint addresses */
@@ -111,6 +119,7 @@ struct ucp_unpacked_address {
     char                        name[UCP_WORKER_ADDRESS_NAME_MAX];
     unsigned                    address_count;  /* Length of address list */
     ucp_address_entry_t         *address_list;  /* Pointer to address list */
+    size_t                      packed_length;  /* Size of the packed buffer */
 };
 
 
@@ -176,4 +185,22 @@ ucs_status_t ucp_address_unpack(ucp_worker_h worker, const void *buffer,
                                 ucp_unpacked_address_t *unpacked_address);
 
 
+/**
+ * Add a full worker address as a dictionary for unpacking compact addresses.
+ *
+ * @param [in]  worker           Worker object.
+ * @param [in]  buffer           Full worker address, packed with
+ *                               UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT.
+ *
+ * @note Adding the same dictionary more than once has no effect.
+ */
+ucs_status_t ucp_address_dict_add(ucp_worker_h worker, const void *buffer);
+
+
+void ucp_address_dicts_init(ucp_worker_h worker);
+
+
+void ucp_address_dicts_cleanup(ucp_worker_h worker);
+
+
 #endif
@@ -16,10 +16,12 @@
 #include <ucp/core/ucp_ep.h>
 #include <ucp/core/ucp_request.inl>
 #include <ucp/core/ucp_proxy_ep.h>
+#include <ucp/core/ucp_shared_iface.h>
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_listener.h>
 #include <ucp/proto/proto_am.inl>
 #include <ucp/tag/eager.h>
+#include <ucs/algorithm/crc.h>
 #include <ucs/async/async.h>
 #include <ucs/datastruct/queue.h>
 #include <ucs/sys/iovec.h>
@@ -569,6 +571,11 @@ ucp_wireup_process_request(ucp_worker_h worker, ucp_ep_h ep,
         return;
     }
 
+    if (ep->flags & UCP_EP_FLAG_LAZY_CONNECT) {
+        /* The peer connected before this endpoint was used */
+        ucp_ep_lazy_connect_release(ep);
+    }
+
     ucp_wireup_match_p2p_lanes(ep, remote_address, addr_indices, lanes2remote);
 
     /* Send a reply if remote side does not have ep_ptr (active-active flow) or
@@ -878,7 +885,8 @@ ucp_wireup_connect_lane_to_iface(ucp_ep_h ep, ucp_lane_index_t lane,
     uct_ep_params.dev_addr   = address->dev_addr;
     uct_ep_params.iface_addr = address->iface_addr;
     uct_ep_params.path_index = path_index;
-    status = uct_ep_create(&uct_ep_params, &uct_ep);
+    status = ucp_shared_iface_ep_create(&uct_ep_params,
+                                        address->iface_attr.shared, &uct_ep);
     if (status != UCS_OK) {
         /* coverity[leaked_storage] */
         return status;
@@ -967,6 +975,7 @@ ucp_wireup_connect_lane(ucp_ep_h ep, unsigned ep_init_flags,
     ucp_rsc_index_t rsc_index;
     ucp_worker_iface_t *wiface;
     ucp_address_entry_t *address;
+    ucs_status_t status;
 
     ucs_trace("ep %p: connect lane[%d]", ep, lane);
 
@@ -978,6 +987,10 @@ ucp_wireup_connect_lane(ucp_ep_h ep, unsigned ep_init_flags,
 
     rsc_index  = ucp_ep_get_rsc_index(ep, lane);
     wiface     = ucp_worker_iface(worker, rsc_index);
+    status     = ucp_worker_iface_check_open(wiface);
+    if (status != UCS_OK) {
+        return status;
+    }
 
     /*
      * create a wireup endpoint which will start connection establishment
@@ -1049,6 +1062,44 @@ static void ucp_wireup_print_config(ucp_worker_h worker,
     }
 }
 
+/*
+ * Interfaces which connect only to endpoints check reachability by the local
+ * and remote devices, so the result of an opened interface is saved on the
+ * context and reused by workers which did not open the interface yet. This way
+ * only the interfaces of the selected lanes are opened.
+ */
+static int ucp_wireup_iface_is_reachable(ucp_worker_iface_t *wiface,
+                                         const ucp_address_entry_t *ae)
+{
+    ucp_context_h context = wiface->worker->context;
+    uint64_t dev_key;
+    int reachable;
+
+    if ((context->tl_iface_cache == NULL) ||
+        !(wiface->attr.cap.flags & UCT_IFACE_FLAG_CONNECT_TO_EP) ||
+        (wiface->attr.cap.flags & UCT_IFACE_FLAG_CONNECT_TO_IFACE)) {
+        return (ucp_worker_iface_check_open(wiface) == UCS_OK) &&
+               uct_iface_is_reachable(wiface->iface, ae->dev_addr,
+                                      ae->iface_addr);
+    }
+
+    dev_key = ucs_fnv1a64(UCS_FNV1A64_INIT, ae->dev_addr, ae->dev_addr_len);
+    if (ucp_context_tl_reachable_get(context, wiface->rsc_index, dev_key,
+                                     &reachable) == UCS_OK) {
+        return reachable;
+    }
+
+    if (ucp_worker_iface_check_open(wiface) != UCS_OK) {
+        return 0;
+    }
+
+    reachable = uct_iface_is_reachable(wiface->iface, ae->dev_addr,
+                                       ae->iface_addr);
+    ucp_context_tl_reachable_set(context, wiface->rsc_index, dev_key,
+                                 reachable);
+    return reachable;
+}
+
 int ucp_wireup_is_reachable(ucp_ep_h ep, unsigned ep_init_flags,
                             ucp_rsc_index_t rsc_index,
                             const ucp_address_entry_t *ae)
@@ -1057,10 +1108,14 @@ int ucp_wireup_is_reachable(ucp_ep_h ep, unsigned ep_init_flags,
     ucp_worker_iface_t *wiface = ucp_worker_iface(ep->worker, rsc_index);
 
     return (context->tl_rscs[rsc_index].tl_name_csum == ae->tl_name_csum) &&
+           /* a shared interface sends to and receives from shared remote
+            * interfaces only */
+           (!(wiface->flags & UCP_WORKER_IFACE_FLAG_SHARED) ==
+            !ae->iface_attr.shared) &&
            (/* assume reachability is checked by CM, if EP selects lanes
              * during CM phase */
             (ep_init_flags & UCP_EP_INIT_CM_PHASE) ||
-            uct_iface_is_reachable(wiface->iface, ae->dev_addr, ae->iface_addr));
+            ucp_wireup_iface_is_reachable(wiface, ae));
 }
 
 static void
@@ -1321,7 +1376,9 @@ ucs_status_t ucp_wireup_init_lanes(ucp_ep_h ep, unsigned ep_init_flags,
 
     if ((ep->cfg_index != UCP_WORKER_CFG_INDEX_NULL) &&
         /* reconfiguration is allowed for CM flow */
-        !ucp_ep_has_cm_lane(ep)) {
+        !ucp_ep_has_cm_lane(ep) &&
+        /* lazily connected endpoint has no lanes to reconfigure */
+        !(ep->flags & UCP_EP_FLAG_LAZY_CONNECT)) {
         /*
          * TODO handle a case where we have to change lanes and reconfigure the ep:
          *
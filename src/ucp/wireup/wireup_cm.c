@@ -522,6 +522,7 @@ static unsigned ucp_cm_client_connect_progress(void *arg)
     uct_ep_h uct_cm_ep                                 = ucp_ep_get_cm_uct_ep(ucp_ep);
     ucp_wireup_ep_t *wireup_ep;
     ucp_unpacked_address_t addr;
+    ucp_address_entry_t *address;
     ucp_tl_bitmap_t tl_bitmap;
     ucp_rsc_index_t dev_index;
     ucp_lane_index_t lane;
@@ -553,8 +554,10 @@ static unsigned ucp_cm_client_connect_progress(void *arg)
     }
 
     for (addr_idx = 0; addr_idx < addr.address_count; ++addr_idx) {
-        addr.address_list[addr_idx].dev_addr  = progress_arg->dev_addr;
-        addr.address_list[addr_idx].dev_index = progress_arg->sa_data->dev_index;
+        address               = &addr.address_list[addr_idx];
+        address->dev_addr     = progress_arg->dev_addr;
+        address->dev_addr_len = progress_arg->dev_addr_len;
+        address->dev_index    = progress_arg->sa_data->dev_index;
     }
 
     ucs_assert(addr.address_count <= UCP_MAX_RESOURCES);
@@ -719,7 +722,8 @@ static void ucp_cm_client_connect_cb(uct_ep_h uct_cm_ep, void *arg,
         goto err_free_sa_data;
     }
 
-    progress_arg->ucp_ep = ucp_ep;
+    progress_arg->ucp_ep       = ucp_ep;
+    progress_arg->dev_addr_len = remote_data->dev_addr_length;
     memcpy(progress_arg->dev_addr, remote_data->dev_addr,
            remote_data->dev_addr_length);
     memcpy(progress_arg->sa_data, remote_data->conn_priv_data,
@@ -1067,6 +1071,7 @@ void ucp_cm_server_conn_request_cb(uct_listener_h listener, void *arg,
                      UCT_DEVICE_NAME_MAX);
     memcpy(ucp_conn_request->remote_dev_addr, remote_data->dev_addr,
            remote_data->dev_addr_length);
+    ucp_conn_request->remote_dev_addr_len = remote_data->dev_addr_length;
     memcpy(&ucp_conn_request->sa_data, remote_data->conn_priv_data,
            remote_data->conn_priv_data_length);
 
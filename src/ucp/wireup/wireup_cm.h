@@ -16,6 +16,7 @@ typedef struct ucp_cm_client_connect_progress_arg {
     ucp_ep_h                   ucp_ep;
     ucp_wireup_sockaddr_data_t *sa_data;
     uct_device_addr_t          *dev_addr;
+    size_t                     dev_addr_len;
 } ucp_cm_client_connect_progress_arg_t;
 
 
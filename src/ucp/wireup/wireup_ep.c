@@ -12,6 +12,7 @@
 #include "wireup.h"
 
 #include <ucp/core/ucp_request.h>
+#include <ucp/core/ucp_shared_iface.h>
 #include <ucp/core/ucp_worker.h>
 #include <ucs/arch/atomic.h>
 #include <ucs/datastruct/queue.h>
@@ -300,7 +301,8 @@ ucp_wireup_ep_connect_aux(ucp_wireup_ep_t *wireup_ep, unsigned ep_init_flags,
     uct_ep_params.iface      = wiface->iface;
     uct_ep_params.dev_addr   = aux_addr->dev_addr;
     uct_ep_params.iface_addr = aux_addr->iface_addr;
-    status = uct_ep_create(&uct_ep_params, &uct_ep);
+    status = ucp_shared_iface_ep_create(&uct_ep_params,
+                                        aux_addr->iface_attr.shared, &uct_ep);
     if (status != UCS_OK) {
         /* coverity[leaked_storage] */
         return status;
@@ -552,16 +554,22 @@ ucs_status_t ucp_wireup_ep_connect(uct_ep_h uct_ep, unsigned ep_init_flags,
     ucp_wireup_ep_t *wireup_ep     = ucp_wireup_ep(uct_ep);
     ucp_ep_h ucp_ep                = wireup_ep->super.ucp_ep;
     ucp_worker_h worker            = ucp_ep->worker;
+    ucp_worker_iface_t *wiface     = ucp_worker_iface(worker, rsc_index);
     uct_ep_params_t uct_ep_params;
     ucs_status_t status;
     uct_ep_h next_ep;
 
     ucs_assert(wireup_ep != NULL);
 
+    status = ucp_worker_iface_check_open(wiface);
+    if (status != UCS_OK) {
+        goto err;
+    }
+
     uct_ep_params.field_mask = UCT_EP_PARAM_FIELD_IFACE |
                                UCT_EP_PARAM_FIELD_PATH_INDEX;
     uct_ep_params.path_index = path_index;
-    uct_ep_params.iface      = ucp_worker_iface(worker, rsc_index)->iface;
+    uct_ep_params.iface      = wiface->iface;
     status = uct_ep_create(&uct_ep_params, &next_ep);
     if (status != UCS_OK) {
         /* make Coverity happy */
@@ -48,6 +48,40 @@ uint16_t ucs_crc16_string(const char *s);
  */
 uint32_t ucs_crc32(uint32_t prev_crc, const void *buffer, size_t size);
 
+
+/**
+ * Calculate CRC32C (Castagnoli) of an arbitrary buffer. Uses the CRC
+ * instructions of the CPU when they are available.
+ *
+ * @param [in]  prev_crc   Initial CRC value, or the result of a previous call
+ *                         to continue the calculation over the next buffer.
+ * @param [in]  buffer     Buffer to compute crc for.
+ * @param [in]  size       Buffer size.
+ *
+ * @return crc32c() function of the buffer.
+ */
+uint32_t ucs_crc32c(uint32_t prev_crc, const void *buffer, size_t size);
+
+
+/**
+ * Initial value of a 64-bit FNV-1a hash.
+ */
+#define UCS_FNV1A64_INIT 0xcbf29ce484222325ul
+
+
+/**
+ * Calculate the 64-bit FNV-1a hash of an arbitrary buffer.
+ *
+ * @param [in]  prev_hash  Initial hash value, @ref UCS_FNV1A64_INIT or the
+ *                         result of a previous call to continue the
+ *                         calculation over the next buffer.
+ * @param [in]  buffer     Buffer to compute the hash for.
+ * @param [in]  size       Buffer size.
+ *
+ * @return FNV-1a hash of the buffer.
+ */
+uint64_t ucs_fnv1a64(uint64_t prev_hash, const void *buffer, size_t size);
+
 END_C_DECLS
 
 #endif
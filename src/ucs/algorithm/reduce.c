@@ -0,0 +1,285 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <ucs/algorithm/reduce.h>
+#include <ucs/arch/cpu.h>
+#include <ucs/debug/assert.h>
+#include <ucs/sys/compiler.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__)
+#  include <immintrin.h>
+#endif
+
+
+typedef void (*ucs_reduce_func_t)(void *dst, const void *src, size_t count);
+
+
+/*
+ * Portable kernels. The elements are accessed by memcpy(), since the arrays
+ * do not have to be aligned; the compiler still vectorizes the loops.
+ */
+#define UCS_REDUCE_SW_KERNEL(_name, _type, _expr) \
+    static void ucs_reduce_##_name##_sw(void *dst, const void *src, \
+                                        size_t count) \
+    { \
+        _type d, s; \
+        size_t i; \
+        \
+        for (i = 0; i < count; ++i) { \
+            memcpy(&d, UCS_PTR_BYTE_OFFSET(dst, i * sizeof(d)), sizeof(d)); \
+            memcpy(&s, UCS_PTR_BYTE_OFFSET(src, i * sizeof(s)), sizeof(s)); \
+            d = (_expr); \
+            memcpy(UCS_PTR_BYTE_OFFSET(dst, i * sizeof(d)), &d, sizeof(d)); \
+        } \
+    }
+
+/* Integer sum wraps around, like the vector instructions */
+UCS_REDUCE_SW_KERNEL(sum_int32,  int32_t, (int32_t)((uint32_t)d + (uint32_t)s))
+UCS_REDUCE_SW_KERNEL(sum_int64,  int64_t, (int64_t)((uint64_t)d + (uint64_t)s))
+UCS_REDUCE_SW_KERNEL(sum_float,  float,   d + s)
+UCS_REDUCE_SW_KERNEL(sum_double, double,  d + s)
+/* Returns the source element if any of them is NaN, like the vector
+ * instructions */
+UCS_REDUCE_SW_KERNEL(max_int32,  int32_t, (d > s) ? d : s)
+UCS_REDUCE_SW_KERNEL(max_int64,  int64_t, (d > s) ? d : s)
+UCS_REDUCE_SW_KERNEL(max_float,  float,   (d > s) ? d : s)
+UCS_REDUCE_SW_KERNEL(max_double, double,  (d > s) ? d : s)
+
+static uint16_t ucs_float_to_half_elem(uint32_t x)
+{
+    uint32_t sign = (x >> 16) & 0x8000;
+    uint32_t absx = x & 0x7fffffff;
+    uint32_t h, rem, mant, shift;
+
+    if (absx >= 0x7f800000) {
+        /* Infinity, or NaN which is kept quiet with the upper payload bits */
+        return sign | 0x7c00 |
+               ((absx > 0x7f800000) ? (0x200 | ((absx >> 13) & 0x3ff)) : 0);
+    } else if (absx >= 0x477ff000) {
+        /* Rounds to a value above the largest half, 65504 */
+        return sign | 0x7c00;
+    } else if (absx >= 0x38800000) {
+        /* Normal half: rebias the exponent from 127 to 15 */
+        h     = (absx - 0x38000000) >> 13;
+        rem   = absx;
+        shift = 13;
+    } else if (absx >= 0x33000000) {
+        /* Subnormal half: shift the mantissa with the implicit bit */
+        mant  = (absx & 0x7fffff) | 0x800000;
+        shift = 126 - (absx >> 23);
+        h     = mant >> shift;
+        rem   = mant;
+    } else {
+        /* Rounds to zero */
+        return sign;
+    }
+
+    /* Round to nearest even by the bits which were shifted out; a carry to
+     * the exponent gives the correct result */
+    rem &= UCS_MASK(shift);
+    if ((rem > UCS_BIT(shift - 1)) ||
+        ((rem == UCS_BIT(shift - 1)) && (h & 1))) {
+        ++h;
+    }
+
+    return sign | h;
+}
+
+static uint32_t ucs_half_to_float_elem(uint16_t h)
+{
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t exp  = (h >> 10) & 0x1f;
+    uint32_t mant = h & 0x3ff;
+
+    if (exp == 0x1f) {
+        return sign | 0x7f800000 | (mant << 13);
+    } else if (exp != 0) {
+        return sign | ((exp + 112) << 23) | (mant << 13);
+    } else if (mant == 0) {
+        return sign;
+    }
+
+    /* Subnormal half is a normal float */
+    exp = 1;
+    while (!(mant & 0x400)) {
+        mant <<= 1;
+        --exp;
+    }
+
+    return sign | ((exp + 112) << 23) | ((mant & 0x3ff) << 13);
+}
+
+static void ucs_float_to_half_sw(void *dst, const void *src, size_t count)
+{
+    uint32_t x;
+    uint16_t h;
+    size_t i;
+
+    for (i = 0; i < count; ++i) {
+        memcpy(&x, UCS_PTR_BYTE_OFFSET(src, i * sizeof(x)), sizeof(x));
+        h = ucs_float_to_half_elem(x);
+        memcpy(UCS_PTR_BYTE_OFFSET(dst, i * sizeof(h)), &h, sizeof(h));
+    }
+}
+
+static void ucs_half_to_float_sw(void *dst, const void *src, size_t count)
+{
+    uint32_t x;
+    uint16_t h;
+    size_t i;
+
+    for (i = 0; i < count; ++i) {
+        memcpy(&h, UCS_PTR_BYTE_OFFSET(src, i * sizeof(h)), sizeof(h));
+        x = ucs_half_to_float_elem(h);
+        memcpy(UCS_PTR_BYTE_OFFSET(dst, i * sizeof(x)), &x, sizeof(x));
+    }
+}
+
+#if defined(__x86_64__)
+
+/* The kernels are compiled for the instruction set which is checked at
+ * runtime, so the library does not have to be built with -mavx */
+#define UCS_REDUCE_X86_KERNEL(_name, _target, _type, _vec, _load, _store, _op) \
+    static __attribute__((target(_target))) void \
+    ucs_reduce_##_name##_x86(void *dst, const void *src, size_t count) \
+    { \
+        const size_t vec_count = sizeof(_vec) / sizeof(_type); \
+        _type *d               = dst; \
+        const _type *s         = src; \
+        \
+        for (; count >= vec_count; \
+             count -= vec_count, d += vec_count, s += vec_count) { \
+            _store((void*)d, _op(_load((const void*)d), \
+                                 _load((const void*)s))); \
+        } \
+        \
+        _mm256_zeroupper(); \
+        ucs_reduce_##_name##_sw(d, s, count); \
+    }
+
+UCS_REDUCE_X86_KERNEL(sum_int32, "avx2", int32_t, __m256i, _mm256_loadu_si256,
+                      _mm256_storeu_si256, _mm256_add_epi32)
+UCS_REDUCE_X86_KERNEL(sum_int64, "avx2", int64_t, __m256i, _mm256_loadu_si256,
+                      _mm256_storeu_si256, _mm256_add_epi64)
+UCS_REDUCE_X86_KERNEL(max_int32, "avx2", int32_t, __m256i, _mm256_loadu_si256,
+                      _mm256_storeu_si256, _mm256_max_epi32)
+UCS_REDUCE_X86_KERNEL(sum_float, "avx", float, __m256, _mm256_loadu_ps,
+                      _mm256_storeu_ps, _mm256_add_ps)
+UCS_REDUCE_X86_KERNEL(max_float, "avx", float, __m256, _mm256_loadu_ps,
+                      _mm256_storeu_ps, _mm256_max_ps)
+UCS_REDUCE_X86_KERNEL(sum_double, "avx", double, __m256d, _mm256_loadu_pd,
+                      _mm256_storeu_pd, _mm256_add_pd)
+UCS_REDUCE_X86_KERNEL(max_double, "avx", double, __m256d, _mm256_loadu_pd,
+                      _mm256_storeu_pd, _mm256_max_pd)
+
+static __attribute__((target("avx,f16c"))) void
+ucs_float_to_half_f16c(void *dst, const void *src, size_t count)
+{
+    uint16_t *d    = dst;
+    const float *s = src;
+
+    for (; count >= 8; count -= 8, d += 8, s += 8) {
+        _mm_storeu_si128((__m128i*)d,
+                         _mm256_cvtps_ph(_mm256_loadu_ps(s),
+                                         _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    _mm256_zeroupper();
+    ucs_float_to_half_sw(d, s, count);
+}
+
+static __attribute__((target("avx,f16c"))) void
+ucs_half_to_float_f16c(void *dst, const void *src, size_t count)
+{
+    float *d          = dst;
+    const uint16_t *s = src;
+
+    for (; count >= 8; count -= 8, d += 8, s += 8) {
+        _mm256_storeu_ps(d, _mm256_cvtph_ps(
+                                 _mm_loadu_si128((const __m128i*)s)));
+    }
+
+    _mm256_zeroupper();
+    ucs_half_to_float_sw(d, s, count);
+}
+
+#endif
+
+static ucs_reduce_func_t
+ucs_reduce_funcs[UCS_REDUCE_OP_LAST][UCS_REDUCE_TYPE_LAST] = {
+    [UCS_REDUCE_OP_SUM] = {
+        [UCS_REDUCE_TYPE_INT32]  = ucs_reduce_sum_int32_sw,
+        [UCS_REDUCE_TYPE_INT64]  = ucs_reduce_sum_int64_sw,
+        [UCS_REDUCE_TYPE_FLOAT]  = ucs_reduce_sum_float_sw,
+        [UCS_REDUCE_TYPE_DOUBLE] = ucs_reduce_sum_double_sw
+    },
+    [UCS_REDUCE_OP_MAX] = {
+        [UCS_REDUCE_TYPE_INT32]  = ucs_reduce_max_int32_sw,
+        [UCS_REDUCE_TYPE_INT64]  = ucs_reduce_max_int64_sw,
+        [UCS_REDUCE_TYPE_FLOAT]  = ucs_reduce_max_float_sw,
+        [UCS_REDUCE_TYPE_DOUBLE] = ucs_reduce_max_double_sw
+    }
+};
+
+static ucs_reduce_func_t ucs_float_to_half_func = ucs_float_to_half_sw;
+static ucs_reduce_func_t ucs_half_to_float_func = ucs_half_to_float_sw;
+
+void ucs_reduce(ucs_reduce_op_t op, ucs_reduce_type_t type, void *dst,
+                const void *src, size_t count)
+{
+    ucs_assert(op < UCS_REDUCE_OP_LAST);
+    ucs_assert(type < UCS_REDUCE_TYPE_LAST);
+    ucs_reduce_funcs[op][type](dst, src, count);
+}
+
+void ucs_float_to_half(void *dst, const void *src, size_t count)
+{
+    ucs_float_to_half_func(dst, src, count);
+}
+
+void ucs_half_to_float(void *dst, const void *src, size_t count)
+{
+    ucs_half_to_float_func(dst, src, count);
+}
+
+UCS_STATIC_INIT {
+#if defined(__x86_64__)
+    int cpu_flags = ucs_arch_get_cpu_flag();
+
+    if (cpu_flags & UCS_CPU_FLAG_AVX) {
+        ucs_reduce_funcs[UCS_REDUCE_OP_SUM][UCS_REDUCE_TYPE_FLOAT]  =
+                ucs_reduce_sum_float_x86;
+        ucs_reduce_funcs[UCS_REDUCE_OP_SUM][UCS_REDUCE_TYPE_DOUBLE] =
+                ucs_reduce_sum_double_x86;
+        ucs_reduce_funcs[UCS_REDUCE_OP_MAX][UCS_REDUCE_TYPE_FLOAT]  =
+                ucs_reduce_max_float_x86;
+        ucs_reduce_funcs[UCS_REDUCE_OP_MAX][UCS_REDUCE_TYPE_DOUBLE] =
+                ucs_reduce_max_double_x86;
+    }
+
+    if (cpu_flags & UCS_CPU_FLAG_AVX2) {
+        /* AVX2 has no 64-bit integer max */
+        ucs_reduce_funcs[UCS_REDUCE_OP_SUM][UCS_REDUCE_TYPE_INT32] =
+                ucs_reduce_sum_int32_x86;
+        ucs_reduce_funcs[UCS_REDUCE_OP_SUM][UCS_REDUCE_TYPE_INT64] =
+                ucs_reduce_sum_int64_x86;
+        ucs_reduce_funcs[UCS_REDUCE_OP_MAX][UCS_REDUCE_TYPE_INT32] =
+                ucs_reduce_max_int32_x86;
+    }
+
+    if (cpu_flags & UCS_CPU_FLAG_F16C) {
+        ucs_float_to_half_func = ucs_float_to_half_f16c;
+        ucs_half_to_float_func = ucs_half_to_float_f16c;
+    }
+#endif
+}
@@ -0,0 +1,78 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2021.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCS_ALGORITHM_REDUCE_H_
+#define UCS_ALGORITHM_REDUCE_H_
+
+#include <ucs/sys/compiler_def.h>
+
+#include <stddef.h>
+
+BEGIN_C_DECLS
+
+/** @file reduce.h */
+
+/**
+ * Element-wise reduction operation.
+ */
+typedef enum {
+    UCS_REDUCE_OP_SUM,   /**< dst[i] = dst[i] + src[i] */
+    UCS_REDUCE_OP_MAX,   /**< dst[i] = max(dst[i], src[i]) */
+    UCS_REDUCE_OP_LAST
+} ucs_reduce_op_t;
+
+
+/**
+ * Type of the reduced elements.
+ */
+typedef enum {
+    UCS_REDUCE_TYPE_INT32,
+    UCS_REDUCE_TYPE_INT64,
+    UCS_REDUCE_TYPE_FLOAT,
+    UCS_REDUCE_TYPE_DOUBLE,
+    UCS_REDUCE_TYPE_LAST
+} ucs_reduce_type_t;
+
+
+/**
+ * Apply a reduction operation on two arrays of elements, and store the result
+ * in the destination array. Uses the vector instructions of the CPU when they
+ * are available.
+ *
+ * @param [in]    op     Reduction operation.
+ * @param [in]    type   Type of the elements.
+ * @param [inout] dst    Destination array, does not have to be aligned.
+ * @param [in]    src    Source array, does not have to be aligned.
+ * @param [in]    count  Number of elements in each array.
+ */
+void ucs_reduce(ucs_reduce_op_t op, ucs_reduce_type_t type, void *dst,
+                const void *src, size_t count);
+
+
+/**
+ * Convert an array of single precision floats to IEEE 754 half precision,
+ * rounding to nearest even.
+ *
+ * @param [out] dst    Destination array of 16-bit values.
+ * @param [in]  src    Source array of floats.
+ * @param [in]  count  Number of elements to convert.
+ */
+void ucs_float_to_half(void *dst, const void *src, size_t count);
+
+
+/**
+ * Convert an array of IEEE 754 half precision values to single precision
+ * floats.
+ *
+ * @param [out] dst    Destination array of floats.
+ * @param [in]  src    Source array of 16-bit values.
+ * @param [in]  count  Number of elements to convert.
+ */
+void ucs_half_to_float(void *dst, const void *src, size_t count);
+
+END_C_DECLS
+
+#endif
@@ -51,7 +51,8 @@ typedef enum ucs_cpu_flag {
     UCS_CPU_FLAG_SSE41      = UCS_BIT(7),
     UCS_CPU_FLAG_SSE42      = UCS_BIT(8),
     UCS_CPU_FLAG_AVX        = UCS_BIT(9),
-    UCS_CPU_FLAG_AVX2       = UCS_BIT(10)
+    UCS_CPU_FLAG_AVX2       = UCS_BIT(10),
+    UCS_CPU_FLAG_F16C       = UCS_BIT(11)
 } ucs_cpu_flag_t;
 
 
@@ -85,6 +86,17 @@ typedef struct ucs_cpu_builtin_memcpy {
 } ucs_cpu_builtin_memcpy_t;
 
 
+/* Hint about how the buffers of a memory copy are going to be accessed */
+typedef enum ucs_arch_memcpy_hint {
+    UCS_ARCH_MEMCPY_NT_NONE,   /**< Both buffers are going to be accessed by
+                                    the local CPU */
+    UCS_ARCH_MEMCPY_NT_SOURCE, /**< Source is not going to be accessed by the
+                                    local CPU again */
+    UCS_ARCH_MEMCPY_NT_DEST    /**< Destination is going to be read by another
+                                    CPU or device */
+} ucs_arch_memcpy_hint_t;
+
+
 /* System constants */
 #define UCS_SYS_POINTER_SIZE       (sizeof(void*))
 #define UCS_SYS_PARAGRAPH_SIZE     16
@@ -80,7 +80,15 @@ static inline void ucs_arch_clear_cache(void *start, void *end)
 }
 #endif
 
-static inline void *ucs_memcpy_relaxed(void *dst, const void *src, size_t len)
+static UCS_F_ALWAYS_INLINE int
+ucs_memcpy_relaxed_is_nt(ucs_arch_memcpy_hint_t hint, size_t total_len)
+{
+    return 0;
+}
+
+static inline void *
+ucs_memcpy_relaxed(void *dst, const void *src, size_t len,
+                   ucs_arch_memcpy_hint_t hint, size_t total_len)
 {
     return memcpy(dst, src, len);
 }
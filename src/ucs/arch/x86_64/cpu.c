@@ -17,6 +17,8 @@
 #include <ucs/sys/math.h>
 #include <ucs/sys/sys.h>
 #include <ucs/sys/string.h>
+#include <emmintrin.h>
+#include <immintrin.h>
 
 #define X86_CPUID_GENUINEINTEL    "GenuntelineI" /* GenuineIntel in magic notation */
 #define X86_CPUID_AUTHENTICAMD    "AuthcAMDenti" /* AuthenticAMD in magic notation */
@@ -34,6 +36,12 @@
 #define X86_CPU_CACHE_TAG_L1_ONLY 0x40
 #define X86_CPU_CACHE_TAG_LEAF4   0xff
 
+/* Default non-temporal copy threshold, if the L2 cache size is unknown */
+#define X86_NT_BUFFER_TRANSFER_MIN_DEFAULT  (512 * UCS_KBYTE)
+
+/* Distance of the non-temporal prefetch of the source ahead of the copy */
+#define X86_NT_PREFETCH_DISTANCE  (4 * UCS_KBYTE)
+
 #if defined (__SSE4_1__)
 #define _mm_load(a)    _mm_stream_load_si128((__m128i *) (a))
 #define _mm_store(a,v) _mm_storeu_si128((__m128i *) (a), (v))
@@ -106,8 +114,18 @@ typedef struct ucs_x86_cpu_cache_size_codes {
 } ucs_x86_cpu_cache_size_codes_t;
 
 
+typedef void (*ucs_x86_memcpy_func_t)(void *dst, const void *src, size_t len);
+
+
 ucs_ternary_auto_value_t ucs_arch_x86_enable_rdtsc = UCS_TRY;
 
+static void ucs_x86_memcpy_nt_dest_sse2(void *dst, const void *src,
+                                        size_t len);
+
+/* Copy with non-temporal stores, selected by the CPU flags */
+static ucs_x86_memcpy_func_t ucs_x86_memcpy_nt_dest =
+        ucs_x86_memcpy_nt_dest_sse2;
+
 static const ucs_x86_cpu_cache_info_t x86_cpu_cache[] = {
     [UCS_CPU_CACHE_L1d] = {.level = 1, .type = X86_CPU_CACHE_TYPE_DATA},
     [UCS_CPU_CACHE_L1i] = {.level = 1, .type = X86_CPU_CACHE_TYPE_INSTRUCTION},
@@ -452,6 +470,9 @@ int ucs_arch_get_cpu_flag()
                 ucs_x86_xgetbv(0, _eax, _edx);
                 if ((_eax & 0x6) == 0x6) {
                     result |= UCS_CPU_FLAG_AVX;
+                    if (_ecx & (1 << 29)) {
+                        result |= UCS_CPU_FLAG_F16C;
+                    }
                 }
             }
         }
@@ -504,8 +525,129 @@ static size_t ucs_cpu_memcpy_thresh(size_t user_val, size_t auto_val)
 }
 #endif
 
+static size_t ucs_cpu_nt_buffer_transfer_min(size_t user_val)
+{
+    size_t l2_size;
+
+    if (user_val != UCS_MEMUNITS_AUTO) {
+        return user_val;
+    }
+
+    /* On AMD, temporal copies of large buffers which are not accessed again
+     * by the local CPU run far below the memory bandwidth. Switch to
+     * non-temporal copy once the transfer does not fit in the L2 cache. */
+    if (ucs_arch_get_cpu_vendor() != UCS_CPU_VENDOR_AMD) {
+        return UCS_MEMUNITS_INF;
+    }
+
+    l2_size = ucs_cpu_get_cache_size(UCS_CPU_CACHE_L2);
+    return (l2_size != 0) ? l2_size : X86_NT_BUFFER_TRANSFER_MIN_DEFAULT;
+}
+
+static UCS_F_ALWAYS_INLINE size_t
+ucs_x86_memcpy_align_dest(void **dst, const void **src, size_t len,
+                          size_t align)
+{
+    size_t head = ucs_min(len, (-(uintptr_t)*dst) & (align - 1));
+
+    memcpy(*dst, *src, head);
+    *dst = UCS_PTR_BYTE_OFFSET(*dst, head);
+    *src = UCS_PTR_BYTE_OFFSET(*src, head);
+    return len - head;
+}
+
+static void ucs_x86_memcpy_nt_dest_sse2(void *dst, const void *src,
+                                        size_t len)
+{
+    const __m128i *s;
+    __m128i *d;
+
+    len = ucs_x86_memcpy_align_dest(&dst, &src, len, sizeof(__m128i));
+    s   = src;
+    d   = dst;
+
+    for (; len >= (4 * sizeof(*d)); len -= 4 * sizeof(*d), s += 4, d += 4) {
+        _mm_stream_si128(d + 0, _mm_loadu_si128(s + 0));
+        _mm_stream_si128(d + 1, _mm_loadu_si128(s + 1));
+        _mm_stream_si128(d + 2, _mm_loadu_si128(s + 2));
+        _mm_stream_si128(d + 3, _mm_loadu_si128(s + 3));
+    }
+
+    for (; len >= sizeof(*d); len -= sizeof(*d), ++s, ++d) {
+        _mm_stream_si128(d, _mm_loadu_si128(s));
+    }
+
+    ucs_memory_bus_store_fence();
+    memcpy(d, s, len);
+}
+
+static __attribute__((target("avx2"))) void
+ucs_x86_memcpy_nt_dest_avx2(void *dst, const void *src, size_t len)
+{
+    const __m256i *s;
+    __m256i *d;
+
+    len = ucs_x86_memcpy_align_dest(&dst, &src, len, sizeof(__m256i));
+    s   = src;
+    d   = dst;
+
+    for (; len >= (4 * sizeof(*d)); len -= 4 * sizeof(*d), s += 4, d += 4) {
+        _mm256_stream_si256(d + 0, _mm256_loadu_si256(s + 0));
+        _mm256_stream_si256(d + 1, _mm256_loadu_si256(s + 1));
+        _mm256_stream_si256(d + 2, _mm256_loadu_si256(s + 2));
+        _mm256_stream_si256(d + 3, _mm256_loadu_si256(s + 3));
+    }
+
+    for (; len >= sizeof(*d); len -= sizeof(*d), ++s, ++d) {
+        _mm256_stream_si256(d, _mm256_loadu_si256(s));
+    }
+
+    _mm256_zeroupper();
+    ucs_memory_bus_store_fence();
+    memcpy(d, s, len);
+}
+
+/* Copy with the source prefetched to the non-temporal cache level, so it does
+ * not evict the data of the local CPU */
+static void ucs_x86_memcpy_nt_source(void *dst, const void *src, size_t len)
+{
+    size_t offset, chunk;
+
+    while (len > 0) {
+        chunk = ucs_min(len, X86_NT_PREFETCH_DISTANCE);
+        for (offset = X86_NT_PREFETCH_DISTANCE;
+             offset < ucs_min(len, 2 * X86_NT_PREFETCH_DISTANCE);
+             offset += UCS_ARCH_CACHE_LINE_SIZE) {
+            _mm_prefetch((const char*)src + offset, _MM_HINT_NTA);
+        }
+
+        memcpy(dst, src, chunk);
+        dst  = UCS_PTR_BYTE_OFFSET(dst, chunk);
+        src  = UCS_PTR_BYTE_OFFSET(src, chunk);
+        len -= chunk;
+    }
+}
+
+void ucs_x86_nt_buffer_transfer(void *dst, const void *src, size_t len,
+                                ucs_arch_memcpy_hint_t hint)
+{
+    if (hint == UCS_ARCH_MEMCPY_NT_DEST) {
+        ucs_x86_memcpy_nt_dest(dst, src, len);
+    } else {
+        ucs_assert(hint == UCS_ARCH_MEMCPY_NT_SOURCE);
+        ucs_x86_memcpy_nt_source(dst, src, len);
+    }
+}
+
 void ucs_cpu_init()
 {
+    ucs_global_opts.arch.nt_buffer_transfer_min =
+        ucs_cpu_nt_buffer_transfer_min(
+                ucs_global_opts.arch.nt_buffer_transfer_min);
+    if (ucs_arch_get_cpu_flag() & UCS_CPU_FLAG_AVX2) {
+        ucs_x86_memcpy_nt_dest = ucs_x86_memcpy_nt_dest_avx2;
+    }
+
 #if ENABLE_BUILTIN_MEMCPY
     ucs_global_opts.arch.builtin_memcpy_min =
         ucs_cpu_memcpy_thresh(ucs_global_opts.arch.builtin_memcpy_min,
@@ -53,6 +53,8 @@ ucs_cpu_vendor_t ucs_arch_get_cpu_vendor();
 void ucs_cpu_init();
 ucs_status_t ucs_arch_get_cache_size(size_t *cache_sizes);
 void ucs_x86_memcpy_sse_movntdqa(void *dst, const void *src, size_t len);
+void ucs_x86_nt_buffer_transfer(void *dst, const void *src, size_t len,
+                                ucs_arch_memcpy_hint_t hint);
 
 static inline int ucs_arch_x86_rdtsc_enabled()
 {
@@ -91,8 +93,31 @@ static inline void ucs_arch_clear_cache(void *start, void *end)
 }
 #endif
 
-static inline void *ucs_memcpy_relaxed(void *dst, const void *src, size_t len)
+/**
+ * Check whether copies of a transfer of @a total_len bytes with access hint
+ * @a hint are non-temporal.
+ */
+static UCS_F_ALWAYS_INLINE int
+ucs_memcpy_relaxed_is_nt(ucs_arch_memcpy_hint_t hint, size_t total_len)
+{
+    return (hint != UCS_ARCH_MEMCPY_NT_NONE) &&
+           (total_len >= ucs_global_opts.arch.nt_buffer_transfer_min);
+}
+
+/**
+ * Copy memory, choosing the strategy by the copy length, the total length of
+ * the transfer it is part of, and the access hint. Non-temporal copy is used
+ * for transfers which would otherwise evict useful data from the cache.
+ */
+static inline void *
+ucs_memcpy_relaxed(void *dst, const void *src, size_t len,
+                   ucs_arch_memcpy_hint_t hint, size_t total_len)
 {
+    if (ucs_unlikely(ucs_memcpy_relaxed_is_nt(hint, total_len))) {
+        ucs_x86_nt_buffer_transfer(dst, src, len, hint);
+        return dst;
+    }
+
 #if ENABLE_BUILTIN_MEMCPY
     if (ucs_unlikely((len > ucs_global_opts.arch.builtin_memcpy_min) &&
                      (len < ucs_global_opts.arch.builtin_memcpy_max))) {
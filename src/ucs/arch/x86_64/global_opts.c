@@ -23,12 +23,21 @@ ucs_config_field_t ucs_arch_global_opts_table[] = {
    "Maximal threshold of buffer length for using built-in memcpy.",
    ucs_offsetof(ucs_arch_global_opts_t, builtin_memcpy_max), UCS_CONFIG_TYPE_MEMUNITS},
 #endif
+
+  {"NT_BUFFER_TRANSFER_MIN", "auto",
+   "Minimal total length of a transfer for copying its data with non-temporal\n"
+   "loads or stores, when the source or the destination is not going to be\n"
+   "accessed by the local CPU. \"auto\" selects it by the CPU vendor and the\n"
+   "L2 cache size.",
+   ucs_offsetof(ucs_arch_global_opts_t, nt_buffer_transfer_min), UCS_CONFIG_TYPE_MEMUNITS},
+
   {NULL}
 };
 
 
 void ucs_arch_print_memcpy_limits(ucs_arch_global_opts_t *config)
 {
+    char nt_thresh_str[32];
 #if ENABLE_BUILTIN_MEMCPY
     char min_thresh_str[32];
     char max_thresh_str[32];
@@ -39,6 +48,11 @@ void ucs_arch_print_memcpy_limits(ucs_arch_global_opts_t *config)
                                 &config->builtin_memcpy_max, NULL);
     printf("# Using built-in memcpy() for size %s..%s\n", min_thresh_str, max_thresh_str);
 #endif
+
+    ucs_config_sprintf_memunits(nt_thresh_str, sizeof(nt_thresh_str),
+                                &config->nt_buffer_transfer_min, NULL);
+    printf("# Using non-temporal memcpy() for transfers of at least %s\n",
+           nt_thresh_str);
 }
 
 #endif
@@ -13,15 +13,17 @@
 
 BEGIN_C_DECLS
 
-#define UCS_ARCH_GLOBAL_OPTS_INITALIZER {   \
-    .builtin_memcpy_min = UCS_MEMUNITS_AUTO, \
-    .builtin_memcpy_max = UCS_MEMUNITS_AUTO  \
+#define UCS_ARCH_GLOBAL_OPTS_INITALIZER {       \
+    .builtin_memcpy_min     = UCS_MEMUNITS_AUTO, \
+    .builtin_memcpy_max     = UCS_MEMUNITS_AUTO, \
+    .nt_buffer_transfer_min = UCS_MEMUNITS_AUTO  \
 }
 
-/* built-in memcpy config */
+/* built-in and non-temporal memcpy config */
 typedef struct ucs_arch_global_opts {
     size_t builtin_memcpy_min;
     size_t builtin_memcpy_max;
+    size_t nt_buffer_transfer_min;
 } ucs_arch_global_opts_t;
 
 END_C_DECLS
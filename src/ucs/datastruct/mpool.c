@@ -13,6 +13,7 @@
 #include "queue.h"
 
 #include <ucs/debug/log.h>
+#include <ucs/memory/numa.h>
 #include <ucs/sys/math.h>
 #include <ucs/sys/checker.h>
 #include <ucs/sys/sys.h>
@@ -77,6 +78,8 @@ ucs_status_t ucs_mpool_init(ucs_mpool_t *mp, size_t priv_size,
     mp->data->chunks          = NULL;
     mp->data->ops             = ops;
     mp->data->name            = ucs_strdup(name, "mpool_data_name");
+    mp->data->placement.hugetlb     = UCS_AUTO;
+    mp->data->placement.numa_policy = UCS_NUMA_POLICY_DEFAULT;
 
     if (mp->data->name == NULL) {
         ucs_error("Failed to allocate memory pool data name");
@@ -151,11 +154,43 @@ void *ucs_mpool_priv(ucs_mpool_t *mp)
     return mp->data + 1;
 }
 
+size_t ucs_mpool_elem_size(ucs_mpool_t *mp)
+{
+    return ucs_mpool_elem_total_size(mp->data);
+}
+
 const char *ucs_mpool_name(ucs_mpool_t *mp)
 {
     return mp->data->name;
 }
 
+void ucs_mpool_set_chunk_placement(ucs_mpool_t *mp,
+                                   const ucs_mpool_chunk_placement_t *placement)
+{
+    ucs_assertv(mp->data->chunks == NULL,
+                "mpool %s: setting chunk placement after allocation",
+                ucs_mpool_name(mp));
+    mp->data->placement = *placement;
+}
+
+int ucs_mpool_chunk_placement_is_set(ucs_mpool_t *mp)
+{
+    return (mp->data->placement.hugetlb != UCS_AUTO) ||
+           (mp->data->placement.numa_policy != UCS_NUMA_POLICY_DEFAULT);
+}
+
+void ucs_mpool_chunk_place(ucs_mpool_t *mp, void *address, size_t length)
+{
+    ucs_status_t status;
+
+    status = ucs_numa_mem_bind(address, length,
+                               (ucs_numa_policy_t)mp->data->placement.numa_policy);
+    if (status != UCS_OK) {
+        ucs_debug("mpool %s: failed to set numa policy of chunk %p: %s",
+                  ucs_mpool_name(mp), address, ucs_status_string(status));
+    }
+}
+
 int ucs_mpool_is_empty(ucs_mpool_t *mp)
 {
     return (mp->freelist == NULL) && (mp->data->quota == 0);
@@ -245,12 +280,22 @@ void *ucs_mpool_get_grow(ucs_mpool_t *mp)
 
 ucs_status_t ucs_mpool_chunk_malloc(ucs_mpool_t *mp, size_t *size_p, void **chunk_p)
 {
+    if (ucs_mpool_chunk_placement_is_set(mp)) {
+        /* Heap memory placement cannot be controlled */
+        return ucs_mpool_chunk_mmap(mp, size_p, chunk_p);
+    }
+
     *chunk_p = ucs_malloc(*size_p, ucs_mpool_name(mp));
     return (*chunk_p == NULL) ? UCS_ERR_NO_MEMORY : UCS_OK;
 }
 
 void ucs_mpool_chunk_free(ucs_mpool_t *mp, void *chunk)
 {
+    if (ucs_mpool_chunk_placement_is_set(mp)) {
+        ucs_mpool_chunk_munmap(mp, chunk);
+        return;
+    }
+
     ucs_free(chunk);
 }
 
@@ -259,18 +304,69 @@ typedef struct ucs_mmap_mpool_chunk_hdr {
     size_t size;
 } ucs_mmap_mpool_chunk_hdr_t;
 
+static void *ucs_mpool_chunk_mmap_hugetlb(ucs_mpool_t *mp, size_t *size_p)
+{
+#ifdef MAP_HUGETLB
+    ssize_t huge_page_size;
+    size_t size;
+    void *ptr;
+
+    huge_page_size = ucs_get_huge_page_size();
+    if (huge_page_size <= 0) {
+        return MAP_FAILED;
+    }
+
+    size = ucs_align_up(*size_p, huge_page_size);
+    ptr  = ucs_mmap(NULL, size, PROT_READ|PROT_WRITE,
+                    MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0,
+                    ucs_mpool_name(mp));
+    if (ptr != MAP_FAILED) {
+        *size_p = size;
+    }
+
+    return ptr;
+#else
+    return MAP_FAILED;
+#endif
+}
+
 ucs_status_t ucs_mpool_chunk_mmap(ucs_mpool_t *mp, size_t *size_p, void **chunk_p)
 {
+    ucs_ternary_auto_value_t hugetlb = mp->data->placement.hugetlb;
     ucs_mmap_mpool_chunk_hdr_t *chunk;
     size_t real_size;
 
-    real_size = ucs_align_up(*size_p + sizeof(*chunk), ucs_get_page_size());
-    chunk = ucs_mmap(NULL, real_size, PROT_READ|PROT_WRITE,
-                     MAP_PRIVATE|MAP_ANONYMOUS, -1, 0, ucs_mpool_name(mp));
+    real_size = *size_p + sizeof(*chunk);
+    chunk     = MAP_FAILED;
+    if ((hugetlb == UCS_YES) || (hugetlb == UCS_TRY)) {
+        chunk = ucs_mpool_chunk_mmap_hugetlb(mp, &real_size);
+        if ((chunk == MAP_FAILED) && (hugetlb == UCS_YES)) {
+            ucs_debug("mpool %s: failed to map %zu bytes of huge pages",
+                      ucs_mpool_name(mp), real_size);
+            return UCS_ERR_NO_MEMORY;
+        }
+    }
+
     if (chunk == MAP_FAILED) {
-        return UCS_ERR_NO_MEMORY;
+        real_size = ucs_align_up(real_size, ucs_get_page_size());
+        chunk     = ucs_mmap(NULL, real_size, PROT_READ|PROT_WRITE,
+                             MAP_PRIVATE|MAP_ANONYMOUS, -1, 0,
+                             ucs_mpool_name(mp));
+        if (chunk == MAP_FAILED) {
+            return UCS_ERR_NO_MEMORY;
+        }
+
+#ifdef MADV_HUGEPAGE
+        /* Huge pages were not available, ask for transparent huge pages */
+        if ((hugetlb == UCS_TRY) && ucs_is_thp_enabled()) {
+            madvise(chunk, real_size, MADV_HUGEPAGE);
+        }
+#endif
     }
 
+    /* Memory was not touched yet, so NUMA policy affects all chunk pages */
+    ucs_mpool_chunk_place(mp, chunk, real_size);
+
     chunk->size = real_size;
     *size_p     = real_size - sizeof(*chunk);
     *chunk_p    = chunk + 1;
@@ -287,37 +383,65 @@ void ucs_mpool_chunk_munmap(ucs_mpool_t *mp, void *chunk)
 
 typedef struct ucs_hugetlb_mpool_chunk_hdr {
     int hugetlb;
+    int mmap;
 } ucs_hugetlb_mpool_chunk_hdr_t;
 
 ucs_status_t ucs_mpool_hugetlb_malloc(ucs_mpool_t *mp, size_t *size_p, void **chunk_p)
 {
+    ucs_ternary_auto_value_t hugetlb = mp->data->placement.hugetlb;
     ucs_hugetlb_mpool_chunk_hdr_t *chunk;
+    ucs_status_t status;
     size_t real_size;
-#ifdef SHM_HUGETLB
     void *ptr;
-    ucs_status_t status;
+#ifdef SHM_HUGETLB
     int shmid;
 #endif
 
 #ifdef SHM_HUGETLB
-    ptr = NULL;
-
-    /* First, try hugetlb */
-    real_size = *size_p;
-    status = ucs_sysv_alloc(&real_size, real_size * 2, (void**)&ptr, SHM_HUGETLB,
-                            ucs_mpool_name(mp), &shmid);
-    if (status == UCS_OK) {
-        chunk = ptr;
-        chunk->hugetlb = 1;
-        goto out_ok;
+    if (hugetlb != UCS_NO) {
+        ptr = NULL;
+
+        /* First, try hugetlb */
+        real_size = *size_p;
+        status = ucs_sysv_alloc(&real_size, real_size * 2, (void**)&ptr,
+                                SHM_HUGETLB, ucs_mpool_name(mp), &shmid);
+        if (status == UCS_OK) {
+            ucs_mpool_chunk_place(mp, ptr, real_size);
+            chunk = ptr;
+            chunk->hugetlb = 1;
+            chunk->mmap    = 0;
+            goto out_ok;
+        }
     }
 #endif
 
+    if (hugetlb == UCS_YES) {
+        ucs_debug("mpool %s: failed to allocate %zu bytes of huge pages",
+                  ucs_mpool_name(mp), *size_p);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    if (mp->data->placement.numa_policy != UCS_NUMA_POLICY_DEFAULT) {
+        /* Heap memory may be already touched, so use a new mapping which gets
+         * the NUMA policy before its first write */
+        real_size = *size_p;
+        status    = ucs_mpool_chunk_mmap(mp, &real_size, &ptr);
+        if (status == UCS_OK) {
+            chunk          = ptr;
+            chunk->hugetlb = 0;
+            chunk->mmap    = 1;
+            goto out_ok;
+        }
+
+        return status;
+    }
+
     /* Fallback to glibc */
     real_size = *size_p;
     chunk = ucs_malloc(real_size, ucs_mpool_name(mp));
     if (chunk != NULL) {
         chunk->hugetlb = 0;
+        chunk->mmap    = 0;
         goto out_ok;
     }
 
@@ -336,6 +460,8 @@ void ucs_mpool_hugetlb_free(ucs_mpool_t *mp, void *chunk)
     hdr = (ucs_hugetlb_mpool_chunk_hdr_t*)chunk - 1;
     if (hdr->hugetlb) {
         ucs_sysv_free(hdr);
+    } else if (hdr->mmap) {
+        ucs_mpool_chunk_munmap(mp, hdr);
     } else {
         ucs_free(hdr);
     }
@@ -8,6 +8,7 @@
 #define UCS_MPOOL_H_
 
 #include <stddef.h>
+#include <ucs/config/types.h>
 #include <ucs/type/status.h>
 #include <ucs/sys/compiler_def.h>
 
@@ -20,6 +21,7 @@ typedef union  ucs_mpool_elem    ucs_mpool_elem_t;
 typedef struct ucs_mpool         ucs_mpool_t;
 typedef struct ucs_mpool_data    ucs_mpool_data_t;
 typedef struct ucs_mpool_ops     ucs_mpool_ops_t;
+typedef struct ucs_mpool_chunk_placement ucs_mpool_chunk_placement_t;
 
 
 /**
@@ -58,6 +60,18 @@ struct ucs_mpool_chunk {
 };
 
 
+/**
+ * Memory pool chunk placement. Chunk allocators which support it use these
+ * hints to select the page size and NUMA node of the chunk memory.
+ */
+struct ucs_mpool_chunk_placement {
+    ucs_ternary_auto_value_t hugetlb;     /* Back chunks by huge pages. AUTO
+                                             means allocator's default */
+    int                      numa_policy; /* NUMA policy of chunks memory, one
+                                             of ucs_numa_policy_t */
+};
+
+
 /**
  * Memory pool structure.
  */
@@ -80,6 +94,7 @@ struct ucs_mpool_data {
     ucs_mpool_chunk_t      *chunks;         /* List of allocated chunks */
     ucs_mpool_ops_t        *ops;            /* Memory pool operations */
     char                   *name;           /* Name - used for debugging */
+    ucs_mpool_chunk_placement_t placement;  /* Chunk memory placement */
 };
 
 
@@ -178,6 +193,46 @@ const char *ucs_mpool_name(ucs_mpool_t *mp);
 void *ucs_mpool_priv(ucs_mpool_t *mp);
 
 
+/**
+ * @param mp               Memory pool structure.
+ *
+ * @return Memory taken by one element in a chunk, including the element header
+ *         and alignment padding.
+ */
+size_t ucs_mpool_elem_size(ucs_mpool_t *mp);
+
+
+/**
+ * Set the placement of chunks allocated by the memory pool from now on.
+ * Should be called before the first chunk is allocated.
+ *
+ * @param mp               Memory pool structure.
+ * @param placement        Chunk placement hints.
+ */
+void ucs_mpool_set_chunk_placement(ucs_mpool_t *mp,
+                                   const ucs_mpool_chunk_placement_t *placement);
+
+
+/**
+ * @param mp               Memory pool structure.
+ *
+ * @return Whether the memory pool chunk placement differs from the default,
+ *         i.e was set by @ref ucs_mpool_set_chunk_placement.
+ */
+int ucs_mpool_chunk_placement_is_set(ucs_mpool_t *mp);
+
+
+/**
+ * Apply the NUMA placement of a memory pool to a newly allocated chunk memory.
+ * Should be called by chunk allocators before the memory is touched.
+ *
+ * @param mp               Memory pool structure.
+ * @param address          Chunk memory start.
+ * @param length           Chunk memory length.
+ */
+void ucs_mpool_chunk_place(ucs_mpool_t *mp, void *address, size_t length);
+
+
 /**
  * Check if a memory pool is empty (cannot allocate more objects).
  *
@@ -227,21 +282,24 @@ void *ucs_mpool_get_grow(ucs_mpool_t *mp);
 
 
 /**
- * heap-based chunk allocator.
+ * heap-based chunk allocator. If the memory pool chunk placement is set, uses
+ * the mmap chunk allocator instead.
  */
 ucs_status_t ucs_mpool_chunk_malloc(ucs_mpool_t *mp, size_t *size_p, void **chunk_p);
 void ucs_mpool_chunk_free(ucs_mpool_t *mp, void *chunk);
 
 
 /*
- * mmap chunk allocator.
+ * mmap chunk allocator. Honors the memory pool chunk placement: if huge pages
+ * are requested, tries to map the chunk with MAP_HUGETLB first.
  */
 ucs_status_t ucs_mpool_chunk_mmap(ucs_mpool_t *mp, size_t *size_p, void **chunk_p);
 void ucs_mpool_chunk_munmap(ucs_mpool_t *mp, void *chunk);
 
 
 /**
- * hugetlb chunk allocator.
+ * hugetlb chunk allocator. Tries SysV huge pages unless the memory pool chunk
+ * placement disables them, and falls back to heap unless it requires them.
  */
 ucs_status_t ucs_mpool_hugetlb_malloc(ucs_mpool_t *mp, size_t *size_p, void **chunk_p);
 void ucs_mpool_hugetlb_free(ucs_mpool_t *mp, void *chunk);
@@ -11,6 +11,7 @@
 #include "memtype_cache.h"
 
 #include <ucs/arch/atomic.h>
+#include <ucs/arch/cpu.h>
 #include <ucs/type/class.h>
 #include <ucs/datastruct/queue.h>
 #include <ucs/debug/log.h>
@@ -28,6 +29,26 @@ typedef enum {
 } ucs_memtype_cache_action_t;
 
 
+/* Copy of the last lookup result of the current thread */
+typedef struct {
+    const ucs_memtype_cache_t *memtype_cache; /* Cache the result belongs to */
+    uint64_t                  generation;     /* Cache generation of the result */
+    ucs_pgt_addr_t            start;          /* Start of the looked-up range */
+    ucs_pgt_addr_t            end;            /* End of the looked-up range */
+    ucs_status_t              status;         /* UCS_OK if the range is a cache
+                                                 region, UCS_ERR_NO_ELEM if it
+                                                 is not in the cache */
+    ucs_memory_info_t         mem_info;       /* Memory info of the region */
+} ucs_memtype_cache_last_t;
+
+
+/* Generations are unique across all caches, so a last lookup result is never
+ * matched by a new cache created at the same address */
+static uint64_t ucs_memtype_cache_generation = 0;
+
+static __thread ucs_memtype_cache_last_t ucs_memtype_cache_last = {NULL};
+
+
 static UCS_F_ALWAYS_INLINE void
 ucs_memory_info_set_unknown(ucs_memory_info_t *mem_info)
 {
@@ -35,6 +56,15 @@ ucs_memory_info_set_unknown(ucs_memory_info_t *mem_info)
     mem_info->sys_dev = UCS_SYS_DEVICE_ID_UNKNOWN;
 }
 
+static void ucs_memtype_cache_new_generation(ucs_memtype_cache_t *memtype_cache)
+{
+    memtype_cache->generation =
+            ucs_atomic_fadd64(&ucs_memtype_cache_generation, 1) + 1;
+    /* Lookups should observe the new generation before the page table is
+     * modified */
+    ucs_memory_cpu_store_fence();
+}
+
 static ucs_pgt_dir_t *ucs_memtype_cache_pgt_dir_alloc(const ucs_pgtable_t *pgtable)
 {
     void *ptr;
@@ -147,6 +177,8 @@ UCS_PROFILE_FUNC_VOID(ucs_memtype_cache_update_internal,
 
     pthread_rwlock_wrlock(&memtype_cache->lock);
 
+    ucs_memtype_cache_new_generation(memtype_cache);
+
     /* find and remove all regions which intersect with new one */
     ucs_pgtable_search_range(&memtype_cache->pgtable, search_start, search_end,
                              ucs_memtype_cache_region_collect_callback,
@@ -263,38 +295,157 @@ static void ucs_memtype_cache_purge(ucs_memtype_cache_t *memtype_cache)
     }
 }
 
-UCS_PROFILE_FUNC(ucs_status_t, ucs_memtype_cache_lookup,
-                 (memtype_cache, address, size, mem_info),
-                 ucs_memtype_cache_t *memtype_cache, const void *address,
-                 size_t size, ucs_memory_info_t *mem_info)
+static UCS_F_ALWAYS_INLINE int
+ucs_memtype_cache_last_is_valid(const ucs_memtype_cache_t *memtype_cache)
 {
-    const ucs_pgt_addr_t start = (uintptr_t)address;
+    return (ucs_memtype_cache_last.memtype_cache == memtype_cache) &&
+           (ucs_memtype_cache_last.generation == memtype_cache->generation);
+}
+
+/* Lookup the last result of the current thread, return 0 if not found */
+static UCS_F_ALWAYS_INLINE int
+ucs_memtype_cache_lookup_last(const ucs_memtype_cache_t *memtype_cache,
+                              ucs_pgt_addr_t start, size_t size,
+                              ucs_memory_info_t *mem_info,
+                              ucs_status_t *status_p)
+{
+    const ucs_memtype_cache_last_t *last = &ucs_memtype_cache_last;
+
+    if (!ucs_memtype_cache_last_is_valid(memtype_cache) ||
+        (start < last->start) || (start >= last->end)) {
+        return 0;
+    }
+
+    if (last->status != UCS_OK) {
+        /* The aligned block of the start address is not in the cache */
+        *status_p = last->status;
+        return 1;
+    }
+
+    if ((start + size) > last->end) {
+        return 0;
+    }
+
+    *mem_info = last->mem_info;
+    *status_p = UCS_OK;
+    return 1;
+}
+
+/* Lock must be held in read mode */
+static ucs_status_t
+ucs_memtype_cache_lookup_locked(ucs_memtype_cache_t *memtype_cache,
+                                ucs_pgt_addr_t start, size_t size,
+                                ucs_memory_info_t *mem_info)
+{
+    ucs_memtype_cache_last_t *last = &ucs_memtype_cache_last;
     ucs_memtype_cache_region_t *region;
     ucs_pgt_region_t *pgt_region;
     ucs_status_t status;
 
-    pthread_rwlock_rdlock(&memtype_cache->lock);
+    if (ucs_memtype_cache_lookup_last(memtype_cache, start, size, mem_info,
+                                      &status)) {
+        return status;
+    }
+
+    last->memtype_cache = memtype_cache;
+    last->generation    = memtype_cache->generation;
 
     pgt_region = UCS_PROFILE_CALL(ucs_pgtable_lookup, &memtype_cache->pgtable,
                                   start);
     if (pgt_region == NULL) {
-        status = UCS_ERR_NO_ELEM;
-        goto out_unlock;
+        /* Regions are aligned, so the whole aligned block is not cached */
+        last->start  = ucs_align_down_pow2(start, UCS_PGT_ADDR_ALIGN);
+        last->end    = last->start + UCS_PGT_ADDR_ALIGN;
+        last->status = UCS_ERR_NO_ELEM;
+        return UCS_ERR_NO_ELEM;
     }
 
+    region         = ucs_derived_of(pgt_region, ucs_memtype_cache_region_t);
+    last->start    = pgt_region->start;
+    last->end      = pgt_region->end;
+    last->status   = UCS_OK;
+    last->mem_info = region->mem_info;
+
     if (ucs_likely((start + size) <= pgt_region->end)) {
-        region    = ucs_derived_of(pgt_region, ucs_memtype_cache_region_t);
         *mem_info = region->mem_info;
     } else {
         ucs_memory_info_set_unknown(mem_info);
     }
-    status = UCS_OK;
 
-out_unlock:
+    return UCS_OK;
+}
+
+UCS_PROFILE_FUNC(ucs_status_t, ucs_memtype_cache_lookup,
+                 (memtype_cache, address, size, mem_info),
+                 ucs_memtype_cache_t *memtype_cache, const void *address,
+                 size_t size, ucs_memory_info_t *mem_info)
+{
+    const ucs_pgt_addr_t start = (uintptr_t)address;
+    ucs_status_t status;
+
+    /* Fast path: consecutive lookups usually hit the same region */
+    if (ucs_memtype_cache_lookup_last(memtype_cache, start, size, mem_info,
+                                      &status)) {
+        return status;
+    }
+
+    pthread_rwlock_rdlock(&memtype_cache->lock);
+    status = ucs_memtype_cache_lookup_locked(memtype_cache, start, size,
+                                             mem_info);
     pthread_rwlock_unlock(&memtype_cache->lock);
     return status;
 }
 
+UCS_PROFILE_FUNC(ucs_status_t, ucs_memtype_cache_lookup_iov,
+                 (memtype_cache, iov, iovcnt, mem_info),
+                 ucs_memtype_cache_t *memtype_cache, const struct iovec *iov,
+                 size_t iovcnt, ucs_memory_info_t *mem_info)
+{
+    size_t num_found   = 0;
+    size_t num_missing = 0;
+    ucs_memory_info_t iov_mem_info;
+    ucs_status_t status;
+    size_t i;
+
+    pthread_rwlock_rdlock(&memtype_cache->lock);
+
+    for (i = 0; i < iovcnt; ++i) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+
+        status = ucs_memtype_cache_lookup_locked(memtype_cache,
+                                                 (uintptr_t)iov[i].iov_base,
+                                                 iov[i].iov_len, &iov_mem_info);
+        if (status != UCS_OK) {
+            ++num_missing;
+            continue;
+        }
+
+        if (num_found == 0) {
+            *mem_info = iov_mem_info;
+        } else if ((mem_info->type != iov_mem_info.type) ||
+                   (mem_info->sys_dev != iov_mem_info.sys_dev)) {
+            ucs_memory_info_set_unknown(mem_info);
+        }
+
+        ++num_found;
+    }
+
+    pthread_rwlock_unlock(&memtype_cache->lock);
+
+    if (num_found == 0) {
+        return UCS_ERR_NO_ELEM;
+    }
+
+    if (num_missing > 0) {
+        /* Mix of cached and not cached memory */
+        ucs_memory_info_set_unknown(mem_info);
+    }
+
+    return UCS_OK;
+}
+
 static UCS_CLASS_INIT_FUNC(ucs_memtype_cache_t)
 {
     ucs_status_t status;
@@ -313,6 +464,8 @@ static UCS_CLASS_INIT_FUNC(ucs_memtype_cache_t)
         goto err_destroy_rwlock;
     }
 
+    ucs_memtype_cache_new_generation(self);
+
     status = ucm_set_event_handler(UCM_EVENT_MEM_TYPE_ALLOC |
                                    UCM_EVENT_MEM_TYPE_FREE |
                                    UCM_EVENT_FLAG_EXISTING_ALLOC,
@@ -15,6 +15,7 @@
 #include <ucs/sys/compiler_def.h>
 #include <ucs/sys/topo.h>
 #include <pthread.h>
+#include <sys/uio.h>
 
 
 BEGIN_C_DECLS
@@ -41,6 +42,8 @@ struct ucs_memtype_cache_region {
 struct ucs_memtype_cache {
     pthread_rwlock_t      lock;       /**< protests the page table */
     ucs_pgtable_t         pgtable;    /**< Page table to hold the regions */
+    volatile uint64_t     generation; /**< Changed on every update, invalidates
+                                           the per-thread last lookup result */
 };
 
 
@@ -80,6 +83,28 @@ ucs_status_t ucs_memtype_cache_lookup(ucs_memtype_cache_t *memtype_cache,
                                       ucs_memory_info_t *mem_info);
 
 
+/**
+ * Find the memory type of several address ranges at once. The cache lock is
+ * taken only once for all ranges, and consecutive ranges which fall into the
+ * same region are resolved without page table lookup.
+ *
+ * @param [in]  memtype_cache   Memtype cache to search.
+ * @param [in]  iov             Array of address ranges to lookup.
+ * @param [in]  iovcnt          Number of entries in @a iov.
+ * @param [out] mem_info        Set to the memory info of all address ranges,
+ *                              or to UCS_MEMORY_TYPE_UNKNOWN if the ranges
+ *                              have different memory info, or some of them are
+ *                              not in the cache.
+ *
+ * @return UCS_ERR_NO_ELEM if none of the ranges is in the cache, otherwise
+ *         UCS_OK.
+ */
+ucs_status_t ucs_memtype_cache_lookup_iov(ucs_memtype_cache_t *memtype_cache,
+                                          const struct iovec *iov,
+                                          size_t iovcnt,
+                                          ucs_memory_info_t *mem_info);
+
+
 /**
  * Update the memory type of an address range.
  * Can be used after @ucs_memtype_cache_lookup returns UCM_MEM_TYPE_LAST, to
@@ -12,6 +12,8 @@
 
 #include <ucs/debug/assert.h>
 #include <ucs/debug/log.h>
+#include <ucs/sys/math.h>
+#include <ucs/sys/sys.h>
 #include <stdint.h>
 #include <sched.h>
 
@@ -71,4 +73,71 @@ int ucs_numa_node_of_cpu(int cpu)
     return cpu_numa_nodes[cpu] - 1;
 }
 
+ucs_status_t ucs_numa_mem_bind(void *address, size_t length,
+                               ucs_numa_policy_t policy)
+{
+    struct bitmask *nodemask;
+    uintptr_t start, end;
+    ucs_status_t status;
+    int ret, mode;
+
+    switch (policy) {
+    case UCS_NUMA_POLICY_DEFAULT:
+        return UCS_OK;
+    case UCS_NUMA_POLICY_BIND:
+        mode = MPOL_BIND;
+        break;
+    case UCS_NUMA_POLICY_PREFERRED:
+        mode = MPOL_PREFERRED;
+        break;
+    default:
+        ucs_error("unexpected numa policy %d", policy);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    if (numa_available() < 0) {
+        return UCS_OK;
+    }
+
+    /* Apply the policy only on whole pages of the range */
+    start = ucs_align_up_pow2((uintptr_t)address, ucs_get_page_size());
+    end   = ucs_align_down_pow2((uintptr_t)address + length,
+                                ucs_get_page_size());
+    if (start >= end) {
+        return UCS_OK;
+    }
+
+    nodemask = numa_allocate_nodemask();
+    if (nodemask == NULL) {
+        ucs_warn("failed to allocate numa node mask");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    numa_get_thread_node_mask(&nodemask);
+
+    ucs_trace("0x%lx..0x%lx: setting numa policy %s, nodemask[0]=0x%lx", start,
+              end, ucs_numa_policy_names[policy], numa_nodemask_p(nodemask)[0]);
+
+    ret = mbind((void*)start, end - start, mode, numa_nodemask_p(nodemask),
+                numa_nodemask_size(nodemask), 0);
+    if (ret < 0) {
+        ucs_debug("mbind(addr=0x%lx length=%ld policy=%d) failed: %m", start,
+                  end - start, mode);
+        status = UCS_ERR_IO_ERROR;
+    } else {
+        status = UCS_OK;
+    }
+
+    numa_free_nodemask(nodemask);
+    return status;
+}
+
+#else
+
+ucs_status_t ucs_numa_mem_bind(void *address, size_t length,
+                               ucs_numa_policy_t policy)
+{
+    return UCS_OK;
+}
+
 #endif
@@ -12,6 +12,7 @@
 #endif
 
 #include <ucs/debug/memtrack.h>
+#include <ucs/type/status.h>
 
 #if HAVE_NUMA
 #include <numaif.h>
@@ -62,4 +63,21 @@ extern const char *ucs_numa_policy_names[];
 int ucs_numa_node_of_cpu(int cpu);
 
 
+/**
+ * Set the NUMA policy of a memory range to the NUMA nodes on which the calling
+ * thread is allowed to run. Should be called before the memory is touched,
+ * since pages which were already faulted-in are not migrated.
+ *
+ * @param address   Start of the memory range.
+ * @param length    Length of the memory range.
+ * @param policy    NUMA policy to set. @ref UCS_NUMA_POLICY_DEFAULT leaves the
+ *                  memory range unchanged.
+ *
+ * @return UCS_OK if the policy was set or NUMA is not supported, or error code
+ *         if failed to set the policy.
+ */
+ucs_status_t ucs_numa_mem_bind(void *address, size_t length,
+                               ucs_numa_policy_t policy);
+
+
 #endif
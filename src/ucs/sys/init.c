@@ -45,6 +45,7 @@ static UCS_F_NOOPTIMIZE void ucs_check_cpu_flags(void)
         { "sse42", UCS_CPU_FLAG_SSE42 },
         { "avx", UCS_CPU_FLAG_AVX },
         { "avx2", UCS_CPU_FLAG_AVX2 },
+        { "f16c", UCS_CPU_FLAG_F16C },
         { NULL, UCS_CPU_FLAG_UNKNOWN },
     };
 
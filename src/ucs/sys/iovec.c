@@ -9,6 +9,7 @@
 #endif
 
 #include <ucs/sys/iovec.h>
+#include <ucs/sys/iovec.inl>
 #include <ucs/sys/math.h>
 
 #include <string.h>
@@ -41,9 +42,9 @@ size_t ucs_iov_copy(const struct iovec *iov, size_t iov_cnt,
 
         len = ucs_min(len, max_copy);
         if (dir == UCS_IOV_COPY_FROM_BUF) {
-            memcpy(iov_buf, UCS_PTR_BYTE_OFFSET(buf, copied), len);
+            ucs_iov_memcpy(iov_buf, UCS_PTR_BYTE_OFFSET(buf, copied), len);
         } else if (dir == UCS_IOV_COPY_TO_BUF) {
-            memcpy(UCS_PTR_BYTE_OFFSET(buf, copied), iov_buf, len);
+            ucs_iov_memcpy(UCS_PTR_BYTE_OFFSET(buf, copied), iov_buf, len);
         }
 
         iov_offset  = 0;
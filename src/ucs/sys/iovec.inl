@@ -11,6 +11,8 @@
 #include <ucs/sys/iovec.h>
 #include <ucs/debug/assert.h>
 
+#include <string.h>
+
 
 /**
  * Fill the destination array of IOVs by data provided in the source
@@ -202,4 +204,43 @@ size_t ucs_iovec_total_length(const struct iovec *iov, size_t iov_cnt)
     return ucs_iov_total_length(iov, iov_cnt, ucs_iovec_get_length);
 }
 
+/**
+ * Copy the data of an IOV element. Elements of up to 16 bytes, which are
+ * common in scatter-gather lists of small fields, are copied by overlapping
+ * loads and stores of registers instead of a call to memcpy().
+ *
+ * @param [out] dst       Destination buffer.
+ * @param [in]  src       Source buffer, must not overlap @a dst.
+ * @param [in]  length    Number of bytes to copy.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucs_iov_memcpy(void *dst, const void *src, size_t length)
+{
+    uint64_t head64, tail64;
+    uint32_t head32, tail32;
+
+    if (length > (2 * sizeof(head64))) {
+        memcpy(dst, src, length);
+    } else if (length >= sizeof(head64)) {
+        memcpy(&head64, src, sizeof(head64));
+        memcpy(&tail64, UCS_PTR_BYTE_OFFSET(src, length - sizeof(tail64)),
+               sizeof(tail64));
+        memcpy(dst, &head64, sizeof(head64));
+        memcpy(UCS_PTR_BYTE_OFFSET(dst, length - sizeof(tail64)), &tail64,
+               sizeof(tail64));
+    } else if (length >= sizeof(head32)) {
+        memcpy(&head32, src, sizeof(head32));
+        memcpy(&tail32, UCS_PTR_BYTE_OFFSET(src, length - sizeof(tail32)),
+               sizeof(tail32));
+        memcpy(dst, &head32, sizeof(head32));
+        memcpy(UCS_PTR_BYTE_OFFSET(dst, length - sizeof(tail32)), &tail32,
+               sizeof(tail32));
+    } else if (length > 0) {
+        /* 1 to 3 bytes */
+        ((uint8_t*)dst)[0]              = ((const uint8_t*)src)[0];
+        ((uint8_t*)dst)[length / 2]     = ((const uint8_t*)src)[length / 2];
+        ((uint8_t*)dst)[length - 1]     = ((const uint8_t*)src)[length - 1];
+    }
+}
+
 #endif
@@ -1487,3 +1487,45 @@ ucs_status_t ucs_sys_get_file_time(const char *name, ucs_sys_file_time_t type,
         return UCS_ERR_INVALID_PARAM;
     }
 }
+
+ucs_status_t ucs_sys_write_file_atomic(const char *filename,
+                                       ucs_sys_write_file_cb_t cb, void *ctx)
+{
+    char tmp_filename[PATH_MAX];
+    ucs_status_t status;
+    FILE *stream;
+
+    /* The temporary file is in the same directory, so that rename() replaces
+     * the target atomically */
+    ucs_snprintf_zero(tmp_filename, sizeof(tmp_filename), "%s.%d", filename,
+                      getpid());
+    stream = fopen(tmp_filename, "w");
+    if (stream == NULL) {
+        ucs_debug("failed to create %s: %m", tmp_filename);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    status = cb(stream, ctx);
+    if (status != UCS_OK) {
+        fclose(stream);
+        goto err_unlink;
+    }
+
+    if (fclose(stream) != 0) {
+        ucs_debug("failed to write %s: %m", tmp_filename);
+        status = UCS_ERR_IO_ERROR;
+        goto err_unlink;
+    }
+
+    if (rename(tmp_filename, filename) != 0) {
+        ucs_debug("failed to rename %s to %s: %m", tmp_filename, filename);
+        status = UCS_ERR_IO_ERROR;
+        goto err_unlink;
+    }
+
+    return UCS_OK;
+
+err_unlink:
+    unlink(tmp_filename);
+    return status;
+}
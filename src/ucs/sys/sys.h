@@ -120,6 +120,12 @@ typedef void (*ucs_sys_vma_cb_t)(ucs_sys_vma_info_t *info, void *ctx);
 typedef ucs_status_t (*ucs_sys_readdir_cb_t)(struct dirent *entry, void *ctx);
 
 
+/**
+ * Callback function type used in ucs_sys_write_file_atomic.
+ */
+typedef ucs_status_t (*ucs_sys_write_file_cb_t)(FILE *stream, void *ctx);
+
+
 /**
  * Callback function type used in ucs_sys_enum_threads.
  */
@@ -609,6 +615,21 @@ ucs_status_t ucs_sys_enum_threads(ucs_sys_enum_threads_cb_t cb, void *ctx);
 ucs_status_t ucs_sys_get_file_time(const char *name, ucs_sys_file_time_t type,
                                    ucs_time_t *time);
 
+
+/**
+ * Write a file atomically: the contents are written to a temporary file which
+ * then replaces @a filename, so that concurrent readers never see a partially
+ * written file. If writing fails, @a filename is left unchanged.
+ *
+ * @param [in]  filename   File name.
+ * @param [in]  cb         Callback function which writes the file contents.
+ * @param [in]  ctx        Context argument passed to @a cb call.
+ *
+ * @return UCS_OK if the file was written, otherwise an error code.
+ */
+ucs_status_t ucs_sys_write_file_atomic(const char *filename,
+                                       ucs_sys_write_file_cb_t cb, void *ctx);
+
 END_C_DECLS
 
 #endif
@@ -10,12 +10,144 @@
 
 #include <ucs/time/timer_wheel.h>
 
+#include <ucs/arch/bitops.h>
 #include <ucs/debug/assert.h>
 #include <ucs/debug/log.h>
 #include <ucs/debug/memtrack.h>
 #include <ucs/sys/math.h>
 
 
+#define UCS_TWHEEL_SLOT_MASK  (UCS_BIT(UCS_TWHEEL_SLOTS_ORDER) - 1)
+
+
+static UCS_F_ALWAYS_INLINE unsigned ucs_twheel_level_shift(unsigned level)
+{
+    return level * UCS_TWHEEL_SLOTS_ORDER;
+}
+
+static UCS_F_ALWAYS_INLINE ucs_list_link_t *
+ucs_twheel_slot(ucs_twheel_t *t, unsigned level, unsigned index)
+{
+    return &t->wheel[(level << UCS_TWHEEL_SLOTS_ORDER) + index];
+}
+
+/*
+ * Insert a timer to the lowest level which covers its expiration tick. A
+ * timer which expires on the current tick is inserted to the current slot of
+ * level 0, so it is expected to be called only before that slot is processed.
+ */
+static void ucs_twheel_insert(ucs_twheel_t *t, ucs_wtimer_t *timer)
+{
+    uint64_t expires = timer->expires;
+    unsigned level, shift, index;
+
+    ucs_assert(expires >= t->current);
+
+    for (level = 0; level < UCS_TWHEEL_NUM_LEVELS - 1; ++level) {
+        shift = ucs_twheel_level_shift(level);
+        if (((expires >> shift) - (t->current >> shift)) <=
+            UCS_TWHEEL_SLOT_MASK) {
+            break;
+        }
+    }
+
+    shift = ucs_twheel_level_shift(level);
+    if (((expires >> shift) - (t->current >> shift)) > UCS_TWHEEL_SLOT_MASK) {
+        /* Beyond the wheel range: park in the farthest slot of the top level,
+         * and the timer is inserted again when the wheel gets there */
+        expires = t->current + ((uint64_t)UCS_TWHEEL_SLOT_MASK << shift);
+    }
+
+    index = (expires >> shift) & UCS_TWHEEL_SLOT_MASK;
+    ucs_list_add_tail(ucs_twheel_slot(t, level, index), &timer->list);
+    t->slot_map[level] |= UCS_BIT(index);
+}
+
+/*
+ * Find the next tick after the current one on which some slot should be
+ * processed: a level 0 slot expires, or a higher level slot is moved down.
+ */
+static uint64_t ucs_twheel_next_tick(ucs_twheel_t *t)
+{
+    uint64_t next = UINT64_MAX;
+    unsigned level, shift, start;
+    uint64_t map, level_current;
+
+    for (level = 0; level < UCS_TWHEEL_NUM_LEVELS; ++level) {
+        map = t->slot_map[level];
+        if (map == 0) {
+            continue;
+        }
+
+        shift         = ucs_twheel_level_shift(level);
+        level_current = t->current >> shift;
+        start         = (level_current + 1) & UCS_TWHEEL_SLOT_MASK;
+
+        /* Rotate the map so that bit 0 is the slot after the current one */
+        if (start != 0) {
+            map = (map >> start) | (map << (UCS_BIT(UCS_TWHEEL_SLOTS_ORDER) -
+                                            start));
+        }
+
+        next = ucs_min(next, (level_current + 1 + ucs_ffs64(map)) << shift);
+    }
+
+    return next;
+}
+
+static void ucs_twheel_cascade(ucs_twheel_t *t, unsigned level, unsigned index)
+{
+    ucs_list_link_t *slot = ucs_twheel_slot(t, level, index);
+    UCS_LIST_HEAD(timers);
+    ucs_wtimer_t *timer;
+
+    t->slot_map[level] &= ~UCS_BIT(index);
+    ucs_list_splice_tail(&timers, slot);
+    ucs_list_head_init(slot);
+
+    while (!ucs_list_is_empty(&timers)) {
+        timer = ucs_list_extract_head(&timers, ucs_wtimer_t, list);
+        ucs_twheel_insert(t, timer);
+    }
+}
+
+static void ucs_twheel_expire(ucs_twheel_t *t, unsigned index)
+{
+    ucs_list_link_t *slot = ucs_twheel_slot(t, 0, index);
+    ucs_wtimer_t *timer;
+
+    t->slot_map[0] &= ~UCS_BIT(index);
+    while (!ucs_list_is_empty(slot)) {
+        timer = ucs_list_extract_head(slot, ucs_wtimer_t, list);
+        timer->is_active = 0;
+        timer->cb(timer);
+        t->count--;
+    }
+}
+
+/* Process all slots which correspond to the current tick */
+static void ucs_twheel_process_tick(ucs_twheel_t *t)
+{
+    unsigned level, shift;
+
+    /* Move timers down from higher levels first, since they could get to the
+     * slots of the lower levels which are processed on this tick */
+    for (level = UCS_TWHEEL_NUM_LEVELS - 1; level > 0; --level) {
+        shift = ucs_twheel_level_shift(level);
+        if ((t->current & (UCS_BIT(shift) - 1)) != 0) {
+            continue;
+        }
+
+        if (t->slot_map[level] &
+            UCS_BIT((t->current >> shift) & UCS_TWHEEL_SLOT_MASK)) {
+            ucs_twheel_cascade(t, level,
+                               (t->current >> shift) & UCS_TWHEEL_SLOT_MASK);
+        }
+    }
+
+    ucs_twheel_expire(t, t->current & UCS_TWHEEL_SLOT_MASK);
+}
+
 ucs_status_t ucs_twheel_init(ucs_twheel_t *twheel, ucs_time_t resolution,
                              ucs_time_t current_time)
 {
@@ -23,20 +155,24 @@ ucs_status_t ucs_twheel_init(ucs_twheel_t *twheel, ucs_time_t resolution,
 
     twheel->res         = ucs_roundup_pow2(resolution);
     twheel->res_order   = (unsigned) ucs_log2(twheel->res);
-    twheel->num_slots   = 1024;
+    twheel->num_slots   = UCS_BIT(UCS_TWHEEL_SLOTS_ORDER);
     twheel->current     = 0;
     twheel->now         = current_time;
-    twheel->wheel       = ucs_malloc(sizeof(*twheel->wheel) * twheel->num_slots,
-                                     "twheel");
+    twheel->wheel       = ucs_malloc(sizeof(*twheel->wheel) * twheel->num_slots *
+                                     UCS_TWHEEL_NUM_LEVELS, "twheel");
     twheel->count       = 0;
     if (twheel->wheel == NULL) {
         return UCS_ERR_NO_MEMORY;
     }
 
-    for (i = 0; i < twheel->num_slots; i++) {
+    for (i = 0; i < twheel->num_slots * UCS_TWHEEL_NUM_LEVELS; i++) {
         ucs_list_head_init(&twheel->wheel[i]);
     }
 
+    for (i = 0; i < UCS_TWHEEL_NUM_LEVELS; i++) {
+        twheel->slot_map[i] = 0;
+    }
+
     ucs_debug("high res timer created log=%d resolution=%lf usec wanted: %lf usec",
               twheel->res_order, ucs_time_to_usec(twheel->res), ucs_time_to_usec(resolution));
     return UCS_OK;
@@ -69,37 +205,27 @@ void __ucs_wtimer_add(ucs_twheel_t *t, ucs_wtimer_t *timer, ucs_time_t delta)
     }
     ucs_assert(slot > 0);
 
-    if (ucs_unlikely(slot >= t->num_slots)) {
-        slot = t->num_slots - 1;
-    }
-
-    slot = (t->current + slot) % t->num_slots;
-    ucs_assert(slot != t->current);
-
-    ucs_list_add_tail(&t->wheel[slot], &timer->list);
+    timer->expires = t->current + slot;
+    ucs_twheel_insert(t, timer);
     t->count++;
 }
 
 void __ucs_twheel_sweep(ucs_twheel_t *t, ucs_time_t current_time)
 {
-    ucs_wtimer_t *timer;
-    uint64_t slot;
+    uint64_t target, next;
 
-    slot   = (current_time - t->now) >> t->res_order;
+    target = t->current + ((current_time - t->now) >> t->res_order);
     t->now = current_time;
 
-    if (ucs_unlikely(slot >= t->num_slots)) {
-        slot = t->num_slots - 1;
-    }
-
-    slot = (t->current + slot) % t->num_slots;
-
-    for (; t->current != slot; t->current = (t->current+1) % t->num_slots) {
-        while (!ucs_list_is_empty(&t->wheel[t->current])) {
-            timer = ucs_list_extract_head(&t->wheel[t->current], ucs_wtimer_t, list);
-            timer->is_active = 0;
-            timer->cb(timer);
-            t->count--;
+    while (t->count > 0) {
+        next = ucs_twheel_next_tick(t);
+        if (next > target) {
+            break;
         }
+
+        t->current = next;
+        ucs_twheel_process_tick(t);
     }
+
+    t->current = target;
 }
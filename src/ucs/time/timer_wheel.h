@@ -12,6 +12,13 @@
 #include <ucs/debug/log.h>
 
 
+/* Number of levels in the hierarchical timer wheel */
+#define UCS_TWHEEL_NUM_LEVELS    5
+
+/* Log2 of number of slots in every level of the wheel */
+#define UCS_TWHEEL_SLOTS_ORDER   6
+
+
 /* Forward declarations */
 typedef struct ucs_wtimer       ucs_wtimer_t;
 typedef struct ucs_timer_wheel  ucs_twheel_t;
@@ -29,17 +36,27 @@ typedef void (*ucs_twheel_callback_t)(ucs_wtimer_t *self);
 struct ucs_wtimer {
     ucs_twheel_callback_t  cb;         /* User callback */
     ucs_list_link_t        list;       /* Link in the list of timers */
+    uint64_t               expires;    /* Expiration tick */
     int                    is_active;
 };
 
 
+/**
+ * Hierarchical timer wheel. Level 0 has a slot per tick, and every slot of
+ * level N covers all slots of level N-1. Timers are inserted to the lowest
+ * level which covers their expiration tick, and moved to lower levels when
+ * the wheel reaches the slot they are in. Slots which have timers are marked
+ * in a per-level bitmap, so a sweep skips directly to the next tick which has
+ * work to do.
+ */
 struct ucs_timer_wheel {
     ucs_time_t             res;
     ucs_time_t             now;        /* when wheel was last updated */
-    uint64_t               current;
-    ucs_list_link_t        *wheel;
+    uint64_t               current;    /* current tick */
+    ucs_list_link_t        *wheel;     /* slots of all levels */
+    uint64_t               slot_map[UCS_TWHEEL_NUM_LEVELS]; /* non-empty slots */
     unsigned               res_order;
-    unsigned               num_slots;
+    unsigned               num_slots;  /* number of slots in a level */
     unsigned               count;
 };
 
@@ -48,7 +65,10 @@ struct ucs_timer_wheel {
  * Initialize the timer queue.
  *
  * @param twheel        Timer queue to initialize.
- * @param resolution    Timer resolution. Timer wheel range is from now to now + UCS_TWHEEL_NSLOTS * res
+ * @param resolution    Timer resolution. Timer wheel range is from now to
+ *                      now + res * num_slots ^ UCS_TWHEEL_NUM_LEVELS, timers
+ *                      beyond the range are kept in the wheel until they
+ *                      get into the range.
  * @param current_time  Current time to initialize the timer with.
  */
 ucs_status_t ucs_twheel_init(ucs_twheel_t *twheel, ucs_time_t resolution,
@@ -134,6 +154,7 @@ static inline ucs_status_t ucs_wtimer_add(ucs_twheel_t *t, ucs_wtimer_t *timer,
  */
 static inline void ucs_wtimer_remove(ucs_twheel_t *t, ucs_wtimer_t *timer)
 {
+    /* The slot is left marked as non-empty, and is cleaned up by the sweep */
     if (ucs_likely(timer->is_active)) {
         ucs_list_del(&timer->list);
         timer->is_active = 0;
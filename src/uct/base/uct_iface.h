@@ -17,6 +17,7 @@
 #include <ucs/datastruct/queue.h>
 #include <ucs/debug/log.h>
 #include <ucs/debug/debug_int.h>
+#include <ucs/memory/numa.h>
 #include <ucs/stats/stats.h>
 #include <ucs/sys/compiler.h>
 #include <ucs/sys/sys.h>
@@ -358,6 +359,7 @@ struct uct_iface_config {
 typedef struct uct_iface_mpool_config {
     unsigned          max_bufs;  /* Upper limit to number of buffers */
     unsigned          bufs_grow; /* How many buffers (approx.) are allocated every time */
+    ucs_mpool_chunk_placement_t placement; /* Page size and NUMA placement */
 } uct_iface_mpool_config_t;
 
 
@@ -373,7 +375,25 @@ typedef struct uct_iface_mpool_config {
     {_prefix "BUFS_GROW", UCS_PP_QUOTE(_dfl_grow), \
      "How much buffers are added every time the " _mp_name " memory pool grows.\n" \
      "0 means the value is chosen by the transport.", \
-     (_offset) + ucs_offsetof(uct_iface_mpool_config_t, bufs_grow), UCS_CONFIG_TYPE_UINT}
+     (_offset) + ucs_offsetof(uct_iface_mpool_config_t, bufs_grow), UCS_CONFIG_TYPE_UINT}, \
+    \
+    {_prefix "HUGETLB", "auto", \
+     "Back the " _mp_name " memory pool by huge pages:\n" \
+     " yes  - use only huge pages, fail if they are not available.\n" \
+     " try  - try huge pages first, and fall back to the interface allocation\n" \
+     "        methods.\n" \
+     " no   - do not use huge pages.\n" \
+     " auto - use the interface allocation methods as is.", \
+     (_offset) + ucs_offsetof(uct_iface_mpool_config_t, placement.hugetlb), \
+     UCS_CONFIG_TYPE_TERNARY_AUTO}, \
+    \
+    {_prefix "NUMA_POLICY", "default", \
+     "NUMA policy of the " _mp_name " memory pool:\n" \
+     " default   - use the process memory policy.\n" \
+     " preferred - prefer the NUMA nodes the allocating thread runs on.\n" \
+     " bind      - bind to the NUMA nodes the allocating thread runs on.", \
+     (_offset) + ucs_offsetof(uct_iface_mpool_config_t, placement.numa_policy), \
+     UCS_CONFIG_TYPE_ENUM(ucs_numa_policy_names)}
 
 
 /**
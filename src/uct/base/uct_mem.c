@@ -26,6 +26,8 @@ typedef struct {
 typedef struct {
     uct_base_iface_t               *iface;
     uct_iface_mpool_init_obj_cb_t  init_obj_cb;
+    unsigned                       num_alloc_methods;
+    uct_alloc_method_t             alloc_methods[UCT_ALLOC_METHOD_LAST];
 } uct_iface_mp_priv_t;
 
 
@@ -335,10 +337,13 @@ ucs_status_t uct_mem_free(const uct_allocated_memory_t *mem)
     }
 }
 
-ucs_status_t uct_iface_mem_alloc(uct_iface_h tl_iface, size_t length, unsigned flags,
-                                 const char *name, uct_allocated_memory_t *mem)
+static ucs_status_t
+uct_iface_mem_alloc_common(uct_base_iface_t *iface, size_t length,
+                           unsigned flags, const char *name,
+                           const uct_alloc_method_t *methods,
+                           unsigned num_methods, ucs_mpool_t *mp,
+                           uct_allocated_memory_t *mem)
 {
-    uct_base_iface_t *iface = ucs_derived_of(tl_iface, uct_base_iface_t);
     void *address           = NULL;
     uct_md_attr_t md_attr;
     ucs_status_t status;
@@ -356,12 +361,17 @@ ucs_status_t uct_iface_mem_alloc(uct_iface_h tl_iface, size_t length, unsigned f
     params.mds.mds         = &iface->md;
     params.mds.count       = 1;
 
-    status = uct_mem_alloc(length, iface->config.alloc_methods,
-                           iface->config.num_alloc_methods, &params, mem);
+    status = uct_mem_alloc(length, methods, num_methods, &params, mem);
     if (status != UCS_OK) {
         goto err;
     }
 
+    if (mp != NULL) {
+        /* The memory pool does not use heap allocation methods when the NUMA
+         * policy is set, so the policy is applied before the first write */
+        ucs_mpool_chunk_place(mp, mem->address, mem->length);
+    }
+
     /* If the memory was not allocated using MD, register it */
     if (mem->method != UCT_ALLOC_METHOD_MD) {
 
@@ -395,6 +405,17 @@ err:
     return status;
 }
 
+ucs_status_t uct_iface_mem_alloc(uct_iface_h tl_iface, size_t length, unsigned flags,
+                                 const char *name, uct_allocated_memory_t *mem)
+{
+    uct_base_iface_t *iface = ucs_derived_of(tl_iface, uct_base_iface_t);
+
+    return uct_iface_mem_alloc_common(iface, length, flags, name,
+                                      iface->config.alloc_methods,
+                                      iface->config.num_alloc_methods, NULL,
+                                      mem);
+}
+
 void uct_iface_mem_free(const uct_allocated_memory_t *mem)
 {
     if ((mem->method != UCT_ALLOC_METHOD_MD) &&
@@ -420,9 +441,13 @@ UCS_PROFILE_FUNC(ucs_status_t, uct_iface_mp_chunk_alloc, (mp, size_p, chunk_p),
     size_t length;
 
     length = sizeof(*hdr) + *size_p;
-    status = uct_iface_mem_alloc(&iface->super, length,
-                                 UCT_MD_MEM_ACCESS_ALL | UCT_MD_MEM_FLAG_LOCK,
-                                 ucs_mpool_name(mp), &mem);
+    status = uct_iface_mem_alloc_common(iface, length,
+                                        UCT_MD_MEM_ACCESS_ALL |
+                                        UCT_MD_MEM_FLAG_LOCK,
+                                        ucs_mpool_name(mp),
+                                        uct_iface_mp_priv(mp)->alloc_methods,
+                                        uct_iface_mp_priv(mp)->num_alloc_methods,
+                                        mp, &mem);
     if (status != UCS_OK) {
         return status;
     }
@@ -477,6 +502,60 @@ static ucs_mpool_ops_t uct_iface_mpool_ops = {
     .obj_cleanup   = NULL
 };
 
+static int uct_iface_mpool_alloc_method_is_huge(uct_alloc_method_t method)
+{
+    return (method == UCT_ALLOC_METHOD_HUGE) || (method == UCT_ALLOC_METHOD_THP);
+}
+
+/*
+ * Heap memory may be reused and already touched, so the NUMA policy set after
+ * the allocation would not move its pages. Other methods return new mappings.
+ */
+static int uct_iface_mpool_alloc_method_is_heap(uct_alloc_method_t method)
+{
+    return (method == UCT_ALLOC_METHOD_HEAP) || (method == UCT_ALLOC_METHOD_THP);
+}
+
+/* Select memory pool allocation methods according to its placement */
+static void
+uct_iface_mpool_set_alloc_methods(uct_base_iface_t *iface,
+                                  uct_iface_mp_priv_t *priv,
+                                  const ucs_mpool_chunk_placement_t *placement)
+{
+    ucs_ternary_auto_value_t hugetlb = placement->hugetlb;
+    int numa_policy_set              = (placement->numa_policy !=
+                                        UCS_NUMA_POLICY_DEFAULT);
+    uct_alloc_method_t method;
+    unsigned i;
+
+    priv->num_alloc_methods = 0;
+    if ((hugetlb == UCS_YES) || (hugetlb == UCS_TRY)) {
+        priv->alloc_methods[priv->num_alloc_methods++] = UCT_ALLOC_METHOD_HUGE;
+        if (hugetlb == UCS_YES) {
+            return;
+        }
+
+        if (!numa_policy_set) {
+            priv->alloc_methods[priv->num_alloc_methods++] = UCT_ALLOC_METHOD_THP;
+        }
+    }
+
+    for (i = 0; i < iface->config.num_alloc_methods; ++i) {
+        method = iface->config.alloc_methods[i];
+        if (((hugetlb != UCS_AUTO) &&
+             uct_iface_mpool_alloc_method_is_huge(method)) ||
+            (numa_policy_set && uct_iface_mpool_alloc_method_is_heap(method))) {
+            continue;
+        }
+
+        priv->alloc_methods[priv->num_alloc_methods++] = method;
+    }
+
+    if (numa_policy_set && (priv->num_alloc_methods == 0)) {
+        priv->alloc_methods[priv->num_alloc_methods++] = UCT_ALLOC_METHOD_MMAP;
+    }
+}
+
 ucs_status_t uct_iface_mpool_init(uct_base_iface_t *iface, ucs_mpool_t *mp,
                                   size_t elem_size, size_t align_offset, size_t alignment,
                                   const uct_iface_mpool_config_t *config, unsigned grow,
@@ -497,5 +576,8 @@ ucs_status_t uct_iface_mpool_init(uct_base_iface_t *iface, ucs_mpool_t *mp,
 
     uct_iface_mp_priv(mp)->iface       = iface;
     uct_iface_mp_priv(mp)->init_obj_cb = init_obj_cb;
+    uct_iface_mpool_set_alloc_methods(iface, uct_iface_mp_priv(mp),
+                                      &config->placement);
+    ucs_mpool_set_chunk_placement(mp, &config->placement);
     return UCS_OK;
 }
@@ -22,7 +22,8 @@ ucs_status_t uct_sm_ep_put_short(uct_ep_h tl_ep, const void *buffer,
                                  uct_rkey_t rkey)
 {
     if (ucs_likely(length != 0)) {
-        memcpy((void *)(rkey + remote_addr), buffer, length);
+        ucs_memcpy_relaxed((void *)(rkey + remote_addr), buffer, length,
+                           UCS_ARCH_MEMCPY_NT_DEST, length);
         uct_sm_ep_trace_data(remote_addr, rkey, "PUT_SHORT [buffer %p size %u]",
                              buffer, length);
     } else {
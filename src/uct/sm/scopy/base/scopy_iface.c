@@ -110,8 +110,13 @@ UCS_CLASS_INIT_FUNC(uct_scopy_iface_t, uct_scopy_iface_ops_t *ops, uct_md_h md,
                             config->tx_mpool.max_bufs,
                             &uct_scopy_mpool_ops,
                             "uct_scopy_iface_tx_mp");
+    if (status != UCS_OK) {
+        return status;
+    }
 
-    return status;
+    ucs_mpool_set_chunk_placement(&self->tx_mpool,
+                                  &config->tx_mpool.placement);
+    return UCS_OK;
 }
 
 static UCS_CLASS_CLEANUP_FUNC(uct_scopy_iface_t)
@@ -1250,9 +1250,10 @@ static inline void uct_tcp_ep_handle_put_req(uct_tcp_ep_t *ep,
     ucs_assert(put_req->addr || !put_req->length);
 
     copied_length  = ucs_min(put_req->length, extra_recvd_length);
-    memcpy((void*)(uintptr_t)put_req->addr,
-           UCS_PTR_BYTE_OFFSET(ep->rx.buf, ep->rx.offset),
-           copied_length);
+    ucs_memcpy_relaxed((void*)(uintptr_t)put_req->addr,
+                       UCS_PTR_BYTE_OFFSET(ep->rx.buf, ep->rx.offset),
+                       copied_length, UCS_ARCH_MEMCPY_NT_SOURCE,
+                       put_req->length);
     ep->rx.offset += copied_length;
     ep->rx.put_sn  = put_req->sn;
 
@@ -622,6 +622,9 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         goto err;
     }
 
+    ucs_mpool_set_chunk_placement(&self->tx_mpool,
+                                  &config->tx_mpool.placement);
+
     status = ucs_mpool_init(&self->rx_mpool, 0, self->config.rx_seg_size * 2,
                             0, UCS_SYS_CACHE_LINE_SIZE,
                             (config->rx_mpool.bufs_grow == 0) ?
@@ -632,6 +635,9 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         goto err_cleanup_tx_mpool;
     }
 
+    ucs_mpool_set_chunk_placement(&self->rx_mpool,
+                                  &config->rx_mpool.placement);
+
     status = uct_tcp_netif_inaddr(self->if_name, &self->config.ifaddr,
                                   &self->config.netmask);
     if (status != UCS_OK) {
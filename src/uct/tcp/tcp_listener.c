@@ -14,11 +14,14 @@
 #include <ucs/async/async.h>
 
 
-static void
-uct_tcp_listener_conn_req_handler(int fd, ucs_event_set_types_t events,
-                                  void *arg)
+/**
+ * Accept a single connection request.
+ *
+ * @return UCS_OK if a connection was accepted, even if creating an endpoint
+ *         for it failed, or the error returned by accept() otherwise.
+ */
+static ucs_status_t uct_tcp_listener_accept(uct_tcp_listener_t *listener)
 {
-    uct_tcp_listener_t *listener = (uct_tcp_listener_t *)arg;
     char ip_port_str[UCS_SOCKADDR_STRING_LEN];
     struct sockaddr_storage client_addr;
     ucs_async_context_t *async_ctx;
@@ -28,14 +31,12 @@ uct_tcp_listener_conn_req_handler(int fd, ucs_event_set_types_t events,
     socklen_t addrlen;
     int conn_fd;
 
-    ucs_assert(fd == listener->listen_fd);
-
     addrlen   = sizeof(struct sockaddr_storage);
     status    = ucs_socket_accept(listener->listen_fd,
                                   (struct sockaddr*)&client_addr,
                                   &addrlen, &conn_fd);
     if (status != UCS_OK) {
-        return;
+        return status;
     }
 
     ucs_assert(conn_fd != -1);
@@ -85,12 +86,37 @@ uct_tcp_listener_conn_req_handler(int fd, ucs_event_set_types_t events,
         goto err_delete_ep;
     }
 
-    return;
+    /* The client sends its connection request right after connecting, so it
+     * is likely to be available already. Handle it now instead of waiting for
+     * another event on the new socket. */
+    uct_tcp_sa_data_handler(conn_fd, UCS_EVENT_SET_EVREAD, ep);
+    return UCS_OK;
 
 err_delete_ep:
     UCS_CLASS_DELETE(uct_tcp_sockcm_ep_t, ep);
 err:
     ucs_close_fd(&conn_fd);
+    return UCS_OK;
+}
+
+static void
+uct_tcp_listener_conn_req_handler(int fd, ucs_event_set_types_t events,
+                                  void *arg)
+{
+    uct_tcp_listener_t *listener = (uct_tcp_listener_t *)arg;
+    unsigned count;
+
+    ucs_assert(fd == listener->listen_fd);
+
+    /* Accept a batch of pending connections, the rest (if any) are accepted
+     * on the next event */
+    for (count = 0; count < listener->sockcm->accept_budget; ++count) {
+        if (uct_tcp_listener_accept(listener) != UCS_OK) {
+            break;
+        }
+    }
+
+    ucs_trace("listener %p accepted %u connection requests", listener, count);
 }
 
 UCS_CLASS_INIT_FUNC(uct_tcp_listener_t, uct_cm_h cm,
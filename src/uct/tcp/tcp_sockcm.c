@@ -26,6 +26,12 @@ ucs_config_field_t uct_tcp_sockcm_config_table[] = {
 
    UCT_TCP_SYN_CNT(ucs_offsetof(uct_tcp_sockcm_config_t, syn_cnt)),
 
+  {"ACCEPT_BUDGET", "32",
+   "Maximal number of pending connection requests to accept by the listener\n"
+   "in a single event. Higher values improve the connection establishment rate\n"
+   "when many clients connect at once, at the cost of a longer event handling.",
+   ucs_offsetof(uct_tcp_sockcm_config_t, accept_budget), UCS_CONFIG_TYPE_UINT},
+
   {NULL}
 };
 
@@ -180,6 +186,7 @@ UCS_CLASS_INIT_FUNC(uct_tcp_sockcm_t, uct_component_h component,
     self->sockopt_sndbuf   = cm_config->sockopt.sndbuf;
     self->sockopt_rcvbuf   = cm_config->sockopt.rcvbuf;
     self->syn_cnt          = cm_config->syn_cnt;
+    self->accept_budget    = ucs_max(cm_config->accept_budget, 1);
 
     ucs_list_head_init(&self->ep_list);
 
@@ -20,6 +20,7 @@ typedef struct uct_tcp_sockcm {
     size_t              sockopt_sndbuf;  /** SO_SNDBUF */
     size_t              sockopt_rcvbuf;  /** SO_RCVBUF */
     unsigned            syn_cnt;         /** TCP_SYNCNT */
+    unsigned            accept_budget;   /** Connections to accept per event */
     ucs_list_link_t     ep_list;         /** List of endpoints */
 } uct_tcp_sockcm_t;
 
@@ -31,6 +32,7 @@ typedef struct uct_tcp_sockcm_config {
     size_t                          priv_data_len;
     uct_tcp_send_recv_buf_config_t  sockopt;
     unsigned                        syn_cnt;
+    unsigned                        accept_budget;
 } uct_tcp_sockcm_config_t;
 
 
@@ -881,6 +881,157 @@ UCS_TEST_P(test_ucp_am_nbx_eager_data_release, multi)
 UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_eager_data_release)
 
 
+class test_ucp_am_nbx_user_buffer : public test_ucp_am_nbx {
+public:
+    test_ucp_am_nbx_user_buffer()
+    {
+        m_alloc_count  = 0;
+        m_alloc_status = UCS_OK;
+        m_cb_status    = UCS_OK;
+    }
+
+    virtual void cleanup()
+    {
+        test_ucp_am_nbx::cleanup();
+        for (size_t i = 0; i < m_buffers.size(); ++i) {
+            delete m_buffers[i];
+        }
+    }
+
+    virtual ucs_status_t
+    am_data_handler(const void *header, size_t header_length, void *data,
+                    size_t length, const ucp_am_recv_param_t *rx_param)
+    {
+        EXPECT_FALSE(m_am_received);
+        check_header(header, header_length);
+        m_am_received = true;
+
+        if (length == 0) {
+            /* Nothing to receive, so no buffer is allocated */
+            EXPECT_FALSE(rx_param->recv_attr &
+                         UCP_AM_RECV_ATTR_FLAG_USER_BUFFER);
+            EXPECT_TRUE(m_buffers.empty());
+            return UCS_OK;
+        }
+
+        if (m_alloc_status != UCS_OK) {
+            /* Received to an internal buffer, since the allocation failed */
+            EXPECT_FALSE(rx_param->recv_attr &
+                         UCP_AM_RECV_ATTR_FLAG_USER_BUFFER);
+            EXPECT_TRUE(rx_param->recv_attr & UCP_AM_RECV_ATTR_FLAG_DATA);
+            EXPECT_TRUE(m_buffers.empty());
+            mem_buffer::pattern_check(data, length, SEED);
+            return UCS_OK;
+        }
+
+        EXPECT_TRUE(rx_param->recv_attr & UCP_AM_RECV_ATTR_FLAG_USER_BUFFER);
+        EXPECT_FALSE(rx_param->recv_attr & (UCP_AM_RECV_ATTR_FLAG_DATA |
+                                            UCP_AM_RECV_ATTR_FLAG_RNDV));
+        EXPECT_EQ(1u, m_buffers.size());
+        if (!m_buffers.empty()) {
+            EXPECT_EQ(&m_buffers.back()->front(), data);
+            EXPECT_EQ(m_buffers.back()->size(), length);
+        }
+
+        mem_buffer::pattern_check(data, length, SEED);
+
+        return m_cb_status;
+    }
+
+    void test_user_buffer(size_t size, unsigned flags = 0)
+    {
+        ucp_am_handler_param_t param;
+
+        param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
+                           UCP_AM_HANDLER_PARAM_FIELD_CB |
+                           UCP_AM_HANDLER_PARAM_FIELD_ARG |
+                           UCP_AM_HANDLER_PARAM_FIELD_ALLOC_CB;
+        param.id         = TEST_AM_NBX_ID;
+        param.cb         = am_data_cb;
+        param.arg        = this;
+        param.alloc_cb   = am_alloc_cb;
+
+        m_hdr.resize(ucs_min(max_am_hdr(), 8));
+        ucs::fill_random(m_hdr);
+        m_am_received = false;
+        ASSERT_UCS_OK(ucp_worker_set_am_recv_handler(receiver().worker(),
+                                                     &param));
+
+        mem_buffer sbuf(size, UCS_MEMORY_TYPE_HOST);
+        mem_buffer::pattern_fill(sbuf.ptr(), size, SEED, UCS_MEMORY_TYPE_HOST);
+        ucp::data_type_desc_t sdt_desc(m_dt, sbuf.ptr(), size);
+
+        ucs_status_ptr_t sptr = send_am(sdt_desc, get_send_flag() | flags,
+                                        m_hdr.data(), m_hdr.size());
+        wait_for_flag(&m_am_received);
+        ASSERT_UCS_OK(request_wait(sptr));
+        EXPECT_TRUE(m_am_received);
+        EXPECT_EQ((size > 0) ? 1u : 0u, m_alloc_count);
+    }
+
+    size_t fragment_size()
+    {
+        return ucp_ep_config(sender().ep())->am.max_bcopy -
+               sizeof(ucp_am_hdr_t);
+    }
+
+private:
+    static void *am_alloc_cb(void *arg, const void *header,
+                             size_t header_length, size_t length)
+    {
+        test_ucp_am_nbx_user_buffer *self =
+                reinterpret_cast<test_ucp_am_nbx_user_buffer*>(arg);
+
+        self->check_header(header, header_length);
+        ++self->m_alloc_count;
+        if (self->m_alloc_status != UCS_OK) {
+            return UCS_STATUS_PTR(self->m_alloc_status);
+        }
+
+        self->m_buffers.push_back(new std::vector<char>(length));
+        return &self->m_buffers.back()->front();
+    }
+
+    unsigned                        m_alloc_count;
+    std::vector<std::vector<char>*> m_buffers;
+
+protected:
+    ucs_status_t                    m_alloc_status;
+    ucs_status_t                    m_cb_status;
+};
+
+UCS_TEST_P(test_ucp_am_nbx_user_buffer, eager_multi, "RNDV_THRESH=inf",
+           "ZCOPY_THRESH=inf")
+{
+    test_user_buffer(fragment_size() * 3 + 7);
+}
+
+UCS_TEST_P(test_ucp_am_nbx_user_buffer, rndv, "RNDV_THRESH=128")
+{
+    test_user_buffer(64 * UCS_KBYTE);
+}
+
+UCS_TEST_P(test_ucp_am_nbx_user_buffer, rndv_zero_length)
+{
+    test_user_buffer(0, UCP_AM_SEND_FLAG_RNDV);
+}
+
+UCS_TEST_P(test_ucp_am_nbx_user_buffer, eager_multi_alloc_err,
+           "RNDV_THRESH=inf", "ZCOPY_THRESH=inf")
+{
+    m_alloc_status = UCS_ERR_NO_MEMORY;
+    test_user_buffer(fragment_size() * 3 + 7);
+}
+
+UCS_TEST_P(test_ucp_am_nbx_user_buffer, rndv_cb_err, "RNDV_THRESH=128")
+{
+    m_cb_status = UCS_ERR_CANCELED;
+    test_user_buffer(64 * UCS_KBYTE);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_user_buffer)
+
+
 class test_ucp_am_nbx_dts : public test_ucp_am_nbx {
 public:
     static const uint64_t dts_bitmap = UCS_BIT(UCP_DATATYPE_CONTIG) |
@@ -995,6 +1146,171 @@ UCS_TEST_P(test_ucp_am_nbx_dts, send_eager_flag, "RNDV_THRESH=128")
 UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_dts)
 
 
+class test_ucp_am_nbx_aggregate : public test_ucp_am_nbx {
+public:
+    test_ucp_am_nbx_aggregate() : m_rx_count(0)
+    {
+    }
+
+    virtual ucp_ep_params_t get_ep_params()
+    {
+        ucp_ep_params_t ep_params = test_ucp_am_nbx::get_ep_params();
+        ep_params.field_mask     |= UCP_EP_PARAM_FIELD_FLAGS;
+        ep_params.flags          |= UCP_EP_PARAMS_FLAGS_AM_AGGREGATE;
+        return ep_params;
+    }
+
+protected:
+    typedef struct {
+        std::string header;
+        std::string data;
+        bool        has_reply_ep;
+    } rx_message_t;
+
+    static ucs_status_t am_agg_cb(void *arg, const void *header,
+                                  size_t header_length, void *data,
+                                  size_t length,
+                                  const ucp_am_recv_param_t *param)
+    {
+        test_ucp_am_nbx_aggregate *self =
+                reinterpret_cast<test_ucp_am_nbx_aggregate*>(arg);
+        rx_message_t msg;
+
+        EXPECT_FALSE(param->recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV);
+
+        msg.header.assign(reinterpret_cast<const char*>(header),
+                          header_length);
+        msg.data.assign(reinterpret_cast<const char*>(data), length);
+        msg.has_reply_ep = (param->recv_attr &
+                            UCP_AM_RECV_ATTR_FIELD_REPLY_EP) &&
+                           (param->reply_ep != NULL);
+        self->m_rx.push_back(msg);
+        ++self->m_rx_count;
+        return UCS_OK;
+    }
+
+    void test_burst(const std::vector<size_t> &sizes, unsigned flags = 0)
+    {
+        std::vector<std::string> data(sizes.size());
+        std::vector<std::string> headers(sizes.size());
+        std::vector<void*> reqs;
+        ucp_request_param_t param;
+
+        set_am_data_handler(receiver(), TEST_AM_NBX_ID, am_agg_cb, this);
+
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+        param.flags        = flags;
+
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            data[i].resize(sizes[i]);
+            ucs::fill_random(data[i]);
+            headers[i].resize((i % 3) * 8);
+            ucs::fill_random(headers[i]);
+
+            ucs_status_ptr_t sptr = ucp_am_send_nbx(sender().ep(),
+                                                    TEST_AM_NBX_ID,
+                                                    headers[i].data(),
+                                                    headers[i].size(),
+                                                    data[i].data(),
+                                                    data[i].size(), &param);
+            ASSERT_FALSE(UCS_PTR_IS_ERR(sptr));
+            if (sptr != NULL) {
+                reqs.push_back(sptr);
+            }
+        }
+
+        requests_wait(reqs);
+        flush_ep(sender());
+        wait_for_value(&m_rx_count, sizes.size());
+
+        ASSERT_EQ(sizes.size(), m_rx.size());
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            EXPECT_EQ(headers[i], m_rx[i].header) << "message " << i;
+            EXPECT_EQ(data[i], m_rx[i].data) << "message " << i;
+            EXPECT_EQ(!!(flags & UCP_AM_SEND_REPLY), m_rx[i].has_reply_ep);
+        }
+    }
+
+    std::vector<rx_message_t> m_rx;
+    volatile size_t           m_rx_count;
+};
+
+UCS_TEST_P(test_ucp_am_nbx_aggregate, short_send)
+{
+    test_am(1);
+}
+
+UCS_TEST_P(test_ucp_am_nbx_aggregate, burst, "RNDV_THRESH=inf")
+{
+    std::vector<size_t> sizes(1000);
+
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        sizes[i] = ucs::rand() % 256;
+    }
+
+    test_burst(sizes);
+}
+
+UCS_TEST_P(test_ucp_am_nbx_aggregate, burst_reply, "RNDV_THRESH=inf")
+{
+    std::vector<size_t> sizes(1000);
+
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        sizes[i] = ucs::rand() % 256;
+    }
+
+    test_burst(sizes, UCP_AM_SEND_REPLY);
+}
+
+UCS_TEST_P(test_ucp_am_nbx_aggregate, burst_mixed_sizes, "RNDV_THRESH=inf")
+{
+    std::vector<size_t> sizes(200);
+
+    /* Large messages are not aggregated, and must keep the order with the
+     * small ones */
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        sizes[i] = (i % 10 == 9) ? (20 * UCS_KBYTE) : (ucs::rand() % 64);
+    }
+
+    test_burst(sizes);
+}
+
+UCS_TEST_P(test_ucp_am_nbx_aggregate, held_until_progress,
+           "AM_AGGREGATE_DELAY=1000s")
+{
+    std::vector<size_t> sizes(10, 32);
+    ucp_ep_ext_gen_t *ep_ext = ucp_ep_ext_gen(sender().ep());
+    ucp_request_param_t param;
+
+    flush_workers();
+    EXPECT_TRUE(ep_ext->am_agg_desc == NULL);
+
+    set_am_data_handler(receiver(), TEST_AM_NBX_ID, am_agg_cb, this);
+    param.op_attr_mask = 0;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        std::string data(sizes[i], 'a' + i);
+        ucs_status_ptr_t sptr = ucp_am_send_nbx(sender().ep(), TEST_AM_NBX_ID,
+                                                NULL, 0, data.data(),
+                                                data.size(), &param);
+        /* The data is copied to the aggregate */
+        EXPECT_EQ(NULL, sptr);
+    }
+
+    EXPECT_TRUE(ep_ext->am_agg_desc != NULL);
+    short_progress_loop();
+    EXPECT_EQ(0u, m_rx_count);
+
+    flush_ep(sender());
+    wait_for_value(&m_rx_count, sizes.size());
+    EXPECT_TRUE(ep_ext->am_agg_desc == NULL);
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        EXPECT_EQ(std::string(sizes[i], 'a' + i), m_rx[i].data);
+    }
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_aggregate)
+
+
 class test_ucp_am_nbx_rndv : public test_ucp_am_nbx {
 public:
     test_ucp_am_nbx_rndv()
@@ -6,9 +6,12 @@
 
 #include "ucp_test.h"
 extern "C" {
+#include <ucp/core/ucp_context.h>
 #include <ucs/sys/sys.h>
 }
 
+#include <dirent.h>
+
 class test_ucp_lib_query : public ucs::test {
 };
 
@@ -58,6 +61,126 @@ UCS_TEST_P(test_ucp_context, minimal_field_mask) {
 
 UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_context, all, "all")
 
+class test_ucp_context_rsc_cache : public test_ucp_context {
+public:
+    virtual void init() {
+        char dir_template[] = "/tmp/ucx_rsc_cache_XXXXXX";
+
+        ASSERT_TRUE(mkdtemp(dir_template) != NULL);
+        m_cache_dir = dir_template;
+        test_ucp_context::init();
+    }
+
+    virtual void cleanup() {
+        std::vector<std::string> files = cache_files();
+
+        test_ucp_context::cleanup();
+        for (size_t i = 0; i < files.size(); ++i) {
+            unlink((m_cache_dir + "/" + files[i]).c_str());
+        }
+        rmdir(m_cache_dir.c_str());
+    }
+
+protected:
+    std::vector<std::string> cache_files() const {
+        std::vector<std::string> files;
+        struct dirent *entry;
+        DIR *dir;
+
+        dir = opendir(m_cache_dir.c_str());
+        if (dir == NULL) {
+            return files;
+        }
+
+        while ((entry = readdir(dir)) != NULL) {
+            if (entry->d_name[0] != '.') {
+                files.push_back(entry->d_name);
+            }
+        }
+
+        closedir(dir);
+        return files;
+    }
+
+    std::vector<std::string> context_resources(const entity &e) const {
+        std::vector<std::string> resources;
+        ucp_context_h context = e.ucph();
+
+        for (ucp_rsc_index_t i = 0; i < context->num_tls; ++i) {
+            const ucp_tl_resource_desc_t *rsc = &context->tl_rscs[i];
+            resources.push_back(std::string(rsc->tl_rsc.tl_name) + "/" +
+                                rsc->tl_rsc.dev_name + "/" +
+                                context->tl_mds[rsc->md_index].rsc.md_name);
+        }
+
+        return resources;
+    }
+
+    std::string m_cache_dir;
+};
+
+UCS_TEST_P(test_ucp_context_rsc_cache, discovery_threads,
+           "RESOURCE_DISCOVERY_THREADS=1") {
+    entity *e = create_entity();
+    std::vector<std::string> expected = context_resources(*e);
+
+    modify_config("RESOURCE_DISCOVERY_THREADS", "4");
+    e = create_entity();
+    EXPECT_EQ(expected, context_resources(*e));
+}
+
+UCS_TEST_P(test_ucp_context_rsc_cache, save_and_load) {
+    entity *e = create_entity();
+    std::vector<std::string> expected = context_resources(*e);
+
+    modify_config("RESOURCE_CACHE_DIR", m_cache_dir);
+    e = create_entity();
+    EXPECT_EQ(expected, context_resources(*e));
+    ASSERT_EQ(1ul, cache_files().size());
+
+    /* The second context reads the resources from the cache file */
+    e = create_entity();
+    EXPECT_EQ(expected, context_resources(*e));
+    EXPECT_EQ(1ul, cache_files().size());
+    e->connect(e, get_ep_params());
+}
+
+UCS_TEST_P(test_ucp_context_rsc_cache, invalid_file) {
+    modify_config("RESOURCE_CACHE_DIR", m_cache_dir);
+    entity *e = create_entity();
+    std::vector<std::string> expected = context_resources(*e);
+
+    std::vector<std::string> files = cache_files();
+    ASSERT_EQ(1ul, files.size());
+
+    FILE *stream = fopen((m_cache_dir + "/" + files[0]).c_str(), "w");
+    ASSERT_TRUE(stream != NULL);
+    fprintf(stream, "ucx_resources 1 0\nmd invalid\n");
+    fclose(stream);
+
+    /* An invalid file is ignored and replaced */
+    e = create_entity();
+    EXPECT_EQ(expected, context_resources(*e));
+    EXPECT_EQ(1ul, cache_files().size());
+}
+
+UCS_TEST_P(test_ucp_context_rsc_cache, env_key) {
+    uint32_t crc = ucp_config_env_crc32(0);
+
+    {
+        /* Only variables which start with the UCX prefix affect the key */
+        ucs::scoped_setenv env("MY_UCX_RSC_CACHE_TEST", "1");
+        EXPECT_EQ(crc, ucp_config_env_crc32(0));
+    }
+
+    {
+        ucs::scoped_setenv env("UCX_RSC_CACHE_TEST", "1");
+        EXPECT_NE(crc, ucp_config_env_crc32(0));
+    }
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_context_rsc_cache, all, "all")
+
 class test_ucp_aliases : public test_ucp_context {
 };
 
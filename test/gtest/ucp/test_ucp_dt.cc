@@ -11,6 +11,7 @@
 extern "C" {
 #include <ucp/dt/dt.h>
 #include <ucp/dt/datatype_iter.inl>
+#include <ucs/algorithm/reduce.h>
 }
 
 class test_ucp_dt_iov : public ucs::test {
@@ -51,6 +52,67 @@ UCS_TEST_F(test_ucp_dt_iov, seek)
     }
 };
 
+UCS_TEST_F(test_ucp_dt_iov, gather_scatter)
+{
+    for (int count = 0; count < 100; ++count) {
+        size_t iovcnt = (ucs::rand() % 20) + 1;
+        std::vector<ucp_dt_iov_t> iov(iovcnt);
+        std::vector<size_t> buf_offsets(iovcnt);
+
+        /* Mix tiny, empty and large entries, some of them adjacent in memory
+         * and some separated by a gap */
+        size_t buf_size = 0, total_size = 0;
+        for (size_t i = 0; i < iovcnt; ++i) {
+            iov[i].length  = (ucs::rand() % 2) ? (ucs::rand() % 20) :
+                                                 (ucs::rand() % 1000);
+            buf_size      += (ucs::rand() % 2) * 8;
+            buf_offsets[i] = buf_size;
+            buf_size      += iov[i].length;
+            total_size    += iov[i].length;
+        }
+
+        std::string buffer(buf_size, '\0');
+        ucs::fill_random(buffer);
+        std::string expected;
+        for (size_t i = 0; i < iovcnt; ++i) {
+            iov[i].buffer = &buffer[buf_offsets[i]];
+            expected.append(&buffer[buf_offsets[i]], iov[i].length);
+        }
+
+        std::string packed(total_size, '\0');
+        size_t iov_offs = 0, iov_indx = 0;
+        size_t offset   = 0;
+        while (offset < total_size) {
+            size_t length = std::min<size_t>((ucs::rand() % 100) + 1,
+                                             total_size - offset);
+            ucp_dt_iov_gather(&packed[offset], &iov[0], length, &iov_offs,
+                              &iov_indx);
+            offset += length;
+            EXPECT_EQ(offset, calc_iov_offset(&iov[0], iov_indx, iov_offs));
+        }
+        EXPECT_EQ(expected, packed);
+
+        std::fill(buffer.begin(), buffer.end(), '\0');
+        iov_offs = iov_indx = offset = 0;
+        while (offset < total_size) {
+            size_t length = std::min<size_t>((ucs::rand() % 100) + 1,
+                                             total_size - offset);
+            EXPECT_EQ(length, ucp_dt_iov_scatter(&iov[0], iovcnt,
+                                                 &packed[offset], length,
+                                                 &iov_offs, &iov_indx));
+            offset += length;
+            EXPECT_EQ(offset, calc_iov_offset(&iov[0], iov_indx, iov_offs));
+        }
+
+        for (size_t i = 0; i < iovcnt; ++i) {
+            EXPECT_EQ(expected.substr(calc_iov_offset(&iov[0], i, 0),
+                                      iov[i].length),
+                      std::string((const char*)iov[i].buffer, iov[i].length))
+                    << "iov[" << i << "]";
+        }
+    }
+}
+
 class test_ucp_dt_iter : public ucs::test_with_param<ucp_datatype_t> {
 protected:
     virtual void init() {
@@ -161,3 +223,323 @@ INSTANTIATE_TEST_CASE_P(iov, test_ucp_dt_iter,
 
 INSTANTIATE_TEST_CASE_P(generic, test_ucp_dt_iter,
                         testing::ValuesIn(test_ucp_dt_iter::enum_dt_generic_params()));
+
+
+class test_ucp_dt_strided : public ucs::test {
+protected:
+    void init_layout() {
+        m_elem_size = (ucs::rand() % 40) + 1;
+        m_dims.resize((ucs::rand() % UCP_DT_STRIDED_MAX_DIMS) + 1);
+        m_extent    = m_elem_size;
+
+        for (size_t i = 0; i < m_dims.size(); ++i) {
+            m_dims[i].count  = (ucs::rand() % 4) + 1;
+            /* Some dimensions are contiguous, to be merged */
+            m_dims[i].stride = m_extent +
+                               (((ucs::rand() % 3) == 0) ? 0 :
+                                (ucs::rand() % 16));
+            m_extent        += (m_dims[i].count - 1) * m_dims[i].stride;
+        }
+
+        ASSERT_UCS_OK(ucp_dt_create_strided(m_elem_size, &m_dims[0],
+                                            m_dims.size(), &m_datatype));
+        m_count = (ucs::rand() % 3) + 1;
+
+        /* Offsets in the buffer of all packed bytes */
+        m_offsets.clear();
+        for (size_t item = 0; item < m_count; ++item) {
+            add_offsets(m_dims.size(), item * m_extent);
+        }
+
+        m_buffer.resize(m_count * m_extent);
+        ucs::fill_random(m_buffer);
+    }
+
+    void cleanup_layout() {
+        ucp_dt_destroy(m_datatype);
+    }
+
+    const ucp_dt_strided_t *dt_strided() const {
+        return ucp_dt_to_strided(m_datatype);
+    }
+
+    std::string expected_packed() const {
+        std::string packed;
+        for (size_t i = 0; i < m_offsets.size(); ++i) {
+            packed.push_back(m_buffer[m_offsets[i]]);
+        }
+        return packed;
+    }
+
+    size_t                            m_elem_size;
+    std::vector<ucp_dt_strided_dim_t> m_dims;
+    size_t                            m_extent;
+    size_t                            m_count;
+    ucp_datatype_t                    m_datatype;
+    std::vector<size_t>               m_offsets;
+    std::string                       m_buffer;
+
+private:
+    void add_offsets(size_t dim, size_t offset) {
+        if (dim == 0) {
+            for (size_t i = 0; i < m_elem_size; ++i) {
+                m_offsets.push_back(offset + i);
+            }
+            return;
+        }
+
+        for (size_t i = 0; i < m_dims[dim - 1].count; ++i) {
+            add_offsets(dim - 1, offset + (i * m_dims[dim - 1].stride));
+        }
+    }
+};
+
+UCS_TEST_F(test_ucp_dt_strided, pack_unpack) {
+    for (int iter = 0; iter < 200; ++iter) {
+        init_layout();
+
+        std::string expected = expected_packed();
+        size_t length        = expected.size();
+        EXPECT_EQ(length, ucp_dt_strided_length(dt_strided(), m_count));
+
+        /* Pack in random fragments */
+        std::string packed(length, 0);
+        for (size_t offset = 0; offset < length;) {
+            size_t frag = std::min((size_t)(ucs::rand() % 64) + 1,
+                                   length - offset);
+            ucp_dt_strided_pack(dt_strided(), &m_buffer[0], offset,
+                                &packed[offset], frag);
+            offset += frag;
+        }
+        EXPECT_EQ(expected, packed) << "iter " << iter;
+
+        /* Unpack in random fragments, the gaps must not be changed */
+        std::string buffer(m_buffer);
+        ucs::fill_random(packed);
+        for (size_t offset = 0; offset < length;) {
+            size_t frag = std::min((size_t)(ucs::rand() % 64) + 1,
+                                   length - offset);
+            ucp_dt_strided_unpack(dt_strided(), &buffer[0], offset,
+                                  &packed[offset], frag);
+            offset += frag;
+        }
+        for (size_t i = 0; i < length; ++i) {
+            m_buffer[m_offsets[i]] = packed[i];
+        }
+        EXPECT_EQ(m_buffer, buffer) << "iter " << iter;
+
+        cleanup_layout();
+    }
+}
+
+UCS_TEST_F(test_ucp_dt_strided, uct_iov) {
+    for (int iter = 0; iter < 200; ++iter) {
+        init_layout();
+
+        std::string expected = expected_packed();
+        size_t length        = expected.size();
+        std::vector<uct_iov_t> iov(8);
+        std::string packed;
+
+        for (size_t offset = 0; offset < length;) {
+            size_t max_length = std::min((size_t)(ucs::rand() % 100) + 1,
+                                         length - offset);
+            size_t max_iov    = (ucs::rand() % iov.size()) + 1;
+            size_t iovcnt;
+
+            size_t iov_length = ucp_dt_strided_to_uct_iov(dt_strided(),
+                                                          &m_buffer[0], offset,
+                                                          max_length,
+                                                          UCT_MEM_HANDLE_NULL,
+                                                          &iov[0], max_iov,
+                                                          &iovcnt);
+            ASSERT_LE(iovcnt, max_iov);
+            ASSERT_GT(iov_length, 0ul);
+            ASSERT_LE(iov_length, max_length);
+            EXPECT_EQ(ucp_dt_strided_block_count(dt_strided(), offset,
+                                                 iov_length), iovcnt);
+
+            for (size_t i = 0; i < iovcnt; ++i) {
+                EXPECT_LE(iov[i].length, dt_strided()->block_size);
+                packed.append((const char*)iov[i].buffer, iov[i].length);
+            }
+            offset += iov_length;
+        }
+        EXPECT_EQ(expected, packed) << "iter " << iter;
+
+        cleanup_layout();
+    }
+}
+
+UCS_TEST_F(test_ucp_dt_strided, merge_contig_dims) {
+    /* 3D box of 2x3x4 floats in a 10x10x10 array, 2 floats per row */
+    ucp_dt_strided_dim_t dims[] = {{3, 10 * sizeof(float)},
+                                   {4, 100 * sizeof(float)},
+                                   {1, 0}};
+    ucp_datatype_t datatype;
+
+    ASSERT_UCS_OK(ucp_dt_create_strided(2 * sizeof(float), dims, 3, &datatype));
+    EXPECT_EQ(2 * sizeof(float), ucp_dt_to_strided(datatype)->block_size);
+    EXPECT_EQ(24 * sizeof(float), ucp_dt_to_strided(datatype)->packed_size);
+    /* 2 dimensions and the items */
+    EXPECT_EQ(3u, ucp_dt_to_strided(datatype)->num_dims);
+    ucp_dt_destroy(datatype);
+
+    /* Full rows are merged into a single block */
+    dims[0].stride = 2 * sizeof(float);
+    ASSERT_UCS_OK(ucp_dt_create_strided(2 * sizeof(float), dims, 2, &datatype));
+    EXPECT_EQ(6 * sizeof(float), ucp_dt_to_strided(datatype)->block_size);
+    EXPECT_EQ(2u, ucp_dt_to_strided(datatype)->num_dims);
+    ucp_dt_destroy(datatype);
+}
+
+UCS_TEST_F(test_ucp_dt_strided, invalid_params) {
+    ucp_dt_strided_dim_t dims[UCP_DT_STRIDED_MAX_DIMS + 1] = {{2, 8}};
+    ucp_datatype_t datatype;
+
+    scoped_log_handler wrap_err(wrap_errors_logger);
+
+    /* Overlapping elements */
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, ucp_dt_create_strided(16, dims, 1,
+                                                           &datatype));
+    /* Empty dimension */
+    dims[0].count = 0;
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, ucp_dt_create_strided(8, dims, 1,
+                                                           &datatype));
+    /* Too many dimensions */
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucp_dt_create_strided(8, dims, UCP_DT_STRIDED_MAX_DIMS + 1,
+                                    &datatype));
+}
+
+
+class test_ucp_dt_unpack_op : public ucs::test {
+protected:
+    /* Split [0, length) to fragments of random sizes, in random order */
+    static std::vector<std::pair<size_t, size_t> > random_frags(size_t length) {
+        std::vector<std::pair<size_t, size_t> > frags;
+        size_t offset = 0;
+
+        while (offset < length) {
+            size_t frag_length = std::min(length - offset,
+                                          (size_t)(ucs::rand() % 50) + 1);
+            frags.push_back(std::make_pair(offset, frag_length));
+            offset += frag_length;
+        }
+
+        /* Fisher-Yates shuffle, reproducible by the test seed */
+        for (size_t i = frags.size(); i > 1; --i) {
+            std::swap(frags[i - 1], frags[ucs::rand() % i]);
+        }
+
+        return frags;
+    }
+
+    template <typename T>
+    void test_unpack(ucp_dt_unpack_op_t op, ucp_dt_elem_type_t elem_type) {
+        const size_t count = 1000;
+        std::vector<T> buffer(count), packed(count), expected(count);
+        ucp_datatype_t datatype;
+
+        for (size_t i = 0; i < count; ++i) {
+            packed[i] = (T)(int)(ucs::rand() % 2000) - 1000;
+            buffer[i] = (T)(int)(ucs::rand() % 2000) - 1000;
+            if (op == UCP_DT_UNPACK_OP_SUM) {
+                expected[i] = buffer[i] + packed[i];
+            } else {
+                expected[i] = std::max(buffer[i], packed[i]);
+            }
+        }
+
+        ASSERT_UCS_OK(ucp_dt_create_unpack_op(op, elem_type, &datatype));
+        unpack(datatype, &buffer[0], count, &packed[0], count * sizeof(T));
+        EXPECT_TRUE(expected == buffer);
+        ucp_dt_destroy(datatype);
+    }
+
+    static void unpack(ucp_datatype_t datatype, void *buffer, size_t count,
+                       const void *packed, size_t length) {
+        ucp_dt_generic_t *dt_gen = ucp_dt_to_generic(datatype);
+        void *state              = dt_gen->ops.start_unpack(dt_gen->context,
+                                                            buffer, count);
+
+        ASSERT_EQ(length, dt_gen->ops.packed_size(state));
+
+        std::vector<std::pair<size_t, size_t> > frags = random_frags(length);
+        for (size_t i = 0; i < frags.size(); ++i) {
+            ASSERT_UCS_OK(dt_gen->ops.unpack(state, frags[i].first,
+                                             UCS_PTR_BYTE_OFFSET(
+                                                     packed, frags[i].first),
+                                             frags[i].second));
+        }
+
+        dt_gen->ops.finish(state);
+    }
+};
+
+UCS_TEST_F(test_ucp_dt_unpack_op, sum) {
+    test_unpack<int32_t>(UCP_DT_UNPACK_OP_SUM, UCP_DT_ELEM_TYPE_INT32);
+    test_unpack<int64_t>(UCP_DT_UNPACK_OP_SUM, UCP_DT_ELEM_TYPE_INT64);
+    test_unpack<float>(UCP_DT_UNPACK_OP_SUM, UCP_DT_ELEM_TYPE_FLOAT32);
+    test_unpack<double>(UCP_DT_UNPACK_OP_SUM, UCP_DT_ELEM_TYPE_FLOAT64);
+}
+
+UCS_TEST_F(test_ucp_dt_unpack_op, max) {
+    test_unpack<int32_t>(UCP_DT_UNPACK_OP_MAX, UCP_DT_ELEM_TYPE_INT32);
+    test_unpack<int64_t>(UCP_DT_UNPACK_OP_MAX, UCP_DT_ELEM_TYPE_INT64);
+    test_unpack<float>(UCP_DT_UNPACK_OP_MAX, UCP_DT_ELEM_TYPE_FLOAT32);
+    test_unpack<double>(UCP_DT_UNPACK_OP_MAX, UCP_DT_ELEM_TYPE_FLOAT64);
+}
+
+UCS_TEST_F(test_ucp_dt_unpack_op, to_float16) {
+    const size_t count = 1000;
+    std::vector<float> packed(count), repacked(count);
+    std::vector<uint16_t> buffer(count), expected(count);
+    ucp_datatype_t datatype;
+
+    for (size_t i = 0; i < count; ++i) {
+        packed[i] = ((ucs::rand() % 20000) - 10000) / 7.0f;
+    }
+    ucs_float_to_half(&expected[0], &packed[0], count);
+
+    ASSERT_UCS_OK(ucp_dt_create_unpack_op(UCP_DT_UNPACK_OP_TO_FLOAT16,
+                                          UCP_DT_ELEM_TYPE_FLOAT32,
+                                          &datatype));
+    unpack(datatype, &buffer[0], count, &packed[0], count * sizeof(float));
+    EXPECT_TRUE(expected == buffer);
+
+    /* Packing converts back to single precision */
+    ucp_dt_generic_t *dt_gen = ucp_dt_to_generic(datatype);
+    void *state              = dt_gen->ops.start_pack(dt_gen->context,
+                                                      &buffer[0], count);
+    std::vector<std::pair<size_t, size_t> > frags =
+            random_frags(count * sizeof(float));
+    for (size_t i = 0; i < frags.size(); ++i) {
+        EXPECT_EQ(frags[i].second,
+                  dt_gen->ops.pack(state, frags[i].first,
+                                   UCS_PTR_BYTE_OFFSET(&repacked[0],
+                                                       frags[i].first),
+                                   frags[i].second));
+    }
+    dt_gen->ops.finish(state);
+
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_NEAR(packed[i], repacked[i], fabs(packed[i]) / 1024)
+                << "index " << i;
+    }
+
+    ucp_dt_destroy(datatype);
+}
+
+UCS_TEST_F(test_ucp_dt_unpack_op, invalid_params) {
+    ucp_datatype_t datatype;
+
+    scoped_log_handler wrap_err(wrap_errors_logger);
+
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucp_dt_create_unpack_op(UCP_DT_UNPACK_OP_TO_FLOAT16,
+                                      UCP_DT_ELEM_TYPE_INT32, &datatype));
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucp_dt_create_unpack_op(UCP_DT_UNPACK_OP_SUM,
+                                      (ucp_dt_elem_type_t)100, &datatype));
+}
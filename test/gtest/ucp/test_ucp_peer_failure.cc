@@ -481,52 +481,62 @@ public:
     static void get_test_variants(std::vector<ucp_test_variant>& variants) {
         add_variant_with_value(variants, UCP_FEATURE_TAG, TEST_TAG, "tag");
     }
-};
 
-UCS_TEST_P(test_ucp_peer_failure_keepalive, kill_receiver,
-           "KEEPALIVE_INTERVAL=0.3", "KEEPALIVE_NUM_EPS=inf") {
-    /* TODO: wireup is not tested yet */
+    void kill_receiver_test() {
+        /* TODO: wireup is not tested yet */
 
-    scoped_log_handler err_handler(wrap_errors_logger);
-    scoped_log_handler warn_handler(hide_warns_logger);
+        scoped_log_handler err_handler(wrap_errors_logger);
+        scoped_log_handler warn_handler(hide_warns_logger);
 
-    /* initiate p2p pairing */
-    ucp_ep_resolve_remote_id(failing_sender(), 0);
-    smoke_test(true); /* allow wireup to complete */
-    smoke_test(false);
+        /* initiate p2p pairing */
+        ucp_ep_resolve_remote_id(failing_sender(), 0);
+        smoke_test(true); /* allow wireup to complete */
+        smoke_test(false);
 
-    if (ucp_ep_config(stable_sender())->key.ep_check_map == 0) {
-        UCS_TEST_SKIP_R("Unsupported");
-    }
+        if (ucp_ep_config(stable_sender())->key.ep_check_map == 0) {
+            UCS_TEST_SKIP_R("Unsupported");
+        }
 
-    /* ensure both pair have ep_check map */
-    ASSERT_NE(0, ucp_ep_config(failing_sender())->key.ep_check_map);
+        /* ensure both pair have ep_check map */
+        ASSERT_NE(0, ucp_ep_config(failing_sender())->key.ep_check_map);
 
-    /* aux (ud) transport doesn't support keepalive feature and
-     * we are assuming that wireup/connect procedure is done */
+        /* aux (ud) transport doesn't support keepalive feature and
+         * we are assuming that wireup/connect procedure is done */
 
-    EXPECT_EQ(0, m_err_count); /* ensure no errors are detected */
+        EXPECT_EQ(0, m_err_count); /* ensure no errors are detected */
 
-    /* flush all outstanding ops to allow keepalive to run */
-    flush_worker(sender());
+        /* flush all outstanding ops to allow keepalive to run */
+        flush_worker(sender());
 
-    /* kill EPs & ifaces */
-    failing_receiver().close_all_eps(*this, 0, UCP_EP_CLOSE_MODE_FORCE);
-    wait_for_flag(&m_err_count);
+        /* kill EPs & ifaces */
+        failing_receiver().close_all_eps(*this, 0, UCP_EP_CLOSE_MODE_FORCE);
+        wait_for_flag(&m_err_count);
 
-    /* dump warnings */
-    int warn_count = m_warnings.size();
-    for (int i = 0; i < warn_count; ++i) {
-        UCS_TEST_MESSAGE << "< " << m_warnings[i] << " >";
-    }
+        /* dump warnings */
+        int warn_count = m_warnings.size();
+        for (int i = 0; i < warn_count; ++i) {
+            UCS_TEST_MESSAGE << "< " << m_warnings[i] << " >";
+        }
 
-    EXPECT_NE(0, m_err_count);
+        EXPECT_NE(0, m_err_count);
 
-    /* check if stable receiver is still works */
-    m_err_count = 0;
-    smoke_test(true);
+        /* check if stable receiver is still works */
+        m_err_count = 0;
+        smoke_test(true);
+
+        EXPECT_EQ(0, m_err_count); /* ensure no errors are detected */
+    }
+};
+
+UCS_TEST_P(test_ucp_peer_failure_keepalive, kill_receiver,
+           "KEEPALIVE_INTERVAL=0.3", "KEEPALIVE_NUM_EPS=inf") {
+    kill_receiver_test();
+}
 
-    EXPECT_EQ(0, m_err_count); /* ensure no errors are detected */
+UCS_TEST_P(test_ucp_peer_failure_keepalive, kill_receiver_limit_num_eps,
+           "KEEPALIVE_INTERVAL=0.3", "KEEPALIVE_NUM_EPS=1") {
+    /* only one EP is checked per progress call, the rest are postponed */
+    kill_receiver_test();
 }
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_peer_failure_keepalive)
@@ -309,6 +309,26 @@ UCS_TEST_SKIP_COND_P(test_ucp_perf, envelope, has_transport("self"))
     }
 }
 
+UCS_TEST_SKIP_COND_P(test_ucp_perf, connect, has_transport("self"))
+{
+    const test_spec test = { "connection rate", "conn/sec",
+                             UCX_PERF_API_UCP, UCX_PERF_CMD_CONNECT,
+                             UCX_PERF_TEST_TYPE_STREAM_UNI,
+                             UCX_PERF_WAIT_MODE_POLL,
+                             UCP_PERF_DATATYPE_CONTIG, 0, 1, { 8 }, 1, 100lu,
+                             ucs_offsetof(ucx_perf_result_t,
+                                          msgrate.total_average),
+                             1.0, 0.0, 0.0, 0 };
+
+    std::stringstream ss;
+    ss << GetParam();
+    /* coverity[tainted_string_argument] */
+    ucs::scoped_setenv tls("UCX_TLS", ss.str().c_str());
+    ucs::scoped_setenv warn_invalid("UCX_WARN_INVALID_CONFIG", "no");
+
+    run_test(test, 0, false, "", "");
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_perf)
 
 
@@ -11,6 +11,7 @@
 extern "C" {
 #include <ucp/core/ucp_rkey.h>
 #include <ucp/proto/proto.h>
+#include <ucp/proto/proto_cache.h>
 #include <ucp/proto/proto_select.h>
 #include <ucp/proto/proto_select.inl>
 #include <ucp/core/ucp_worker.inl>
@@ -56,7 +57,9 @@ UCS_TEST_P(test_ucp_proto, dump_protocols) {
     ucp_worker_cfg_index_t ep_cfg_index   = sender().ep()->cfg_index;
     ucp_worker_cfg_index_t rkey_cfg_index = UCP_WORKER_CFG_INDEX_NULL;
 
-    ucp_proto_select_lookup(worker, &worker->ep_config[ep_cfg_index].proto_select,
+    ucp_proto_select_lookup(worker,
+                            &ucp_worker_ep_config(worker,
+                                                  ep_cfg_index)->proto_select,
                             ep_cfg_index, rkey_cfg_index, &select_param, 0);
     ucp_ep_print_info(sender().ep(), stdout);
 }
@@ -112,3 +115,99 @@ UCS_TEST_P(test_ucp_proto, worker_print_info_rkey)
 }
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_proto)
+
+class test_ucp_proto_cache : public test_ucp_proto {
+protected:
+    virtual void init() {
+        char file_template[] = "/tmp/ucx_proto_cache_XXXXXX";
+        int fd;
+
+        fd = mkstemp(file_template);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        /* Start with no cache file */
+        unlink(file_template);
+
+        m_cache_file = file_template;
+        modify_config("PROTO_CACHE_FILE", m_cache_file);
+        test_ucp_proto::init();
+    }
+
+    virtual void cleanup() {
+        test_ucp_proto::cleanup();
+        unlink(m_cache_file.c_str());
+    }
+
+    void select_param_init(ucp_proto_select_param_t *select_param) {
+        ucs_memory_info_t mem_info;
+
+        ucp_memory_info_set_host(&mem_info);
+        ucp_proto_select_param_init(select_param, UCP_OP_ID_TAG_SEND, 0,
+                                    UCP_DATATYPE_CONTIG, &mem_info, 1);
+    }
+
+    std::string m_cache_file;
+};
+
+UCS_TEST_P(test_ucp_proto_cache, save_and_load) {
+    ucp_context_h context               = sender().ucph();
+    ucp_worker_cfg_index_t ep_cfg_index = sender().ep()->cfg_index;
+    ucp_proto_select_t *proto_select    =
+            &ucp_worker_ep_config(worker(), ep_cfg_index)->proto_select;
+    const ucp_proto_cache_elem_t *cache_elem;
+    ucp_proto_select_elem_t *select_elem;
+    ucp_proto_select_param_t select_param;
+    ucp_proto_select_t tmp_proto_select;
+    ucs_status_t status;
+    uint64_t key;
+    unsigned i;
+
+    ASSERT_TRUE(context->proto_cache != NULL);
+    ucp_proto_select_prefill(worker(), ep_cfg_index);
+
+    select_param_init(&select_param);
+    select_elem = ucp_proto_select_lookup_slow(worker(), proto_select,
+                                               ep_cfg_index,
+                                               UCP_WORKER_CFG_INDEX_NULL,
+                                               &select_param);
+    ASSERT_TRUE(select_elem != NULL);
+
+    /* Save the cache to the file and load it again */
+    ucp_proto_cache_destroy(context->proto_cache);
+    context->proto_cache = NULL;
+    EXPECT_EQ(0, access(m_cache_file.c_str(), R_OK));
+    status = ucp_proto_cache_create(context, m_cache_file.c_str(),
+                                    &context->proto_cache);
+    ASSERT_UCS_OK(status);
+
+    key        = ucp_proto_cache_key(worker(), ep_cfg_index,
+                                     UCP_WORKER_CFG_INDEX_NULL, &select_param);
+    cache_elem = ucp_proto_cache_lookup(context->proto_cache, key);
+    ASSERT_TRUE(cache_elem != NULL);
+
+    /* Selection from the loaded cache is the same as the original one */
+    status = ucp_proto_select_init(&tmp_proto_select);
+    ASSERT_UCS_OK(status);
+
+    const ucp_proto_select_elem_t *cached_select_elem =
+            ucp_proto_select_lookup_slow(worker(), &tmp_proto_select,
+                                         ep_cfg_index,
+                                         UCP_WORKER_CFG_INDEX_NULL,
+                                         &select_param);
+    ASSERT_TRUE(cached_select_elem != NULL);
+
+    i = 0;
+    do {
+        EXPECT_EQ(cache_elem->thresholds[i].max_length,
+                  select_elem->thresholds[i].max_msg_length);
+        EXPECT_EQ(select_elem->thresholds[i].proto_config.proto,
+                  cached_select_elem->thresholds[i].proto_config.proto);
+        EXPECT_EQ(select_elem->thresholds[i].max_msg_length,
+                  cached_select_elem->thresholds[i].max_msg_length);
+    } while (select_elem->thresholds[i++].max_msg_length != SIZE_MAX);
+    EXPECT_EQ(i, cache_elem->num_thresholds);
+
+    ucp_proto_select_cleanup(&tmp_proto_select);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_proto_cache)
@@ -12,6 +12,7 @@
 #include <ucs/sys/sys.h>
 #include <ifaddrs.h>
 #include <sys/poll.h>
+#include <algorithm>
 
 extern "C" {
 #include <ucp/core/ucp_listener.h>
@@ -437,7 +438,8 @@ public:
         return get_ep_params();
     }
 
-    void client_ep_connect_basic(const ucp_ep_params_t &base_ep_params)
+    void client_ep_connect_basic(const ucp_ep_params_t &base_ep_params,
+                                 int ep_idx = 0)
     {
         ucp_ep_params_t ep_params = base_ep_params;
 
@@ -449,7 +451,7 @@ public:
         ep_params.sockaddr.addrlen = m_test_addr.get_addr_size();
         ep_params.user_data        = &sender();
 
-        sender().connect(&receiver(), ep_params);
+        sender().connect(&receiver(), ep_params, ep_idx);
     }
 
     void client_ep_connect()
@@ -990,6 +992,66 @@ UCS_TEST_P(test_ucp_sockaddr, connect_and_fail_wireup)
     concurrent_disconnect(UCP_EP_CLOSE_MODE_FORCE);
 }
 
+UCS_TEST_P(test_ucp_sockaddr, conn_rate)
+{
+    const int num_conns = 64;
+    ucs_time_t start, deadline;
+    double elapsed;
+
+    start_listener(cb_type());
+
+    {
+        scoped_log_handler slh(detect_error_logger);
+
+        /* All clients connect at once, and the server accepts them */
+        start = ucs_get_time();
+        for (int i = 0; i < num_conns; ++i) {
+            client_ep_connect_basic(get_ep_params(), i);
+        }
+
+        deadline = ucs::get_deadline();
+        while ((receiver().get_num_eps() < num_conns) &&
+               (sender().get_err_num() == 0) && (ucs_get_time() < deadline)) {
+            progress();
+        }
+    }
+
+    if ((sender().get_err_num() != 0) ||
+        (receiver().get_num_eps() < num_conns)) {
+        UCS_TEST_SKIP_R("cannot connect to server");
+    }
+
+    elapsed = ucs_time_to_sec(ucs_get_time() - start);
+    UCS_TEST_MESSAGE << num_conns << " connections in " << (elapsed * 1e3)
+                     << " ms, " << (num_conns / elapsed)
+                     << " connections/sec";
+
+    /* Close all endpoints on both sides concurrently, to avoid an error
+     * callback on every endpoint of the peer */
+    std::vector<void*> close_reqs;
+    for (int i = 0; i < num_conns; ++i) {
+        close_reqs.push_back(sender().disconnect_nb(0, i,
+                                                    UCP_EP_CLOSE_MODE_FLUSH));
+        close_reqs.push_back(receiver().disconnect_nb(0, i,
+                                                      UCP_EP_CLOSE_MODE_FLUSH));
+    }
+
+    {
+        scoped_log_handler slh(detect_error_logger);
+        deadline = ucs::get_deadline();
+        while (!std::all_of(close_reqs.begin(), close_reqs.end(),
+                            is_request_completed) &&
+               (ucs_get_time() < deadline)) {
+            progress();
+        }
+    }
+
+    for (int i = 0; i < num_conns; ++i) {
+        sender().close_ep_req_free(close_reqs[2 * i]);
+        receiver().close_ep_req_free(close_reqs[(2 * i) + 1]);
+    }
+}
+
 UCP_INSTANTIATE_ALL_TEST_CASE(test_ucp_sockaddr)
 
 
@@ -177,7 +177,21 @@ UCP_INSTANTIATE_TEST_CASE(test_ucp_stream_onesided)
 class test_ucp_stream : public test_ucp_stream_base
 {
 public:
+    enum {
+        ENABLE_PROTO = UCS_BIT(0)
+    };
+
+    static void get_test_variants(std::vector<ucp_test_variant>& variants) {
+        add_variant(variants, UCP_FEATURE_STREAM);
+        add_variant_with_value(variants, UCP_FEATURE_STREAM, ENABLE_PROTO,
+                               "proto");
+    }
+
     virtual void init() {
+        if (get_variant_value() & ENABLE_PROTO) {
+            modify_config("PROTO_ENABLE", "y");
+        }
+
         ucp_test::init();
 
         sender().connect(&receiver(), get_ep_params());
@@ -193,6 +207,7 @@ protected:
     template <typename T, unsigned recv_flags>
     void do_send_exp_recv_test(ucp_datatype_t datatype);
     void do_send_recv_data_recv_test(ucp_datatype_t datatype);
+    void do_send_recv_rndv_interleaved_test(bool exp_recv);
 
     /* for self-validation of generic datatype
      * NOTE: it's tested only with byte array data since it's recv completion
@@ -488,6 +503,60 @@ UCS_TEST_P(test_ucp_stream, send_iov_recv_data) {
     do_send_recv_data_test(DATATYPE_IOV);
 }
 
+UCS_TEST_P(test_ucp_stream, send_recv_data_iov) {
+    const size_t      msg_size = 5000;
+    const size_t      n_msgs   = 16;
+    std::vector<char> sbuf(msg_size * n_msgs);
+    std::vector<char> rbuf;
+    ucp_dt_iov_t      iov[4];
+    ucs_status_ptr_t  sstatus;
+    size_t            iovcnt, length, consume;
+
+    ucs::fill_random(sbuf);
+    for (size_t i = 0; i < n_msgs; ++i) {
+        ucp::data_type_desc_t dt_desc(DATATYPE, &sbuf[i * msg_size],
+                                      msg_size);
+        sstatus = stream_send_nb(dt_desc);
+        EXPECT_FALSE(UCS_PTR_IS_ERR(sstatus));
+        request_wait(sstatus);
+    }
+
+    while (rbuf.size() < sbuf.size()) {
+        progress();
+        iovcnt = ucs_static_array_size(iov);
+        ASSERT_UCS_OK(ucp_stream_recv_data_iov(receiver().ep(), iov, &iovcnt,
+                                               &length));
+        if (iovcnt == 0) {
+            EXPECT_EQ(0u, length);
+            continue;
+        }
+
+        /* consume an odd prefix, to also release partial descriptors */
+        consume = ucs_max(length / 3, 1);
+        for (size_t i = 0; (i < iovcnt) && (consume > 0); ++i) {
+            size_t chunk = ucs_min(consume, iov[i].length);
+            const char *data = static_cast<const char*>(iov[i].buffer);
+
+            rbuf.insert(rbuf.end(), data, data + chunk);
+            consume -= chunk;
+        }
+
+        ASSERT_UCS_OK(ucp_stream_data_consume(receiver().ep(),
+                                              ucs_max(length / 3, 1)));
+    }
+
+    EXPECT_EQ(sbuf, rbuf);
+
+    iovcnt = ucs_static_array_size(iov);
+    ASSERT_UCS_OK(ucp_stream_recv_data_iov(receiver().ep(), iov, &iovcnt,
+                                           &length));
+    EXPECT_EQ(0u, iovcnt);
+
+    scoped_log_handler wrap_err(wrap_errors_logger);
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucp_stream_data_consume(receiver().ep(), 1));
+}
+
 UCS_TEST_P(test_ucp_stream, send_generic_recv_data) {
     ucp_datatype_t dt;
     ucs_status_t status;
@@ -643,6 +712,92 @@ UCS_TEST_P(test_ucp_stream, send_zero_ending_iov_recv_data) {
     }
 }
 
+UCS_TEST_P(test_ucp_stream, send_recv_data_rndv, "RNDV_THRESH=4K") {
+    do_send_recv_data_test(ucp_dt_make_contig(1));
+}
+
+UCS_TEST_P(test_ucp_stream, send_recv_rndv, "RNDV_THRESH=4K") {
+    ucp_datatype_t datatype = ucp_dt_make_contig(sizeof(uint32_t));
+
+    do_send_recv_test<uint32_t, 0>(datatype);
+    do_send_recv_test<uint32_t, UCP_STREAM_RECV_FLAG_WAITALL>(datatype);
+}
+
+UCS_TEST_P(test_ucp_stream, send_exp_recv_rndv, "RNDV_THRESH=4K") {
+    ucp_datatype_t datatype = ucp_dt_make_contig(sizeof(uint8_t));
+
+    do_send_exp_recv_test<uint8_t, 0>(datatype);
+    do_send_exp_recv_test<uint8_t, UCP_STREAM_RECV_FLAG_WAITALL>(datatype);
+}
+
+void test_ucp_stream::do_send_recv_rndv_interleaved_test(bool exp_recv)
+{
+    const size_t num_msgs = 32;
+    std::vector<size_t> sizes;
+    size_t total_size     = 0;
+
+    /* eager and rendezvous sends are posted back-to-back, so the eager data
+     * arrives while preceding rendezvous data is still being received */
+    for (size_t i = 0; i < num_msgs; ++i) {
+        sizes.push_back((i % 2) ? (i + 1) : ((64 * UCS_KBYTE) + i));
+        total_size += sizes.back();
+    }
+
+    std::vector<char> sbuf(total_size);
+    ucs::fill_random(sbuf, sbuf.size());
+
+    std::vector<char> rbuf(total_size, 'r');
+    std::vector<void*> sreqs;
+    ucp_request_param_t param;
+    size_t length;
+    void *rreq = NULL;
+
+    /* the expected receive gets the rendezvous data directly while it's not
+     * preceded by other data */
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags        = UCP_STREAM_RECV_FLAG_WAITALL;
+    if (exp_recv) {
+        rreq = ucp_stream_recv_nbx(receiver().ep(), &rbuf[0], rbuf.size(),
+                                   &length, &param);
+        ASSERT_TRUE(UCS_PTR_IS_PTR(rreq));
+    }
+
+    param.op_attr_mask = 0;
+
+    size_t offset = 0;
+    for (size_t i = 0; i < num_msgs; ++i) {
+        void *sreq = ucp_stream_send_nbx(sender().ep(), &sbuf[offset],
+                                         sizes[i], &param);
+        ASSERT_FALSE(UCS_PTR_IS_ERR(sreq));
+        sreqs.push_back(sreq);
+        offset += sizes[i];
+    }
+
+    if (!exp_recv) {
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+        rreq = ucp_stream_recv_nbx(receiver().ep(), &rbuf[0], rbuf.size(),
+                                   &length, &param);
+        ASSERT_FALSE(UCS_PTR_IS_ERR(rreq));
+    }
+
+    if (UCS_PTR_IS_PTR(rreq)) {
+        length = wait_stream_recv(rreq);
+    }
+
+    ASSERT_UCS_OK(requests_wait(sreqs));
+
+    EXPECT_EQ(total_size, length);
+    EXPECT_EQ(sbuf, rbuf);
+}
+
+UCS_TEST_P(test_ucp_stream, send_recv_rndv_interleaved, "RNDV_THRESH=4K") {
+    do_send_recv_rndv_interleaved_test(false);
+}
+
+UCS_TEST_P(test_ucp_stream, send_exp_recv_rndv_interleaved, "RNDV_THRESH=4K") {
+    do_send_recv_rndv_interleaved_test(true);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_stream)
 
 class test_ucp_stream_many2one : public test_ucp_stream_base {
@@ -9,6 +9,13 @@
 
 #include <common/test_helpers.h>
 
+extern "C" {
+#include <ucp/core/ucp_ep.inl>
+#include <ucp/core/ucp_shared_iface.h>
+#include <ucp/core/ucp_worker.h>
+#include <ucp/wireup/wireup_ep.h>
+}
+
 #if _OPENMP
 #include "omp.h"
 #endif
@@ -35,42 +42,301 @@ public:
     {
         return get_variant_value() == RECV_REQ_EXTERNAL;
     }
+
+protected:
+    void test_send_recv(size_t size)
+    {
+        std::vector<std::vector<char> > send_data(MT_TEST_NUM_THREADS);
+        std::vector<std::vector<char> > recv_data(MT_TEST_NUM_THREADS);
+        ucp_tag_recv_info_t info[MT_TEST_NUM_THREADS] GTEST_ATTRIBUTE_UNUSED_;
+
+        for (int i = 0; i < MT_TEST_NUM_THREADS; i++) {
+            send_data[i].resize(size);
+            recv_data[i].resize(size, 0);
+            ucs::fill_random(send_data[i]);
+        }
+
+#if _OPENMP && ENABLE_MT
+#pragma omp parallel for
+        for (int i = 0; i < MT_TEST_NUM_THREADS; i++) {
+            ucs_status_t status;
+            int worker_index = 0;
+
+            if (get_variant_thread_type() == MULTI_THREAD_CONTEXT) {
+                worker_index = i;
+            }
+
+            send_b(&send_data[i][0], size, DATATYPE, 0x111337+i, NULL, i);
+
+            short_progress_loop(worker_index); /* Receive messages as unexpected */
+
+            status = recv_b(&recv_data[i][0], size, DATATYPE, 0x1337+i, 0xffff,
+                            &(info[i]), NULL, i);
+            ASSERT_UCS_OK(status);
+
+            EXPECT_EQ(size,                    info[i].length);
+            EXPECT_EQ((ucp_tag_t)(0x111337+i), info[i].sender_tag);
+            EXPECT_EQ(send_data[i], recv_data[i]);
+        }
+#endif
+    }
 };
 
 UCS_TEST_P(test_ucp_tag_mt, send_recv) {
-    uint64_t            send_data[MT_TEST_NUM_THREADS] GTEST_ATTRIBUTE_UNUSED_;
-    uint64_t            recv_data[MT_TEST_NUM_THREADS] GTEST_ATTRIBUTE_UNUSED_;
-    ucp_tag_recv_info_t info[MT_TEST_NUM_THREADS] GTEST_ATTRIBUTE_UNUSED_;
+    test_send_recv(sizeof(uint64_t));
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_mt)
+
+
+class test_ucp_tag_mt_shared_iface : public test_ucp_tag_mt {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant>& variants)
+    {
+        add_variant_with_value(variants, get_ctx_params(), RECV_REQ_INTERNAL,
+                               "req_int,mt_context", MULTI_THREAD_CONTEXT);
+    }
 
-    for (int i = 0; i < MT_TEST_NUM_THREADS; i++) {
-        send_data[i] = 0xdeadbeefdeadbeef + 10 * i;
-        recv_data[i] = 0;
+    virtual void init()
+    {
+        modify_config("SHARED_IFACES", "*");
+        test_ucp_tag_mt::init();
     }
 
-#if _OPENMP && ENABLE_MT
-#pragma omp parallel for
-    for (int i = 0; i < MT_TEST_NUM_THREADS; i++) {
+protected:
+    /* Check all workers use the same shared transport interfaces */
+    void check_shared_ifaces(const entity &e)
+    {
+        ucp_worker_h worker0 = e.worker(0);
+        unsigned num_shared  = 0;
+        ucp_worker_h worker;
+
+        for (ucp_rsc_index_t i = 0; i < worker0->num_ifaces; ++i) {
+            if (!(worker0->ifaces[i]->flags & UCP_WORKER_IFACE_FLAG_SHARED)) {
+                continue;
+            }
+
+            ++num_shared;
+            for (int w = 1; w < e.get_num_workers(); ++w) {
+                worker = e.worker(w);
+                ASSERT_EQ(worker0->num_ifaces, worker->num_ifaces);
+                EXPECT_TRUE(worker->ifaces[i]->flags &
+                            UCP_WORKER_IFACE_FLAG_SHARED);
+                EXPECT_EQ(shared_tl(worker0->ifaces[i]),
+                          shared_tl(worker->ifaces[i]));
+            }
+        }
+
+        EXPECT_GT(num_shared, 0u);
+    }
+
+private:
+    static ucp_shared_tl_t *shared_tl(ucp_worker_iface_t *wiface)
+    {
+        EXPECT_TRUE(ucp_shared_iface_test(wiface->iface));
+        return ucs_derived_of(wiface->iface, ucp_shared_iface_t)->tl;
+    }
+};
+
+UCS_TEST_P(test_ucp_tag_mt_shared_iface, send_recv) {
+    check_shared_ifaces(sender());
+    check_shared_ifaces(receiver());
+    test_send_recv(sizeof(uint64_t));
+}
+
+UCS_TEST_P(test_ucp_tag_mt_shared_iface, send_recv_large) {
+    test_send_recv(100 * UCS_KBYTE);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_mt_shared_iface)
+
+
+class test_ucp_tag_shared_iface : public test_ucp_tag {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant>& variants)
+    {
+        add_variant(variants, get_ctx_params());
+    }
+
+    virtual void init()
+    {
+        modify_config("SHARED_IFACES", "*");
+        test_ucp_tag::init();
+    }
+
+protected:
+    /* Count the lanes of an endpoint on shared interfaces, which must use
+     * shared connections */
+    static unsigned num_shared_lanes(ucp_ep_h ep)
+    {
+        unsigned num_shared = 0;
+        ucp_rsc_index_t rsc_index;
+        ucp_shared_ep_t *sep;
+        uct_ep_h uct_ep;
+
+        for (ucp_lane_index_t lane = 0; lane < ucp_ep_num_lanes(ep); ++lane) {
+            rsc_index = ucp_ep_get_rsc_index(ep, lane);
+            uct_ep    = ep->uct_eps[lane];
+            if ((rsc_index == UCP_NULL_RESOURCE) ||
+                ucp_ep_is_lane_p2p(ep, lane) || ucp_wireup_ep_test(uct_ep) ||
+                !(ucp_worker_iface(ep->worker, rsc_index)->flags &
+                  UCP_WORKER_IFACE_FLAG_SHARED)) {
+                continue;
+            }
+
+            ++num_shared;
+            sep = ucs_derived_of(uct_ep, ucp_shared_ep_t);
+            EXPECT_NE((ucp_shared_conn_t*)NULL, sep->conn) << "lane "
+                                                           << int(lane);
+        }
+
+        return num_shared;
+    }
+
+    static ucp_shared_tl_t *shared_tl(ucp_worker_iface_t *wiface)
+    {
+        return ucs_derived_of(wiface->iface, ucp_shared_iface_t)->tl;
+    }
+
+    void wait_worker(ucp_worker_h worker, void *req)
+    {
+        ucs_time_t deadline = ucs::get_deadline();
         ucs_status_t status;
-        int worker_index = 0;
 
-        if (get_variant_thread_type() == MULTI_THREAD_CONTEXT) {
-            worker_index = i;
+        if (req == NULL) {
+            return;
         }
 
-        send_b(&(send_data[i]), sizeof(send_data[i]), DATATYPE, 0x111337+i,
-               NULL, i);
+        ASSERT_FALSE(UCS_PTR_IS_ERR(req)) << ucs_status_string(
+                                                     UCS_PTR_STATUS(req));
+        do {
+            ucp_worker_progress(worker);
+            progress();
+            status = ucp_request_check_status(req);
+        } while ((status == UCS_INPROGRESS) && (ucs_get_time() < deadline));
+
+        EXPECT_EQ(UCS_OK, status);
+        ucp_request_free(req);
+    }
+};
 
-        short_progress_loop(worker_index); /* Receive messages as unexpected */
+/* The self transport reaches only the worker itself */
+UCS_TEST_SKIP_COND_P(test_ucp_tag_shared_iface, two_workers,
+                     has_transport("self")) {
+    ucp_worker_params_t worker_params;
+    ucs::handle<ucp_worker_h> worker;
+    ucp_address_t *address;
+    size_t address_length;
+    ucp_ep_params_t ep_params;
+    ucp_request_param_t param;
+    ucp_ep_h ep;
 
-        status = recv_b(&(recv_data[i]), sizeof(recv_data[i]), DATATYPE, 0x1337+i,
-                        0xffff, &(info[i]), NULL, i);
-        ASSERT_UCS_OK(status);
+    /* Another worker on the sender context, which is not shared by threads */
+    worker_params.field_mask  = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
+    worker_params.thread_mode = UCS_THREAD_MODE_SINGLE;
+    UCS_TEST_CREATE_HANDLE(ucp_worker_h, worker, ucp_worker_destroy,
+                           ucp_worker_create, sender().ucph(), &worker_params);
 
-        EXPECT_EQ(sizeof(send_data[i]),   info[i].length);
-        EXPECT_EQ((ucp_tag_t)(0x111337+i), info[i].sender_tag);
-        EXPECT_EQ(send_data[i], recv_data[i]);
+    for (ucp_rsc_index_t i = 0; i < worker->num_ifaces; ++i) {
+        ASSERT_EQ(sender().worker()->ifaces[i]->flags &
+                  UCP_WORKER_IFACE_FLAG_SHARED,
+                  worker->ifaces[i]->flags & UCP_WORKER_IFACE_FLAG_SHARED);
+        if (worker->ifaces[i]->flags & UCP_WORKER_IFACE_FLAG_SHARED) {
+            EXPECT_EQ(shared_tl(sender().worker()->ifaces[i]),
+                      shared_tl(worker->ifaces[i]));
+        }
     }
-#endif
+
+    ASSERT_UCS_OK(ucp_worker_get_address(receiver().worker(), &address,
+                                         &address_length));
+    ep_params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+    ep_params.address    = address;
+    ASSERT_UCS_OK(ucp_ep_create(worker, &ep_params, &ep));
+    ucp_worker_release_address(receiver().worker(), address);
+
+    /* Both workers send to the same remote worker */
+    uint64_t send_data[2] = {0xdead, 0xbeef};
+    uint64_t recv_data[2] = {0, 0};
+    param.op_attr_mask    = 0;
+    void *reqs[]          = {
+        ucp_tag_send_nbx(sender().ep(), &send_data[0], sizeof(send_data[0]),
+                         0x10, &param),
+        ucp_tag_send_nbx(ep, &send_data[1], sizeof(send_data[1]), 0x11,
+                         &param),
+        ucp_tag_recv_nbx(receiver().worker(), &recv_data[0],
+                         sizeof(recv_data[0]), 0x10, (ucp_tag_t)-1, &param),
+        ucp_tag_recv_nbx(receiver().worker(), &recv_data[1],
+                         sizeof(recv_data[1]), 0x11, (ucp_tag_t)-1, &param)
+    };
+
+    for (size_t i = 0; i < ucs_static_array_size(reqs); ++i) {
+        wait_worker(worker, reqs[i]);
+    }
+
+    EXPECT_EQ(send_data[0], recv_data[0]);
+    EXPECT_EQ(send_data[1], recv_data[1]);
+    EXPECT_GT(num_shared_lanes(sender().ep()), 0u);
+    EXPECT_GT(num_shared_lanes(ep), 0u);
+
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags        = 0;
+    wait_worker(worker, ucp_ep_close_nbx(ep, &param));
 }
 
-UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_mt)
+UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_shared_iface)
+
+
+class test_ucp_tag_shared_iface_mixed : public test_ucp_tag_shared_iface {
+public:
+    virtual void init()
+    {
+        /* Only the receiver shares its tcp interfaces, so the peers have to
+         * use shared memory */
+        ucs::test_base::init();
+        create_entity();
+        modify_config("SHARED_IFACES", "tcp");
+        create_entity();
+
+        sender().connect(&receiver(), get_ep_params());
+        receiver().connect(&sender(), get_ep_params());
+    }
+};
+
+UCS_TEST_P(test_ucp_tag_shared_iface_mixed, send_recv) {
+    uint64_t send_data = 0xfeed, recv_data = 0;
+    ucp_tag_recv_info_t info;
+    request *req;
+
+    req = send(sender(), SEND_B, &send_data, sizeof(send_data),
+               ucp_dt_make_contig(1), 0x20);
+    ASSERT_UCS_PTR_OK(req);
+    req = recv(receiver(), RECV_B, &recv_data, sizeof(recv_data),
+               ucp_dt_make_contig(1), 0x20, (ucp_tag_t)-1, &info);
+    ASSERT_UCS_OK(UCS_PTR_STATUS(req));
+    EXPECT_EQ(send_data, recv_data);
+
+    recv_data = 0;
+    req = send(receiver(), SEND_B, &send_data, sizeof(send_data),
+               ucp_dt_make_contig(1), 0x21);
+    ASSERT_UCS_PTR_OK(req);
+    req = recv(sender(), RECV_B, &recv_data, sizeof(recv_data),
+               ucp_dt_make_contig(1), 0x21, (ucp_tag_t)-1, &info);
+    ASSERT_UCS_OK(UCS_PTR_STATUS(req));
+    EXPECT_EQ(send_data, recv_data);
+
+    /* Shared interfaces are not used with a peer which doesn't share them */
+    unsigned num_shared_ifaces = 0;
+    for (ucp_rsc_index_t i = 0; i < receiver().worker()->num_ifaces; ++i) {
+        if (receiver().worker()->ifaces[i]->flags &
+            UCP_WORKER_IFACE_FLAG_SHARED) {
+            ++num_shared_ifaces;
+        }
+    }
+
+    EXPECT_GT(num_shared_ifaces, 0u);
+    EXPECT_EQ(0u, num_shared_lanes(sender().ep()));
+    EXPECT_EQ(0u, num_shared_lanes(receiver().ep()));
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_tag_shared_iface_mixed, shm_tcp,
+                              "shm,tcp")
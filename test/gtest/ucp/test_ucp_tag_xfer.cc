@@ -13,6 +13,8 @@
 extern "C" {
 #include <ucp/core/ucp_resource.h>
 #include <ucp/core/ucp_ep.inl>
+#include <ucp/tag/tag_rndv.h>
+#include <ucs/arch/atomic.h>
 #include <ucs/datastruct/queue.h>
 }
 
@@ -28,6 +30,7 @@ public:
         VARIANT_RNDV_GET_ZCOPY,
         VARIANT_RNDV_AUTO,
         VARIANT_SEND_NBR,
+        VARIANT_PAYLOAD_CHECKSUM
     };
 
     test_ucp_tag_xfer() {
@@ -51,6 +54,8 @@ public:
             modify_config("RNDV_SCHEME", "get_zcopy");
         } else if (get_variant_value() == VARIANT_RNDV_AUTO) {
             modify_config("RNDV_SCHEME", "auto");
+        } else if (get_variant_value() == VARIANT_PAYLOAD_CHECKSUM) {
+            modify_config("PAYLOAD_CHECKSUM", "y");
         }
         modify_config("MAX_EAGER_LANES", "2");
         modify_config("MAX_RNDV_LANES", "2");
@@ -80,6 +85,8 @@ public:
                                VARIANT_RNDV_AUTO, "rndv_auto");
         add_variant_with_value(variants, get_ctx_params(),
                                VARIANT_SEND_NBR, "send_nbr");
+        add_variant_with_value(variants, get_ctx_params(),
+                               VARIANT_PAYLOAD_CHECKSUM, "payload_csum");
     }
 
     virtual ucp_ep_params_t get_ep_params() {
@@ -104,6 +111,9 @@ public:
     void test_xfer_contig(size_t size, bool expected, bool sync, bool truncated);
     void test_xfer_generic(size_t size, bool expected, bool sync, bool truncated);
     void test_xfer_iov(size_t size, bool expected, bool sync, bool truncated);
+    void test_xfer_strided(size_t size, bool expected, bool sync, bool truncated);
+    void test_xfer_unpack_op(size_t size, bool expected, bool sync,
+                             bool truncated);
     void test_xfer_generic_err(size_t size, bool expected, bool sync, bool truncated);
 
 protected:
@@ -126,6 +136,16 @@ protected:
 
     void test_xfer_len_offset();
 
+    void test_xfer_csum_mismatch(uint8_t am_id, uct_am_callback_t cb,
+                                 size_t size);
+
+    static ucs_status_t corrupt_eager_payload_handler(void *arg, void *data,
+                                                      size_t length,
+                                                      unsigned flags);
+
+    static ucs_status_t corrupt_rts_csum_handler(void *arg, void *data,
+                                                 size_t length, unsigned flags);
+
 private:
     request* do_send(const void *sendbuf, size_t count, ucp_datatype_t dt, bool sync);
 
@@ -405,6 +425,114 @@ void test_ucp_tag_xfer::test_xfer_iov(size_t size, bool expected, bool sync,
                                "IOV"));
 }
 
+static void strided_pack(std::vector<char> &packed,
+                         const std::vector<char> &buffer, size_t count,
+                         size_t elem_size, size_t rows, size_t stride)
+{
+    size_t extent = ((rows - 1) * stride) + elem_size;
+
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t row = 0; row < rows; ++row) {
+            const char *elem = &buffer[(i * extent) + (row * stride)];
+            packed.insert(packed.end(), elem, elem + elem_size);
+        }
+    }
+}
+
+void test_ucp_tag_xfer::test_xfer_strided(size_t size, bool expected, bool sync,
+                                          bool truncated)
+{
+    static const size_t elem_sizes[] = {1, 8, 100, 32 * UCS_KBYTE};
+    const size_t rows                = 4;
+    size_t elem_size                 = elem_sizes[ucs::rand() %
+                                                  ucs_static_array_size(elem_sizes)];
+    size_t count                     = size / (rows * elem_size);
+    /* Different layouts of the same elements on the sender and the receiver */
+    ucp_dt_strided_dim_t send_dim    = {rows, (2 * elem_size) + 3};
+    ucp_dt_strided_dim_t recv_dim    = {rows, 3 * elem_size};
+    ucp_datatype_t send_dt, recv_dt;
+    std::vector<char> sendbuf, recvbuf, recvbuf_orig, send_packed, recv_packed;
+    ucs_status_t status;
+    size_t recvd;
+
+    /* if count is zero, truncation has no effect */
+    if (truncated && (count == 0)) {
+        truncated = false;
+    }
+
+    status = ucp_dt_create_strided(elem_size, &send_dim, 1, &send_dt);
+    ASSERT_UCS_OK(status);
+    status = ucp_dt_create_strided(elem_size, &recv_dim, 1, &recv_dt);
+    ASSERT_UCS_OK(status);
+
+    sendbuf.resize(count * (((rows - 1) * send_dim.stride) + elem_size) + 1);
+    recvbuf.resize(count * (((rows - 1) * recv_dim.stride) + elem_size) + 1);
+    ucs::fill_random(sendbuf);
+    ucs::fill_random(recvbuf);
+    recvbuf_orig = recvbuf;
+
+    recvd = do_xfer(&sendbuf[0], &recvbuf[0], count, send_dt, recv_dt,
+                    expected, sync, truncated);
+    if (!truncated) {
+        ASSERT_EQ(count * rows * elem_size, recvd);
+
+        strided_pack(send_packed, sendbuf, count, elem_size, rows,
+                     send_dim.stride);
+        strided_pack(recv_packed, recvbuf, count, elem_size, rows,
+                     recv_dim.stride);
+        EXPECT_TRUE(send_packed == recv_packed) << "elem_size=" << elem_size
+                                                << " count=" << count;
+
+        /* Data between the elements must not be touched */
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t row = 0; row < rows; ++row) {
+                memcpy(&recvbuf_orig[(i * (((rows - 1) * recv_dim.stride) +
+                                            elem_size)) +
+                                     (row * recv_dim.stride)],
+                       &send_packed[((i * rows) + row) * elem_size],
+                       elem_size);
+            }
+        }
+        EXPECT_TRUE(recvbuf_orig == recvbuf) << "elem_size=" << elem_size
+                                             << " count=" << count;
+    }
+
+    ucp_dt_destroy(send_dt);
+    ucp_dt_destroy(recv_dt);
+}
+
+void test_ucp_tag_xfer::test_xfer_unpack_op(size_t size, bool expected,
+                                            bool sync, bool truncated)
+{
+    size_t count = size / sizeof(float);
+    std::vector<float> sendbuf(count), recvbuf(count), recvbuf_orig;
+    ucp_datatype_t recv_dt;
+    size_t recvd;
+
+    /* Integer values, so the sum is exact */
+    for (size_t i = 0; i < count; ++i) {
+        sendbuf[i] = ucs::rand() % 1000;
+        recvbuf[i] = ucs::rand() % 1000;
+    }
+    recvbuf_orig = recvbuf;
+
+    ASSERT_UCS_OK(ucp_dt_create_unpack_op(UCP_DT_UNPACK_OP_SUM,
+                                          UCP_DT_ELEM_TYPE_FLOAT32, &recv_dt));
+
+    recvd = do_xfer(sendbuf.data(), recvbuf.data(), count,
+                    ucp_dt_make_contig(sizeof(float)), recv_dt, expected, sync,
+                    truncated);
+    if (!truncated) {
+        ASSERT_EQ(count * sizeof(float), recvd);
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(recvbuf_orig[i] + sendbuf[i], recvbuf[i])
+                    << "index " << i << " count " << count;
+        }
+    }
+
+    ucp_dt_destroy(recv_dt);
+}
+
 void test_ucp_tag_xfer::test_xfer_generic_err(size_t size, bool expected,
                                               bool sync, bool truncated)
 {
@@ -557,6 +685,84 @@ void test_ucp_tag_xfer::test_xfer_len_offset()
     free(send_buf);
 }
 
+ucs_status_t
+test_ucp_tag_xfer::corrupt_eager_payload_handler(void *arg, void *data,
+                                                 size_t length, unsigned flags)
+{
+    std::vector<uint8_t> msg((uint8_t*)data, (uint8_t*)data + length);
+
+    /* flip the last payload byte, the checksum is ahead of the payload */
+    msg.back() ^= 0xff;
+    return ucp_am_handlers[UCP_AM_ID_EAGER_CSUM_ONLY].cb(
+            arg, &msg[0], length, flags & ~UCT_CB_PARAM_FLAG_DESC);
+}
+
+ucs_status_t
+test_ucp_tag_xfer::corrupt_rts_csum_handler(void *arg, void *data,
+                                            size_t length, unsigned flags)
+{
+    std::vector<uint8_t> msg((uint8_t*)data, (uint8_t*)data + length);
+    ucp_rndv_rts_hdr_t *rts_hdr = (ucp_rndv_rts_hdr_t*)&msg[0];
+
+    /* flip a byte of the checksum which follows the TAG RTS header */
+    EXPECT_TRUE(rts_hdr->flags & UCP_RNDV_RTS_FLAG_CSUM);
+    msg[sizeof(ucp_tag_rndv_rts_hdr_t)] ^= 0xff;
+    return ucp_am_handlers[UCP_AM_ID_RNDV_RTS].cb(
+            arg, &msg[0], length, flags & ~UCT_CB_PARAM_FLAG_DESC);
+}
+
+void test_ucp_tag_xfer::test_xfer_csum_mismatch(uint8_t am_id,
+                                                uct_am_callback_t cb,
+                                                size_t size)
+{
+    ucp_worker_h worker = receiver().worker();
+    std::vector<char> sendbuf(size, 0);
+    std::vector<char> recvbuf(size, 0);
+    ucp_worker_iface_t *wiface;
+    ucs_status_t status;
+    request *rreq, *sreq;
+
+    if (ucp_ep_config_key_has_tag_lane(&ucp_ep_config(sender().ep())->key)) {
+        UCS_TEST_SKIP_R("payload checksum is not used with tag offload");
+    }
+
+    ucs::fill_random(sendbuf);
+
+    for (int corrupt = 0; corrupt <= 1; ++corrupt) {
+        if (corrupt) {
+            /* intercept the message on the receiver to corrupt it; it's done
+             * after the first transfer completed the wireup, which resets the
+             * handlers of the interfaces it activates */
+            for (unsigned i = 0; i < worker->num_ifaces; ++i) {
+                wiface = worker->ifaces[i];
+                if (!(wiface->attr.cap.flags & (UCT_IFACE_FLAG_AM_SHORT |
+                                                UCT_IFACE_FLAG_AM_BCOPY |
+                                                UCT_IFACE_FLAG_AM_ZCOPY)) ||
+                    !(wiface->attr.cap.flags & UCT_IFACE_FLAG_CB_SYNC)) {
+                    continue;
+                }
+
+                status = uct_iface_set_am_handler(wiface->iface, am_id, cb,
+                                                  worker,
+                                                  ucp_am_handlers[am_id].flags);
+                ASSERT_UCS_OK(status);
+            }
+        }
+
+        rreq = recv_nb(&recvbuf[0], size, DATATYPE, RECV_TAG, RECV_MASK);
+        sreq = send_nb(&sendbuf[0], size, DATATYPE, SENDER_TAG);
+
+        wait(rreq);
+        if (sreq != NULL) {
+            wait(sreq);
+            request_free(sreq);
+        }
+
+        EXPECT_EQ(corrupt ? UCS_ERR_IO_ERROR : UCS_OK, rreq->status);
+        request_free(rreq);
+    }
+}
+
 UCS_TEST_P(test_ucp_tag_xfer, contig_exp) {
     test_xfer(&test_ucp_tag_xfer::test_xfer_contig, true, false, false);
 }
@@ -598,6 +804,31 @@ UCS_TEST_P(test_ucp_tag_xfer, iov_unexp) {
     test_xfer(&test_ucp_tag_xfer::test_xfer_iov, false, false, false);
 }
 
+UCS_TEST_P(test_ucp_tag_xfer, strided_exp) {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, true, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_exp_truncated) {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, true, false, true);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_unexp) {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, false, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, unpack_op_exp) {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_unpack_op, true, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, unpack_op_unexp) {
+    test_xfer(&test_ucp_tag_xfer::test_xfer_unpack_op, false, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, strided_exp_sync) {
+    skip_loopback();
+    test_xfer(&test_ucp_tag_xfer::test_xfer_strided, true, true, false);
+}
+
 UCS_TEST_P(test_ucp_tag_xfer, generic_err_exp) {
     test_xfer(&test_ucp_tag_xfer::test_xfer_generic_err, true, false, false);
 }
@@ -1005,9 +1236,109 @@ UCS_TEST_P(test_ucp_tag_xfer, iov_with_empty_buffers, "ZCOPY_THRESH=512") {
                                "IOV"));
 }
 
+UCS_TEST_SKIP_COND_P(test_ucp_tag_xfer, csum_mismatch_eager,
+                     get_variant_value() != VARIANT_PAYLOAD_CHECKSUM,
+                     "RNDV_THRESH=inf") {
+    test_xfer_csum_mismatch(UCP_AM_ID_EAGER_CSUM_ONLY,
+                            corrupt_eager_payload_handler, 64);
+}
+
+UCS_TEST_SKIP_COND_P(test_ucp_tag_xfer, csum_mismatch_rndv,
+                     get_variant_value() != VARIANT_PAYLOAD_CHECKSUM,
+                     "RNDV_THRESH=1000") {
+    test_xfer_csum_mismatch(UCP_AM_ID_RNDV_RTS, corrupt_rts_csum_handler,
+                            64 * UCS_KBYTE);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_xfer)
 
 
+class test_ucp_tag_xfer_parallel_pack : public test_ucp_tag_xfer {
+public:
+    virtual void init() {
+        modify_config("GENERIC_DT_PACK_THREADS", "2");
+        modify_config("GENERIC_DT_PACK_THRESH", "64k");
+        test_ucp_tag_xfer::init();
+    }
+
+    static void get_test_variants(std::vector<ucp_test_variant>& variants)
+    {
+        add_variant_with_value(variants, get_ctx_params(), VARIANT_DEFAULT, "");
+    }
+
+    void test_xfer_parallel(size_t size, bool expected, bool helpers_used)
+    {
+        size_t count                = size / sizeof(uint32_t);
+        ucp_generic_dt_ops_t dt_ops = ucp::test_dt_uint32_ops;
+        ucp_datatype_t dt;
+
+        ucp::dt_gen_start_count  = 0;
+        ucp::dt_gen_finish_count = 0;
+        m_caller_thread          = pthread_self();
+        m_helper_pack_count      = 0;
+
+        dt_ops.pack = pack_count_threads;
+        ASSERT_UCS_OK(ucp_dt_create_generic(&dt_ops, NULL, &dt));
+        ASSERT_UCS_OK(ucp_dt_generic_set_flags(
+                dt, UCP_DT_GENERIC_FLAG_PARALLEL_PACK));
+
+        size_t recvd = do_xfer(NULL, NULL, count, dt, dt, expected, false,
+                               false);
+        EXPECT_EQ(count * sizeof(uint32_t), recvd);
+        EXPECT_EQ(2, ucp::dt_gen_start_count);
+        EXPECT_EQ(2, ucp::dt_gen_finish_count);
+        if (helpers_used) {
+            EXPECT_GT(m_helper_pack_count, 0u);
+        } else {
+            EXPECT_EQ(0u, m_helper_pack_count);
+        }
+
+        ucp_dt_destroy(dt);
+    }
+
+private:
+    static size_t pack_count_threads(void *state, size_t offset, void *dest,
+                                     size_t max_length)
+    {
+        if (pthread_equal(pthread_self(), m_caller_thread)) {
+            /* Let the helper threads run also when there is a single CPU */
+            usleep(1000);
+        } else {
+            ucs_atomic_add32(&m_helper_pack_count, 1);
+        }
+
+        return ucp::test_dt_uint32_ops.pack(state, offset, dest, max_length);
+    }
+
+    static pthread_t         m_caller_thread;
+    static volatile uint32_t m_helper_pack_count;
+};
+
+pthread_t test_ucp_tag_xfer_parallel_pack::m_caller_thread;
+volatile uint32_t test_ucp_tag_xfer_parallel_pack::m_helper_pack_count = 0;
+
+UCS_TEST_P(test_ucp_tag_xfer_parallel_pack, generic_exp) {
+    test_xfer_parallel(4 * UCS_MBYTE + 12, true, true);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer_parallel_pack, generic_unexp) {
+    test_xfer_parallel(4 * UCS_MBYTE + 12, false, true);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer_parallel_pack, generic_below_thresh) {
+    test_xfer_parallel(32 * UCS_KBYTE, true, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer_parallel_pack, set_flags_non_generic) {
+    scoped_log_handler wrap_err(wrap_errors_logger);
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucp_dt_generic_set_flags(DATATYPE,
+                                       UCP_DT_GENERIC_FLAG_PARALLEL_PACK));
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_xfer_parallel_pack)
+
+
 #ifdef ENABLE_STATS
 
 class test_ucp_tag_stats : public test_ucp_tag_xfer {
@@ -10,6 +10,10 @@
 #include <sys/epoll.h>
 #include <sys/poll.h>
 
+extern "C" {
+#include <ucp/core/ucp_worker.h>
+}
+
 
 class test_ucp_wakeup : public ucp_test {
 public:
@@ -42,6 +46,46 @@ protected:
         ASSERT_EQ(UCS_OK, status);
     }
 
+    /* Receive messages by waiting on the receiver worker, return the number of
+     * ucp_worker_wait() calls */
+    uint64_t wait_recv(unsigned count) {
+        const ucp_datatype_t DATATYPE = ucp_dt_make_contig(1);
+        const uint64_t TAG            = 0xdeadbeef;
+        uint64_t num_waits            = 0;
+        uint64_t send_data, recv_data;
+        void *req;
+
+        sender().connect(&receiver(), get_ep_params());
+
+        for (unsigned i = 0; i < count; ++i) {
+            send_data = i;
+            req       = ucp_tag_send_nb(sender().ep(), &send_data,
+                                        sizeof(send_data), DATATYPE, TAG,
+                                        send_completion);
+            if (UCS_PTR_IS_PTR(req)) {
+                wait(req);
+            } else {
+                EXPECT_UCS_OK(UCS_PTR_STATUS(req));
+            }
+
+            recv_data = 0;
+            req       = ucp_tag_recv_nb(receiver().worker(), &recv_data,
+                                        sizeof(recv_data), DATATYPE, TAG,
+                                        (ucp_tag_t)-1, recv_completion);
+            while (!ucp_request_is_completed(req)) {
+                EXPECT_UCS_OK(ucp_worker_wait(receiver().worker()));
+                ++num_waits;
+                while (ucp_worker_progress(receiver().worker()));
+            }
+
+            ucp_request_release(req);
+            EXPECT_EQ(send_data, recv_data);
+        }
+
+        flush_worker(sender());
+        return num_waits;
+    }
+
     static size_t comp_cntr;
 };
 
@@ -178,6 +222,32 @@ UCS_TEST_P(test_ucp_wakeup, signal)
     EXPECT_EQ(UCS_OK, ucp_worker_arm(worker));
 }
 
+UCS_TEST_P(test_ucp_wakeup, wait_spin, "WAIT_SPIN=inf")
+{
+    ucp_worker_h worker = receiver().worker();
+    uint64_t num_waits  = wait_recv(100);
+
+    /* Busy-polling forever never goes to sleep */
+    EXPECT_EQ(0u, worker->wait.sleep_count);
+    EXPECT_EQ(num_waits, worker->wait.spin_count);
+}
+
+UCS_TEST_P(test_ucp_wakeup, wait_spin_auto, "WAIT_SPIN=auto",
+           "WAIT_SPIN_MAX=1ms")
+{
+    ucp_worker_h worker = receiver().worker();
+    uint64_t num_waits  = wait_recv(100);
+
+    /* Waits which found a pending event when arming the worker are neither
+     * spin hits nor sleeps */
+    EXPECT_GE(num_waits, worker->wait.spin_count + worker->wait.sleep_count);
+    EXPECT_LE(worker->wait.spin_time, ucs_time_from_msec(1));
+    UCS_TEST_MESSAGE << "waits: " << num_waits << " spin: "
+                     << worker->wait.spin_count << " sleep: "
+                     << worker->wait.sleep_count << " spin time: "
+                     << ucs_time_to_usec(worker->wait.spin_time) << " us";
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_wakeup)
 
 class test_ucp_wakeup_external_epollfd : public test_ucp_wakeup {
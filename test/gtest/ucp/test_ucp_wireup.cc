@@ -511,6 +511,75 @@ UCS_TEST_P(test_ucp_wireup_1sided, empty_address) {
     ucs_free(buffer);
 }
 
+UCS_TEST_P(test_ucp_wireup_1sided, compact_address) {
+    ucp_worker_attr_t attr;
+    ucs_status_t status;
+
+    attr.field_mask = UCP_WORKER_ATTR_FIELD_ADDRESS;
+    ASSERT_UCS_OK(ucp_worker_query(receiver().worker(), &attr));
+    ucp_address_t *dict   = attr.address;
+    size_t dict_length    = attr.address_length;
+
+    attr.field_mask    = UCP_WORKER_ATTR_FIELD_ADDRESS |
+                         UCP_WORKER_ATTR_FIELD_ADDRESS_FLAGS;
+    attr.address_flags = UCP_WORKER_ADDRESS_FLAG_COMPACT;
+    ASSERT_UCS_OK(ucp_worker_query(receiver().worker(), &attr));
+    ucp_address_t *compact = attr.address;
+
+    EXPECT_LE(attr.address_length, dict_length);
+
+    ucp_unpacked_address unpacked_address;
+    if (!(get_variant_value() & UNIFIED_MODE)) {
+        EXPECT_LT(attr.address_length, dict_length);
+
+        /* Compact address can't be used before the dictionary is added */
+        scoped_log_handler slh(wrap_errors_logger);
+        status = ucp_address_unpack(sender().worker(), compact,
+                                    UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT,
+                                    &unpacked_address);
+        EXPECT_EQ(UCS_ERR_NO_ELEM, status);
+    }
+
+    ASSERT_UCS_OK(ucp_worker_add_address_dict(sender().worker(), dict));
+    ASSERT_UCS_OK(ucp_worker_add_address_dict(sender().worker(), dict));
+
+    ucp_unpacked_address unpacked_dict;
+    status = ucp_address_unpack(sender().worker(), dict,
+                                UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT,
+                                &unpacked_dict);
+    ASSERT_UCS_OK(status);
+    status = ucp_address_unpack(sender().worker(), compact,
+                                UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT,
+                                &unpacked_address);
+    ASSERT_UCS_OK(status);
+
+    EXPECT_EQ(receiver().worker()->uuid, unpacked_address.uuid);
+    ASSERT_EQ(unpacked_dict.address_count, unpacked_address.address_count);
+    for (unsigned i = 0; i < unpacked_dict.address_count; ++i) {
+        EXPECT_EQ(unpacked_dict.address_list[i].tl_name_csum,
+                  unpacked_address.address_list[i].tl_name_csum);
+        EXPECT_EQ(unpacked_dict.address_list[i].md_index,
+                  unpacked_address.address_list[i].md_index);
+    }
+
+    ucs_free(unpacked_address.address_list);
+    ucs_free(unpacked_dict.address_list);
+    ucp_worker_release_address(receiver().worker(), dict);
+
+    /* Connect by the compact address and send a message */
+    ucp_ep_params_t ep_params = get_ep_params();
+    ep_params.field_mask     |= UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+    ep_params.address         = compact;
+
+    ucp_ep_h ep;
+    status = ucp_ep_create(sender().worker(), &ep_params, &ep);
+    ucp_worker_release_address(receiver().worker(), compact);
+    ASSERT_UCS_OK(status);
+
+    send_recv(ep, receiver().worker(), receiver().ep(), 1, 1);
+    request_wait(ucp_ep_close_nb(ep, UCP_EP_CLOSE_MODE_FLUSH));
+}
+
 UCS_TEST_P(test_ucp_wireup_1sided, one_sided_wireup) {
     sender().connect(&receiver(), get_ep_params());
     send_recv(sender().ep(), receiver().worker(), receiver().ep(), 1, 1);
@@ -712,6 +781,13 @@ public:
 
 protected:
     void test_connect_loopback(bool delay_before_connect, bool enable_loopback);
+
+    ucp_ep_params_t get_lazy_ep_params() {
+        ucp_ep_params_t params = get_ep_params();
+        params.field_mask     |= UCP_EP_PARAM_FIELD_FLAGS;
+        params.flags          |= UCP_EP_PARAMS_FLAGS_LAZY_CONNECT;
+        return params;
+    }
 };
 
 UCS_TEST_P(test_ucp_wireup_2sided, two_sided_wireup) {
@@ -875,8 +951,181 @@ UCS_TEST_P(test_ucp_wireup_2sided, multi_ep_2sided) {
     }
 }
 
+UCS_TEST_P(test_ucp_wireup_2sided, lazy_connect) {
+    sender().connect(&receiver(), get_lazy_ep_params());
+    if (!is_loopback()) {
+        receiver().connect(&sender(), get_lazy_ep_params());
+    }
+
+    /* No transport endpoints are created before the first operation */
+    EXPECT_TRUE(sender().ep()->flags & UCP_EP_FLAG_LAZY_CONNECT);
+    EXPECT_EQ(0, ucp_ep_num_lanes(sender().ep()));
+
+    send_recv(sender().ep(), receiver().worker(), receiver().ep(), 1, 1);
+    flush_worker(sender());
+    EXPECT_FALSE(sender().ep()->flags & UCP_EP_FLAG_LAZY_CONNECT);
+
+    send_recv(receiver().ep(), sender().worker(), sender().ep(), 1, 1);
+    flush_worker(receiver());
+    EXPECT_FALSE(receiver().ep()->flags & UCP_EP_FLAG_LAZY_CONNECT);
+}
+
+UCS_TEST_P(test_ucp_wireup_2sided, lazy_connect_unused) {
+    const unsigned count   = 8;
+    const unsigned used_ep = 3;
+
+    for (unsigned i = 0; i < count; ++i) {
+        sender().connect(&receiver(), get_lazy_ep_params(), i);
+        if (!is_loopback()) {
+            receiver().connect(&sender(), get_lazy_ep_params(), i);
+        }
+    }
+
+    send_recv(sender().ep(0, used_ep), receiver().worker(),
+              receiver().ep(0, used_ep), 8, 1);
+    short_progress_loop(0);
+
+    for (unsigned i = 0; i < count; ++i) {
+        EXPECT_EQ(i != used_ep,
+                  !!(sender().ep(0, i)->flags & UCP_EP_FLAG_LAZY_CONNECT))
+                << "ep index " << i;
+    }
+
+    disconnect(sender());
+    if (!is_loopback()) {
+        disconnect(receiver());
+    }
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_wireup_2sided)
 
+class test_ucp_wireup_lazy_iface : public test_ucp_wireup {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant>& variants)
+    {
+        test_ucp_wireup::get_test_variants(variants, UCP_FEATURE_TAG);
+    }
+
+    virtual void init()
+    {
+        modify_config("LAZY_IFACE_OPEN", "y");
+        test_ucp_wireup::init();
+    }
+
+protected:
+    void progress_until(ucp_worker_h worker, void *req)
+    {
+        while (!is_request_completed(req)) {
+            progress();
+            ucp_worker_progress(worker);
+        }
+
+        if (req != NULL) {
+            ASSERT_UCS_OK(ucp_request_check_status(req));
+            ucp_request_free(req);
+        }
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_ucp_wireup_lazy_iface, open_on_connect,
+                     is_self()) {
+    ucp_context_h context = receiver().ucph();
+    ucp_worker_params_t worker_params;
+    ucp_address_t *address;
+    size_t address_length;
+    ucs_status_t status;
+    ucp_worker_h worker;
+    ucp_ep_h ep;
+
+    /* Let the receiver worker check the reachability of the sender devices,
+     * so that a new worker can reuse the results */
+    receiver().connect(&sender(), get_ep_params());
+
+    /* The receiver worker saved the interface attributes, so a new worker on
+     * the same context can defer opening point-to-point transports */
+    worker_params.field_mask  = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
+    worker_params.thread_mode = UCS_THREAD_MODE_SINGLE;
+    ASSERT_UCS_OK(ucp_worker_create(context, &worker_params, &worker));
+    ucs::handle<ucp_worker_h> worker_h(worker, ucp_worker_destroy);
+
+    std::set<ucp_rsc_index_t> lazy_rscs;
+    unsigned num_lazy = 0;
+    for (ucp_rsc_index_t i = 0; i < worker->num_ifaces; ++i) {
+        ucp_worker_iface_t *wiface = worker->ifaces[i];
+        if (wiface->iface == NULL) {
+            lazy_rscs.insert(wiface->rsc_index);
+            EXPECT_FALSE(get_variant_value() & UNIFIED_MODE);
+            EXPECT_EQ(UCT_IFACE_FLAG_CONNECT_TO_EP,
+                      wiface->attr.cap.flags &
+                      (UCT_IFACE_FLAG_CONNECT_TO_EP |
+                       UCT_IFACE_FLAG_CONNECT_TO_IFACE));
+            ++num_lazy;
+        }
+    }
+    UCS_TEST_MESSAGE << num_lazy << " of " << worker->num_ifaces
+                     << " interfaces are not opened";
+
+    /* The address still advertises all transports */
+    ASSERT_UCS_OK(ucp_worker_get_address(worker, &address, &address_length));
+    ucp_unpacked_address unpacked_address;
+    status = ucp_address_unpack(sender().worker(), address,
+                                UCP_ADDRESS_PACK_FLAGS_WORKER_DEFAULT,
+                                &unpacked_address);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(unsigned(worker->num_ifaces), unpacked_address.address_count);
+    ucs_free(unpacked_address.address_list);
+
+    ucp_ep_params_t ep_params = get_ep_params();
+    ep_params.field_mask     |= UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+    ep_params.address         = address;
+    status = ucp_ep_create(sender().worker(), &ep_params, &ep);
+    ucp_worker_release_address(worker, address);
+    ASSERT_UCS_OK(status);
+
+    elem_type send_data = SEND_DATA;
+    elem_type recv_data = 0;
+    void *rreq = ucp_tag_recv_nb(worker, &recv_data, 1, DT_U64, TAG,
+                                 (ucp_tag_t)-1, tag_recv_completion);
+    ASSERT_FALSE(UCS_PTR_IS_ERR(rreq));
+    void *sreq = ucp_tag_send_nb(ep, &send_data, 1, DT_U64, TAG,
+                                 send_completion);
+    ASSERT_FALSE(UCS_PTR_IS_ERR(sreq));
+    progress_until(worker, sreq);
+    progress_until(worker, rreq);
+    EXPECT_EQ(send_data, recv_data);
+
+    /* Interfaces of all lanes which were connected by the wireup request
+     * are opened */
+    std::set<ucp_rsc_index_t> lane_rscs;
+    ucp_ep_ext_gen_t *ep_ext;
+    ucs_list_for_each(ep_ext, &worker->all_eps, ep_list) {
+        ucp_ep_h remote_ep = ucp_ep_from_ext_gen(ep_ext);
+        for (ucp_lane_index_t lane = 0; lane < ucp_ep_num_lanes(remote_ep);
+             ++lane) {
+            ucp_rsc_index_t rsc_index = ucp_ep_get_rsc_index(remote_ep, lane);
+            if (rsc_index != UCP_NULL_RESOURCE) {
+                EXPECT_TRUE(ucp_worker_iface(worker, rsc_index)->iface != NULL)
+                        << "lane " << int(lane);
+                lane_rscs.insert(rsc_index);
+            }
+        }
+    }
+
+    /* Reachability of the other transports was checked without opening them */
+    for (ucp_rsc_index_t i = 0; i < worker->num_ifaces; ++i) {
+        ucp_worker_iface_t *wiface = worker->ifaces[i];
+        if (lazy_rscs.count(wiface->rsc_index) &&
+            !lane_rscs.count(wiface->rsc_index)) {
+            EXPECT_TRUE(wiface->iface == NULL)
+                    << context->tl_rscs[wiface->rsc_index].tl_rsc.tl_name;
+        }
+    }
+
+    progress_until(worker, ucp_ep_close_nb(ep, UCP_EP_CLOSE_MODE_FLUSH));
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_wireup_lazy_iface)
+
 class test_ucp_wireup_errh_peer : public test_ucp_wireup_1sided
 {
 public:
@@ -9,6 +9,7 @@
 #include <uct/api/tl.h>
 
 extern "C" {
+#include <ucp/core/ucp_ep.inl>
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_worker.inl>
 #include <ucp/core/ucp_request.h>
@@ -612,3 +613,72 @@ UCS_TEST_P(test_ucp_worker_thread_mode, query)
 }
 
 UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_worker_thread_mode, all, "all")
+
+
+class test_ucp_worker_ep_config : public ucp_test {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant> &variants)
+    {
+        add_variant(variants, UCP_FEATURE_TAG);
+    }
+
+protected:
+    virtual void init()
+    {
+        ucp_test::init();
+        sender().connect(&receiver(), get_ep_params());
+    }
+};
+
+UCS_TEST_P(test_ucp_worker_ep_config, many_configs)
+{
+    /* More configurations than an 8-bit index can address */
+    const unsigned num_configs = 300;
+    ucp_worker_h worker        = sender().worker();
+    ucp_ep_h ep                = sender().ep();
+    ucp_ep_config_t *ep_config = ucp_ep_config(ep);
+    ucp_ep_config_key_t key    = ep_config->key;
+    std::set<ucp_worker_cfg_index_t> cfg_indexes;
+    ucp_worker_cfg_index_t cfg_index, first_cfg_index;
+    ucs_status_t status;
+
+    cfg_indexes.insert(ep->cfg_index);
+
+    UCS_ASYNC_BLOCK(&worker->async);
+    /* Path index is a part of the configuration key, but does not affect the
+     * configuration itself */
+    for (unsigned i = 1; i <= num_configs; ++i) {
+        key.lanes[0].path_index = i % 256;
+        key.err_mode            = (i < 256) ? ep_config->key.err_mode :
+                                  UCP_ERR_HANDLING_MODE_PEER;
+        status = ucp_worker_get_ep_config(worker, &key, 0, &cfg_index);
+        ASSERT_UCS_OK(status);
+        cfg_indexes.insert(cfg_index);
+    }
+
+    /* Existing configurations are found, and do not move */
+    key.lanes[0].path_index = 1;
+    key.err_mode            = ep_config->key.err_mode;
+    status = ucp_worker_get_ep_config(worker, &key, 0, &first_cfg_index);
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    ASSERT_UCS_OK(status);
+
+    EXPECT_EQ(num_configs + 1, cfg_indexes.size());
+    EXPECT_EQ(ucp_worker_ep_config(worker, first_cfg_index)->key.lanes[0]
+                      .path_index, 1);
+    EXPECT_EQ(ep_config, ucp_ep_config(ep));
+
+    /* The endpoint still works */
+    ucp_request_param_t param;
+    uint64_t send_data = 1, recv_data = 0;
+    param.op_attr_mask = 0;
+    void *rreq = ucp_tag_recv_nbx(receiver().worker(), &recv_data,
+                                  sizeof(recv_data), 0, 0, &param);
+    void *sreq = ucp_tag_send_nbx(sender().ep(), &send_data,
+                                  sizeof(send_data), 0, &param);
+    ASSERT_UCS_OK(request_wait(sreq));
+    ASSERT_UCS_OK(request_wait(rreq));
+    EXPECT_EQ(send_data, recv_data);
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_worker_ep_config, all, "all")
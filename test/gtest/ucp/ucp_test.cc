@@ -874,7 +874,7 @@ unsigned ucp_test_base::entity::progress(int worker_index)
 
     unsigned progress_count = 0;
     if (!m_conn_reqs.empty()) {
-        ucp_conn_request_h conn_req = m_conn_reqs.back();
+        ucp_conn_request_h conn_req = m_conn_reqs.front();
         m_conn_reqs.pop();
         ucp_ep_h ep = accept(ucp_worker, conn_req);
         set_ep(ep, worker_index, std::numeric_limits<int>::max());
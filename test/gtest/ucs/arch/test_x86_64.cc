@@ -14,6 +14,7 @@ extern "C" {
 }
 
 #include <sys/mman.h>
+#include <vector>
 
 class test_arch : public ucs::test {
 protected:
@@ -21,7 +22,8 @@ protected:
      * not be used as template argument */
     static inline void *memcpy_relaxed(void *dst, const void *src, size_t size)
     {
-        return ucs_memcpy_relaxed(dst, src, size);
+        return ucs_memcpy_relaxed(dst, src, size, UCS_ARCH_MEMCPY_NT_NONE,
+                                  size);
     }
 
     template <void* (C)(void*, const void*, size_t)>
@@ -102,4 +104,39 @@ UCS_TEST_SKIP_COND_F(test_arch, memcpy, RUNNING_ON_VALGRIND || !ucs::perf_retry_
     }
 }
 
+UCS_TEST_F(test_arch, nt_buffer_transfer) {
+    const size_t max_size = 64 * UCS_KBYTE + 256;
+    std::vector<uint8_t> src(max_size + 64), dst(max_size + 64);
+    ucs_arch_memcpy_hint_t hint;
+    size_t size, src_off, dst_off, i;
+
+    for (i = 0; i < src.size(); ++i) {
+        src[i] = ucs::rand();
+    }
+
+    for (int h = UCS_ARCH_MEMCPY_NT_SOURCE; h <= UCS_ARCH_MEMCPY_NT_DEST; ++h) {
+        hint = static_cast<ucs_arch_memcpy_hint_t>(h);
+        for (size = 0; size <= max_size; size = (size * 3) + 1) {
+            for (src_off = 0; src_off < 64; src_off += 13) {
+                for (dst_off = 0; dst_off < 64; dst_off += 11) {
+                    std::fill(dst.begin(), dst.end(), 0xa5);
+                    ucs_x86_nt_buffer_transfer(&dst[dst_off], &src[src_off],
+                                               size, hint);
+                    ASSERT_EQ(0, memcmp(&dst[dst_off], &src[src_off], size))
+                            << "hint " << h << " size " << size
+                            << " src_off " << src_off << " dst_off "
+                            << dst_off;
+                    /* Bytes around the destination are not modified */
+                    for (i = 0; i < dst_off; ++i) {
+                        ASSERT_EQ(0xa5, dst[i]);
+                    }
+                    for (i = dst_off + size; i < dst.size(); ++i) {
+                        ASSERT_EQ(0xa5, dst[i]);
+                    }
+                }
+            }
+        }
+    }
+}
+
 #endif
@@ -8,6 +8,7 @@
 extern "C" {
 #include <ucs/algorithm/crc.h>
 #include <ucs/algorithm/qsort_r.h>
+#include <ucs/algorithm/reduce.h>
 }
 #include <vector>
 
@@ -25,6 +26,18 @@ protected:
         return compare_func(elem1, elem2);
     }
 
+    static uint32_t crc32c_bitwise(uint32_t crc, const uint8_t *p, size_t size)
+    {
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i) {
+            crc ^= p[i];
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (-(int)(crc & 1) & 0x82f63b78u);
+            }
+        }
+        return ~crc;
+    }
+
     static void *MAGIC;
 };
 
@@ -120,3 +133,167 @@ UCS_TEST_F(test_algorithm, crc32) {
     test_str = "0123456789";
     EXPECT_EQ(0xa684c7c6ul, ucs_crc32(0, test_str.c_str(), test_str.size()));
 }
+
+UCS_TEST_F(test_algorithm, crc32c) {
+    std::string test_str;
+    std::vector<uint8_t> buf(32);
+
+    test_str = "";
+    EXPECT_EQ(0u, ucs_crc32c(0, test_str.c_str(), test_str.size()));
+
+    test_str = "123456789";
+    EXPECT_EQ(0xe3069283ul, ucs_crc32c(0, test_str.c_str(), test_str.size()));
+
+    /* RFC 3720 test vectors */
+    std::fill(buf.begin(), buf.end(), 0);
+    EXPECT_EQ(0x8a9136aaul, ucs_crc32c(0, &buf[0], buf.size()));
+
+    std::fill(buf.begin(), buf.end(), 0xff);
+    EXPECT_EQ(0x62a8ab43ul, ucs_crc32c(0, &buf[0], buf.size()));
+
+    for (size_t i = 0; i < buf.size(); ++i) {
+        buf[i] = i;
+    }
+    EXPECT_EQ(0x46dd794eul, ucs_crc32c(0, &buf[0], buf.size()));
+}
+
+UCS_TEST_F(test_algorithm, crc32c_random) {
+    std::vector<uint8_t> buf(1024);
+
+    for (size_t i = 0; i < buf.size(); ++i) {
+        buf[i] = ucs::rand();
+    }
+
+    /* Cover all alignments and tails of the word-sized loop */
+    for (size_t offset = 0; offset < 16; ++offset) {
+        for (size_t size = 0; size < (buf.size() - offset); size += 7) {
+            uint32_t crc = crc32c_bitwise(0, &buf[offset], size);
+            ASSERT_EQ(crc, ucs_crc32c(0, &buf[offset], size))
+                    << "offset " << offset << " size " << size;
+
+            /* Continue the calculation from a split point */
+            size_t split = size / 3;
+            ASSERT_EQ(crc, ucs_crc32c(ucs_crc32c(0, &buf[offset], split),
+                                      &buf[offset + split], size - split))
+                    << "offset " << offset << " size " << size;
+        }
+    }
+}
+
+UCS_TEST_F(test_algorithm, fnv1a64) {
+    std::string test_str;
+
+    test_str = "";
+    EXPECT_EQ(UCS_FNV1A64_INIT,
+              ucs_fnv1a64(UCS_FNV1A64_INIT, test_str.c_str(), test_str.size()));
+
+    test_str = "a";
+    EXPECT_EQ(0xaf63dc4c8601ec8cul,
+              ucs_fnv1a64(UCS_FNV1A64_INIT, test_str.c_str(), test_str.size()));
+
+    test_str = "foobar";
+    EXPECT_EQ(0x85944171f73967e8ul,
+              ucs_fnv1a64(UCS_FNV1A64_INIT, test_str.c_str(), test_str.size()));
+
+    /* Continue the calculation over the next buffer */
+    EXPECT_EQ(0x85944171f73967e8ul,
+              ucs_fnv1a64(ucs_fnv1a64(UCS_FNV1A64_INIT, "foo", 3), "bar", 3));
+}
+
+template <typename T>
+static void test_reduce(ucs_reduce_type_t type)
+{
+    const size_t max_count = 100;
+    std::vector<T> dst(max_count), src(max_count), expected(max_count);
+    std::vector<char> dst_buf((max_count + 1) * sizeof(T));
+    std::vector<char> src_buf((max_count + 1) * sizeof(T));
+
+    /* Cover unaligned arrays and tails of the vector loops */
+    for (size_t offset = 0; offset < 4; ++offset) {
+        for (size_t count = 0; count < max_count; count += 3) {
+            for (int op = 0; op < UCS_REDUCE_OP_LAST; ++op) {
+                for (size_t i = 0; i < count; ++i) {
+                    dst[i]      = (T)(int)((ucs::rand() % 2000) - 1000);
+                    src[i]      = (T)(int)((ucs::rand() % 2000) - 1000);
+                    expected[i] = (op == UCS_REDUCE_OP_SUM) ?
+                                  (T)(dst[i] + src[i]) :
+                                  std::max(dst[i], src[i]);
+                }
+
+                memcpy(&dst_buf[offset], &dst[0], count * sizeof(T));
+                memcpy(&src_buf[offset], &src[0], count * sizeof(T));
+                ucs_reduce((ucs_reduce_op_t)op, type, &dst_buf[offset],
+                           &src_buf[offset], count);
+                ASSERT_EQ(0, memcmp(&expected[0], &dst_buf[offset],
+                                    count * sizeof(T)))
+                        << "op " << op << " offset " << offset << " count "
+                        << count;
+            }
+        }
+    }
+}
+
+UCS_TEST_F(test_algorithm, reduce) {
+    test_reduce<int32_t>(UCS_REDUCE_TYPE_INT32);
+    test_reduce<int64_t>(UCS_REDUCE_TYPE_INT64);
+    test_reduce<float>(UCS_REDUCE_TYPE_FLOAT);
+    test_reduce<double>(UCS_REDUCE_TYPE_DOUBLE);
+}
+
+UCS_TEST_F(test_algorithm, float_to_half) {
+    static const struct {
+        float    value;
+        uint16_t half;
+    } tests[] = {
+        {0.0f,          0x0000},
+        {-0.0f,         0x8000},
+        {1.0f,          0x3c00},
+        {-2.0f,         0xc000},
+        {0.1f,          0x2e66},
+        {65504.0f,      0x7bff}, /* largest half */
+        {65519.0f,      0x7bff},
+        {65520.0f,      0x7c00}, /* rounds to infinity */
+        {1e10f,         0x7c00},
+        {6.1035156e-5f, 0x0400}, /* smallest normal half */
+        {5.9604645e-8f, 0x0001}, /* smallest subnormal half */
+        {2.9802322e-8f, 0x0000}, /* halfway to the smallest, rounds to even */
+        {4.4703484e-8f, 0x0001},
+        {1.0009766f,    0x3c01},
+        {1.0004883f,    0x3c00}, /* halfway, rounds to even */
+        {1.0014648f,    0x3c02}  /* halfway, rounds to even */
+    };
+    std::vector<float> values(17);
+    std::vector<uint16_t> halves(17);
+
+    for (size_t i = 0; i < ucs_static_array_size(tests); ++i) {
+        /* Convert arrays, to use the vector instructions if available */
+        std::fill(values.begin(), values.end(), tests[i].value);
+        ucs_float_to_half(&halves[0], &values[0], values.size());
+        for (size_t j = 0; j < halves.size(); ++j) {
+            ASSERT_EQ(tests[i].half, halves[j])
+                    << "value " << tests[i].value << " index " << j;
+        }
+    }
+}
+
+UCS_TEST_F(test_algorithm, half_to_float) {
+    std::vector<uint16_t> halves, halves2;
+    std::vector<float> values;
+
+    for (unsigned i = 0; i < 0x10000; ++i) {
+        /* Skip NaN, which may not keep the payload */
+        if (((i & 0x7c00) != 0x7c00) || !(i & 0x3ff)) {
+            halves.push_back(i);
+        }
+    }
+
+    values.resize(halves.size());
+    halves2.resize(halves.size());
+    ucs_half_to_float(&values[0], &halves[0], halves.size());
+    ucs_float_to_half(&halves2[0], &values[0], values.size());
+    EXPECT_TRUE(halves == halves2);
+
+    EXPECT_EQ(1.0f, values[0x3c00]);
+    EXPECT_EQ(65504.0f, values[0x7bff]);
+    EXPECT_EQ(5.9604645e-8f, values[0x0001]);
+}
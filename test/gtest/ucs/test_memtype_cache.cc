@@ -300,6 +300,20 @@ protected:
         ucs_memtype_cache_remove(m_memtype_cache, ptr, size);
     }
 
+    ucs_status_t memtype_cache_lookup_iov(const std::vector<struct iovec> &iov,
+                                          ucs_memory_info_t *mem_info) const {
+        return ucs_memtype_cache_lookup_iov(m_memtype_cache, &iov[0],
+                                            iov.size(), mem_info);
+    }
+
+    static struct iovec make_iov(size_t address, size_t length) {
+        struct iovec iov;
+
+        iov.iov_base = reinterpret_cast<void*>(address);
+        iov.iov_len  = length;
+        return iov;
+    }
+
 private:
     ucs_memtype_cache_t *m_memtype_cache;
 };
@@ -448,6 +462,76 @@ UCS_TEST_P(test_memtype_cache, diff_mem_types_diff_bufs_keep_mem) {
     test_memtype_cache_alloc_diff_mem_types(true, false);
 }
 
+UCS_TEST_P(test_memtype_cache, lookup_after_update) {
+    const size_t region_size = UCS_BIT(20);
+    const size_t start       = 0x7f6ef0000000;
+    void *ptr                = reinterpret_cast<void*>(start);
+
+    /* repeated lookups are served from the last lookup result, which must be
+     * invalidated by every update of the cache */
+    for (int i = 0; i < 3; ++i) {
+        memtype_cache_update(ptr, region_size, UCS_MEMORY_TYPE_LAST);
+        test_ptr_found(ptr, region_size, UCS_MEMORY_TYPE_LAST);
+        test_ptr_found(ptr, region_size, UCS_MEMORY_TYPE_LAST);
+
+        memtype_cache_remove(ptr, region_size / 2);
+        test_ptr_released(ptr, region_size / 2);
+        test_ptr_found(UCS_PTR_BYTE_OFFSET(ptr, region_size / 2),
+                       region_size / 2, UCS_MEMORY_TYPE_LAST);
+
+        memtype_cache_remove(ptr, region_size);
+        test_ptr_released(ptr, region_size);
+        test_ptr_released(UCS_PTR_BYTE_OFFSET(ptr, region_size / 2), 1);
+    }
+}
+
+UCS_TEST_P(test_memtype_cache, lookup_iov) {
+    const size_t region_size = UCS_BIT(20);
+    const size_t start1      = 0x7f6ef0000000;
+    const size_t start2      = 0x7f6f2c021000;
+    const size_t host_start  = 0x7f6f42000000;
+    std::vector<struct iovec> iov;
+    ucs_memory_info_t mem_info;
+    ucs_status_t status;
+
+    memtype_cache_update(reinterpret_cast<void*>(start1), region_size,
+                         UCS_MEMORY_TYPE_LAST);
+    memtype_cache_update(reinterpret_cast<void*>(start2), region_size,
+                         UCS_MEMORY_TYPE_LAST);
+
+    /* several entries in the same region and in another region of the same
+     * memory type */
+    for (size_t offset = 0; offset < region_size; offset += region_size / 8) {
+        iov.push_back(make_iov(start1 + offset, region_size / 8));
+    }
+    iov.push_back(make_iov(start2, region_size));
+    status = memtype_cache_lookup_iov(iov, &mem_info);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(UCS_MEMORY_TYPE_LAST, mem_info.type);
+
+    /* zero-length entries are ignored */
+    iov.push_back(make_iov(host_start, 0));
+    status = memtype_cache_lookup_iov(iov, &mem_info);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(UCS_MEMORY_TYPE_LAST, mem_info.type);
+
+    /* mix of cached and not cached entries */
+    iov.push_back(make_iov(host_start, region_size));
+    status = memtype_cache_lookup_iov(iov, &mem_info);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(UCS_MEMORY_TYPE_UNKNOWN, mem_info.type);
+
+    /* only not cached entries */
+    iov.clear();
+    iov.push_back(make_iov(host_start, region_size));
+    iov.push_back(make_iov(host_start + region_size, region_size));
+    status = memtype_cache_lookup_iov(iov, &mem_info);
+    EXPECT_EQ(UCS_ERR_NO_ELEM, status);
+
+    memtype_cache_remove(reinterpret_cast<void*>(start1), region_size);
+    memtype_cache_remove(reinterpret_cast<void*>(start2), region_size);
+}
+
 INSTANTIATE_TEST_CASE_P(mem_type, test_memtype_cache,
                         ::testing::ValuesIn(mem_buffer::supported_mem_types()));
 
@@ -7,6 +7,7 @@
 #include <common/test.h>
 extern "C" {
 #include <ucs/datastruct/mpool.h>
+#include <ucs/memory/numa.h>
 }
 
 #include <limits.h>
@@ -81,6 +82,9 @@ UCS_TEST_F(test_mpool, no_allocs) {
     status = ucs_mpool_init(&mp, 0, header_size + data_size, header_size, align,
                             6, 18, &ops, "test");
     ASSERT_UCS_OK(status);
+
+    EXPECT_GE(ucs_mpool_elem_size(&mp), header_size + data_size);
+    EXPECT_EQ(0ul, ucs_mpool_elem_size(&mp) % align);
     ucs_mpool_cleanup(&mp, 1);
 }
 
@@ -244,3 +248,55 @@ UCS_TEST_F(test_mpool, leak_check) {
     scoped_log_handler log_handler(mpool_log_leak_handler);
     ucs_mpool_cleanup(&mp, 1);
 }
+
+UCS_TEST_F(test_mpool, chunk_placement) {
+    static const ucs_ternary_auto_value_t hugetlb_modes[] = {UCS_NO, UCS_TRY};
+    ucs_mpool_chunk_placement_t placement;
+    ucs_status_t status;
+    ucs_mpool_t mp;
+
+    ucs_mpool_ops_t ops[] = {
+        {ucs_mpool_chunk_malloc, ucs_mpool_chunk_free, NULL, NULL},
+        {ucs_mpool_hugetlb_malloc, ucs_mpool_hugetlb_free, NULL, NULL}
+    };
+
+    for (size_t k = 0; k < ucs_static_array_size(ops); ++k) {
+        for (size_t i = 0; i < ucs_static_array_size(hugetlb_modes); ++i) {
+            status = ucs_mpool_init(&mp, 0, header_size + data_size,
+                                    header_size, align, 1000, UINT_MAX, &ops[k],
+                                    "test");
+            ASSERT_UCS_OK(status);
+
+            EXPECT_FALSE(ucs_mpool_chunk_placement_is_set(&mp));
+            placement.hugetlb     = hugetlb_modes[i];
+            placement.numa_policy = UCS_NUMA_POLICY_PREFERRED;
+            ucs_mpool_set_chunk_placement(&mp, &placement);
+            EXPECT_TRUE(ucs_mpool_chunk_placement_is_set(&mp));
+
+            std::vector<void*> objs;
+            for (unsigned j = 0; j < 2000; ++j) {
+                void *obj = ucs_mpool_get(&mp);
+                ASSERT_TRUE(obj != NULL);
+                EXPECT_EQ(0ul, ((uintptr_t)obj + header_size) % align);
+                memset(obj, 0, header_size + data_size);
+                objs.push_back(obj);
+            }
+
+#if HAVE_NUMA
+            if (numa_available() >= 0) {
+                int policy;
+                int ret = get_mempolicy(&policy, NULL, 0, objs.back(),
+                                        MPOL_F_ADDR);
+                ASSERT_EQ(0, ret);
+                EXPECT_EQ(MPOL_PREFERRED, policy);
+            }
+#endif
+
+            for (unsigned j = 0; j < objs.size(); ++j) {
+                ucs_mpool_put(objs[j]);
+            }
+
+            ucs_mpool_cleanup(&mp, 1);
+        }
+    }
+}
@@ -166,3 +166,44 @@ UCS_TEST_F(test_sys, cpu_cache) {
     check_cache_type(UCS_CPU_CACHE_L2, "L2");
     check_cache_type(UCS_CPU_CACHE_L3, "L3");
 }
+
+static ucs_status_t test_write_file_cb(FILE *stream, void *ctx)
+{
+    fputs((const char*)ctx, stream);
+    return UCS_OK;
+}
+
+static ucs_status_t test_write_file_err_cb(FILE *stream, void *ctx)
+{
+    fputs((const char*)ctx, stream);
+    return UCS_ERR_UNSUPPORTED;
+}
+
+UCS_TEST_F(test_sys, write_file_atomic) {
+    char dir_template[] = "/tmp/ucs_write_file_XXXXXX";
+    char buffer[64];
+    ucs_status_t status;
+
+    ASSERT_TRUE(mkdtemp(dir_template) != NULL);
+    std::string dir      = dir_template;
+    std::string filename = dir + "/file";
+
+    status = ucs_sys_write_file_atomic(filename.c_str(), test_write_file_cb,
+                                       (void*)"first");
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(5, ucs_read_file_str(buffer, sizeof(buffer), 0, "%s",
+                                   filename.c_str()));
+    EXPECT_EQ(std::string("first"), buffer);
+
+    /* A failed write leaves the previous contents and no temporary file */
+    status = ucs_sys_write_file_atomic(filename.c_str(),
+                                       test_write_file_err_cb,
+                                       (void*)"second");
+    EXPECT_EQ(UCS_ERR_UNSUPPORTED, status);
+    EXPECT_EQ(5, ucs_read_file_str(buffer, sizeof(buffer), 0, "%s",
+                                   filename.c_str()));
+    EXPECT_EQ(std::string("first"), buffer);
+
+    EXPECT_EQ(0, unlink(filename.c_str()));
+    EXPECT_EQ(0, rmdir(dir.c_str()));
+}
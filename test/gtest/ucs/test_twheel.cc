@@ -239,3 +239,173 @@ UCS_TEST_F(twheel, delayed_sweep) {
     }
 }
 
+
+class twheel_virtual_time : public twheel {
+protected:
+    struct vtimer {
+        ucs_wtimer_t         timer;
+        ucs_time_t           expire_time;
+        ucs_time_t           fired_time;
+        twheel_virtual_time  *self;
+    };
+
+    virtual void init() {
+        /* drive the wheel by virtual time, starting from 0 */
+        ucs_twheel_init(&m_wheel, ucs_time_from_usec(32), 0);
+        m_time = 0;
+    }
+
+    static void vtimer_func(ucs_wtimer_t *self) {
+        struct vtimer *t = ucs_container_of(self, struct vtimer, timer);
+        t->fired_time    = t->self->m_time;
+    }
+
+    void add_vtimer(struct vtimer *t, ucs_time_t delta) {
+        ucs_wtimer_init(&t->timer, vtimer_func);
+        t->self        = this;
+        t->fired_time  = 0;
+        t->expire_time = m_time + delta;
+        ASSERT_EQ(UCS_OK, ucs_wtimer_add(&m_wheel, &t->timer, delta));
+    }
+
+    void advance(ucs_time_t delta) {
+        m_time += delta;
+        ucs_twheel_sweep(&m_wheel, m_time);
+    }
+
+    ucs_time_t m_time;
+};
+
+UCS_TEST_F(twheel_virtual_time, expire_in_time) {
+    const unsigned num_timers = 100000 / ucs::test_time_multiplier();
+    std::vector<struct vtimer> t(num_timers);
+
+    /* deltas span all levels of the wheel, and some are beyond its range */
+    for (unsigned i = 0; i < num_timers; ++i) {
+        unsigned order = ucs::rand() % ((UCS_TWHEEL_NUM_LEVELS + 1) *
+                                        UCS_TWHEEL_SLOTS_ORDER);
+        ucs_time_t delta = m_wheel.res * (1 + (ucs::rand() % UCS_BIT(order)));
+        add_vtimer(&t[i], delta);
+    }
+
+    EXPECT_EQ(num_timers, m_wheel.count);
+
+    while (!ucs_twheel_is_empty(&m_wheel)) {
+        advance(m_wheel.res * (1 + (ucs::rand() % UCS_BIT(ucs::rand() % 16))));
+    }
+
+    for (unsigned i = 0; i < num_timers; ++i) {
+        /* never earlier than requested */
+        ASSERT_NE(0u, t[i].fired_time) << "timer " << i;
+        EXPECT_GE(t[i].fired_time, t[i].expire_time) << "timer " << i;
+    }
+}
+
+UCS_TEST_F(twheel_virtual_time, remove) {
+    const unsigned num_timers = 10000;
+    std::vector<struct vtimer> t(num_timers);
+
+    for (unsigned i = 0; i < num_timers; ++i) {
+        add_vtimer(&t[i], m_wheel.res * (1 + (i * 997) % 100000));
+    }
+
+    for (unsigned i = 0; i < num_timers; i += 2) {
+        ucs_wtimer_remove(&m_wheel, &t[i].timer);
+    }
+
+    EXPECT_EQ(num_timers / 2, m_wheel.count);
+
+    while (!ucs_twheel_is_empty(&m_wheel)) {
+        advance(m_wheel.res * 1000);
+    }
+
+    for (unsigned i = 0; i < num_timers; ++i) {
+        if ((i % 2) == 0) {
+            EXPECT_EQ(0u, t[i].fired_time) << "timer " << i;
+        } else {
+            EXPECT_NE(0u, t[i].fired_time) << "timer " << i;
+        }
+    }
+}
+
+UCS_TEST_F(twheel_virtual_time, rearm_from_callback) {
+    struct vtimer t;
+
+    add_vtimer(&t, m_wheel.res * 100);
+    for (int i = 0; i < 10; ++i) {
+        while (t.fired_time == 0) {
+            advance(m_wheel.res);
+        }
+
+        EXPECT_GE(t.fired_time, t.expire_time);
+        add_vtimer(&t, m_wheel.res * (1 + ucs::rand() % 10000));
+    }
+
+    ucs_wtimer_remove(&m_wheel, &t.timer);
+    EXPECT_TRUE(ucs_twheel_is_empty(&m_wheel));
+}
+
+UCS_TEST_SKIP_COND_F(twheel_virtual_time, perf,
+                     (ucs::test_time_multiplier() > 1)) {
+    const unsigned num_timers = 1000000;
+    const unsigned num_sweeps = 1000000;
+    std::vector<struct vtimer> t(num_timers);
+    ucs_time_t start_time, add_time, remove_time, sweep_time, idle_time;
+
+    for (unsigned i = 0; i < num_timers; ++i) {
+        ucs_wtimer_init(&t[i].timer, vtimer_func);
+        t[i].self = this;
+    }
+
+    /* add timers with keepalive-like spread of timeouts, which do not expire
+     * during the idle sweeps */
+    start_time = ucs_get_time();
+    for (unsigned i = 0; i < num_timers; ++i) {
+        ucs_wtimer_add(&m_wheel, &t[i].timer,
+                       m_wheel.res * (num_sweeps + 1 + (i * 7919ul) % 1000000));
+    }
+    add_time = ucs_get_time() - start_time;
+
+    /* sweep every tick while no timer expires */
+    start_time = ucs_get_time();
+    for (unsigned i = 0; i < num_sweeps; ++i) {
+        advance(m_wheel.res);
+    }
+    idle_time = ucs_get_time() - start_time;
+    EXPECT_EQ(num_timers, m_wheel.count);
+
+    start_time = ucs_get_time();
+    for (unsigned i = 0; i < num_timers; ++i) {
+        ucs_wtimer_remove(&m_wheel, &t[i].timer);
+    }
+    remove_time = ucs_get_time() - start_time;
+
+    for (unsigned i = 0; i < num_timers; ++i) {
+        ucs_wtimer_add(&m_wheel, &t[i].timer,
+                       m_wheel.res * (1 + (i * 7919ul) % 1000000));
+    }
+
+    /* sweep until all timers expire */
+    start_time = ucs_get_time();
+    while (!ucs_twheel_is_empty(&m_wheel)) {
+        advance(m_wheel.res * 64);
+    }
+    sweep_time = ucs_get_time() - start_time;
+
+    double add_ns    = ucs_time_to_nsec(add_time) / num_timers;
+    double remove_ns = ucs_time_to_nsec(remove_time) / num_timers;
+    double expire_ns = ucs_time_to_nsec(sweep_time) / num_timers;
+    double idle_ns   = ucs_time_to_nsec(idle_time) / num_sweeps;
+
+    UCS_TEST_MESSAGE << "Timings (nsec): add " << add_ns << " remove "
+                     << remove_ns << " expire " << expire_ns
+                     << " idle sweep " << idle_ns;
+
+    if (ucs::perf_retry_count) {
+        EXPECT_LT(add_ns, 1000.0);
+        EXPECT_LT(remove_ns, 1000.0);
+        EXPECT_LT(idle_ns, 1000.0);
+    } else {
+        UCS_TEST_MESSAGE << "not validating performance";
+    }
+}